@@ -1513,6 +1513,140 @@ enum aome_enc_control_id {
    */
   AV1E_GET_NUM_OPERATING_POINTS = 156,
 
+  /*!\brief Codec control function to register a callback that receives each
+   * tile group of a frame as soon as its tiles are encoded,
+   * aom_tile_group_output_cb_t* parameter. A NULL parameter or a NULL
+   * output_partition disables it.
+   *
+   * The partitions of a frame are passed in bitstream order, with
+   * partition_id counting from 0: the temporal delimiter that starts a
+   * temporal unit, then the sequence header, metadata and frame header,
+   * written before the tiles are encoded, then each tile group OBU as soon as
+   * its tiles are encoded. is_last is set for the last tile group.
+   * Concatenating the partitions yields exactly the frame returned by
+   * aom_codec_get_cx_data(), which is still produced as usual. The callback
+   * may be called from the encoder worker threads, but never concurrently.
+   *
+   * For the frame header to be final before the tiles are encoded, the loop
+   * filter levels and CDEF strengths are derived from q, loop restoration is
+   * off and the CDFs of the first tile are kept for the next frame. Frames
+   * using intra block copy, delta q or film grain, error resilient frames
+   * with several tile groups and frames that may be encoded more than once
+   * (superres search, recode loop) are split into the same partitions once
+   * they are packed instead.
+   *
+   * Only honored with g_lag_in_frames == 0 and without Annex B output. Set
+   * AV1E_SET_NUM_TG above 1 to get more than one tile group per frame.
+   */
+  AV1E_SET_TILE_GROUP_OUTPUT_CB = AOME_SET_DELTA_QINDEX_MULT + 20,
+
+  /*!\brief Codec control function to compute the PSNR of each frame in the
+   * background, int parameter
+   *
+   * Only has an effect when the encoder was initialized with
+   * AOM_CODEC_USE_PSNR. When enabled, the PSNR of a shown frame is computed
+   * on a separate thread while the application carries on, and its
+   * AOM_CODEC_PSNR_PKT is returned with the output of the next
+   * aom_codec_encode() call (including the flush call) instead of the current
+   * one.
+   *
+   * - 0 = disable (default)
+   * - 1 = enable
+   */
+  AV1E_SET_ASYNC_PSNR = AOME_SET_DELTA_QINDEX_MULT + 21,
+
+  /*!\brief Codec control function to get the time spent in each of the main
+   * stages of the encoder, aom_enc_stage_times_t* parameter
+   *
+   * The times are wall times in microseconds, accumulated since the encoder
+   * was initialized. A stage is timed as a whole whether it ran on one thread
+   * or on several. With frame parallel encoding, the stages of frames encoded
+   * at the same time all count, so the sum can exceed the elapsed time.
+   */
+  AV1E_GET_STAGE_TIMES = AOME_SET_DELTA_QINDEX_MULT + 22,
+
+  /*!\brief Codec control function to seed the LAST_FRAME motion search of
+   * the upper spatial layers with the motion vectors of the layer below,
+   * int parameter
+   *
+   * Only used in real-time SVC with AV1E_SET_SVC_REF_FRAME_CONFIG, when both
+   * layers predict from their own frames of the same previous superframe.
+   * The motion search then only refines the scaled vector of the co-located
+   * block, which lowers the encoding time of the upper layers.
+   *
+   * - 0 = disable (default)
+   * - 1 = enable
+   */
+  AV1E_SET_SVC_REUSE_LOWER_LAYER_MV = AOME_SET_DELTA_QINDEX_MULT + 23,
+
+  /*!\brief Codec control function to set the regions of the source that
+   * changed since the previous frame, aom_dirty_rects_t* parameter
+   *
+   * Blocks outside all the rectangles are coded as skip blocks that copy the
+   * LAST reference, without any partition or mode search. This is meant for
+   * screen content, where most of the frame is often unchanged.
+   *
+   * The rectangles are converted to an active map (see AOME_SET_ACTIVEMAP)
+   * that only applies to the next encoded frame, so they have to be set again
+   * before each frame. Frames without rectangles are coded in full, and key
+   * frames ignore them. A NULL rects pointer marks the whole frame as changed.
+   */
+  AV1E_SET_DIRTY_RECTS = AOME_SET_DELTA_QINDEX_MULT + 24,
+
+  /*!\brief Codec control function to denoise each superblock row before it
+   * is encoded, unsigned int parameter
+   *
+   * Only has an effect when the temporal denoiser is on (see
+   * AV1E_SET_NOISE_SENSITIVITY). Rows are filtered against the LAST denoised
+   * frame at zero motion, on the same worker that encodes them, instead of
+   * each block being filtered inside the mode search.
+   *
+   * - 0 = disable (default)
+   * - 1 = enable
+   */
+  AV1E_SET_DENOISE_PREPASS = AOME_SET_DELTA_QINDEX_MULT + 25,
+
+  /*!\brief Codec control function to set the encoding time budget of a
+   * frame in microseconds, unsigned int parameter
+   *
+   * Only used by the real-time speeds that use the nonrd mode search. The
+   * encoder times each frame and, when a frame falls behind its budget,
+   * speeds up its remaining superblock rows: first by searching fewer
+   * reference and mode pairs, then by limiting the subpel motion search to
+   * half pel, using the largest transform size, and finally by selecting
+   * shallower partitions. The level a frame starts at follows the encoding
+   * time of the previous frames. With spatial layers the budget applies to
+   * each layer frame.
+   *
+   * - 0 = disable (default)
+   */
+  AV1E_SET_FRAME_TIME_BUDGET = AOME_SET_DELTA_QINDEX_MULT + 26,
+
+  /*!\brief Codec control function to get the encoding time statistics of
+   * the last encoded frame, aom_enc_frame_time_stats_t* parameter
+   */
+  AV1E_GET_FRAME_TIME_STATS = AOME_SET_DELTA_QINDEX_MULT + 27,
+
+  /*!\brief Codec control function to split a two pass encode into chunks
+   * that can be encoded independently, aom_encode_chunks_t* parameter
+   *
+   * Only valid on an encoder initialized for the last pass, whose
+   * rc_twopass_stats_in holds the first pass stats of the whole sequence.
+   * Each chunk starts with a key frame, at a scene cut found by the key
+   * frame detection of the second pass when possible. If chunks is NULL,
+   * only num_chunks is set.
+   */
+  AV1E_GET_ENCODE_CHUNKS = AOME_SET_DELTA_QINDEX_MULT + 28,
+
+  /*!\brief Codec control function to get the first pass stats of a chunk
+   * returned by AV1E_GET_ENCODE_CHUNKS, aom_encode_chunk_stats_t* parameter
+   *
+   * The stats are those of the frames of the chunk followed by their total,
+   * to be passed in rc_twopass_stats_in to the encoder of the chunk. If
+   * stats.buf is NULL, only stats.sz is set to the size needed.
+   */
+  AV1E_GET_ENCODE_CHUNK_STATS = AOME_SET_DELTA_QINDEX_MULT + 29,
+
   // Any new encoder control IDs should be added above.
   // Maximum allowed encoder control ID is 229.
   // No encoder control ID should be added below.
@@ -1572,6 +1706,29 @@ typedef struct aom_active_map {
   unsigned int cols; /**< number of cols */
 } aom_active_map_t;
 
+/*!\brief  aom dirty rectangle
+ *
+ * A region of the source frame, in luma pixels
+ *
+ */
+typedef struct aom_dirty_rect {
+  int x;      /**< left column */
+  int y;      /**< top row */
+  int width;  /**< width */
+  int height; /**< height */
+} aom_dirty_rect_t;
+
+/*!\brief  aom dirty rectangle list
+ *
+ * The regions of the next source frame that changed since the previous frame
+ *
+ */
+typedef struct aom_dirty_rects {
+  /*!\brief rectangles, or NULL if the whole frame changed */
+  const aom_dirty_rect_t *rects;
+  unsigned int num_rects; /**< number of rectangles */
+} aom_dirty_rects_t;
+
 /*!\brief  aom image scaling mode
  *
  * This defines the data structure for image scaling mode
@@ -1682,6 +1839,88 @@ typedef struct aom_svc_ref_frame_comp_pred {
   int use_comp_pred[3]; /**<Compound reference flag. */
 } aom_svc_ref_frame_comp_pred_t;
 
+/*!\brief Callback receiving one partition of a frame.
+ *
+ * \param[in] user_priv     The user_priv of aom_tile_group_output_cb_t
+ * \param[in] data          Partition data, valid only during the call
+ * \param[in] size          Size of the partition data in bytes
+ * \param[in] partition_id  Index of the partition within the frame
+ * \param[in] is_last       Nonzero for the last partition of the frame
+ */
+typedef void (*aom_tile_group_output_cb_fn_t)(void *user_priv,
+                                              const uint8_t *data, size_t size,
+                                              int partition_id, int is_last);
+
+/*!brief Parameter type for AV1E_SET_TILE_GROUP_OUTPUT_CB */
+typedef struct aom_tile_group_output_cb {
+  aom_tile_group_output_cb_fn_t output_partition; /**< Output callback */
+  void *user_priv; /**< Opaque pointer passed to output_partition */
+} aom_tile_group_output_cb_t;
+
+/*!\brief Encoder stages timed by AV1E_GET_STAGE_TIMES */
+typedef enum aom_enc_stage {
+  AOM_ENC_STAGE_FIRST_PASS,         /**< First pass */
+  AOM_ENC_STAGE_TEMPORAL_FILTER,    /**< Temporal filtering */
+  AOM_ENC_STAGE_TPL,                /**< TPL model */
+  AOM_ENC_STAGE_GLOBAL_MOTION,      /**< Global motion estimation */
+  AOM_ENC_STAGE_ENCODE,             /**< Partition and mode search of tiles */
+  AOM_ENC_STAGE_LOOP_FILTER,        /**< Deblocking level search and filter */
+  AOM_ENC_STAGE_CDEF_SEARCH,        /**< CDEF strength search */
+  AOM_ENC_STAGE_CDEF,               /**< CDEF filter */
+  AOM_ENC_STAGE_LOOP_RESTORATION,   /**< Loop restoration search and filter */
+  AOM_ENC_STAGE_PACK_BITSTREAM,     /**< Tile bitstream packing */
+  AOM_ENC_STAGE_METRICS,            /**< Frame quality metrics */
+  AOM_ENC_STAGE_COUNT               /**< Number of stages */
+} aom_enc_stage_t;
+
+/*!brief Parameter type for AV1E_GET_STAGE_TIMES */
+typedef struct aom_enc_stage_times {
+  /*! Microseconds spent in each stage, indexed by aom_enc_stage_t */
+  int64_t time_us[AOM_ENC_STAGE_COUNT];
+} aom_enc_stage_times_t;
+
+/*!brief Parameter type for AV1E_GET_FRAME_TIME_STATS */
+typedef struct aom_enc_frame_time_stats {
+  int64_t frame_time_us;      /**< Wall time taken to encode the frame */
+  int64_t sb_encode_time_us;  /**< Part of it spent in superblock rows */
+  int64_t max_sb_row_time_us; /**< Time taken by the slowest superblock row */
+  unsigned int budget_us;     /**< Budget, see AV1E_SET_FRAME_TIME_BUDGET */
+  int start_speed_level;      /**< Speed level the frame started at */
+  int max_speed_level;        /**< Highest level used by a superblock row */
+  int num_sb_rows;            /**< Superblock rows, of all tile columns */
+  int num_boosted_sb_rows;    /**< Rows encoded above the start level */
+  int dropped;                /**< Nonzero if the frame was dropped */
+} aom_enc_frame_time_stats_t;
+
+/*!brief A chunk of a two pass encode, see AV1E_GET_ENCODE_CHUNKS */
+typedef struct aom_encode_chunk {
+  int start;      /**< Index of the first frame in the first pass stats */
+  int num_frames; /**< Number of frames in the chunk */
+  /*! Target bitrate of the chunk relative to that of the whole sequence,
+   * from the share of the first pass error that falls in the chunk */
+  double bitrate_scale;
+} aom_encode_chunk_t;
+
+/*!brief Parameter type for AV1E_GET_ENCODE_CHUNKS */
+typedef struct aom_encode_chunks {
+  /*! Chunks are only split at a scene cut once they have this many frames */
+  int min_chunk_frames;
+  /*! Chunks that reach this many frames are split without a scene cut */
+  int max_chunk_frames;
+  /*! Lowers max_chunk_frames so that a sequence without scene cuts is split
+   * into at least this many chunks of min_chunk_frames or more */
+  int min_num_chunks;
+  aom_encode_chunk_t *chunks; /**< Receives the chunks in display order */
+  int max_chunks;             /**< Number of entries of chunks */
+  int num_chunks;             /**< Set to the number of chunks */
+} aom_encode_chunks_t;
+
+/*!brief Parameter type for AV1E_GET_ENCODE_CHUNK_STATS */
+typedef struct aom_encode_chunk_stats {
+  aom_encode_chunk_t chunk; /**< A chunk from AV1E_GET_ENCODE_CHUNKS */
+  aom_fixed_buf_t stats;    /**< Buffer receiving the stats of the chunk */
+} aom_encode_chunk_stats_t;
+
 /*!\cond */
 /*!\brief Encoder control function parameter type
  *
@@ -2203,6 +2442,36 @@ AOM_CTRL_USE_TYPE(AOME_SET_TPL_RD_MULT, int)
 AOM_CTRL_USE_TYPE(AV1E_GET_NUM_OPERATING_POINTS, int *)
 #define AOM_CTRL_AV1E_GET_NUM_OPERATING_POINTS
 
+AOM_CTRL_USE_TYPE(AV1E_SET_TILE_GROUP_OUTPUT_CB, aom_tile_group_output_cb_t *)
+#define AOM_CTRL_AV1E_SET_TILE_GROUP_OUTPUT_CB
+
+AOM_CTRL_USE_TYPE(AV1E_SET_ASYNC_PSNR, int)
+#define AOM_CTRL_AV1E_SET_ASYNC_PSNR
+
+AOM_CTRL_USE_TYPE(AV1E_GET_STAGE_TIMES, aom_enc_stage_times_t *)
+#define AOM_CTRL_AV1E_GET_STAGE_TIMES
+
+AOM_CTRL_USE_TYPE(AV1E_SET_SVC_REUSE_LOWER_LAYER_MV, int)
+#define AOM_CTRL_AV1E_SET_SVC_REUSE_LOWER_LAYER_MV
+
+AOM_CTRL_USE_TYPE(AV1E_SET_DIRTY_RECTS, aom_dirty_rects_t *)
+#define AOM_CTRL_AV1E_SET_DIRTY_RECTS
+
+AOM_CTRL_USE_TYPE(AV1E_SET_DENOISE_PREPASS, unsigned int)
+#define AOM_CTRL_AV1E_SET_DENOISE_PREPASS
+
+AOM_CTRL_USE_TYPE(AV1E_SET_FRAME_TIME_BUDGET, unsigned int)
+#define AOM_CTRL_AV1E_SET_FRAME_TIME_BUDGET
+
+AOM_CTRL_USE_TYPE(AV1E_GET_FRAME_TIME_STATS, aom_enc_frame_time_stats_t *)
+#define AOM_CTRL_AV1E_GET_FRAME_TIME_STATS
+
+AOM_CTRL_USE_TYPE(AV1E_GET_ENCODE_CHUNKS, aom_encode_chunks_t *)
+#define AOM_CTRL_AV1E_GET_ENCODE_CHUNKS
+
+AOM_CTRL_USE_TYPE(AV1E_GET_ENCODE_CHUNK_STATS, aom_encode_chunk_stats_t *)
+#define AOM_CTRL_AV1E_GET_ENCODE_CHUNK_STATS
+
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
@@ -183,6 +183,64 @@ typedef struct av1_ext_ref_frame {
   int num;
 } av1_ext_ref_frame_t;
 
+/*!\brief Callback receiving rows of the frame being decoded.
+ *
+ * \param[in] user_priv  The user_priv of aom_row_output_cb_t
+ * \param[in] img        The frame being decoded, valid only during the call
+ * \param[in] row_start  First luma row that became final
+ * \param[in] row_end    One past the last luma row that became final
+ */
+typedef void (*aom_row_output_cb_fn_t)(void *user_priv, const aom_image_t *img,
+                                       unsigned int row_start,
+                                       unsigned int row_end);
+
+/*!\brief Structure to hold the row output callback.
+ *
+ * Define a structure to hold the callback set with AV1D_SET_ROW_OUTPUT_CB.
+ */
+typedef struct aom_row_output_cb {
+  /*! Called each time more rows of the frame become final. */
+  aom_row_output_cb_fn_t output_rows;
+  /*! Opaque pointer passed to output_rows. */
+  void *user_priv;
+} aom_row_output_cb_t;
+
+/*!\brief Decoder stages timed by AV1D_GET_FRAME_TIMES */
+typedef enum aom_dec_stage {
+  AOM_DEC_STAGE_HEADER,           /**< Frame header parsing and frame setup */
+  AOM_DEC_STAGE_TILES,            /**< Entropy decoding and reconstruction */
+  AOM_DEC_STAGE_LOOP_FILTER,      /**< Deblocking filter */
+  AOM_DEC_STAGE_CDEF,             /**< CDEF filter */
+  AOM_DEC_STAGE_SUPERRES,         /**< Super-resolution upscaling */
+  AOM_DEC_STAGE_LOOP_RESTORATION, /**< Loop restoration filter */
+  AOM_DEC_STAGE_FILM_GRAIN,       /**< Film grain synthesis */
+  AOM_DEC_STAGE_OUTPUT,           /**< Output image setup and tile list copy */
+  AOM_DEC_STAGE_COUNT             /**< Number of stages */
+} aom_dec_stage_t;
+
+/*!\brief Parameter type for AV1D_GET_FRAME_TIMES */
+typedef struct aom_dec_frame_times {
+  /*! Microseconds spent in each stage, indexed by aom_dec_stage_t */
+  int64_t time_us[AOM_DEC_STAGE_COUNT];
+  /*!
+   * Microseconds the tile worker threads spent without a job while a
+   * multi-threaded stage was running, summed over the workers
+   */
+  int64_t worker_idle_us;
+  /*! Number of frames with coded tiles that were decoded */
+  int num_frames;
+  /*! Number of tiles of the last of these frames */
+  int num_tiles;
+  /*!
+   * Input: array receiving the microseconds spent in each tile of the last
+   * frame, in raster order, summed over the threads that worked on it. May be
+   * NULL.
+   */
+  int64_t *tile_time_us;
+  /*! Input: number of elements of tile_time_us */
+  int tile_time_us_size;
+} aom_dec_frame_times_t;
+
 /*!\enum aom_dec_control_id
  * \brief AOM decoder control functions
  *
@@ -463,6 +521,43 @@ enum aom_dec_control_id {
    * be used.
    */
   AV1D_GET_MI_INFO,
+
+  /*!\brief Codec control function to accept temporal units split across
+   * several calls to aom_codec_decode(), int parameter.
+   *
+   * When enabled, each call may carry any number of whole OBUs, e.g. the
+   * frame header in one call and each tile group in its own call. Tile groups
+   * are decoded as soon as they are received; a frame is output once its last
+   * tile group has been decoded. The default is 0. Not supported with Annex B
+   * or large scale tile streams.
+   */
+  AV1D_SET_PARTIAL_INPUT,
+
+  /*!\brief Codec control function to register a callback that is told which
+   * rows of the frame being decoded are final, aom_row_output_cb_t* parameter.
+   * A NULL parameter or a NULL output_rows disables it.
+   *
+   * Rows are reported in increasing order and cover the whole frame once it
+   * is decoded. If the frame uses no in-loop filtering, rows are reported as
+   * soon as the tile rows containing them are decoded; otherwise they are
+   * reported as the last in-loop filter (deblocking, CDEF or loop
+   * restoration) finishes them, or once the frame is done when it is
+   * upscaled with superres. With multiple threads the callback may be called
+   * from a decoder thread, one call at a time. The image does not include
+   * film grain.
+   */
+  AV1D_SET_ROW_OUTPUT_CB,
+
+  /*!\brief Codec control function to get the time spent decoding,
+   * aom_dec_frame_times_t* parameter
+   *
+   * The times are wall times in microseconds of the work done by the last
+   * call to aom_codec_decode(), and of the film grain synthesis and output of
+   * the frames returned by aom_codec_get_frame() since then. Tile times cover
+   * entropy decoding and reconstruction, which are interleaved. Worker idle
+   * time is only measured with the default thread worker interface.
+   */
+  AV1D_GET_FRAME_TIMES,
 };
 
 /*!\cond */
@@ -595,6 +690,15 @@ AOM_CTRL_USE_TYPE(AOMD_GET_ORDER_HINT, unsigned int *)
 // The AOM_CTRL_USE_TYPE macro can't be used with AV1D_GET_MI_INFO because
 // AV1D_GET_MI_INFO takes more than one parameter.
 #define AOM_CTRL_AV1D_GET_MI_INFO
+
+AOM_CTRL_USE_TYPE(AV1D_SET_PARTIAL_INPUT, int)
+#define AOM_CTRL_AV1D_SET_PARTIAL_INPUT
+
+AOM_CTRL_USE_TYPE(AV1D_SET_ROW_OUTPUT_CB, aom_row_output_cb_t *)
+#define AOM_CTRL_AV1D_SET_ROW_OUTPUT_CB
+
+AOM_CTRL_USE_TYPE(AV1D_GET_FRAME_TIMES, aom_dec_frame_times_t *)
+#define AOM_CTRL_AV1D_GET_FRAME_TIMES
 /*!\endcond */
 /*! @} - end defgroup aom_decoder */
 #ifdef __cplusplus
@@ -765,11 +765,11 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
 
   add_proto qw/uint64_t aom_sum_sse_2d_i16/, "const int16_t *src, int src_stride, int width, int height, int *sum";
   specialize qw/aom_sum_sse_2d_i16 avx2 neon    sse2/;
-  specialize qw/aom_sad128x128    avx2 neon     sse2/;
-  specialize qw/aom_sad128x64     avx2 neon     sse2/;
-  specialize qw/aom_sad64x128     avx2 neon     sse2/;
-  specialize qw/aom_sad64x64      avx2 neon msa sse2/;
-  specialize qw/aom_sad64x32      avx2 neon msa sse2/;
+  specialize qw/aom_sad128x128    avx2 neon     sse2 avx512/;
+  specialize qw/aom_sad128x64     avx2 neon     sse2 avx512/;
+  specialize qw/aom_sad64x128     avx2 neon     sse2 avx512/;
+  specialize qw/aom_sad64x64      avx2 neon msa sse2 avx512/;
+  specialize qw/aom_sad64x32      avx2 neon msa sse2 avx512/;
   specialize qw/aom_sad32x64      avx2 neon msa sse2/;
   specialize qw/aom_sad32x32      avx2 neon msa sse2/;
   specialize qw/aom_sad32x16      avx2 neon msa sse2/;
@@ -789,11 +789,11 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   specialize qw/aom_sad16x64           neon     sse2/;
   specialize qw/aom_sad64x16           neon     sse2/;
 
-  specialize qw/aom_sad_skip_128x128    avx2          sse2  neon/;
-  specialize qw/aom_sad_skip_128x64     avx2          sse2  neon/;
-  specialize qw/aom_sad_skip_64x128     avx2          sse2  neon/;
-  specialize qw/aom_sad_skip_64x64      avx2          sse2  neon/;
-  specialize qw/aom_sad_skip_64x32      avx2          sse2  neon/;
+  specialize qw/aom_sad_skip_128x128    avx2          sse2  neon avx512/;
+  specialize qw/aom_sad_skip_128x64     avx2          sse2  neon avx512/;
+  specialize qw/aom_sad_skip_64x128     avx2          sse2  neon avx512/;
+  specialize qw/aom_sad_skip_64x64      avx2          sse2  neon avx512/;
+  specialize qw/aom_sad_skip_64x32      avx2          sse2  neon avx512/;
   specialize qw/aom_sad_skip_32x64      avx2          sse2  neon/;
   specialize qw/aom_sad_skip_32x32      avx2          sse2  neon/;
   specialize qw/aom_sad_skip_32x16      avx2          sse2  neon/;
@@ -1002,11 +1002,11 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
     add_proto qw/void/, "aom_masked_sad${w}x${h}x4d", "const uint8_t *src, int src_stride, const uint8_t *ref[4], int ref_stride, const uint8_t *second_pred, const uint8_t *msk, int msk_stride, int invert_mask, unsigned sads[4]";
   }
 
-  specialize qw/aom_sad128x128x4d avx2 neon     sse2/;
-  specialize qw/aom_sad128x64x4d  avx2 neon     sse2/;
-  specialize qw/aom_sad64x128x4d  avx2 neon     sse2/;
-  specialize qw/aom_sad64x64x4d   avx2 neon msa sse2/;
-  specialize qw/aom_sad64x32x4d   avx2 neon msa sse2/;
+  specialize qw/aom_sad128x128x4d avx2 neon     sse2 avx512/;
+  specialize qw/aom_sad128x64x4d  avx2 neon     sse2 avx512/;
+  specialize qw/aom_sad64x128x4d  avx2 neon     sse2 avx512/;
+  specialize qw/aom_sad64x64x4d   avx2 neon msa sse2 avx512/;
+  specialize qw/aom_sad64x32x4d   avx2 neon msa sse2 avx512/;
   specialize qw/aom_sad32x64x4d   avx2 neon msa sse2/;
   specialize qw/aom_sad32x32x4d   avx2 neon msa sse2/;
   specialize qw/aom_sad32x16x4d   avx2 neon msa sse2/;
@@ -1021,19 +1021,19 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   specialize qw/aom_sad4x8x4d          neon msa sse2/;
   specialize qw/aom_sad4x4x4d          neon msa sse2/;
 
-  specialize qw/aom_sad64x16x4d   avx2 neon     sse2/;
+  specialize qw/aom_sad64x16x4d   avx2 neon     sse2 avx512/;
   specialize qw/aom_sad32x8x4d    avx2 neon     sse2/;
   specialize qw/aom_sad16x64x4d        neon     sse2/;
   specialize qw/aom_sad16x4x4d         neon     sse2/;
   specialize qw/aom_sad8x32x4d         neon     sse2/;
   specialize qw/aom_sad4x16x4d         neon msa sse2/;
 
-  specialize qw/aom_sad_skip_128x128x4d avx2 sse2 neon/;
-  specialize qw/aom_sad_skip_128x64x4d  avx2 sse2 neon/;
-  specialize qw/aom_sad_skip_64x128x4d  avx2 sse2 neon/;
-  specialize qw/aom_sad_skip_64x64x4d   avx2 sse2 neon/;
-  specialize qw/aom_sad_skip_64x32x4d   avx2 sse2 neon/;
-  specialize qw/aom_sad_skip_64x16x4d   avx2 sse2 neon/;
+  specialize qw/aom_sad_skip_128x128x4d avx2 sse2 neon avx512/;
+  specialize qw/aom_sad_skip_128x64x4d  avx2 sse2 neon avx512/;
+  specialize qw/aom_sad_skip_64x128x4d  avx2 sse2 neon avx512/;
+  specialize qw/aom_sad_skip_64x64x4d   avx2 sse2 neon avx512/;
+  specialize qw/aom_sad_skip_64x32x4d   avx2 sse2 neon avx512/;
+  specialize qw/aom_sad_skip_64x16x4d   avx2 sse2 neon avx512/;
   specialize qw/aom_sad_skip_32x64x4d   avx2 sse2 neon/;
   specialize qw/aom_sad_skip_32x32x4d   avx2 sse2 neon/;
   specialize qw/aom_sad_skip_32x16x4d   avx2 sse2 neon/;
@@ -1178,6 +1178,9 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   add_proto qw/void aom_avg_8x8_quad/, "const uint8_t *s, int p, int x16_idx, int y16_idx, int *avg";
   specialize qw/aom_avg_8x8_quad avx2 sse2 neon/;
 
+  add_proto qw/void aom_get_8x8_stats_row/, "const uint8_t *src, int src_stride, const uint8_t *ref, int ref_stride, int num_blks, uint16_t *src_sum, uint32_t *src_sse, uint16_t *ref_sum, uint16_t *sad";
+  specialize qw/aom_get_8x8_stats_row avx2 sse2/;
+
   add_proto qw/void aom_minmax_8x8/, "const uint8_t *s, int p, const uint8_t *d, int dp, int *min, int *max";
   specialize qw/aom_minmax_8x8 sse2/;
 
@@ -1247,7 +1250,7 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   # Structured Similarity (SSIM)
   #
   add_proto qw/void aom_ssim_parms_8x8/, "const uint8_t *s, int sp, const uint8_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
-  specialize qw/aom_ssim_parms_8x8/, "$sse2_x86_64";
+  specialize qw/aom_ssim_parms_8x8 avx2/, "$sse2_x86_64";
 
   if (aom_config("CONFIG_INTERNAL_STATS") eq "yes") {
     add_proto qw/void aom_ssim_parms_16x16/, "const uint8_t *s, int sp, const uint8_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
@@ -1256,6 +1259,7 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
 
   if (aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
     add_proto qw/void aom_highbd_ssim_parms_8x8/, "const uint16_t *s, int sp, const uint16_t *r, int rp, uint32_t *sum_s, uint32_t *sum_r, uint32_t *sum_sq_s, uint32_t *sum_sq_r, uint32_t *sum_sxr";
+    specialize qw/aom_highbd_ssim_parms_8x8 avx2/;
   }
 }  # CONFIG_AV1_ENCODER
 
@@ -1319,6 +1323,9 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   add_proto qw/uint64_t/, "aom_mse_wxh_16bit", "uint8_t *dst, int dstride,uint16_t *src, int sstride, int w, int h";
   specialize qw/aom_mse_wxh_16bit  sse2 avx2/;
 
+  add_proto qw/uint64_t/, "aom_mse_16xh_16bit", "uint8_t *dst, int dstride,uint16_t *src, int w, int h";
+  specialize qw/aom_mse_16xh_16bit sse2 avx2/;
+
   foreach (@encoder_block_sizes) {
     ($w, $h) = @$_;
     add_proto qw/unsigned int/, "aom_variance${w}x${h}", "const uint8_t *src_ptr, int source_stride, const uint8_t *ref_ptr, int ref_stride, unsigned int *sse";
@@ -1326,11 +1333,11 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
     add_proto qw/uint32_t/, "aom_sub_pixel_avg_variance${w}x${h}", "const uint8_t *src_ptr, int source_stride, int xoffset, int  yoffset, const uint8_t *ref_ptr, int ref_stride, uint32_t *sse, const uint8_t *second_pred";
     add_proto qw/uint32_t/, "aom_dist_wtd_sub_pixel_avg_variance${w}x${h}", "const uint8_t *src_ptr, int source_stride, int xoffset, int  yoffset, const uint8_t *ref_ptr, int ref_stride, uint32_t *sse, const uint8_t *second_pred, const DIST_WTD_COMP_PARAMS *jcp_param";
   }
-  specialize qw/aom_variance128x128   sse2 avx2 neon    /;
-  specialize qw/aom_variance128x64    sse2 avx2 neon    /;
-  specialize qw/aom_variance64x128    sse2 avx2 neon    /;
-  specialize qw/aom_variance64x64     sse2 avx2 neon msa/;
-  specialize qw/aom_variance64x32     sse2 avx2 neon msa/;
+  specialize qw/aom_variance128x128   sse2 avx2 neon     avx512/;
+  specialize qw/aom_variance128x64    sse2 avx2 neon     avx512/;
+  specialize qw/aom_variance64x128    sse2 avx2 neon     avx512/;
+  specialize qw/aom_variance64x64     sse2 avx2 neon msa avx512/;
+  specialize qw/aom_variance64x32     sse2 avx2 neon msa avx512/;
   specialize qw/aom_variance32x64     sse2 avx2 neon msa/;
   specialize qw/aom_variance32x32     sse2 avx2 neon msa/;
   specialize qw/aom_variance32x16     sse2 avx2 neon msa/;
@@ -1343,11 +1350,11 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   specialize qw/aom_variance4x8       sse2      neon msa/;
   specialize qw/aom_variance4x4       sse2      neon msa/;
 
-  specialize qw/aom_sub_pixel_variance128x128   avx2 neon msa sse2 ssse3/;
-  specialize qw/aom_sub_pixel_variance128x64    avx2 neon msa sse2 ssse3/;
-  specialize qw/aom_sub_pixel_variance64x128    avx2 neon msa sse2 ssse3/;
-  specialize qw/aom_sub_pixel_variance64x64     avx2 neon msa sse2 ssse3/;
-  specialize qw/aom_sub_pixel_variance64x32     avx2 neon msa sse2 ssse3/;
+  specialize qw/aom_sub_pixel_variance128x128   avx2 neon msa sse2 ssse3 avx512/;
+  specialize qw/aom_sub_pixel_variance128x64    avx2 neon msa sse2 ssse3 avx512/;
+  specialize qw/aom_sub_pixel_variance64x128    avx2 neon msa sse2 ssse3 avx512/;
+  specialize qw/aom_sub_pixel_variance64x64     avx2 neon msa sse2 ssse3 avx512/;
+  specialize qw/aom_sub_pixel_variance64x32     avx2 neon msa sse2 ssse3 avx512/;
   specialize qw/aom_sub_pixel_variance32x64     avx2 neon msa sse2 ssse3/;
   specialize qw/aom_sub_pixel_variance32x32     avx2 neon msa sse2 ssse3/;
   specialize qw/aom_sub_pixel_variance32x16     avx2 neon msa sse2 ssse3/;
@@ -59,6 +59,39 @@ void aom_avg_8x8_quad_c(const uint8_t *s, int p, int x16_idx, int y16_idx,
   }
 }
 
+void aom_get_8x8_stats_row_c(const uint8_t *src, int src_stride,
+                             const uint8_t *ref, int ref_stride, int num_blks,
+                             uint16_t *src_sum, uint32_t *src_sse,
+                             uint16_t *ref_sum, uint16_t *sad) {
+  for (int b = 0; b < num_blks; ++b) {
+    const uint8_t *s = src + 8 * b;
+    int s_sum = 0;
+    uint32_t s_sse = 0;
+    for (int i = 0; i < 8; ++i, s += src_stride) {
+      for (int j = 0; j < 8; ++j) {
+        s_sum += s[j];
+        s_sse += s[j] * s[j];
+      }
+    }
+    src_sum[b] = s_sum;
+    src_sse[b] = s_sse;
+    if (ref == NULL) continue;
+
+    const uint8_t *r = ref + 8 * b;
+    int r_sum = 0;
+    int r_sad = 0;
+    s = src + 8 * b;
+    for (int i = 0; i < 8; ++i, s += src_stride, r += ref_stride) {
+      for (int j = 0; j < 8; ++j) {
+        r_sum += r[j];
+        r_sad += abs(s[j] - r[j]);
+      }
+    }
+    ref_sum[b] = r_sum;
+    sad[b] = r_sad;
+  }
+}
+
 #if CONFIG_AV1_HIGHBITDEPTH
 unsigned int aom_highbd_avg_8x8_c(const uint8_t *s8, int p) {
   int i, j;
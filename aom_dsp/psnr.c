@@ -11,6 +11,7 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stddef.h>
 
 #include "config/aom_dsp_rtcd.h"
 
@@ -359,47 +360,78 @@ int64_t aom_get_sse_plane(const YV12_BUFFER_CONFIG *a,
 #endif
 }
 
-#if CONFIG_AV1_HIGHBITDEPTH
-void aom_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
-                          const YV12_BUFFER_CONFIG *b, PSNR_STATS *psnr,
-                          uint32_t bit_depth, uint32_t in_bit_depth) {
+void aom_calc_psnr_sse_rows(const YV12_BUFFER_CONFIG *a,
+                            const YV12_BUFFER_CONFIG *b, int row_start,
+                            int row_end, uint32_t bit_depth,
+                            uint32_t in_bit_depth, uint64_t *sse,
+                            uint64_t *sse_hbd) {
   assert(a->y_crop_width == b->y_crop_width);
   assert(a->y_crop_height == b->y_crop_height);
   assert(a->uv_crop_width == b->uv_crop_width);
   assert(a->uv_crop_height == b->uv_crop_height);
+  assert(row_start >= 0 && row_start <= row_end &&
+         row_end <= a->y_crop_height);
+  assert(!(row_start & a->subsampling_y));
   const int widths[3] = { a->y_crop_width, a->uv_crop_width, a->uv_crop_width };
-  const int heights[3] = { a->y_crop_height, a->uv_crop_height,
-                           a->uv_crop_height };
   const int a_strides[3] = { a->y_stride, a->uv_stride, a->uv_stride };
   const int b_strides[3] = { b->y_stride, b->uv_stride, b->uv_stride };
-  int i;
-  uint64_t total_sse = 0;
-  uint32_t total_samples = 0;
-  double peak = (double)((1 << in_bit_depth) - 1);
+#if CONFIG_AV1_HIGHBITDEPTH
   const unsigned int input_shift = bit_depth - in_bit_depth;
+  const int calc_hbd =
+      (a->flags & YV12_FLAG_HIGHBITDEPTH) && in_bit_depth < bit_depth;
+#else
+  (void)bit_depth;
+  (void)in_bit_depth;
+  (void)sse_hbd;
+#endif
 
-  for (i = 0; i < 3; ++i) {
+  for (int i = 0; i < 3; ++i) {
+    const int ss_y = i ? a->subsampling_y : 0;
+    const int r0 = row_start >> ss_y;
+    int r1 = row_end >> ss_y;
+    // The last strip also covers the odd chroma row of an odd height frame.
+    if (row_end == a->y_crop_height) r1 = i ? a->uv_crop_height : row_end;
     const int w = widths[i];
-    const int h = heights[i];
-    const uint32_t samples = w * h;
-    uint64_t sse;
+    const int h = r1 - r0;
+    const uint8_t *const pa = a->buffers[i] + (ptrdiff_t)r0 * a_strides[i];
+    const uint8_t *const pb = b->buffers[i] + (ptrdiff_t)r0 * b_strides[i];
+    if (h <= 0) continue;
+#if CONFIG_AV1_HIGHBITDEPTH
     if (a->flags & YV12_FLAG_HIGHBITDEPTH) {
       if (input_shift) {
-        sse = highbd_get_sse_shift(a->buffers[i], a_strides[i], b->buffers[i],
-                                   b_strides[i], w, h, input_shift);
+        sse[i] += highbd_get_sse_shift(pa, a_strides[i], pb, b_strides[i], w,
+                                       h, input_shift);
       } else {
-        sse = highbd_get_sse(a->buffers[i], a_strides[i], b->buffers[i],
-                             b_strides[i], w, h);
+        sse[i] += highbd_get_sse(pa, a_strides[i], pb, b_strides[i], w, h);
+      }
+      // Compute SSE based on stream bit depth
+      if (calc_hbd) {
+        sse_hbd[i] += highbd_get_sse(pa, a_strides[i], pb, b_strides[i], w, h);
       }
-    } else {
-      sse = get_sse(a->buffers[i], a_strides[i], b->buffers[i], b_strides[i], w,
-                    h);
+      continue;
     }
-    psnr->sse[1 + i] = sse;
+#endif
+    sse[i] += get_sse(pa, a_strides[i], pb, b_strides[i], w, h);
+  }
+}
+
+void aom_calc_psnr_from_sse(const YV12_BUFFER_CONFIG *a, const uint64_t *sse,
+                            const uint64_t *sse_hbd, uint32_t bit_depth,
+                            uint32_t in_bit_depth, PSNR_STATS *psnr) {
+  const int widths[3] = { a->y_crop_width, a->uv_crop_width, a->uv_crop_width };
+  const int heights[3] = { a->y_crop_height, a->uv_crop_height,
+                           a->uv_crop_height };
+  uint64_t total_sse = 0;
+  uint32_t total_samples = 0;
+  double peak = (double)((1 << in_bit_depth) - 1);
+
+  for (int i = 0; i < 3; ++i) {
+    const uint32_t samples = widths[i] * heights[i];
+    psnr->sse[1 + i] = sse[i];
     psnr->samples[1 + i] = samples;
-    psnr->psnr[1 + i] = aom_sse_to_psnr(samples, peak, (double)sse);
+    psnr->psnr[1 + i] = aom_sse_to_psnr(samples, peak, (double)sse[i]);
 
-    total_sse += sse;
+    total_sse += sse[i];
     total_samples += samples;
   }
 
@@ -408,22 +440,19 @@ void aom_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
   psnr->psnr[0] =
       aom_sse_to_psnr((double)total_samples, peak, (double)total_sse);
 
+#if CONFIG_AV1_HIGHBITDEPTH
   // Compute PSNR based on stream bit depth
   if ((a->flags & YV12_FLAG_HIGHBITDEPTH) && (in_bit_depth < bit_depth)) {
     peak = (double)((1 << bit_depth) - 1);
     total_sse = 0;
     total_samples = 0;
-    for (i = 0; i < 3; ++i) {
-      const int w = widths[i];
-      const int h = heights[i];
-      const uint32_t samples = w * h;
-      uint64_t sse;
-      sse = highbd_get_sse(a->buffers[i], a_strides[i], b->buffers[i],
-                           b_strides[i], w, h);
-      psnr->sse_hbd[1 + i] = sse;
+    for (int i = 0; i < 3; ++i) {
+      const uint32_t samples = widths[i] * heights[i];
+      psnr->sse_hbd[1 + i] = sse_hbd[i];
       psnr->samples_hbd[1 + i] = samples;
-      psnr->psnr_hbd[1 + i] = aom_sse_to_psnr(samples, peak, (double)sse);
-      total_sse += sse;
+      psnr->psnr_hbd[1 + i] =
+          aom_sse_to_psnr(samples, peak, (double)sse_hbd[i]);
+      total_sse += sse_hbd[i];
       total_samples += samples;
     }
 
@@ -432,6 +461,21 @@ void aom_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
     psnr->psnr_hbd[0] =
         aom_sse_to_psnr((double)total_samples, peak, (double)total_sse);
   }
+#else
+  (void)sse_hbd;
+  (void)bit_depth;
+#endif
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+void aom_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
+                          const YV12_BUFFER_CONFIG *b, PSNR_STATS *psnr,
+                          uint32_t bit_depth, uint32_t in_bit_depth) {
+  uint64_t sse[3] = { 0, 0, 0 };
+  uint64_t sse_hbd[3] = { 0, 0, 0 };
+  aom_calc_psnr_sse_rows(a, b, 0, a->y_crop_height, bit_depth, in_bit_depth,
+                         sse, sse_hbd);
+  aom_calc_psnr_from_sse(a, sse, sse_hbd, bit_depth, in_bit_depth, psnr);
 }
 #endif
 
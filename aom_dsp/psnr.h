@@ -87,6 +87,43 @@ void aom_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
 void aom_calc_psnr(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b,
                    PSNR_STATS *psnr);
 
+/*!\brief Computes the per-plane SSE of a range of luma rows
+ *
+ * Accumulates the sum of squared errors of the luma rows [row_start, row_end)
+ * and of the chroma rows co-sited with them into sse[0..2], measured at
+ * in_bit_depth. For high bitdepth buffers with in_bit_depth < bit_depth, the
+ * SSE at bit_depth is also accumulated into sse_hbd[0..2]. row_start must be
+ * a multiple of the vertical chroma subsampling factor. The sums do not
+ * depend on how the frame is split into row ranges.
+ *
+ * \param[in]     a             First frame
+ * \param[in]     b             Second frame
+ * \param[in]     row_start     First luma row
+ * \param[in]     row_end       Luma row after the last one
+ * \param[in]     bit_depth     Bit depth of the frames
+ * \param[in]     in_bit_depth  Input bit depth
+ * \param[in,out] sse           Y/U/V SSE at in_bit_depth
+ * \param[in,out] sse_hbd       Y/U/V SSE at bit_depth
+ */
+void aom_calc_psnr_sse_rows(const YV12_BUFFER_CONFIG *a,
+                            const YV12_BUFFER_CONFIG *b, int row_start,
+                            int row_end, uint32_t bit_depth,
+                            uint32_t in_bit_depth, uint64_t *sse,
+                            uint64_t *sse_hbd);
+
+/*!\brief Fills in the PSNR of a frame from its per-plane SSE
+ *
+ * \param[in]     a             Frame the SSE was computed on
+ * \param[in]     sse           Y/U/V SSE at in_bit_depth
+ * \param[in]     sse_hbd       Y/U/V SSE at bit_depth
+ * \param[in]     bit_depth     Bit depth of the frame
+ * \param[in]     in_bit_depth  Input bit depth
+ * \param[out]    psnr          PSNR statistics
+ */
+void aom_calc_psnr_from_sse(const YV12_BUFFER_CONFIG *a, const uint64_t *sse,
+                            const uint64_t *sse_hbd, uint32_t bit_depth,
+                            uint32_t in_bit_depth, PSNR_STATS *psnr);
+
 double aom_psnrhvs(const YV12_BUFFER_CONFIG *source,
                    const YV12_BUFFER_CONFIG *dest, double *phvs_y,
                    double *phvs_u, double *phvs_v, uint32_t bd, uint32_t in_bd);
@@ -14,84 +14,9 @@
 #include "config/aom_dsp_rtcd.h"
 #include "aom/aom_integer.h"
 #include "aom_dsp/x86/bitdepth_conversion_avx2.h"
+#include "aom_dsp/x86/hadamard_avx2.h"
 #include "aom_ports/mem.h"
 
-static void hadamard_col8x2_avx2(__m256i *in, int iter) {
-  __m256i a0 = in[0];
-  __m256i a1 = in[1];
-  __m256i a2 = in[2];
-  __m256i a3 = in[3];
-  __m256i a4 = in[4];
-  __m256i a5 = in[5];
-  __m256i a6 = in[6];
-  __m256i a7 = in[7];
-
-  __m256i b0 = _mm256_add_epi16(a0, a1);
-  __m256i b1 = _mm256_sub_epi16(a0, a1);
-  __m256i b2 = _mm256_add_epi16(a2, a3);
-  __m256i b3 = _mm256_sub_epi16(a2, a3);
-  __m256i b4 = _mm256_add_epi16(a4, a5);
-  __m256i b5 = _mm256_sub_epi16(a4, a5);
-  __m256i b6 = _mm256_add_epi16(a6, a7);
-  __m256i b7 = _mm256_sub_epi16(a6, a7);
-
-  a0 = _mm256_add_epi16(b0, b2);
-  a1 = _mm256_add_epi16(b1, b3);
-  a2 = _mm256_sub_epi16(b0, b2);
-  a3 = _mm256_sub_epi16(b1, b3);
-  a4 = _mm256_add_epi16(b4, b6);
-  a5 = _mm256_add_epi16(b5, b7);
-  a6 = _mm256_sub_epi16(b4, b6);
-  a7 = _mm256_sub_epi16(b5, b7);
-
-  if (iter == 0) {
-    b0 = _mm256_add_epi16(a0, a4);
-    b7 = _mm256_add_epi16(a1, a5);
-    b3 = _mm256_add_epi16(a2, a6);
-    b4 = _mm256_add_epi16(a3, a7);
-    b2 = _mm256_sub_epi16(a0, a4);
-    b6 = _mm256_sub_epi16(a1, a5);
-    b1 = _mm256_sub_epi16(a2, a6);
-    b5 = _mm256_sub_epi16(a3, a7);
-
-    a0 = _mm256_unpacklo_epi16(b0, b1);
-    a1 = _mm256_unpacklo_epi16(b2, b3);
-    a2 = _mm256_unpackhi_epi16(b0, b1);
-    a3 = _mm256_unpackhi_epi16(b2, b3);
-    a4 = _mm256_unpacklo_epi16(b4, b5);
-    a5 = _mm256_unpacklo_epi16(b6, b7);
-    a6 = _mm256_unpackhi_epi16(b4, b5);
-    a7 = _mm256_unpackhi_epi16(b6, b7);
-
-    b0 = _mm256_unpacklo_epi32(a0, a1);
-    b1 = _mm256_unpacklo_epi32(a4, a5);
-    b2 = _mm256_unpackhi_epi32(a0, a1);
-    b3 = _mm256_unpackhi_epi32(a4, a5);
-    b4 = _mm256_unpacklo_epi32(a2, a3);
-    b5 = _mm256_unpacklo_epi32(a6, a7);
-    b6 = _mm256_unpackhi_epi32(a2, a3);
-    b7 = _mm256_unpackhi_epi32(a6, a7);
-
-    in[0] = _mm256_unpacklo_epi64(b0, b1);
-    in[1] = _mm256_unpackhi_epi64(b0, b1);
-    in[2] = _mm256_unpacklo_epi64(b2, b3);
-    in[3] = _mm256_unpackhi_epi64(b2, b3);
-    in[4] = _mm256_unpacklo_epi64(b4, b5);
-    in[5] = _mm256_unpackhi_epi64(b4, b5);
-    in[6] = _mm256_unpacklo_epi64(b6, b7);
-    in[7] = _mm256_unpackhi_epi64(b6, b7);
-  } else {
-    in[0] = _mm256_add_epi16(a0, a4);
-    in[7] = _mm256_add_epi16(a1, a5);
-    in[3] = _mm256_add_epi16(a2, a6);
-    in[4] = _mm256_add_epi16(a3, a7);
-    in[2] = _mm256_sub_epi16(a0, a4);
-    in[6] = _mm256_sub_epi16(a1, a5);
-    in[1] = _mm256_sub_epi16(a2, a6);
-    in[5] = _mm256_sub_epi16(a3, a7);
-  }
-}
-
 void aom_hadamard_lp_8x8_dual_avx2(const int16_t *src_diff,
                                    ptrdiff_t src_stride, int16_t *coeff) {
   __m256i src[8];
@@ -552,3 +477,72 @@ void aom_avg_8x8_quad_avx2(const uint8_t *s, int p, int x16_idx, int y16_idx,
   avg[2] = _mm_extract_epi16(_mm256_castsi256_si128(result_0), 4);
   avg[3] = _mm_extract_epi16(_mm256_extracti128_si256(result_0, 1), 4);
 }
+
+void aom_get_8x8_stats_row_avx2(const uint8_t *src, int src_stride,
+                                const uint8_t *ref, int ref_stride,
+                                int num_blks, uint16_t *src_sum,
+                                uint32_t *src_sse, uint16_t *ref_sum,
+                                uint16_t *sad) {
+  const __m256i zero = _mm256_setzero_si256();
+  int b = 0;
+  // Four 8x8 blocks per 32 pixel wide row. _mm256_sad_epu8() leaves the sum
+  // of each block in its own 64-bit lane, in block order, while the unpacks
+  // interleave the squares of blocks 0/2 and 1/3.
+  for (; b + 4 <= num_blks; b += 4) {
+    const uint8_t *s_ptr = src + 8 * b;
+    __m256i s_sum = zero, sse_02 = zero, sse_13 = zero;
+    __m256i r_sum = zero, r_sad = zero;
+    for (int i = 0; i < 8; ++i) {
+      const __m256i s =
+          _mm256_loadu_si256((const __m256i *)(s_ptr + i * src_stride));
+      const __m256i s_lo = _mm256_unpacklo_epi8(s, zero);
+      const __m256i s_hi = _mm256_unpackhi_epi8(s, zero);
+      s_sum = _mm256_add_epi64(s_sum, _mm256_sad_epu8(s, zero));
+      sse_02 = _mm256_add_epi32(sse_02, _mm256_madd_epi16(s_lo, s_lo));
+      sse_13 = _mm256_add_epi32(sse_13, _mm256_madd_epi16(s_hi, s_hi));
+      if (ref != NULL) {
+        const __m256i r = _mm256_loadu_si256(
+            (const __m256i *)(ref + 8 * b + i * ref_stride));
+        r_sum = _mm256_add_epi64(r_sum, _mm256_sad_epu8(r, zero));
+        r_sad = _mm256_add_epi64(r_sad, _mm256_sad_epu8(s, r));
+      }
+    }
+    // [b0 b0 b1 b1 | b2 b2 b3 b3] -> [b0 b1 b0 b1 | b2 b3 b2 b3]
+    __m256i sse = _mm256_hadd_epi32(sse_02, sse_13);
+    sse = _mm256_hadd_epi32(sse, sse);
+    const __m128i sse_lo = _mm256_castsi256_si128(sse);
+    const __m128i sse_hi = _mm256_extracti128_si256(sse, 1);
+    src_sse[b] = (uint32_t)_mm_cvtsi128_si32(sse_lo);
+    src_sse[b + 1] = (uint32_t)_mm_extract_epi32(sse_lo, 1);
+    src_sse[b + 2] = (uint32_t)_mm_cvtsi128_si32(sse_hi);
+    src_sse[b + 3] = (uint32_t)_mm_extract_epi32(sse_hi, 1);
+
+    // Gather the low words of the 64-bit lanes.
+    const __m256i sums = _mm256_packus_epi32(s_sum, r_sum);
+    const __m128i sums_lo = _mm256_castsi256_si128(sums);
+    const __m128i sums_hi = _mm256_extracti128_si256(sums, 1);
+    src_sum[b] = _mm_extract_epi16(sums_lo, 0);
+    src_sum[b + 1] = _mm_extract_epi16(sums_lo, 2);
+    src_sum[b + 2] = _mm_extract_epi16(sums_hi, 0);
+    src_sum[b + 3] = _mm_extract_epi16(sums_hi, 2);
+    if (ref != NULL) {
+      ref_sum[b] = _mm_extract_epi16(sums_lo, 4);
+      ref_sum[b + 1] = _mm_extract_epi16(sums_lo, 6);
+      ref_sum[b + 2] = _mm_extract_epi16(sums_hi, 4);
+      ref_sum[b + 3] = _mm_extract_epi16(sums_hi, 6);
+      const __m128i sad_lo = _mm256_castsi256_si128(r_sad);
+      const __m128i sad_hi = _mm256_extracti128_si256(r_sad, 1);
+      sad[b] = _mm_extract_epi16(sad_lo, 0);
+      sad[b + 1] = _mm_extract_epi16(sad_lo, 4);
+      sad[b + 2] = _mm_extract_epi16(sad_hi, 0);
+      sad[b + 3] = _mm_extract_epi16(sad_hi, 4);
+    }
+  }
+  if (b < num_blks) {
+    aom_get_8x8_stats_row_sse2(src + 8 * b, src_stride,
+                               ref ? ref + 8 * b : NULL, ref_stride,
+                               num_blks - b, src_sum + b, src_sse + b,
+                               ref_sum ? ref_sum + b : NULL,
+                               sad ? sad + b : NULL);
+  }
+}
@@ -131,6 +131,76 @@ void aom_avg_8x8_quad_sse2(const uint8_t *s, int p, int x16_idx, int y16_idx,
   }
 }
 
+// Accumulates the statistics of the 8x8 blocks covered by 16 (or, with
+// half set, 8) pixel wide rows. The sums and SADs are left in the low word of
+// each 64-bit lane, the sums of squares in four 32-bit lanes per block.
+static INLINE void get_8x8_stats_sse2(const uint8_t *src, int src_stride,
+                                      const uint8_t *ref, int ref_stride,
+                                      int half, __m128i *s_sum, __m128i *sse_lo,
+                                      __m128i *sse_hi, __m128i *r_sum,
+                                      __m128i *sad) {
+  const __m128i zero = _mm_setzero_si128();
+  *s_sum = *sse_lo = *sse_hi = *r_sum = *sad = zero;
+  for (int i = 0; i < 8; ++i) {
+    const __m128i s =
+        half ? _mm_loadl_epi64((const __m128i *)(src + i * src_stride))
+             : _mm_loadu_si128((const __m128i *)(src + i * src_stride));
+    const __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+    const __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+    *s_sum = _mm_add_epi64(*s_sum, _mm_sad_epu8(s, zero));
+    *sse_lo = _mm_add_epi32(*sse_lo, _mm_madd_epi16(s_lo, s_lo));
+    *sse_hi = _mm_add_epi32(*sse_hi, _mm_madd_epi16(s_hi, s_hi));
+    if (ref != NULL) {
+      const __m128i r =
+          half ? _mm_loadl_epi64((const __m128i *)(ref + i * ref_stride))
+               : _mm_loadu_si128((const __m128i *)(ref + i * ref_stride));
+      *r_sum = _mm_add_epi64(*r_sum, _mm_sad_epu8(r, zero));
+      *sad = _mm_add_epi64(*sad, _mm_sad_epu8(s, r));
+    }
+  }
+}
+
+static INLINE uint32_t hsum_epi32_sse2(__m128i v) {
+  v = _mm_add_epi32(v, _mm_srli_si128(v, 8));
+  v = _mm_add_epi32(v, _mm_srli_si128(v, 4));
+  return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+void aom_get_8x8_stats_row_sse2(const uint8_t *src, int src_stride,
+                                const uint8_t *ref, int ref_stride,
+                                int num_blks, uint16_t *src_sum,
+                                uint32_t *src_sse, uint16_t *ref_sum,
+                                uint16_t *sad) {
+  __m128i s_sum, sse_lo, sse_hi, r_sum, r_sad;
+  int b = 0;
+  for (; b + 2 <= num_blks; b += 2) {
+    get_8x8_stats_sse2(src + 8 * b, src_stride, ref ? ref + 8 * b : NULL,
+                       ref_stride, 0, &s_sum, &sse_lo, &sse_hi, &r_sum,
+                       &r_sad);
+    src_sum[b] = _mm_extract_epi16(s_sum, 0);
+    src_sum[b + 1] = _mm_extract_epi16(s_sum, 4);
+    src_sse[b] = hsum_epi32_sse2(sse_lo);
+    src_sse[b + 1] = hsum_epi32_sse2(sse_hi);
+    if (ref != NULL) {
+      ref_sum[b] = _mm_extract_epi16(r_sum, 0);
+      ref_sum[b + 1] = _mm_extract_epi16(r_sum, 4);
+      sad[b] = _mm_extract_epi16(r_sad, 0);
+      sad[b + 1] = _mm_extract_epi16(r_sad, 4);
+    }
+  }
+  if (b < num_blks) {
+    get_8x8_stats_sse2(src + 8 * b, src_stride, ref ? ref + 8 * b : NULL,
+                       ref_stride, 1, &s_sum, &sse_lo, &sse_hi, &r_sum,
+                       &r_sad);
+    src_sum[b] = _mm_extract_epi16(s_sum, 0);
+    src_sse[b] = hsum_epi32_sse2(sse_lo);
+    if (ref != NULL) {
+      ref_sum[b] = _mm_extract_epi16(r_sum, 0);
+      sad[b] = _mm_extract_epi16(r_sad, 0);
+    }
+  }
+}
+
 unsigned int aom_avg_4x4_sse2(const uint8_t *s, int p) {
   __m128i s0, s1, u0;
   unsigned int avg = 0;
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#include <immintrin.h>  // AVX512
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+
+// Computes the SADs of an MxN source block against four references. M must be
+// a multiple of 64.
+static INLINE void sad_mxnx4d_avx512(int M, int N, const uint8_t *src,
+                                     int src_stride,
+                                     const uint8_t *const ref[4],
+                                     int ref_stride, uint32_t res[4]) {
+  __m512i sum_ref0 = _mm512_setzero_si512();
+  __m512i sum_ref1 = _mm512_setzero_si512();
+  __m512i sum_ref2 = _mm512_setzero_si512();
+  __m512i sum_ref3 = _mm512_setzero_si512();
+  const uint8_t *ref0 = ref[0];
+  const uint8_t *ref1 = ref[1];
+  const uint8_t *ref2 = ref[2];
+  const uint8_t *ref3 = ref[3];
+
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < M; j += 64) {
+      const __m512i src_reg = _mm512_loadu_si512((const __m512i *)(src + j));
+      const __m512i ref0_reg = _mm512_loadu_si512((const __m512i *)(ref0 + j));
+      const __m512i ref1_reg = _mm512_loadu_si512((const __m512i *)(ref1 + j));
+      const __m512i ref2_reg = _mm512_loadu_si512((const __m512i *)(ref2 + j));
+      const __m512i ref3_reg = _mm512_loadu_si512((const __m512i *)(ref3 + j));
+      sum_ref0 = _mm512_add_epi64(sum_ref0, _mm512_sad_epu8(ref0_reg, src_reg));
+      sum_ref1 = _mm512_add_epi64(sum_ref1, _mm512_sad_epu8(ref1_reg, src_reg));
+      sum_ref2 = _mm512_add_epi64(sum_ref2, _mm512_sad_epu8(ref2_reg, src_reg));
+      sum_ref3 = _mm512_add_epi64(sum_ref3, _mm512_sad_epu8(ref3_reg, src_reg));
+    }
+    src += src_stride;
+    ref0 += ref_stride;
+    ref1 += ref_stride;
+    ref2 += ref_stride;
+    ref3 += ref_stride;
+  }
+
+  res[0] = (uint32_t)_mm512_reduce_add_epi64(sum_ref0);
+  res[1] = (uint32_t)_mm512_reduce_add_epi64(sum_ref1);
+  res[2] = (uint32_t)_mm512_reduce_add_epi64(sum_ref2);
+  res[3] = (uint32_t)_mm512_reduce_add_epi64(sum_ref3);
+}
+
+#define SADMXN_AVX512(m, n)                                               \
+  void aom_sad##m##x##n##x4d_avx512(const uint8_t *src, int src_stride,   \
+                                    const uint8_t *const ref[4],          \
+                                    int ref_stride, uint32_t res[4]) {    \
+    sad_mxnx4d_avx512(m, n, src, src_stride, ref, ref_stride, res);       \
+  }
+
+SADMXN_AVX512(64, 16)
+SADMXN_AVX512(64, 32)
+SADMXN_AVX512(64, 64)
+SADMXN_AVX512(64, 128)
+
+SADMXN_AVX512(128, 64)
+SADMXN_AVX512(128, 128)
+
+#define SAD_SKIP_MXN_AVX512(m, n)                                             \
+  void aom_sad_skip_##m##x##n##x4d_avx512(const uint8_t *src, int src_stride, \
+                                          const uint8_t *const ref[4],        \
+                                          int ref_stride, uint32_t res[4]) {  \
+    sad_mxnx4d_avx512(m, ((n) >> 1), src, 2 * src_stride, ref,                \
+                      2 * ref_stride, res);                                   \
+    res[0] <<= 1;                                                             \
+    res[1] <<= 1;                                                             \
+    res[2] <<= 1;                                                             \
+    res[3] <<= 1;                                                             \
+  }
+
+SAD_SKIP_MXN_AVX512(64, 16)
+SAD_SKIP_MXN_AVX512(64, 32)
+SAD_SKIP_MXN_AVX512(64, 64)
+SAD_SKIP_MXN_AVX512(64, 128)
+
+SAD_SKIP_MXN_AVX512(128, 64)
+SAD_SKIP_MXN_AVX512(128, 128)
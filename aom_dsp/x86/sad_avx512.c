@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#include <immintrin.h>  // AVX512
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "aom_ports/mem.h"
+
+// Each _mm512_sad_epu8 produces eight 16-bit sums in 64-bit lanes, so the
+// accumulators never overflow for blocks up to 128x128.
+static INLINE unsigned int sad64xh_avx512(const uint8_t *src_ptr,
+                                          int src_stride,
+                                          const uint8_t *ref_ptr,
+                                          int ref_stride, int h) {
+  __m512i sum = _mm512_setzero_si512();
+  for (int i = 0; i < h; ++i) {
+    const __m512i s = _mm512_loadu_si512((const __m512i *)src_ptr);
+    const __m512i r = _mm512_loadu_si512((const __m512i *)ref_ptr);
+    sum = _mm512_add_epi64(sum, _mm512_sad_epu8(s, r));
+    src_ptr += src_stride;
+    ref_ptr += ref_stride;
+  }
+  return (unsigned int)_mm512_reduce_add_epi64(sum);
+}
+
+static INLINE unsigned int sad128xh_avx512(const uint8_t *src_ptr,
+                                           int src_stride,
+                                           const uint8_t *ref_ptr,
+                                           int ref_stride, int h) {
+  __m512i sum0 = _mm512_setzero_si512();
+  __m512i sum1 = _mm512_setzero_si512();
+  for (int i = 0; i < h; ++i) {
+    const __m512i s0 = _mm512_loadu_si512((const __m512i *)src_ptr);
+    const __m512i s1 = _mm512_loadu_si512((const __m512i *)(src_ptr + 64));
+    const __m512i r0 = _mm512_loadu_si512((const __m512i *)ref_ptr);
+    const __m512i r1 = _mm512_loadu_si512((const __m512i *)(ref_ptr + 64));
+    sum0 = _mm512_add_epi64(sum0, _mm512_sad_epu8(s0, r0));
+    sum1 = _mm512_add_epi64(sum1, _mm512_sad_epu8(s1, r1));
+    src_ptr += src_stride;
+    ref_ptr += ref_stride;
+  }
+  return (unsigned int)_mm512_reduce_add_epi64(_mm512_add_epi64(sum0, sum1));
+}
+
+#define FSAD64_H(h)                                                           \
+  unsigned int aom_sad64x##h##_avx512(const uint8_t *src_ptr, int src_stride, \
+                                      const uint8_t *ref_ptr,                 \
+                                      int ref_stride) {                       \
+    return sad64xh_avx512(src_ptr, src_stride, ref_ptr, ref_stride, h);       \
+  }
+
+#define FSADS64_H(h)                                                          \
+  unsigned int aom_sad_skip_64x##h##_avx512(                                  \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr,         \
+      int ref_stride) {                                                       \
+    return 2 * sad64xh_avx512(src_ptr, src_stride * 2, ref_ptr,               \
+                              ref_stride * 2, h / 2);                         \
+  }
+
+#define FSAD128_H(h)                                                           \
+  unsigned int aom_sad128x##h##_avx512(const uint8_t *src_ptr, int src_stride, \
+                                       const uint8_t *ref_ptr,                 \
+                                       int ref_stride) {                       \
+    return sad128xh_avx512(src_ptr, src_stride, ref_ptr, ref_stride, h);       \
+  }
+
+#define FSADS128_H(h)                                                         \
+  unsigned int aom_sad_skip_128x##h##_avx512(                                 \
+      const uint8_t *src_ptr, int src_stride, const uint8_t *ref_ptr,         \
+      int ref_stride) {                                                       \
+    return 2 * sad128xh_avx512(src_ptr, src_stride * 2, ref_ptr,              \
+                               ref_stride * 2, h / 2);                        \
+  }
+
+FSAD64_H(32)
+FSAD64_H(64)
+FSAD64_H(128)
+FSAD128_H(64)
+FSAD128_H(128)
+
+FSADS64_H(32)
+FSADS64_H(64)
+FSADS64_H(128)
+FSADS128_H(64)
+FSADS128_H(128)
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+// Each 256-bit register holds two rows of 8 samples as 16-bit values. The
+// sums of s and r are accumulated as 16-bit values (at most 4 samples per
+// lane), the products as 32-bit values.
+typedef struct {
+  __m256i sum_s;
+  __m256i sum_r;
+  __m256i sum_sq_s;
+  __m256i sum_sq_r;
+  __m256i sum_sxr;
+} SsimAcc;
+
+static INLINE void ssim_acc_init(SsimAcc *acc) {
+  acc->sum_s = _mm256_setzero_si256();
+  acc->sum_r = _mm256_setzero_si256();
+  acc->sum_sq_s = _mm256_setzero_si256();
+  acc->sum_sq_r = _mm256_setzero_si256();
+  acc->sum_sxr = _mm256_setzero_si256();
+}
+
+static INLINE void ssim_acc_add(SsimAcc *acc, __m256i s, __m256i r) {
+  acc->sum_s = _mm256_add_epi16(acc->sum_s, s);
+  acc->sum_r = _mm256_add_epi16(acc->sum_r, r);
+  acc->sum_sq_s = _mm256_add_epi32(acc->sum_sq_s, _mm256_madd_epi16(s, s));
+  acc->sum_sq_r = _mm256_add_epi32(acc->sum_sq_r, _mm256_madd_epi16(r, r));
+  acc->sum_sxr = _mm256_add_epi32(acc->sum_sxr, _mm256_madd_epi16(s, r));
+}
+
+static INLINE void ssim_acc_store(const SsimAcc *acc, uint32_t *sum_s,
+                                  uint32_t *sum_r, uint32_t *sum_sq_s,
+                                  uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  const __m256i one = _mm256_set1_epi16(1);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i s = _mm256_madd_epi16(acc->sum_s, one);
+  const __m256i r = _mm256_madd_epi16(acc->sum_r, one);
+  // Per 128-bit lane: { s, r, sq_s, sq_r } and { sxr, 0, 0, 0 }.
+  const __m256i t0 = _mm256_hadd_epi32(s, r);
+  const __m256i t1 = _mm256_hadd_epi32(acc->sum_sq_s, acc->sum_sq_r);
+  const __m256i t2 = _mm256_hadd_epi32(acc->sum_sxr, zero);
+  const __m256i u0 = _mm256_hadd_epi32(t0, t1);
+  const __m256i u1 = _mm256_hadd_epi32(t2, zero);
+  const __m128i v0 = _mm_add_epi32(_mm256_castsi256_si128(u0),
+                                   _mm256_extracti128_si256(u0, 1));
+  const __m128i v1 = _mm_add_epi32(_mm256_castsi256_si128(u1),
+                                   _mm256_extracti128_si256(u1, 1));
+  *sum_s += (uint32_t)_mm_cvtsi128_si32(v0);
+  *sum_r += (uint32_t)_mm_extract_epi32(v0, 1);
+  *sum_sq_s += (uint32_t)_mm_extract_epi32(v0, 2);
+  *sum_sq_r += (uint32_t)_mm_extract_epi32(v0, 3);
+  *sum_sxr += (uint32_t)_mm_cvtsi128_si32(v1);
+}
+
+static INLINE __m256i load_2_rows_u8(const uint8_t *p, int stride) {
+  const __m128i row0 = _mm_loadl_epi64((const __m128i *)p);
+  const __m128i row1 = _mm_loadl_epi64((const __m128i *)(p + stride));
+  return _mm256_cvtepu8_epi16(_mm_unpacklo_epi64(row0, row1));
+}
+
+void aom_ssim_parms_8x8_avx2(const uint8_t *s, int sp, const uint8_t *r,
+                             int rp, uint32_t *sum_s, uint32_t *sum_r,
+                             uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                             uint32_t *sum_sxr) {
+  SsimAcc acc;
+  ssim_acc_init(&acc);
+  for (int i = 0; i < 8; i += 2, s += 2 * sp, r += 2 * rp) {
+    ssim_acc_add(&acc, load_2_rows_u8(s, sp), load_2_rows_u8(r, rp));
+  }
+  ssim_acc_store(&acc, sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr);
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+// Samples of up to 12 bits fit the signed 16-bit multiplies of
+// _mm256_madd_epi16().
+void aom_highbd_ssim_parms_8x8_avx2(const uint16_t *s, int sp,
+                                    const uint16_t *r, int rp, uint32_t *sum_s,
+                                    uint32_t *sum_r, uint32_t *sum_sq_s,
+                                    uint32_t *sum_sq_r, uint32_t *sum_sxr) {
+  SsimAcc acc;
+  ssim_acc_init(&acc);
+  for (int i = 0; i < 8; i += 2, s += 2 * sp, r += 2 * rp) {
+    ssim_acc_add(&acc, yy_loadu2_128(s + sp, s), yy_loadu2_128(r + rp, r));
+  }
+  ssim_acc_store(&acc, sum_s, sum_r, sum_sq_s, sum_sq_r, sum_sxr);
+}
+#endif  // CONFIG_AV1_HIGHBITDEPTH
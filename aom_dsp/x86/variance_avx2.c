@@ -646,6 +646,48 @@ uint64_t aom_mse_wxh_16bit_avx2(uint8_t *dst, int dstride, uint16_t *src,
   }
 }
 
+// Computes the mse of 16 / w horizontally adjacent wxh blocks. The blocks are
+// contiguous in dst (one row of dst covers all of them) while src holds each
+// wxh block packed one after the other.
+uint64_t aom_mse_16xh_16bit_avx2(uint8_t *dst, int dstride, uint16_t *src,
+                                 int w, int h) {
+  assert((w == 8 || w == 4) && (h == 8 || h == 4) &&
+         "w=8/4 and h=8/4 must satisfy");
+  const __m256i zeros = _mm256_setzero_si256();
+  __m256i square_result = _mm256_setzero_si256();
+  const int blk_size = w * h;
+  for (int i = 0; i < h; i++) {
+    const __m256i dst_16x16 = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128((__m128i const *)&dst[i * dstride]));
+    __m256i src_16x16;
+    if (w == 8) {
+      src_16x16 = _mm256_insertf128_si256(
+          _mm256_castsi128_si256(_mm_loadu_si128((__m128i const *)&src[i * w])),
+          _mm_loadu_si128((__m128i const *)&src[blk_size + i * w]), 1);
+    } else {
+      src_16x16 = _mm256_set_epi64x(*(int64_t *)&src[3 * blk_size + i * w],
+                                    *(int64_t *)&src[2 * blk_size + i * w],
+                                    *(int64_t *)&src[blk_size + i * w],
+                                    *(int64_t *)&src[i * w]);
+    }
+    const __m256i sub_result = _mm256_sub_epi16(src_16x16, dst_16x16);
+    // Each 32-bit lane accumulates at most 2 * 8 squared 8-bit differences,
+    // so the sum cannot overflow before being widened below.
+    square_result = _mm256_add_epi32(square_result,
+                                     _mm256_madd_epi16(sub_result, sub_result));
+  }
+  const __m256i sum_4x64 =
+      _mm256_add_epi64(_mm256_unpacklo_epi32(square_result, zeros),
+                       _mm256_unpackhi_epi32(square_result, zeros));
+  const __m128i sum_2x64 =
+      _mm_add_epi64(_mm256_castsi256_si128(sum_4x64),
+                    _mm256_extracti128_si256(sum_4x64, 1));
+  const __m128i sum_1x64 = _mm_add_epi64(sum_2x64, _mm_srli_si128(sum_2x64, 8));
+  uint64_t sum = 0;
+  xx_storel_64(&sum, sum_1x64);
+  return sum;
+}
+
 static INLINE void sum_final_256bit_avx2(__m256i sum_8x16[2], int *const sum) {
   const __m256i sum_result_0 = _mm256_hadd_epi16(sum_8x16[0], sum_8x16[1]);
   const __m256i sum_result_1 =
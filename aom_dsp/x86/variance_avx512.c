@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_filter.h"
+#include "aom_ports/mem.h"
+
+// Accumulates the sum and sum of squares of the differences of 32 pixels.
+// Both accumulators hold 32-bit lanes; a 128x128 block adds at most 512
+// squared differences (< 2^25) per lane, so neither can overflow.
+static INLINE void variance_kernel_avx512(const __m256i src, const __m256i ref,
+                                          __m512i *const sse,
+                                          __m512i *const sum) {
+  const __m512i ones = _mm512_set1_epi16(1);
+  const __m512i diff = _mm512_sub_epi16(_mm512_cvtepu8_epi16(src),
+                                        _mm512_cvtepu8_epi16(ref));
+  *sse = _mm512_add_epi32(*sse, _mm512_madd_epi16(diff, diff));
+  *sum = _mm512_add_epi32(*sum, _mm512_madd_epi16(diff, ones));
+}
+
+static INLINE void variance_avx512(const uint8_t *src, int src_stride,
+                                   const uint8_t *ref, int ref_stride, int w,
+                                   int h, unsigned int *sse, int *sum) {
+  __m512i vsse = _mm512_setzero_si512();
+  __m512i vsum = _mm512_setzero_si512();
+  for (int i = 0; i < h; ++i) {
+    for (int j = 0; j < w; j += 32) {
+      const __m256i s = _mm256_loadu_si256((const __m256i *)(src + j));
+      const __m256i r = _mm256_loadu_si256((const __m256i *)(ref + j));
+      variance_kernel_avx512(s, r, &vsse, &vsum);
+    }
+    src += src_stride;
+    ref += ref_stride;
+  }
+  *sse = (unsigned int)_mm512_reduce_add_epi32(vsse);
+  *sum = _mm512_reduce_add_epi32(vsum);
+}
+
+#define AOM_VAR_AVX512(bw, bh, bits)                                           \
+  unsigned int aom_variance##bw##x##bh##_avx512(                               \
+      const uint8_t *src, int src_stride, const uint8_t *ref, int ref_stride, \
+      unsigned int *sse) {                                                     \
+    int sum;                                                                   \
+    variance_avx512(src, src_stride, ref, ref_stride, bw, bh, sse, &sum);      \
+    return *sse - (unsigned int)(((int64_t)sum * sum) >> bits);                \
+  }
+
+AOM_VAR_AVX512(64, 32, 11)
+AOM_VAR_AVX512(64, 64, 12)
+AOM_VAR_AVX512(64, 128, 13)
+AOM_VAR_AVX512(128, 64, 13)
+AOM_VAR_AVX512(128, 128, 14)
+
+// Applies the 2-tap bilinear filter to 64 pairs of pixels, matching
+// ROUND_POWER_OF_TWO(a * taps[0] + b * taps[1], FILTER_BITS) of the C code.
+static INLINE __m512i bil_filter_avx512(const __m512i a, const __m512i b,
+                                        const __m512i taps) {
+  const __m512i round = _mm512_set1_epi16(1 << (FILTER_BITS - 1));
+  __m512i lo = _mm512_maddubs_epi16(_mm512_unpacklo_epi8(a, b), taps);
+  __m512i hi = _mm512_maddubs_epi16(_mm512_unpackhi_epi8(a, b), taps);
+  lo = _mm512_srli_epi16(_mm512_add_epi16(lo, round), FILTER_BITS);
+  hi = _mm512_srli_epi16(_mm512_add_epi16(hi, round), FILTER_BITS);
+  return _mm512_packus_epi16(lo, hi);
+}
+
+// Returns the taps of a non-zero offset, paired for _mm512_maddubs_epi16().
+// The taps of offset 0, { 128, 0 }, do not fit in a signed byte; that offset
+// is a copy.
+static INLINE __m512i bil_taps_avx512(int offset) {
+  const uint8_t *const f = bilinear_filters_2t[offset];
+  return _mm512_set1_epi16((int16_t)(f[0] | (f[1] << 8)));
+}
+
+// Filters a w x h block, w a multiple of 64, horizontally by xoffset and
+// then vertically by yoffset into dst, like the two passes of
+// aom_sub_pixel_variance##w##x##h##_c().
+static INLINE void bil_filter_block_avx512(const uint8_t *src, int src_stride,
+                                           int xoffset, int yoffset,
+                                           uint8_t *dst, int w, int h) {
+  DECLARE_ALIGNED(64, uint8_t, fdata[(MAX_SB_SIZE + 1) * MAX_SB_SIZE]);
+  const __m512i xtaps = bil_taps_avx512(xoffset);
+  const __m512i ytaps = bil_taps_avx512(yoffset);
+  uint8_t *const first = yoffset ? fdata : dst;
+  const int first_rows = yoffset ? h + 1 : h;
+
+  for (int i = 0; i < first_rows; ++i) {
+    for (int j = 0; j < w; j += 64) {
+      const __m512i a = _mm512_loadu_si512((const void *)(src + j));
+      __m512i out = a;
+      if (xoffset) {
+        const __m512i b = _mm512_loadu_si512((const void *)(src + j + 1));
+        out = bil_filter_avx512(a, b, xtaps);
+      }
+      _mm512_store_si512((void *)(first + i * w + j), out);
+    }
+    src += src_stride;
+  }
+
+  if (!yoffset) return;
+  for (int i = 0; i < h; ++i) {
+    for (int j = 0; j < w; j += 64) {
+      const __m512i a = _mm512_load_si512((const void *)(fdata + i * w + j));
+      const __m512i b =
+          _mm512_load_si512((const void *)(fdata + (i + 1) * w + j));
+      _mm512_store_si512((void *)(dst + i * w + j),
+                         bil_filter_avx512(a, b, ytaps));
+    }
+  }
+}
+
+#define AOM_SUB_PIXEL_VAR_AVX512(bw, bh)                                       \
+  unsigned int aom_sub_pixel_variance##bw##x##bh##_avx512(                     \
+      const uint8_t *src, int src_stride, int xoffset, int yoffset,            \
+      const uint8_t *ref, int ref_stride, unsigned int *sse) {                 \
+    DECLARE_ALIGNED(64, uint8_t, pred[bw * bh]);                               \
+    bil_filter_block_avx512(src, src_stride, xoffset, yoffset, pred, bw, bh);  \
+    return aom_variance##bw##x##bh##_avx512(pred, bw, ref, ref_stride, sse);   \
+  }
+
+AOM_SUB_PIXEL_VAR_AVX512(64, 32)
+AOM_SUB_PIXEL_VAR_AVX512(64, 64)
+AOM_SUB_PIXEL_VAR_AVX512(64, 128)
+AOM_SUB_PIXEL_VAR_AVX512(128, 64)
+AOM_SUB_PIXEL_VAR_AVX512(128, 128)
@@ -762,3 +762,47 @@ uint64_t aom_mse_wxh_16bit_sse2(uint8_t *dst, int dstride, uint16_t *src,
     default: assert(0 && "unsupported width"); return -1;
   }
 }
+
+// Computes the mse of 16 / w horizontally adjacent wxh blocks. The blocks are
+// contiguous in dst (one row of dst covers all of them) while src holds each
+// wxh block packed one after the other.
+uint64_t aom_mse_16xh_16bit_sse2(uint8_t *dst, int dstride, uint16_t *src,
+                                 int w, int h) {
+  assert((w == 8 || w == 4) && (h == 8 || h == 4) &&
+         "w=8/4 and h=8/4 must satisfy");
+  const __m128i zeros = _mm_setzero_si128();
+  __m128i square_result = _mm_setzero_si128();
+  const int blk_size = w * h;
+  for (int i = 0; i < h; i++) {
+    const __m128i dst_8x16 =
+        _mm_loadu_si128((__m128i const *)&dst[i * dstride]);
+    const __m128i dst0_16x8 = _mm_unpacklo_epi8(dst_8x16, zeros);
+    const __m128i dst1_16x8 = _mm_unpackhi_epi8(dst_8x16, zeros);
+    __m128i src0_16x8, src1_16x8;
+    if (w == 8) {
+      src0_16x8 = _mm_loadu_si128((__m128i const *)&src[i * w]);
+      src1_16x8 = _mm_loadu_si128((__m128i const *)&src[blk_size + i * w]);
+    } else {
+      src0_16x8 = _mm_unpacklo_epi64(
+          _mm_loadl_epi64((__m128i const *)&src[i * w]),
+          _mm_loadl_epi64((__m128i const *)&src[blk_size + i * w]));
+      src1_16x8 = _mm_unpacklo_epi64(
+          _mm_loadl_epi64((__m128i const *)&src[2 * blk_size + i * w]),
+          _mm_loadl_epi64((__m128i const *)&src[3 * blk_size + i * w]));
+    }
+    const __m128i sub0_16x8 = _mm_sub_epi16(src0_16x8, dst0_16x8);
+    const __m128i sub1_16x8 = _mm_sub_epi16(src1_16x8, dst1_16x8);
+    // Each 32-bit lane accumulates at most 2 * 8 squared 8-bit differences,
+    // so the sum cannot overflow before being widened below.
+    square_result = _mm_add_epi32(
+        square_result, _mm_add_epi32(_mm_madd_epi16(sub0_16x8, sub0_16x8),
+                                     _mm_madd_epi16(sub1_16x8, sub1_16x8)));
+  }
+  const __m128i sum_2x64 =
+      _mm_add_epi64(_mm_unpacklo_epi32(square_result, zeros),
+                    _mm_unpackhi_epi32(square_result, zeros));
+  const __m128i sum_1x64 = _mm_add_epi64(sum_2x64, _mm_srli_si128(sum_2x64, 8));
+  uint64_t sum = 0;
+  xx_storel_64(&sum, sum_1x64);
+  return sum;
+}
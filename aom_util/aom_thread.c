@@ -24,6 +24,7 @@
 #include <string.h>  // for memset()
 
 #include "aom_mem/aom_mem.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_util/aom_thread.h"
 
 #if CONFIG_MULTITHREAD
@@ -160,7 +161,11 @@ static int reset(AVxWorker *const worker) {
 
 static void execute(AVxWorker *const worker) {
   if (worker->hook != NULL) {
+    struct aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
     worker->had_error |= !worker->hook(worker->data1, worker->data2);
+    aom_usec_timer_mark(&timer);
+    worker->busy_us += aom_usec_timer_elapsed(&timer);
   }
 }
 
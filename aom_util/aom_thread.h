@@ -19,6 +19,8 @@
 
 #include "config/aom_config.h"
 
+#include "aom/aom_integer.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -318,6 +320,9 @@ typedef struct {
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // true if a call to 'hook' returned false
+  // Microseconds spent in calls to 'hook' since init(). Only maintained by
+  // the default interface.
+  int64_t busy_us;
 } AVxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -34,6 +34,7 @@
 #include "common/ivfdec.h"
 #include "common/md5_utils.h"
 #include "common/obudec.h"
+#include "common/packet_index.h"
 #include "common/tools_common.h"
 
 #if CONFIG_WEBM_IO
@@ -43,6 +44,10 @@
 #include "common/rawenc.h"
 #include "common/y4menc.h"
 
+#if CONFIG_MULTITHREAD
+#include "aom_util/aom_thread.h"
+#endif
+
 #if CONFIG_LIBYUV
 #include "third_party/libyuv/include/libyuv/scale.h"
 #endif
@@ -53,6 +58,8 @@ struct AvxDecInputContext {
   struct AvxInputContext *aom_input_ctx;
   struct ObuDecInputContext *obu_ctx;
   struct WebmInputContext *webm_ctx;
+  // Set when the input file is mapped and indexed.
+  PacketIndex *packet_index;
 };
 
 static const arg_def_t help =
@@ -76,6 +83,10 @@ static const arg_def_t limitarg =
     ARG_DEF(NULL, "limit", 1, "Stop decoding after n frames");
 static const arg_def_t skiparg =
     ARG_DEF(NULL, "skip", 1, "Skip the first n input frames");
+static const arg_def_t seekarg =
+    ARG_DEF(NULL, "seek", 1,
+            "Start decoding at the last key frame at or before input frame n "
+            "(IVF and OBU files)");
 static const arg_def_t summaryarg =
     ARG_DEF(NULL, "summary", 0, "Show timing summary");
 static const arg_def_t outputfile =
@@ -106,6 +117,13 @@ static const arg_def_t outallarg = ARG_DEF(
     NULL, "all-layers", 0, "Output all decoded frames of a scalable bitstream");
 static const arg_def_t skipfilmgrain =
     ARG_DEF(NULL, "skip-film-grain", 0, "Skip film grain application");
+static const arg_def_t pipelinearg =
+    ARG_DEF(NULL, "pipeline", 1,
+            "Queue up to n decoded frames for a separate output thread");
+static const arg_def_t segmentthreadsarg =
+    ARG_DEF(NULL, "segment-threads", 1,
+            "Decode the segments between key frames in parallel on n "
+            "threads (IVF and OBU files)");
 
 static const arg_def_t *all_args[] = {
   &help,           &codecarg, &use_yv12,      &use_i420,
@@ -114,7 +132,7 @@ static const arg_def_t *all_args[] = {
   &threadsarg,     &rowmtarg, &verbosearg,    &scalearg,
   &fb_arg,         &md5arg,   &framestatsarg, &continuearg,
   &outbitdeptharg, &isannexb, &oppointarg,    &outallarg,
-  &skipfilmgrain,  NULL
+  &skipfilmgrain,  &pipelinearg, &seekarg, &segmentthreadsarg, NULL
 };
 
 #if CONFIG_LIBYUV
@@ -249,6 +267,21 @@ static int read_frame(struct AvxDecInputContext *input, uint8_t **buf,
   }
 }
 
+// Reads the next temporal unit into |data| and |bytes_in_buffer|. Indexed
+// inputs are handed out as pointers into the file mapping, the others are
+// read into |buf|.
+static int read_packet(struct AvxDecInputContext *input, uint8_t **buf,
+                       size_t *buffer_size, const uint8_t **data,
+                       size_t *bytes_in_buffer) {
+  if (input->packet_index) {
+    return packet_index_read(input->packet_index, data, bytes_in_buffer,
+                             NULL);
+  }
+  const int ret = read_frame(input, buf, bytes_in_buffer, buffer_size);
+  *data = *buf;
+  return ret;
+}
+
 static int file_is_raw(struct AvxInputContext *input) {
   uint8_t buf[32];
   int is_raw = 0;
@@ -288,6 +321,8 @@ static void show_progress(int frame_in, int frame_out, uint64_t dx_time) {
 struct ExternalFrameBuffer {
   uint8_t *data;
   size_t size;
+  // Number of references held by the decoder and by frames queued for the
+  // output thread.
   int in_use;
 };
 
@@ -339,10 +374,24 @@ static int release_av1_frame_buffer(void *cb_priv,
   struct ExternalFrameBuffer *const ext_fb =
       (struct ExternalFrameBuffer *)fb->priv;
   (void)cb_priv;
-  ext_fb->in_use = 0;
+  --ext_fb->in_use;
   return 0;
 }
 
+// Returns the external frame buffer |img| was decoded into, or NULL if it is
+// not backed by one of the buffers in |ext_fb_list|.
+static struct ExternalFrameBuffer *find_frame_buffer(
+    const struct ExternalFrameBufferList *ext_fb_list, const aom_image_t *img) {
+  struct ExternalFrameBuffer *const ext_fb =
+      (struct ExternalFrameBuffer *)img->fb_priv;
+  for (int i = 0; i < ext_fb_list->num_external_frame_buffers; ++i) {
+    if (ext_fb == &ext_fb_list->ext_fb[i] && img->planes[0] >= ext_fb->data &&
+        img->planes[0] < ext_fb->data + ext_fb->size)
+      return ext_fb;
+  }
+  return NULL;
+}
+
 static void generate_filename(const char *pattern, char *out, size_t q_len,
                               unsigned int d_w, unsigned int d_h,
                               unsigned int frame_in) {
@@ -428,18 +477,675 @@ static FILE *open_outfile(const char *name) {
   }
 }
 
+// Controls applied to every decoder instance.
+struct DecoderControls {
+  unsigned int is_annexb;
+  int operating_point;
+  int output_all_layers;
+  int skip_film_grain;
+  int enable_row_mt;
+};
+
+// Returns 0 if all of |controls| were applied to |decoder|.
+static int set_decoder_controls(aom_codec_ctx_t *decoder,
+                                const struct DecoderControls *controls) {
+  if (AOM_CODEC_CONTROL_TYPECHECKED(decoder, AV1D_SET_IS_ANNEXB,
+                                    controls->is_annexb)) {
+    fprintf(stderr, "Failed to set is_annexb: %s\n", aom_codec_error(decoder));
+    return -1;
+  }
+
+  if (AOM_CODEC_CONTROL_TYPECHECKED(decoder, AV1D_SET_OPERATING_POINT,
+                                    controls->operating_point)) {
+    fprintf(stderr, "Failed to set operating_point: %s\n",
+            aom_codec_error(decoder));
+    return -1;
+  }
+
+  if (AOM_CODEC_CONTROL_TYPECHECKED(decoder, AV1D_SET_OUTPUT_ALL_LAYERS,
+                                    controls->output_all_layers)) {
+    fprintf(stderr, "Failed to set output_all_layers: %s\n",
+            aom_codec_error(decoder));
+    return -1;
+  }
+
+  if (AOM_CODEC_CONTROL_TYPECHECKED(decoder, AV1D_SET_SKIP_FILM_GRAIN,
+                                    controls->skip_film_grain)) {
+    fprintf(stderr, "Failed to set skip_film_grain: %s\n",
+            aom_codec_error(decoder));
+    return -1;
+  }
+
+  if (AOM_CODEC_CONTROL_TYPECHECKED(decoder, AV1D_SET_ROW_MT,
+                                    controls->enable_row_mt)) {
+    fprintf(stderr, "Failed to set row multithreading mode: %s\n",
+            aom_codec_error(decoder));
+    return -1;
+  }
+  return 0;
+}
+
+static const int PLANES_YUV[] = { AOM_PLANE_Y, AOM_PLANE_U, AOM_PLANE_V };
+static const int PLANES_YVU[] = { AOM_PLANE_Y, AOM_PLANE_V, AOM_PLANE_U };
+
+// State used to scale, convert and write out decoded frames. With --pipeline
+// it is only accessed by the output thread while frames are queued.
+struct OutputContext {
+  int use_y4m;
+  int opt_raw;
+  int opt_i420;
+  int opt_yv12;
+  int do_md5;
+  int single_file;
+  const int *planes;
+  unsigned int fixed_output_bit_depth;
+  const char *outfile_pattern;
+  const struct AvxRational *framerate;
+  char outfile_name[PATH_MAX];
+  FILE *outfile;
+  MD5Context md5_ctx;
+  // Allocated by the decode loop for the first frame if output frames are
+  // scaled to a fixed size.
+  aom_image_t *scaled_img;
+  aom_image_t *img_shifted;
+};
+
+// Writes |img| to the output file(s), or adds it to the MD5 sum. |frame_out|
+// is the 1-based index of the output frame and |frame_in| the number of input
+// frames read when it was decoded. Returns 0 on success.
+static int output_frame(struct OutputContext *out, aom_image_t *img,
+                        int frame_out, int frame_in) {
+  const int *planes = out->planes;
+
+  if (out->scaled_img &&
+      (img->d_w != out->scaled_img->d_w || img->d_h != out->scaled_img->d_h)) {
+#if CONFIG_LIBYUV
+    libyuv_scale(img, out->scaled_img, kFilterBox);
+    img = out->scaled_img;
+#else
+    fprintf(stderr,
+            "Failed to scale output frame.\n"
+            "libyuv is required for scaling but is currently disabled.\n"
+            "Be sure to specify -DCONFIG_LIBYUV=1 when running cmake.\n");
+    return -1;
+#endif
+  }
+  // Default to codec bit depth if output bit depth not set
+  unsigned int output_bit_depth;
+  if (!out->fixed_output_bit_depth && out->single_file) {
+    output_bit_depth = img->bit_depth;
+  } else {
+    output_bit_depth = out->fixed_output_bit_depth;
+  }
+  // Shift up or down if necessary
+  if (output_bit_depth != 0) {
+    if (!aom_shift_img(output_bit_depth, &img, &out->img_shifted)) {
+      fprintf(stderr, "Error allocating image\n");
+      return -1;
+    }
+  }
+
+  int num_planes = (out->opt_raw && img->monochrome) ? 1 : 3;
+  if (out->single_file) {
+    if (out->use_y4m) {
+      char y4m_buf[Y4M_BUFFER_SIZE] = { 0 };
+      size_t len = 0;
+      if (frame_out == 1) {
+        // Y4M file header
+        len = y4m_write_file_header(y4m_buf, sizeof(y4m_buf), img->d_w,
+                                    img->d_h, out->framerate, img->monochrome,
+                                    img->csp, img->fmt, img->bit_depth,
+                                    img->range);
+        if (img->csp == AOM_CSP_COLOCATED) {
+          fprintf(stderr,
+                  "Warning: Y4M lacks a colorspace for colocated "
+                  "chroma. Using a placeholder.\n");
+        }
+        if (out->do_md5) {
+          MD5Update(&out->md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
+        } else {
+          fputs(y4m_buf, out->outfile);
+        }
+      }
+
+      // Y4M frame header
+      len = y4m_write_frame_header(y4m_buf, sizeof(y4m_buf));
+      if (out->do_md5) {
+        MD5Update(&out->md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
+        y4m_update_image_md5(img, planes, &out->md5_ctx);
+      } else {
+        fputs(y4m_buf, out->outfile);
+        y4m_write_image_file(img, planes, out->outfile);
+      }
+    } else {
+      if (frame_out == 1) {
+        // Check if --yv12 or --i420 options are consistent with the
+        // bit-stream decoded
+        if (out->opt_i420) {
+          if (img->fmt != AOM_IMG_FMT_I420 && img->fmt != AOM_IMG_FMT_I42016) {
+            fprintf(stderr, "Cannot produce i420 output for bit-stream.\n");
+            return -1;
+          }
+        }
+        if (out->opt_yv12) {
+          if ((img->fmt != AOM_IMG_FMT_I420 && img->fmt != AOM_IMG_FMT_YV12) ||
+              img->bit_depth != 8) {
+            fprintf(stderr, "Cannot produce yv12 output for bit-stream.\n");
+            return -1;
+          }
+        }
+      }
+      if (out->do_md5) {
+        raw_update_image_md5(img, planes, num_planes, &out->md5_ctx);
+      } else {
+        raw_write_image_file(img, planes, num_planes, out->outfile);
+      }
+    }
+  } else {
+    generate_filename(out->outfile_pattern, out->outfile_name, PATH_MAX,
+                      img->d_w, img->d_h, frame_in);
+    if (out->do_md5) {
+      unsigned char md5_digest[16];
+      MD5Init(&out->md5_ctx);
+      if (out->use_y4m) {
+        y4m_update_image_md5(img, planes, &out->md5_ctx);
+      } else {
+        raw_update_image_md5(img, planes, num_planes, &out->md5_ctx);
+      }
+      MD5Final(md5_digest, &out->md5_ctx);
+      print_md5(md5_digest, out->outfile_name);
+    } else {
+      out->outfile = open_outfile(out->outfile_name);
+      if (out->use_y4m) {
+        y4m_write_image_file(img, planes, out->outfile);
+      } else {
+        raw_write_image_file(img, planes, num_planes, out->outfile);
+      }
+      fclose(out->outfile);
+    }
+  }
+  return 0;
+}
+
+#if CONFIG_MULTITHREAD
+struct OutputJob {
+  aom_image_t img;
+  struct ExternalFrameBuffer *ext_fb;
+  int frame_out;
+  int frame_in;
+};
+
+// Decoded frames waiting for the output thread. Each queued frame holds a
+// reference to its external frame buffer, so the decoder keeps decoding into
+// other buffers until the output thread has written it.
+struct OutputQueue {
+  struct OutputContext *out;
+  struct ExternalFrameBufferList *ext_fb_list;
+  struct OutputJob *jobs;
+  int size;
+  int head;
+  int count;
+  int eos;
+  int error;
+  int thread_done;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+};
+
+static int has_free_frame_buffer(
+    const struct ExternalFrameBufferList *ext_fb_list) {
+  for (int i = 0; i < ext_fb_list->num_external_frame_buffers; ++i) {
+    if (!ext_fb_list->ext_fb[i].in_use) return 1;
+  }
+  return 0;
+}
+
+// Frame buffer callbacks used with --pipeline. The frame buffer list is shared
+// with the output thread, and a request waits for the output thread to drop
+// its references when every buffer is in use.
+static int get_av1_frame_buffer_mt(void *cb_priv, size_t min_size,
+                                   aom_codec_frame_buffer_t *fb) {
+  struct OutputQueue *const queue = (struct OutputQueue *)cb_priv;
+  pthread_mutex_lock(&queue->mutex);
+  while (queue->count > 0 && !has_free_frame_buffer(queue->ext_fb_list))
+    pthread_cond_wait(&queue->cond, &queue->mutex);
+  const int ret = get_av1_frame_buffer(queue->ext_fb_list, min_size, fb);
+  pthread_mutex_unlock(&queue->mutex);
+  return ret;
+}
+
+static int release_av1_frame_buffer_mt(void *cb_priv,
+                                       aom_codec_frame_buffer_t *fb) {
+  struct OutputQueue *const queue = (struct OutputQueue *)cb_priv;
+  pthread_mutex_lock(&queue->mutex);
+  const int ret = release_av1_frame_buffer(queue->ext_fb_list, fb);
+  pthread_mutex_unlock(&queue->mutex);
+  return ret;
+}
+
+static THREADFN output_thread_hook(void *arg) {
+  struct OutputQueue *const queue = (struct OutputQueue *)arg;
+  pthread_mutex_lock(&queue->mutex);
+  for (;;) {
+    while (queue->count == 0 && !queue->eos)
+      pthread_cond_wait(&queue->cond, &queue->mutex);
+    if (queue->count == 0) break;
+    struct OutputJob *const job = &queue->jobs[queue->head];
+    const int skip = queue->error;
+    pthread_mutex_unlock(&queue->mutex);
+
+    const int failed =
+        !skip && output_frame(queue->out, &job->img, job->frame_out,
+                              job->frame_in) != 0;
+
+    pthread_mutex_lock(&queue->mutex);
+    --job->ext_fb->in_use;
+    queue->error |= failed;
+    queue->head = (queue->head + 1) % queue->size;
+    --queue->count;
+    pthread_cond_broadcast(&queue->cond);
+  }
+  pthread_mutex_unlock(&queue->mutex);
+  return THREAD_RETURN(NULL);
+}
+
+static struct OutputQueue *output_queue_create(
+    struct OutputContext *out, struct ExternalFrameBufferList *ext_fb_list,
+    int size) {
+  struct OutputQueue *const queue =
+      (struct OutputQueue *)calloc(1, sizeof(*queue));
+  if (!queue) return NULL;
+  queue->jobs = (struct OutputJob *)calloc(size, sizeof(*queue->jobs));
+  if (!queue->jobs) {
+    free(queue);
+    return NULL;
+  }
+  queue->out = out;
+  queue->ext_fb_list = ext_fb_list;
+  queue->size = size;
+  pthread_mutex_init(&queue->mutex, NULL);
+  pthread_cond_init(&queue->cond, NULL);
+  if (pthread_create(&queue->thread, NULL, output_thread_hook, queue)) {
+    pthread_cond_destroy(&queue->cond);
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue->jobs);
+    free(queue);
+    return NULL;
+  }
+  return queue;
+}
+
+// Queues |img| for the output thread. Frames that are not in an external
+// frame buffer are written on the calling thread once the queue has drained.
+// Returns 0 on success.
+static int output_queue_push(struct OutputQueue *queue, aom_image_t *img,
+                             int frame_out, int frame_in) {
+  struct ExternalFrameBuffer *const ext_fb =
+      find_frame_buffer(queue->ext_fb_list, img);
+  const int limit = ext_fb ? queue->size : 1;
+  pthread_mutex_lock(&queue->mutex);
+  while (!queue->error && queue->count >= limit)
+    pthread_cond_wait(&queue->cond, &queue->mutex);
+  if (queue->error) {
+    pthread_mutex_unlock(&queue->mutex);
+    return -1;
+  }
+  if (!ext_fb) {
+    pthread_mutex_unlock(&queue->mutex);
+    return output_frame(queue->out, img, frame_out, frame_in);
+  }
+  struct OutputJob *const job =
+      &queue->jobs[(queue->head + queue->count) % queue->size];
+  job->img = *img;
+  // Metadata is owned by the decoder and released on the next call.
+  job->img.metadata = NULL;
+  job->ext_fb = ext_fb;
+  job->frame_out = frame_out;
+  job->frame_in = frame_in;
+  ++ext_fb->in_use;
+  ++queue->count;
+  pthread_cond_broadcast(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+  return 0;
+}
+
+// Waits for the output thread to write every queued frame. Returns 0 if all
+// frames were written successfully.
+static int output_queue_finish(struct OutputQueue *queue) {
+  if (!queue->thread_done) {
+    pthread_mutex_lock(&queue->mutex);
+    queue->eos = 1;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->mutex);
+    pthread_join(queue->thread, NULL);
+    queue->thread_done = 1;
+  }
+  return queue->error ? -1 : 0;
+}
+
+// Frees |queue| once the decoder, which may still release frame buffers
+// through it, has been destroyed.
+static void output_queue_destroy(struct OutputQueue *queue) {
+  output_queue_finish(queue);
+  pthread_cond_destroy(&queue->cond);
+  pthread_mutex_destroy(&queue->mutex);
+  free(queue->jobs);
+  free(queue);
+}
+
+// Returns a copy of |img| that does not reference decoder memory, or NULL on
+// allocation failure.
+static aom_image_t *copy_image(const aom_image_t *img) {
+  aom_image_t *const copy =
+      aom_img_alloc(NULL, img->fmt, img->d_w, img->d_h, 1);
+  if (!copy) return NULL;
+  copy->cp = img->cp;
+  copy->tc = img->tc;
+  copy->mc = img->mc;
+  copy->monochrome = img->monochrome;
+  copy->csp = img->csp;
+  copy->range = img->range;
+  copy->bit_depth = img->bit_depth;
+  copy->temporal_id = img->temporal_id;
+  copy->spatial_id = img->spatial_id;
+  const int bytes_per_sample = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  for (int plane = 0; plane < 3; ++plane) {
+    if (!img->planes[plane]) continue;
+    const int w = aom_img_plane_width(img, plane) * bytes_per_sample;
+    const int h = aom_img_plane_height(img, plane);
+    for (int y = 0; y < h; ++y) {
+      memcpy(copy->planes[plane] + y * copy->stride[plane],
+             img->planes[plane] + y * img->stride[plane], w);
+    }
+  }
+  return copy;
+}
+
+struct SegmentFrame {
+  aom_image_t *img;
+  int frame_in;
+};
+
+// Number of decoded frames a segment keeps before its decoder waits for
+// them to be written out.
+#define SEGMENT_MAX_FRAMES 8
+
+// A run of temporal units from a key frame up to the next one. A shown key
+// frame refreshes every reference, so each segment is decoded by a decoder
+// instance of its own. The segment being written out lends its frames to the
+// main thread; the segments after it queue copies of at most
+// SEGMENT_MAX_FRAMES frames.
+struct Segment {
+  size_t start;
+  size_t end;
+  struct SegmentFrame frames[SEGMENT_MAX_FRAMES];
+  int first_frame;
+  int num_frames;
+  // Decoder frame lent to the main thread, valid until it has been written.
+  struct SegmentFrame lent;
+  int corrupted;
+  int error;
+  int done;
+};
+
+struct SegmentDecoder {
+  const PacketIndex *index;
+  aom_codec_iface_t *iface;
+  const aom_codec_dec_cfg_t *cfg;
+  const struct DecoderControls *controls;
+  int keep_going;
+  // Index entry of the first decoded packet, which is input frame 1.
+  size_t first_entry;
+  struct Segment *segments;
+  int num_segments;
+  // Next segment to be decoded and segment being written out.
+  int next_segment;
+  int output_segment;
+  int abort;
+  int num_threads;
+  pthread_t *threads;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+};
+
+// Passes a decoded frame of |seg| on to the main thread. The frame is lent
+// if |seg| is being written out and has no frames queued, which holds the
+// decoder until it has been written; otherwise a copy is queued once there
+// is room for it. Returns -1 on allocation failure or abort.
+static int segment_put_frame(struct SegmentDecoder *sd, struct Segment *seg,
+                             aom_image_t *img, int frame_in) {
+  pthread_mutex_lock(&sd->mutex);
+  while (!sd->abort && seg->num_frames == SEGMENT_MAX_FRAMES)
+    pthread_cond_wait(&sd->cond, &sd->mutex);
+  const int lend =
+      seg->num_frames == 0 && seg == &sd->segments[sd->output_segment];
+  if (!sd->abort && lend) {
+    seg->lent.img = img;
+    seg->lent.frame_in = frame_in;
+    pthread_cond_broadcast(&sd->cond);
+    while (!sd->abort && seg->lent.img)
+      pthread_cond_wait(&sd->cond, &sd->mutex);
+  }
+  const int abort = sd->abort;
+  pthread_mutex_unlock(&sd->mutex);
+  if (abort) return -1;
+  if (lend) return 0;
+
+  // Only this thread adds frames to |seg|, so the free slot stays free.
+  aom_image_t *const copy = copy_image(img);
+  if (!copy) {
+    fprintf(stderr, "Failed to allocate a decoded frame\n");
+    return -1;
+  }
+  pthread_mutex_lock(&sd->mutex);
+  struct SegmentFrame *const frame =
+      &seg->frames[(seg->first_frame + seg->num_frames) % SEGMENT_MAX_FRAMES];
+  frame->img = copy;
+  frame->frame_in = frame_in;
+  ++seg->num_frames;
+  pthread_cond_broadcast(&sd->cond);
+  pthread_mutex_unlock(&sd->mutex);
+  return 0;
+}
+
+static void segment_free_frames(struct Segment *seg) {
+  for (int i = 0; i < seg->num_frames; ++i) {
+    aom_img_free(
+        seg->frames[(seg->first_frame + i) % SEGMENT_MAX_FRAMES].img);
+  }
+  seg->num_frames = 0;
+}
+
+static void decode_segment(struct SegmentDecoder *sd, struct Segment *seg) {
+  aom_codec_ctx_t decoder;
+  if (aom_codec_dec_init(&decoder, sd->iface, sd->cfg, 0)) {
+    fprintf(stderr, "Failed to initialize decoder: %s\n",
+            aom_codec_error(&decoder));
+    seg->error = 1;
+    return;
+  }
+  if (set_decoder_controls(&decoder, sd->controls)) seg->error = 1;
+
+  // The last iteration flushes the decoder.
+  for (size_t i = seg->start; i <= seg->end && !seg->error; ++i) {
+    const int frame_in = (int)(i - sd->first_entry) + (i < seg->end);
+    if (i < seg->end) {
+      const PacketIndexEntry *const entry = &sd->index->entries[i];
+      if (aom_codec_decode(&decoder, sd->index->map.data + entry->offset,
+                           entry->size, NULL)) {
+        const char *detail = aom_codec_error_detail(&decoder);
+        aom_tools_warn("Failed to decode frame %d: %s", frame_in,
+                       aom_codec_error(&decoder));
+        if (detail) aom_tools_warn("Additional information: %s", detail);
+        if (!sd->keep_going) seg->error = 1;
+      }
+    } else if (aom_codec_decode(&decoder, NULL, 0, NULL)) {
+      aom_tools_warn("Failed to flush decoder: %s", aom_codec_error(&decoder));
+    }
+
+    aom_codec_iter_t iter = NULL;
+    aom_image_t *img;
+    while (!seg->error && (img = aom_codec_get_frame(&decoder, &iter))) {
+      int corrupted = 0;
+      if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AOMD_GET_FRAME_CORRUPTED,
+                                        &corrupted)) {
+        aom_tools_warn("Failed AOM_GET_FRAME_CORRUPTED: %s",
+                       aom_codec_error(&decoder));
+        if (!sd->keep_going) seg->error = 1;
+      }
+      seg->corrupted += corrupted;
+      if (segment_put_frame(sd, seg, img, frame_in)) seg->error = 1;
+    }
+  }
+
+  if (aom_codec_destroy(&decoder)) {
+    fprintf(stderr, "Failed to destroy decoder: %s\n",
+            aom_codec_error(&decoder));
+  }
+}
+
+static THREADFN segment_thread_hook(void *arg) {
+  struct SegmentDecoder *const sd = (struct SegmentDecoder *)arg;
+  pthread_mutex_lock(&sd->mutex);
+  for (;;) {
+    if (sd->abort || sd->next_segment == sd->num_segments) break;
+    struct Segment *const seg = &sd->segments[sd->next_segment++];
+    pthread_mutex_unlock(&sd->mutex);
+
+    decode_segment(sd, seg);
+
+    pthread_mutex_lock(&sd->mutex);
+    seg->done = 1;
+    pthread_cond_broadcast(&sd->cond);
+  }
+  pthread_mutex_unlock(&sd->mutex);
+  return THREAD_RETURN(NULL);
+}
+
+static void segment_decoder_destroy(struct SegmentDecoder *sd) {
+  pthread_mutex_lock(&sd->mutex);
+  sd->abort = 1;
+  pthread_cond_broadcast(&sd->cond);
+  pthread_mutex_unlock(&sd->mutex);
+  for (int i = 0; i < sd->num_threads; ++i) pthread_join(sd->threads[i], NULL);
+  for (int i = 0; i < sd->num_segments; ++i)
+    segment_free_frames(&sd->segments[i]);
+  pthread_cond_destroy(&sd->cond);
+  pthread_mutex_destroy(&sd->mutex);
+  free(sd->threads);
+  free(sd->segments);
+  free(sd);
+}
+
+// Splits index entries [start, end) at key frames and starts decoding the
+// segments on |num_threads| threads. The first segment starts at |start|
+// even if it is not a key frame. Returns NULL on failure.
+static struct SegmentDecoder *segment_decoder_create(
+    const PacketIndex *index, size_t start, size_t end,
+    aom_codec_iface_t *iface, const aom_codec_dec_cfg_t *cfg,
+    const struct DecoderControls *controls, int keep_going,
+    int num_threads) {
+  struct SegmentDecoder *const sd =
+      (struct SegmentDecoder *)calloc(1, sizeof(*sd));
+  if (!sd) return NULL;
+  sd->index = index;
+  sd->iface = iface;
+  sd->cfg = cfg;
+  sd->controls = controls;
+  sd->keep_going = keep_going;
+  sd->first_entry = start;
+  pthread_mutex_init(&sd->mutex, NULL);
+  pthread_cond_init(&sd->cond, NULL);
+
+  int num_segments = start < end;
+  for (size_t i = start + 1; i < end; ++i)
+    num_segments += index->entries[i].is_keyframe;
+  sd->segments = (struct Segment *)calloc(
+      num_segments ? num_segments : 1, sizeof(*sd->segments));
+  sd->threads = (pthread_t *)calloc(num_threads, sizeof(*sd->threads));
+  if (!sd->segments || !sd->threads) {
+    segment_decoder_destroy(sd);
+    return NULL;
+  }
+  for (size_t i = start; i < end; ++i) {
+    if (i == start || index->entries[i].is_keyframe) {
+      if (sd->num_segments > 0)
+        sd->segments[sd->num_segments - 1].end = i;
+      sd->segments[sd->num_segments++].start = i;
+    }
+  }
+  if (sd->num_segments > 0) sd->segments[sd->num_segments - 1].end = end;
+
+  for (; sd->num_threads < num_threads; ++sd->num_threads) {
+    if (pthread_create(&sd->threads[sd->num_threads], NULL,
+                       segment_thread_hook, sd)) {
+      segment_decoder_destroy(sd);
+      return NULL;
+    }
+  }
+  return sd;
+}
+
+// Waits for the next frame of segment |k| in output order and returns it, or
+// returns NULL once the segment has been decoded and all its frames taken.
+// Segments must be taken in order, and each frame given back with
+// segment_decoder_frame_done() once it has been written.
+static const struct SegmentFrame *segment_decoder_next_frame(
+    struct SegmentDecoder *sd, int k) {
+  struct Segment *const seg = &sd->segments[k];
+  const struct SegmentFrame *frame = NULL;
+  pthread_mutex_lock(&sd->mutex);
+  while (!seg->done && seg->num_frames == 0 && !seg->lent.img)
+    pthread_cond_wait(&sd->cond, &sd->mutex);
+  if (seg->num_frames > 0)
+    frame = &seg->frames[seg->first_frame];
+  else if (seg->lent.img)
+    frame = &seg->lent;
+  pthread_mutex_unlock(&sd->mutex);
+  return frame;
+}
+
+// Frees the frame of segment |k| returned last, or hands it back to the
+// decoder if it was lent.
+static void segment_decoder_frame_done(struct SegmentDecoder *sd, int k) {
+  struct Segment *const seg = &sd->segments[k];
+  pthread_mutex_lock(&sd->mutex);
+  if (seg->num_frames > 0) {
+    aom_img_free(seg->frames[seg->first_frame].img);
+    seg->first_frame = (seg->first_frame + 1) % SEGMENT_MAX_FRAMES;
+    --seg->num_frames;
+  } else {
+    seg->lent.img = NULL;
+  }
+  pthread_cond_broadcast(&sd->cond);
+  pthread_mutex_unlock(&sd->mutex);
+}
+
+// Moves the output on to the segment after |k|, whose decoder can then lend
+// its frames.
+static void segment_decoder_release(struct SegmentDecoder *sd, int k) {
+  pthread_mutex_lock(&sd->mutex);
+  sd->output_segment = k + 1;
+  pthread_cond_broadcast(&sd->cond);
+  pthread_mutex_unlock(&sd->mutex);
+}
+#endif  // CONFIG_MULTITHREAD
+
 static int main_loop(int argc, const char **argv_) {
   aom_codec_ctx_t decoder;
   char *fn = NULL;
   int i;
   int ret = EXIT_FAILURE;
   uint8_t *buf = NULL;
+  const uint8_t *data = NULL;
   size_t bytes_in_buffer = 0, buffer_size = 0;
   FILE *infile;
   int frame_in = 0, frame_out = 0, flipuv = 0, noblit = 0;
   int do_md5 = 0, progress = 0;
   int stop_after = 0, summary = 0, quiet = 1;
   int arg_skip = 0;
+  int arg_seek = -1;
   int keep_going = 0;
   uint64_t dx_time = 0;
   struct arg arg;
@@ -460,22 +1166,26 @@ static int main_loop(int argc, const char **argv_) {
   int output_all_layers = 0;
   int skip_film_grain = 0;
   int enable_row_mt = 0;
-  aom_image_t *scaled_img = NULL;
-  aom_image_t *img_shifted = NULL;
   int frame_avail, got_data, flush_decoder = 0;
   int num_external_frame_buffers = 0;
+  int pipeline_depth = 0;
   struct ExternalFrameBufferList ext_fb_list = { 0, NULL };
+  int segment_threads = 0;
+#if CONFIG_MULTITHREAD
+  struct OutputQueue *output_queue = NULL;
+  struct SegmentDecoder *segment_decoder = NULL;
+#endif
 
   const char *outfile_pattern = NULL;
-  char outfile_name[PATH_MAX] = { 0 };
-  FILE *outfile = NULL;
+  struct OutputContext out;
+  memset(&out, 0, sizeof(out));
 
   FILE *framestats_file = NULL;
 
-  MD5Context md5_ctx;
   unsigned char md5_digest[16];
 
-  struct AvxDecInputContext input = { NULL, NULL, NULL };
+  struct AvxDecInputContext input = { NULL, NULL, NULL, NULL };
+  PacketIndex packet_index;
   struct AvxInputContext aom_input_ctx;
   memset(&aom_input_ctx, 0, sizeof(aom_input_ctx));
 #if CONFIG_WEBM_IO
@@ -541,6 +1251,8 @@ static int main_loop(int argc, const char **argv_) {
       stop_after = arg_parse_uint(&arg);
     } else if (arg_match(&arg, &skiparg, argi)) {
       arg_skip = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &seekarg, argi)) {
+      arg_seek = arg_parse_uint(&arg);
     } else if (arg_match(&arg, &md5arg, argi)) {
       do_md5 = 1;
     } else if (arg_match(&arg, &framestatsarg, argi)) {
@@ -581,6 +1293,24 @@ static int main_loop(int argc, const char **argv_) {
       output_all_layers = 1;
     } else if (arg_match(&arg, &skipfilmgrain, argi)) {
       skip_film_grain = 1;
+    } else if (arg_match(&arg, &pipelinearg, argi)) {
+      pipeline_depth = arg_parse_uint(&arg);
+#if !CONFIG_MULTITHREAD
+      if (pipeline_depth > 0) {
+        die("Error: --pipeline=%d is not supported when CONFIG_MULTITHREAD = "
+            "0.\n",
+            pipeline_depth);
+      }
+#endif
+    } else if (arg_match(&arg, &segmentthreadsarg, argi)) {
+      segment_threads = arg_parse_uint(&arg);
+#if !CONFIG_MULTITHREAD
+      if (segment_threads > 0) {
+        die("Error: --segment-threads=%d is not supported when "
+            "CONFIG_MULTITHREAD = 0.\n",
+            segment_threads);
+      }
+#endif
     } else {
       argj++;
     }
@@ -638,16 +1368,41 @@ static int main_loop(int argc, const char **argv_) {
     return EXIT_FAILURE;
   }
 
+  // Regular IVF and OBU files are mapped and indexed, so that packets reach
+  // the decoder without being copied and seeking is possible. Pipes and
+  // other inputs that cannot be mapped are read with stdio.
+  if (input.aom_input_ctx->file_type == FILE_TYPE_IVF ||
+      input.aom_input_ctx->file_type == FILE_TYPE_OBU) {
+    const PacketIndexFormat format =
+        is_ivf ? PACKET_INDEX_IVF
+               : (is_annexb ? PACKET_INDEX_ANNEXB : PACKET_INDEX_OBU);
+    if (packet_index_open(infile, format, &packet_index) == 0) {
+      input.packet_index = &packet_index;
+    }
+  }
+  if (arg_seek >= 0 && !input.packet_index) {
+    fatal("--seek requires an IVF or OBU input file");
+  }
+  if (segment_threads > 0) {
+    if (!input.packet_index)
+      fatal("--segment-threads requires an IVF or OBU input file");
+    if (do_scale || framestats_file || pipeline_depth > 0 ||
+        num_external_frame_buffers > 0) {
+      fatal("--segment-threads cannot be combined with --scale, "
+            "--framestats, --pipeline or --frame-buffers");
+    }
+  }
+
   outfile_pattern = outfile_pattern ? outfile_pattern : "-";
   single_file = is_single_file(outfile_pattern);
 
   if (!noblit && single_file) {
-    generate_filename(outfile_pattern, outfile_name, PATH_MAX,
+    generate_filename(outfile_pattern, out.outfile_name, PATH_MAX,
                       aom_input_ctx.width, aom_input_ctx.height, 0);
     if (do_md5)
-      MD5Init(&md5_ctx);
+      MD5Init(&out.md5_ctx);
     else
-      outfile = open_outfile(outfile_name);
+      out.outfile = open_outfile(out.outfile_name);
   }
 
   if (use_y4m && !noblit) {
@@ -693,45 +1448,58 @@ static int main_loop(int argc, const char **argv_) {
 
   if (!quiet) fprintf(stderr, "%s\n", decoder.name);
 
-  if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_IS_ANNEXB, is_annexb)) {
-    fprintf(stderr, "Failed to set is_annexb: %s\n", aom_codec_error(&decoder));
-    goto fail;
-  }
-
-  if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_OPERATING_POINT,
-                                    operating_point)) {
-    fprintf(stderr, "Failed to set operating_point: %s\n",
-            aom_codec_error(&decoder));
-    goto fail;
-  }
-
-  if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_OUTPUT_ALL_LAYERS,
-                                    output_all_layers)) {
-    fprintf(stderr, "Failed to set output_all_layers: %s\n",
-            aom_codec_error(&decoder));
-    goto fail;
-  }
-
-  if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_SKIP_FILM_GRAIN,
-                                    skip_film_grain)) {
-    fprintf(stderr, "Failed to set skip_film_grain: %s\n",
-            aom_codec_error(&decoder));
-    goto fail;
-  }
+  const struct DecoderControls controls = { is_annexb, operating_point,
+                                            output_all_layers, skip_film_grain,
+                                            enable_row_mt };
+  if (set_decoder_controls(&decoder, &controls)) goto fail;
 
-  if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_ROW_MT, enable_row_mt)) {
-    fprintf(stderr, "Failed to set row multithreading mode: %s\n",
-            aom_codec_error(&decoder));
-    goto fail;
+  if (arg_seek >= 0) {
+    size_t keyframe;
+    if (packet_index_seek_keyframe(input.packet_index, (size_t)arg_seek,
+                                   &keyframe)) {
+      fprintf(stderr, "No key frame at or before frame %d.\n", arg_seek);
+      goto fail;
+    }
+    fprintf(stderr, "Seeking to key frame %u.\n", (unsigned int)keyframe);
   }
 
   if (arg_skip) fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
+  if (input.packet_index) {
+    PacketIndex *const index = input.packet_index;
+    const size_t remaining = index->num_entries - index->next;
+    const size_t skip =
+        (size_t)arg_skip < remaining ? (size_t)arg_skip : remaining;
+    packet_index_seek(index, index->next + skip);
+    arg_skip = 0;
+  }
   while (arg_skip) {
     if (read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) break;
     arg_skip--;
   }
 
+  out.use_y4m = use_y4m;
+  out.opt_raw = opt_raw;
+  out.opt_i420 = opt_i420;
+  out.opt_yv12 = opt_yv12;
+  out.do_md5 = do_md5;
+  out.single_file = single_file;
+  out.planes = flipuv ? PLANES_YVU : PLANES_YUV;
+  out.fixed_output_bit_depth = fixed_output_bit_depth;
+  out.outfile_pattern = outfile_pattern;
+  out.framerate = &aom_input_ctx.framerate;
+
+  if (noblit) pipeline_depth = 0;
+  // Queued frames are kept in external frame buffers, in addition to the
+  // ones the decoder references.
+  if (pipeline_depth > 0 && num_external_frame_buffers == 0) {
+    num_external_frame_buffers =
+        AOM_MAXIMUM_WORK_BUFFERS + AOM_MAXIMUM_REF_BUFFERS + pipeline_depth;
+  }
+
   if (num_external_frame_buffers > 0) {
+    aom_get_frame_buffer_cb_fn_t get_fb = get_av1_frame_buffer;
+    aom_release_frame_buffer_cb_fn_t release_fb = release_av1_frame_buffer;
+    void *fb_priv = &ext_fb_list;
     ext_fb_list.num_external_frame_buffers = num_external_frame_buffers;
     ext_fb_list.ext_fb = (struct ExternalFrameBuffer *)calloc(
         num_external_frame_buffers, sizeof(*ext_fb_list.ext_fb));
@@ -739,9 +1507,20 @@ static int main_loop(int argc, const char **argv_) {
       fprintf(stderr, "Failed to allocate ExternalFrameBuffer\n");
       goto fail;
     }
-    if (aom_codec_set_frame_buffer_functions(&decoder, get_av1_frame_buffer,
-                                             release_av1_frame_buffer,
-                                             &ext_fb_list)) {
+#if CONFIG_MULTITHREAD
+    if (pipeline_depth > 0) {
+      output_queue = output_queue_create(&out, &ext_fb_list, pipeline_depth);
+      if (!output_queue) {
+        fprintf(stderr, "Failed to create output thread\n");
+        goto fail;
+      }
+      get_fb = get_av1_frame_buffer_mt;
+      release_fb = release_av1_frame_buffer_mt;
+      fb_priv = output_queue;
+    }
+#endif
+    if (aom_codec_set_frame_buffer_functions(&decoder, get_fb, release_fb,
+                                             fb_priv)) {
       fprintf(stderr, "Failed to configure external frame buffers: %s\n",
               aom_codec_error(&decoder));
       goto fail;
@@ -753,6 +1532,50 @@ static int main_loop(int argc, const char **argv_) {
 
   if (framestats_file) fprintf(framestats_file, "bytes,qp\r\n");
 
+#if CONFIG_MULTITHREAD
+  if (segment_threads > 0) {
+    PacketIndex *const index = input.packet_index;
+    const size_t start = index->next;
+    size_t end = index->num_entries;
+    if (stop_after > 0 && (size_t)stop_after < end - start)
+      end = start + stop_after;
+    struct aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    segment_decoder =
+        segment_decoder_create(index, start, end, interface, &cfg, &controls,
+                               keep_going, segment_threads);
+    if (!segment_decoder) {
+      fprintf(stderr, "Failed to create segment decoder threads\n");
+      goto fail;
+    }
+    // Frames are written in order as they are decoded.
+    for (int k = 0; k < segment_decoder->num_segments; ++k) {
+      const struct SegmentFrame *frame;
+      while ((frame = segment_decoder_next_frame(segment_decoder, k))) {
+        ++frame_out;
+        frame_in = frame->frame_in;
+        if (progress) {
+          aom_usec_timer_mark(&timer);
+          show_progress(frame_in, frame_out, aom_usec_timer_elapsed(&timer));
+        }
+        if (!noblit && output_frame(&out, frame->img, frame_out, frame_in)) {
+          goto fail;
+        }
+        segment_decoder_frame_done(segment_decoder, k);
+      }
+      const struct Segment *const seg = &segment_decoder->segments[k];
+      if (seg->error) goto fail;
+      frames_corrupted += seg->corrupted;
+      segment_decoder_release(segment_decoder, k);
+    }
+    aom_usec_timer_mark(&timer);
+    frame_in = (int)(end - start);
+    dx_time = aom_usec_timer_elapsed(&timer);
+    // Everything has been decoded; skip the serial decode loop.
+    frame_avail = 0;
+  }
+#endif
+
   /* Decode file */
   while (frame_avail || got_data) {
     aom_codec_iter_t iter = NULL;
@@ -762,13 +1585,13 @@ static int main_loop(int argc, const char **argv_) {
 
     frame_avail = 0;
     if (!stop_after || frame_in < stop_after) {
-      if (!read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) {
+      if (!read_packet(&input, &buf, &buffer_size, &data, &bytes_in_buffer)) {
         frame_avail = 1;
         frame_in++;
 
         aom_usec_timer_start(&timer);
 
-        if (aom_codec_decode(&decoder, buf, bytes_in_buffer, NULL)) {
+        if (aom_codec_decode(&decoder, data, bytes_in_buffer, NULL)) {
           const char *detail = aom_codec_error_detail(&decoder);
           aom_tools_warn("Failed to decode frame %d: %s", frame_in,
                          aom_codec_error(&decoder));
@@ -826,163 +1649,54 @@ static int main_loop(int argc, const char **argv_) {
       if (progress) show_progress(frame_in, frame_out, dx_time);
 
       if (!noblit) {
-        const int PLANES_YUV[] = { AOM_PLANE_Y, AOM_PLANE_U, AOM_PLANE_V };
-        const int PLANES_YVU[] = { AOM_PLANE_Y, AOM_PLANE_V, AOM_PLANE_U };
-        const int *planes = flipuv ? PLANES_YVU : PLANES_YUV;
-
-        if (do_scale) {
-          if (frame_out == 1) {
-            // If the output frames are to be scaled to a fixed display size
-            // then use the width and height specified in the container. If
-            // either of these is set to 0, use the display size set in the
-            // first frame header. If that is unavailable, use the raw decoded
-            // size of the first decoded frame.
-            int render_width = aom_input_ctx.width;
-            int render_height = aom_input_ctx.height;
-            if (!render_width || !render_height) {
-              int render_size[2];
-              if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_GET_DISPLAY_SIZE,
-                                                render_size)) {
-                // As last resort use size of first frame as display size.
-                render_width = img->d_w;
-                render_height = img->d_h;
-              } else {
-                render_width = render_size[0];
-                render_height = render_size[1];
-              }
-            }
-            scaled_img =
-                aom_img_alloc(NULL, img->fmt, render_width, render_height, 16);
-            if (!scaled_img) {
-              fprintf(stderr, "Failed to allocate scaled image (%d x %d)\n",
-                      render_width, render_height);
-              goto fail;
+        if (do_scale && frame_out == 1) {
+          // If the output frames are to be scaled to a fixed display size
+          // then use the width and height specified in the container. If
+          // either of these is set to 0, use the display size set in the
+          // first frame header. If that is unavailable, use the raw decoded
+          // size of the first decoded frame.
+          int render_width = aom_input_ctx.width;
+          int render_height = aom_input_ctx.height;
+          if (!render_width || !render_height) {
+            int render_size[2];
+            if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_GET_DISPLAY_SIZE,
+                                              render_size)) {
+              // As last resort use size of first frame as display size.
+              render_width = img->d_w;
+              render_height = img->d_h;
+            } else {
+              render_width = render_size[0];
+              render_height = render_size[1];
             }
-            scaled_img->bit_depth = img->bit_depth;
-            scaled_img->monochrome = img->monochrome;
-            scaled_img->csp = img->csp;
-          }
-
-          if (img->d_w != scaled_img->d_w || img->d_h != scaled_img->d_h) {
-#if CONFIG_LIBYUV
-            libyuv_scale(img, scaled_img, kFilterBox);
-            img = scaled_img;
-#else
-            fprintf(
-                stderr,
-                "Failed to scale output frame: %s.\n"
-                "libyuv is required for scaling but is currently disabled.\n"
-                "Be sure to specify -DCONFIG_LIBYUV=1 when running cmake.\n",
-                aom_codec_error(&decoder));
-            goto fail;
-#endif
           }
-        }
-        // Default to codec bit depth if output bit depth not set
-        unsigned int output_bit_depth;
-        if (!fixed_output_bit_depth && single_file) {
-          output_bit_depth = img->bit_depth;
-        } else {
-          output_bit_depth = fixed_output_bit_depth;
-        }
-        // Shift up or down if necessary
-        if (output_bit_depth != 0) {
-          if (!aom_shift_img(output_bit_depth, &img, &img_shifted)) {
-            fprintf(stderr, "Error allocating image\n");
+          out.scaled_img =
+              aom_img_alloc(NULL, img->fmt, render_width, render_height, 16);
+          if (!out.scaled_img) {
+            fprintf(stderr, "Failed to allocate scaled image (%d x %d)\n",
+                    render_width, render_height);
             goto fail;
           }
+          out.scaled_img->bit_depth = img->bit_depth;
+          out.scaled_img->monochrome = img->monochrome;
+          out.scaled_img->csp = img->csp;
         }
 
-        aom_input_ctx.width = img->d_w;
-        aom_input_ctx.height = img->d_h;
-
-        int num_planes = (opt_raw && img->monochrome) ? 1 : 3;
-        if (single_file) {
-          if (use_y4m) {
-            char y4m_buf[Y4M_BUFFER_SIZE] = { 0 };
-            size_t len = 0;
-            if (frame_out == 1) {
-              // Y4M file header
-              len = y4m_write_file_header(
-                  y4m_buf, sizeof(y4m_buf), aom_input_ctx.width,
-                  aom_input_ctx.height, &aom_input_ctx.framerate,
-                  img->monochrome, img->csp, img->fmt, img->bit_depth,
-                  img->range);
-              if (img->csp == AOM_CSP_COLOCATED) {
-                fprintf(stderr,
-                        "Warning: Y4M lacks a colorspace for colocated "
-                        "chroma. Using a placeholder.\n");
-              }
-              if (do_md5) {
-                MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
-              } else {
-                fputs(y4m_buf, outfile);
-              }
-            }
-
-            // Y4M frame header
-            len = y4m_write_frame_header(y4m_buf, sizeof(y4m_buf));
-            if (do_md5) {
-              MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
-              y4m_update_image_md5(img, planes, &md5_ctx);
-            } else {
-              fputs(y4m_buf, outfile);
-              y4m_write_image_file(img, planes, outfile);
-            }
-          } else {
-            if (frame_out == 1) {
-              // Check if --yv12 or --i420 options are consistent with the
-              // bit-stream decoded
-              if (opt_i420) {
-                if (img->fmt != AOM_IMG_FMT_I420 &&
-                    img->fmt != AOM_IMG_FMT_I42016) {
-                  fprintf(stderr,
-                          "Cannot produce i420 output for bit-stream.\n");
-                  goto fail;
-                }
-              }
-              if (opt_yv12) {
-                if ((img->fmt != AOM_IMG_FMT_I420 &&
-                     img->fmt != AOM_IMG_FMT_YV12) ||
-                    img->bit_depth != 8) {
-                  fprintf(stderr,
-                          "Cannot produce yv12 output for bit-stream.\n");
-                  goto fail;
-                }
-              }
-            }
-            if (do_md5) {
-              raw_update_image_md5(img, planes, num_planes, &md5_ctx);
-            } else {
-              raw_write_image_file(img, planes, num_planes, outfile);
-            }
-          }
-        } else {
-          generate_filename(outfile_pattern, outfile_name, PATH_MAX, img->d_w,
-                            img->d_h, frame_in);
-          if (do_md5) {
-            MD5Init(&md5_ctx);
-            if (use_y4m) {
-              y4m_update_image_md5(img, planes, &md5_ctx);
-            } else {
-              raw_update_image_md5(img, planes, num_planes, &md5_ctx);
-            }
-            MD5Final(md5_digest, &md5_ctx);
-            print_md5(md5_digest, outfile_name);
-          } else {
-            outfile = open_outfile(outfile_name);
-            if (use_y4m) {
-              y4m_write_image_file(img, planes, outfile);
-            } else {
-              raw_write_image_file(img, planes, num_planes, outfile);
-            }
-            fclose(outfile);
-          }
+#if CONFIG_MULTITHREAD
+        if (output_queue) {
+          if (output_queue_push(output_queue, img, frame_out, frame_in))
+            goto fail;
+          continue;
         }
+#endif
+        if (output_frame(&out, img, frame_out, frame_in)) goto fail;
       }
     }
   }
 
+#if CONFIG_MULTITHREAD
+  if (output_queue && output_queue_finish(output_queue)) goto fail;
+#endif
+
   if (summary || progress) {
     show_progress(frame_in, frame_out, dx_time);
     fprintf(stderr, "\n");
@@ -996,6 +1710,12 @@ static int main_loop(int argc, const char **argv_) {
 
 fail:
 
+#if CONFIG_MULTITHREAD
+  // Stop the output thread before the decoder releases its frame buffers.
+  if (output_queue) output_queue_finish(output_queue);
+  if (segment_decoder) segment_decoder_destroy(segment_decoder);
+#endif
+
   if (aom_codec_destroy(&decoder)) {
     fprintf(stderr, "Failed to destroy decoder: %s\n",
             aom_codec_error(&decoder));
@@ -1005,10 +1725,10 @@ fail2:
 
   if (!noblit && single_file) {
     if (do_md5) {
-      MD5Final(md5_digest, &md5_ctx);
-      print_md5(md5_digest, outfile_name);
+      MD5Final(md5_digest, &out.md5_ctx);
+      print_md5(md5_digest, out.outfile_name);
     } else {
-      fclose(outfile);
+      fclose(out.outfile);
     }
   }
 
@@ -1018,11 +1738,15 @@ fail2:
 #endif
   if (input.aom_input_ctx->file_type == FILE_TYPE_OBU)
     obudec_free(input.obu_ctx);
+  if (input.packet_index) packet_index_close(input.packet_index);
 
   if (input.aom_input_ctx->file_type != FILE_TYPE_WEBM) free(buf);
 
-  if (scaled_img) aom_img_free(scaled_img);
-  if (img_shifted) aom_img_free(img_shifted);
+#if CONFIG_MULTITHREAD
+  if (output_queue) output_queue_destroy(output_queue);
+#endif
+  if (out.scaled_img) aom_img_free(out.scaled_img);
+  if (out.img_shifted) aom_img_free(out.img_shifted);
 
   for (i = 0; i < ext_fb_list.num_external_frame_buffers; ++i) {
     free(ext_fb_list.ext_fb[i].data);
@@ -33,6 +33,7 @@
 #include "aom_ports/aom_timer.h"
 #include "aom_ports/mem_ops.h"
 #include "common/args.h"
+#include "common/frame_reader.h"
 #include "common/ivfenc.h"
 #include "common/tools_common.h"
 #include "common/warnings.h"
@@ -50,6 +51,10 @@
 #include "third_party/libyuv/include/libyuv/scale.h"
 #endif
 
+#if CONFIG_MULTITHREAD
+#include "aom_util/aom_thread.h"
+#endif
+
 /* Swallow warnings about unused results of fread/fwrite */
 static size_t wrap_fread(void *ptr, size_t size, size_t nmemb, FILE *stream) {
   return fread(ptr, size, nmemb, stream);
@@ -97,20 +102,6 @@ static AOM_TOOLS_FORMAT_PRINTF(3, 4) void warn_or_exit_on_error(
   va_end(ap);
 }
 
-static int read_frame(struct AvxInputContext *input_ctx, aom_image_t *img) {
-  FILE *f = input_ctx->file;
-  y4m_input *y4m = &input_ctx->y4m;
-  int shortread = 0;
-
-  if (input_ctx->file_type == FILE_TYPE_Y4M) {
-    if (y4m_input_fetch_frame(y4m, f, img) < 1) return 0;
-  } else {
-    shortread = read_yuv_frame(input_ctx, img);
-  }
-
-  return !shortread;
-}
-
 static int file_is_y4m(const char detect[4]) {
   if (memcmp(detect, "YUV4", 4) == 0) {
     return 1;
@@ -265,6 +256,7 @@ static const int av1_arg_ctrl_map[] = { AOME_SET_CPUUSED,
                                         AOME_SET_VMAF_RD_MULT,
 #endif
                                         AOME_SET_TPL_RD_MULT,
+                                        AV1E_SET_ASYNC_PSNR,
                                         0 };
 
 const arg_def_t *main_args[] = { &g_av1_codec_arg_defs.help,
@@ -291,6 +283,10 @@ const arg_def_t *main_args[] = { &g_av1_codec_arg_defs.help,
                                  &g_av1_codec_arg_defs.disable_warnings,
                                  &g_av1_codec_arg_defs.disable_warning_prompt,
                                  &g_av1_codec_arg_defs.recontest,
+                                 &g_av1_codec_arg_defs.parallel_streams,
+                                 &g_av1_codec_arg_defs.read_ahead,
+                                 &g_av1_codec_arg_defs.mmap_input,
+                                 &g_av1_codec_arg_defs.chunk_threads,
                                  NULL };
 
 const arg_def_t *global_args[] = {
@@ -497,6 +493,7 @@ const arg_def_t *av1_ctrl_args[] = {
   &g_av1_codec_arg_defs.vmaf_rd_mult,
 #endif
   &g_av1_codec_arg_defs.tpl_rd_mult,
+  &g_av1_codec_arg_defs.async_psnr,
   NULL,
 };
 
@@ -569,6 +566,8 @@ struct WebmOutputContext {
 };
 #endif
 
+struct encode_chunk;
+
 /* Per-stream configuration */
 struct stream_config {
   struct aom_codec_enc_cfg cfg;
@@ -611,6 +610,8 @@ struct stream_state {
   unsigned int frames_out;
   uint64_t cx_time;
   size_t nbytes;
+  size_t ivf_frame_size;
+  FileOffset ivf_header_pos;
   stats_io_t stats;
   struct aom_image *img;
   aom_codec_ctx_t decoder;
@@ -623,6 +624,9 @@ struct stream_state {
   int orig_write_webm;
   int orig_write_ivf;
   char tmp_out_fn[1000];
+  // Set on the encoders of --chunk-threads, whose frame packets are kept in
+  // the chunk until the main thread writes them.
+  struct encode_chunk *chunk;
 };
 
 static void validate_positive_rational(const char *msg,
@@ -745,6 +749,14 @@ static void parse_global_config(struct AvxEncoderConfig *global, char ***argv) {
     } else if (arg_match(&arg, &g_av1_codec_arg_defs.disable_warning_prompt,
                          argi)) {
       global->disable_warning_prompt = 1;
+    } else if (arg_match(&arg, &g_av1_codec_arg_defs.parallel_streams, argi)) {
+      global->parallel_streams = 1;
+    } else if (arg_match(&arg, &g_av1_codec_arg_defs.read_ahead, argi)) {
+      global->read_ahead = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &g_av1_codec_arg_defs.mmap_input, argi)) {
+      global->mmap_input = 1;
+    } else if (arg_match(&arg, &g_av1_codec_arg_defs.chunk_threads, argi)) {
+      global->chunk_threads = arg_parse_uint(&arg);
     } else {
       argj++;
     }
@@ -808,7 +820,7 @@ static void open_input_file(struct AvxInputContext *input,
   input->pixel_aspect_ratio.denominator = 1;
 
   /* For RAW input sources, these bytes will applied on the first frame
-   *  in read_frame().
+   *  in read_yuv_frame().
    */
   input->detect.buf_read = fread(input->detect.buf, 1, 4, input->file);
   input->detect.position = 0;
@@ -1763,52 +1775,67 @@ static void update_quantizer_histogram(struct stream_state *stream) {
   }
 }
 
+// Writes a frame packet to the output file of the stream.
+static void write_frame_packet(struct stream_state *stream,
+                               struct AvxEncoderConfig *global,
+                               const aom_codec_cx_pkt_t *pkt) {
+  const struct aom_codec_enc_cfg *cfg = &stream->config.cfg;
+
+  ++stream->frames_out;
+  if (!global->quiet)
+    fprintf(stderr, " %6luF", (unsigned long)pkt->data.frame.sz);
+
+  update_rate_histogram(stream->rate_hist, cfg, pkt);
+#if CONFIG_WEBM_IO
+  if (stream->config.write_webm) {
+    if (write_webm_block(&stream->webm_ctx, cfg, pkt) != 0) {
+      fatal("WebM writer failed.");
+    }
+  }
+#endif
+  if (!stream->config.write_webm) {
+    if (stream->config.write_ivf) {
+      if (pkt->data.frame.partition_id <= 0) {
+        stream->ivf_header_pos = ftello(stream->file);
+        stream->ivf_frame_size = pkt->data.frame.sz;
+
+        ivf_write_frame_header(stream->file, pkt->data.frame.pts,
+                               stream->ivf_frame_size);
+      } else {
+        stream->ivf_frame_size += pkt->data.frame.sz;
+
+        const FileOffset currpos = ftello(stream->file);
+        fseeko(stream->file, stream->ivf_header_pos, SEEK_SET);
+        ivf_write_frame_size(stream->file, stream->ivf_frame_size);
+        fseeko(stream->file, currpos, SEEK_SET);
+      }
+    }
+
+    (void)fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz, stream->file);
+  }
+  stream->nbytes += pkt->data.raw.sz;
+}
+
+#if CONFIG_MULTITHREAD && !CONFIG_REALTIME_ONLY
+static void store_chunk_packet(struct stream_state *stream,
+                               const aom_codec_cx_pkt_t *pkt);
+#endif
+
 static void get_cx_data(struct stream_state *stream,
                         struct AvxEncoderConfig *global, int *got_data) {
   const aom_codec_cx_pkt_t *pkt;
-  const struct aom_codec_enc_cfg *cfg = &stream->config.cfg;
   aom_codec_iter_t iter = NULL;
 
   *got_data = 0;
   while ((pkt = aom_codec_get_cx_data(&stream->encoder, &iter))) {
-    static size_t fsize = 0;
-    static FileOffset ivf_header_pos = 0;
-
     switch (pkt->kind) {
       case AOM_CODEC_CX_FRAME_PKT:
-        ++stream->frames_out;
-        if (!global->quiet)
-          fprintf(stderr, " %6luF", (unsigned long)pkt->data.frame.sz);
-
-        update_rate_histogram(stream->rate_hist, cfg, pkt);
-#if CONFIG_WEBM_IO
-        if (stream->config.write_webm) {
-          if (write_webm_block(&stream->webm_ctx, cfg, pkt) != 0) {
-            fatal("WebM writer failed.");
-          }
-        }
+#if CONFIG_MULTITHREAD && !CONFIG_REALTIME_ONLY
+        if (stream->chunk)
+          store_chunk_packet(stream, pkt);
+        else
 #endif
-        if (!stream->config.write_webm) {
-          if (stream->config.write_ivf) {
-            if (pkt->data.frame.partition_id <= 0) {
-              ivf_header_pos = ftello(stream->file);
-              fsize = pkt->data.frame.sz;
-
-              ivf_write_frame_header(stream->file, pkt->data.frame.pts, fsize);
-            } else {
-              fsize += pkt->data.frame.sz;
-
-              const FileOffset currpos = ftello(stream->file);
-              fseeko(stream->file, ivf_header_pos, SEEK_SET);
-              ivf_write_frame_size(stream->file, fsize);
-              fseeko(stream->file, currpos, SEEK_SET);
-            }
-          }
-
-          (void)fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz,
-                       stream->file);
-        }
-        stream->nbytes += pkt->data.raw.sz;
+          write_frame_packet(stream, global, pkt);
 
         *got_data = 1;
 #if CONFIG_AV1_DECODER
@@ -1970,6 +1997,169 @@ static void test_decode(struct stream_state *stream,
   aom_img_free(&dec_img);
 }
 
+struct stream_frame_queue;
+
+#if CONFIG_MULTITHREAD
+/* With --parallel-streams each stream runs its encoder on a thread of its
+ * own. The main thread reads the input once and hands every frame to all
+ * streams through a bounded queue; a slot is reused once the last stream has
+ * encoded it, so the ladder runs at the speed of its slowest rung while the
+ * reader stays at most STREAM_QUEUE_SIZE frames ahead.
+ */
+#define STREAM_QUEUE_SIZE 8
+
+struct queued_frame {
+  aom_image_t img;
+  int allocated;
+  int eos;
+  unsigned int frames_in;
+  // Number of streams that have not encoded this frame yet.
+  int refcount;
+};
+
+struct stream_thread_data {
+  pthread_t thread;
+  struct stream_state *stream;
+  // Per-thread copy so that progress output can be disabled on workers.
+  struct AvxEncoderConfig global;
+  struct stream_frame_queue *queue;
+};
+
+struct stream_frame_queue {
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  struct queued_frame frames[STREAM_QUEUE_SIZE];
+  // Number of frames queued so far, including the end of stream entry.
+  unsigned int num_queued;
+  int num_streams;
+  struct stream_thread_data *threads;
+};
+
+static THREADFN stream_thread_hook(void *arg) {
+  struct stream_thread_data *const data = (struct stream_thread_data *)arg;
+  struct stream_frame_queue *const queue = data->queue;
+  struct stream_state *const stream = data->stream;
+  unsigned int next = 0;
+
+  while (1) {
+    pthread_mutex_lock(&queue->mutex);
+    while (queue->num_queued == next)
+      pthread_cond_wait(&queue->cond, &queue->mutex);
+    pthread_mutex_unlock(&queue->mutex);
+
+    struct queued_frame *const frame = &queue->frames[next % STREAM_QUEUE_SIZE];
+    int got_data;
+    encode_frame(stream, &data->global, frame->eos ? NULL : &frame->img,
+                 frame->frames_in);
+    update_quantizer_histogram(stream);
+    get_cx_data(stream, &data->global, &got_data);
+    if (got_data && data->global.test_decode != TEST_DECODE_OFF)
+      test_decode(stream, data->global.test_decode);
+
+    if (frame->eos) {
+      // Keep flushing until the encoder has no more output.
+      if (!got_data) break;
+      continue;
+    }
+    pthread_mutex_lock(&queue->mutex);
+    --frame->refcount;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->mutex);
+    ++next;
+  }
+  return THREAD_RETURN(NULL);
+}
+
+static void copy_queued_image(aom_image_t *dst, const aom_image_t *src) {
+  const int bytes_per_sample = (src->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  const int num_planes = src->monochrome ? 1 : 3;
+  for (int plane = 0; plane < num_planes; ++plane) {
+    const int w = aom_img_plane_width(src, plane) * bytes_per_sample;
+    const int h = aom_img_plane_height(src, plane);
+    for (int y = 0; y < h; ++y) {
+      memcpy(dst->planes[plane] + y * dst->stride[plane],
+             src->planes[plane] + y * src->stride[plane], w);
+    }
+  }
+  dst->bit_depth = src->bit_depth;
+  dst->monochrome = src->monochrome;
+  dst->csp = src->csp;
+  dst->range = src->range;
+  dst->cp = src->cp;
+  dst->tc = src->tc;
+  dst->mc = src->mc;
+}
+
+static void stream_queue_push(struct stream_frame_queue *queue,
+                              const aom_image_t *img, unsigned int frames_in) {
+  struct queued_frame *const frame =
+      &queue->frames[queue->num_queued % STREAM_QUEUE_SIZE];
+
+  pthread_mutex_lock(&queue->mutex);
+  while (frame->refcount > 0) pthread_cond_wait(&queue->cond, &queue->mutex);
+  pthread_mutex_unlock(&queue->mutex);
+
+  if (img) {
+    if (!frame->allocated) {
+      if (!aom_img_alloc(&frame->img, img->fmt, img->d_w, img->d_h, 32))
+        fatal("Failed to allocate frame queue image");
+      frame->allocated = 1;
+    }
+    copy_queued_image(&frame->img, img);
+  }
+  frame->eos = img == NULL;
+  frame->frames_in = frames_in;
+  frame->refcount = queue->num_streams;
+
+  pthread_mutex_lock(&queue->mutex);
+  ++queue->num_queued;
+  pthread_cond_broadcast(&queue->cond);
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+static struct stream_frame_queue *start_stream_threads(
+    struct stream_state *streams, int stream_cnt,
+    const struct AvxEncoderConfig *global) {
+  struct stream_frame_queue *const queue =
+      (struct stream_frame_queue *)calloc(1, sizeof(*queue));
+  if (!queue) fatal("Failed to allocate frame queue");
+  queue->threads = (struct stream_thread_data *)calloc(
+      stream_cnt, sizeof(*queue->threads));
+  if (!queue->threads) fatal("Failed to allocate stream threads");
+  queue->num_streams = stream_cnt;
+  pthread_mutex_init(&queue->mutex, NULL);
+  pthread_cond_init(&queue->cond, NULL);
+
+  int i = 0;
+  FOREACH_STREAM(stream, streams) {
+    struct stream_thread_data *const data = &queue->threads[i++];
+    data->stream = stream;
+    data->global = *global;
+    data->global.quiet = 1;
+    data->queue = queue;
+    if (pthread_create(&data->thread, NULL, stream_thread_hook, data))
+      fatal("Failed to create thread for stream %d", stream->index);
+  }
+  return queue;
+}
+
+// Queues the end of stream, waits for every stream to finish flushing its
+// encoder and frees the queue.
+static void finish_stream_threads(struct stream_frame_queue *queue,
+                                  unsigned int frames_in) {
+  stream_queue_push(queue, NULL, frames_in);
+  for (int i = 0; i < queue->num_streams; ++i)
+    pthread_join(queue->threads[i].thread, NULL);
+  for (int i = 0; i < STREAM_QUEUE_SIZE; ++i) {
+    if (queue->frames[i].allocated) aom_img_free(&queue->frames[i].img);
+  }
+  pthread_cond_destroy(&queue->cond);
+  pthread_mutex_destroy(&queue->mutex);
+  free(queue->threads);
+  free(queue);
+}
+#endif  // CONFIG_MULTITHREAD
+
 static void print_time(int64_t etl) {
   int64_t mins;
   int64_t secs;
@@ -1999,6 +2189,314 @@ static void clear_stream_count_state(struct stream_state *stream) {
   memset(stream->counts, 0, sizeof(stream->counts));
 }
 
+#if CONFIG_MULTITHREAD && !CONFIG_REALTIME_ONLY
+/* With --chunk-threads the second pass is split into chunks at the scene cuts
+ * found in the first pass stats. Each chunk is encoded from a key frame by an
+ * encoder of its own, which gets the stats of the chunk and a target bitrate
+ * weighted by the share of the first pass error that falls in the chunk. A
+ * pool of threads picks up the chunks in order, each thread reading the input
+ * on its own. The main thread writes the packets of every chunk once it is
+ * finished, so the output is a single stream whose timestamps run on across
+ * the chunks.
+ */
+struct encode_chunk {
+  aom_encode_chunk_t info;
+  aom_fixed_buf_t stats;
+  struct stream_state stream;
+  aom_codec_cx_pkt_t *packets;
+  int num_packets;
+  int packets_size;
+  int done;
+};
+
+struct chunk_pool;
+
+struct chunk_thread_data {
+  pthread_t thread;
+  struct chunk_pool *pool;
+  struct AvxInputContext input;
+  FrameReader *reader;
+  // Number of input frames read so far, including skipped frames.
+  unsigned int frames_read;
+  aom_image_t raw_shift;
+  int allocated_raw_shift;
+};
+
+struct chunk_pool {
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  struct encode_chunk *chunks;
+  int num_chunks;
+  // Next chunk to be picked up by a thread.
+  int next_chunk;
+  struct chunk_thread_data *threads;
+  int num_threads;
+  // Copy shared by the threads, with progress output disabled.
+  struct AvxEncoderConfig global;
+  int do_16bit_internal;
+  int input_shift;
+};
+
+static void store_chunk_packet(struct stream_state *stream,
+                               const aom_codec_cx_pkt_t *pkt) {
+  struct encode_chunk *const chunk = stream->chunk;
+  if (chunk->num_packets == chunk->packets_size) {
+    const int new_size = chunk->packets_size ? 2 * chunk->packets_size : 64;
+    aom_codec_cx_pkt_t *const packets = (aom_codec_cx_pkt_t *)realloc(
+        chunk->packets, new_size * sizeof(*packets));
+    if (!packets) fatal("Failed to allocate chunk packets");
+    chunk->packets = packets;
+    chunk->packets_size = new_size;
+  }
+  aom_codec_cx_pkt_t *const copy = &chunk->packets[chunk->num_packets++];
+  *copy = *pkt;
+  copy->data.frame.buf = malloc(pkt->data.frame.sz);
+  if (!copy->data.frame.buf) fatal("Failed to allocate chunk packet");
+  memcpy(copy->data.frame.buf, pkt->data.frame.buf, pkt->data.frame.sz);
+  ++stream->frames_out;
+  stream->nbytes += pkt->data.raw.sz;
+}
+
+static void encode_chunk_frames(struct chunk_thread_data *data,
+                                struct encode_chunk *chunk) {
+  struct chunk_pool *const pool = data->pool;
+  struct AvxEncoderConfig *const global = &pool->global;
+  struct stream_state *const stream = &chunk->stream;
+  const unsigned int first_frame = global->skip_frames + chunk->info.start;
+  int got_data;
+
+  // Chunks are picked up in order, so the input only moves forward.
+  while (data->frames_read < first_frame) {
+    if (!frame_reader_next(data->reader))
+      fatal("Failed to read input frame %u", data->frames_read + 1);
+    ++data->frames_read;
+  }
+
+  initialize_encoder(stream, global);
+  for (int i = 0;; ++i) {
+    aom_image_t *img = NULL;
+    if (i < chunk->info.num_frames) {
+      img = frame_reader_next(data->reader);
+      if (!img) fatal("Failed to read input frame %u", data->frames_read + 1);
+      ++data->frames_read;
+      if (pool->input_shift ||
+          (pool->do_16bit_internal && data->input.bit_depth == 8)) {
+        if (!data->allocated_raw_shift) {
+          aom_img_alloc(&data->raw_shift, img->fmt | AOM_IMG_FMT_HIGHBITDEPTH,
+                        data->input.width, data->input.height, 32);
+          data->allocated_raw_shift = 1;
+        }
+        aom_img_upshift(&data->raw_shift, img, pool->input_shift);
+        img = &data->raw_shift;
+      }
+    }
+    encode_frame(stream, global, img, data->frames_read);
+    update_quantizer_histogram(stream);
+    get_cx_data(stream, global, &got_data);
+    if (got_data && global->test_decode != TEST_DECODE_OFF)
+      test_decode(stream, global->test_decode);
+    // Keep flushing until the encoder has no more output.
+    if (!img && !got_data) break;
+  }
+
+  aom_codec_destroy(&stream->encoder);
+  if (global->test_decode != TEST_DECODE_OFF)
+    aom_codec_destroy(&stream->decoder);
+  if (stream->img) {
+    aom_img_free(stream->img);
+    stream->img = NULL;
+  }
+}
+
+static THREADFN chunk_thread_hook(void *arg) {
+  struct chunk_thread_data *const data = (struct chunk_thread_data *)arg;
+  struct chunk_pool *const pool = data->pool;
+
+  while (1) {
+    pthread_mutex_lock(&pool->mutex);
+    const int next = pool->next_chunk;
+    if (next < pool->num_chunks) ++pool->next_chunk;
+    pthread_mutex_unlock(&pool->mutex);
+    if (next >= pool->num_chunks) break;
+
+    encode_chunk_frames(data, &pool->chunks[next]);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->chunks[next].done = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+  }
+  return THREAD_RETURN(NULL);
+}
+
+// Opens the input of |main_input| again for a chunk thread, with the format
+// settled on by the main thread.
+static void open_chunk_input(struct AvxInputContext *input,
+                             const struct AvxInputContext *main_input,
+                             aom_chroma_sample_position_t csp) {
+  memset(input, 0, sizeof(*input));
+  input->filename = main_input->filename;
+  input->framerate = main_input->framerate;
+  input->only_i420 = main_input->only_i420;
+  input->fmt = main_input->fmt;
+  input->bit_depth = main_input->bit_depth;
+  open_input_file(input, csp);
+  input->width = main_input->width;
+  input->height = main_input->height;
+  input->fmt = main_input->fmt;
+  input->bit_depth = main_input->bit_depth;
+}
+
+static struct chunk_pool *start_chunk_threads(
+    struct stream_state *stream, const struct AvxEncoderConfig *global,
+    const struct AvxInputContext *input, int do_16bit_internal,
+    int input_shift) {
+  const struct aom_codec_enc_cfg *const cfg = &stream->config.cfg;
+  // The encoder of |stream| has been initialized for the second pass with
+  // the first pass stats of the whole sequence.
+  aom_codec_ctx_t *const encoder = &stream->encoder;
+  aom_encode_chunks_t split;
+  memset(&split, 0, sizeof(split));
+  // Shorter scenes are merged so that every chunk fills the lookahead.
+  split.min_chunk_frames =
+      AOMMAX((int)cfg->kf_min_dist, (int)cfg->g_lag_in_frames);
+  split.max_chunk_frames = (int)cfg->kf_max_dist;
+  split.min_num_chunks = global->chunk_threads;
+  if (aom_codec_control(encoder, AV1E_GET_ENCODE_CHUNKS, &split) ||
+      split.num_chunks <= 0)
+    fatal("Failed to split the first pass stats");
+  const int num_chunks = split.num_chunks;
+  split.chunks =
+      (aom_encode_chunk_t *)malloc(num_chunks * sizeof(*split.chunks));
+  if (!split.chunks) fatal("Failed to allocate chunks");
+  split.max_chunks = num_chunks;
+  if (aom_codec_control(encoder, AV1E_GET_ENCODE_CHUNKS, &split))
+    fatal("Failed to split the first pass stats");
+
+  struct chunk_pool *const pool =
+      (struct chunk_pool *)calloc(1, sizeof(*pool));
+  if (!pool) fatal("Failed to allocate chunk pool");
+  pool->chunks =
+      (struct encode_chunk *)calloc(num_chunks, sizeof(*pool->chunks));
+  if (!pool->chunks) fatal("Failed to allocate chunks");
+  pool->num_chunks = num_chunks;
+  pool->global = *global;
+  pool->global.quiet = 1;
+  pool->do_16bit_internal = do_16bit_internal;
+  pool->input_shift = input_shift;
+
+  for (int i = 0; i < num_chunks; ++i) {
+    struct encode_chunk *const chunk = &pool->chunks[i];
+    chunk->info = split.chunks[i];
+    aom_encode_chunk_stats_t chunk_stats;
+    memset(&chunk_stats, 0, sizeof(chunk_stats));
+    chunk_stats.chunk = chunk->info;
+    if (aom_codec_control(encoder, AV1E_GET_ENCODE_CHUNK_STATS, &chunk_stats))
+      fatal("Failed to get the first pass stats of chunk %d", i);
+    chunk_stats.stats.buf = malloc(chunk_stats.stats.sz);
+    if (!chunk_stats.stats.buf) fatal("Failed to allocate chunk stats");
+    if (aom_codec_control(encoder, AV1E_GET_ENCODE_CHUNK_STATS, &chunk_stats))
+      fatal("Failed to get the first pass stats of chunk %d", i);
+    chunk->stats = chunk_stats.stats;
+
+    struct stream_state *const chunk_stream = &chunk->stream;
+    *chunk_stream = *stream;
+    chunk_stream->file = NULL;
+    chunk_stream->rate_hist = NULL;
+    chunk_stream->img = NULL;
+    chunk_stream->frames_out = 0;
+    chunk_stream->cx_time = 0;
+    chunk_stream->nbytes = 0;
+    chunk_stream->mismatch_seen = 0;
+    chunk_stream->chunk = chunk;
+    clear_stream_count_state(chunk_stream);
+
+    struct aom_codec_enc_cfg *const chunk_cfg = &chunk_stream->config.cfg;
+    chunk_cfg->rc_twopass_stats_in = chunk->stats;
+    chunk_cfg->g_limit = chunk->info.num_frames;
+    chunk_cfg->rc_target_bitrate = (unsigned int)AOMMAX(
+        1, lround(cfg->rc_target_bitrate * chunk->info.bitrate_scale));
+  }
+  free(split.chunks);
+
+  pool->num_threads = AOMMIN(global->chunk_threads, num_chunks);
+  pool->threads = (struct chunk_thread_data *)calloc(pool->num_threads,
+                                                     sizeof(*pool->threads));
+  if (!pool->threads) fatal("Failed to allocate chunk threads");
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->cond, NULL);
+
+  for (int i = 0; i < pool->num_threads; ++i) {
+    struct chunk_thread_data *const data = &pool->threads[i];
+    data->pool = pool;
+    open_chunk_input(&data->input, input, global->csp);
+    data->reader = frame_reader_create(&data->input, global->read_ahead,
+                                       global->mmap_input);
+    if (!data->reader) fatal("Failed to create input frame reader");
+    if (pthread_create(&data->thread, NULL, chunk_thread_hook, data))
+      fatal("Failed to create chunk thread %d", i);
+  }
+  return pool;
+}
+
+// Writes the packets of the chunks to |stream| in order as the chunks are
+// finished, adds up their statistics, waits for the threads and frees the
+// pool. Returns the number of frames encoded.
+static unsigned int finish_chunk_threads(
+    struct chunk_pool *pool, struct stream_state *stream,
+    const struct AvxEncoderConfig *global) {
+  unsigned int frames = 0;
+
+  for (int i = 0; i < pool->num_chunks; ++i) {
+    struct encode_chunk *const chunk = &pool->chunks[i];
+    pthread_mutex_lock(&pool->mutex);
+    while (!chunk->done) pthread_cond_wait(&pool->cond, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int j = 0; j < chunk->num_packets; ++j) {
+      write_frame_packet(stream, &pool->global, &chunk->packets[j]);
+      free(chunk->packets[j].data.frame.buf);
+    }
+    free(chunk->packets);
+    free(chunk->stats.buf);
+
+    const struct stream_state *const chunk_stream = &chunk->stream;
+    for (int k = 0; k < 2; ++k) {
+      stream->psnr_sse_total[k] += chunk_stream->psnr_sse_total[k];
+      stream->psnr_samples_total[k] += chunk_stream->psnr_samples_total[k];
+      for (int p = 0; p < 4; ++p)
+        stream->psnr_totals[k][p] += chunk_stream->psnr_totals[k][p];
+      stream->psnr_count[k] += chunk_stream->psnr_count[k];
+    }
+    for (int q = 0; q < 64; ++q) stream->counts[q] += chunk_stream->counts[q];
+    if (!stream->mismatch_seen && chunk_stream->mismatch_seen)
+      stream->mismatch_seen = chunk->info.start + chunk_stream->mismatch_seen;
+    frames += chunk->info.num_frames;
+
+    if (!global->quiet) {
+      fprintf(stderr, "\rPass 2/2 chunk %d/%d frame %4u/%-4u %5lu KB\033[K",
+              i + 1, pool->num_chunks, frames, stream->frames_out,
+              (unsigned long)(stream->nbytes / 1000));
+      fflush(stderr);
+    }
+  }
+
+  for (int i = 0; i < pool->num_threads; ++i) {
+    struct chunk_thread_data *const data = &pool->threads[i];
+    pthread_join(data->thread, NULL);
+    frame_reader_destroy(data->reader);
+    close_input_file(&data->input);
+    if (data->allocated_raw_shift) aom_img_free(&data->raw_shift);
+  }
+  pthread_cond_destroy(&pool->cond);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->threads);
+  free(pool->chunks);
+  free(pool);
+  return frames;
+}
+#endif  // CONFIG_MULTITHREAD && !CONFIG_REALTIME_ONLY
+
 // aomenc will downscale the second pass if:
 // 1. the specific pass is not given by commandline (aomenc will perform all
 //    passes)
@@ -2011,7 +2509,6 @@ static int pass_need_downscale(int global_pass, int global_passes, int pass) {
 
 int main(int argc, const char **argv_) {
   int pass;
-  aom_image_t raw;
   aom_image_t raw_shift;
   int allocated_raw_shift = 0;
   int do_16bit_internal = 0;
@@ -2028,7 +2525,6 @@ int main(int argc, const char **argv_) {
   int profile_updated = 0;
 
   memset(&input, 0, sizeof(input));
-  memset(&raw, 0, sizeof(raw));
   exec_name = argv_[0];
 
   /* Setup default input stream settings */
@@ -2086,6 +2582,19 @@ int main(int argc, const char **argv_) {
       die("only support ivf output format while large-scale-tile=1\n");
   }
 
+  if (global.chunk_threads) {
+#if CONFIG_MULTITHREAD && !CONFIG_REALTIME_ONLY
+    if (global.passes != 2 || global.pass)
+      die("Error: --chunk-threads requires --passes=2 without --pass\n");
+    if (stream_cnt > 1)
+      die("Error: --chunk-threads supports a single output stream\n");
+    if (streams->config.cfg.kf_mode == AOM_KF_DISABLED)
+      die("Error: --chunk-threads requires automatic key frames\n");
+#else
+    die("Error: --chunk-threads is not supported in this build\n");
+#endif
+  }
+
   /* Handle non-option arguments */
   input.filename = argv[0];
   const char *orig_input_filename = input.filename;
@@ -2102,6 +2611,10 @@ int main(int argc, const char **argv_) {
     usage_exit();
   }
 
+  // Every chunk thread opens the input again.
+  if (global.chunk_threads && !strcmp(input.filename, "-"))
+    die("Error: --chunk-threads cannot read the input from stdin\n");
+
   /* Decide if other chroma subsamplings than 4:2:0 are supported */
   if (get_fourcc_by_aom_encoder(global.codec) == AV1_FOURCC)
     input.only_i420 = 0;
@@ -2112,6 +2625,10 @@ int main(int argc, const char **argv_) {
     }
 
     int frames_in = 0, seen_frames = 0;
+    struct stream_frame_queue *frame_queue = NULL;
+    // Wall time of the parallel streams, which run beside the main thread.
+    struct aom_usec_timer parallel_timer;
+    const int encode_chunks = global.chunk_threads && pass == 1;
     const int need_downscale =
         pass_need_downscale(global.pass, global.passes, pass);
 
@@ -2400,10 +2917,6 @@ int main(int argc, const char **argv_) {
     }
 
     if (pass == (global.pass ? global.pass - 1 : 0)) {
-      // The Y4M reader does its own allocation.
-      if (input.file_type != FILE_TYPE_Y4M) {
-        aom_img_alloc(&raw, input.fmt, input.width, input.height, 32);
-      }
       FOREACH_STREAM(stream, streams) {
         stream->rate_hist =
             init_rate_histogram(&stream->config.cfg, &global.framerate);
@@ -2450,14 +2963,47 @@ int main(int argc, const char **argv_) {
       }
     }
 
-    frame_avail = 1;
+#if CONFIG_MULTITHREAD
+    if (global.parallel_streams && stream_cnt > 1) {
+      FOREACH_STREAM(stream, streams) {
+        if (do_16bit_internal && !stream->config.use_16bit_internal)
+          fatal("--parallel-streams requires the same internal bit depth in "
+                "all streams");
+      }
+      frame_queue = start_stream_threads(streams, stream_cnt, &global);
+      aom_usec_timer_start(&parallel_timer);
+    }
+#endif
+
+#if CONFIG_MULTITHREAD && !CONFIG_REALTIME_ONLY
+    if (encode_chunks) {
+      struct aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      struct chunk_pool *const pool = start_chunk_threads(
+          streams, &global, &input, do_16bit_internal, input_shift);
+      seen_frames = (int)finish_chunk_threads(pool, streams, &global);
+      aom_usec_timer_mark(&timer);
+      cx_time += aom_usec_timer_elapsed(&timer);
+    }
+#endif
+
+    // The chunks have been encoded already, so the loop below is skipped.
+    FrameReader *const reader =
+        encode_chunks ? NULL
+                      : frame_reader_create(&input, global.read_ahead,
+                                            global.mmap_input);
+    if (!encode_chunks && !reader) fatal("Failed to create input frame reader");
+    aom_image_t *input_img = NULL;
+
+    frame_avail = !encode_chunks;
     got_data = 0;
 
     while (frame_avail || got_data) {
       struct aom_usec_timer timer;
 
       if (!global.limit || frames_in < global.limit) {
-        frame_avail = read_frame(&input, &raw);
+        input_img = frame_reader_next(reader);
+        frame_avail = input_img != NULL;
 
         if (frame_avail) frames_in++;
         seen_frames =
@@ -2467,23 +3013,31 @@ int main(int argc, const char **argv_) {
           float fps = usec_to_fps(cx_time, seen_frames);
           fprintf(stderr, "\rPass %d/%d ", pass + 1, global.passes);
 
-          int64_t bytes = (int64_t)streams->nbytes;
           if (stream_cnt == 1)
             fprintf(stderr, "frame %4d/%-4d", frames_in, streams->frames_out);
           else
             fprintf(stderr, "frame %4d", frames_in);
 
-          print_time(cx_time / 1000000);
-          if (global.pass == global.passes) {
-            fprintf(stderr, " %5lu KB    %6.2f fps  %7.1f Kbps", bytes / 1000,
-                    fps,
-                    streams->frames_out > 0
-                        ? (float)bytes * 8. / 1000. / streams->frames_out *
-                              input.framerate.numerator /
-                              input.framerate.denominator
-                        : 0.);
+          if (frame_queue) {
+            // cx_time only covers queuing the frames here, and the per-stream
+            // counters are owned by the stream threads. Show the elapsed time
+            // and report the frame rate of each stream once it is done.
+            aom_usec_timer_mark(&parallel_timer);
+            print_time(aom_usec_timer_elapsed(&parallel_timer) / 1000000);
           } else {
-            fprintf(stderr, "             %6.2f fps", fps);
+            print_time(cx_time / 1000000);
+            if (global.pass == global.passes) {
+              int64_t bytes = (int64_t)streams->nbytes;
+              fprintf(stderr, " %5lu KB    %6.2f fps  %7.1f Kbps",
+                      bytes / 1000, fps,
+                      streams->frames_out > 0
+                          ? (float)bytes * 8. / 1000. / streams->frames_out *
+                                input.framerate.numerator /
+                                input.framerate.denominator
+                          : 0.);
+            } else {
+              fprintf(stderr, "             %6.2f fps", fps);
+            }
           }
           // mingw-w64 gcc does not match msvc for stderr buffering behavior
           // and uses line buffering, thus the progress output is not
@@ -2497,24 +3051,29 @@ int main(int argc, const char **argv_) {
       }
 
       if (frames_in > global.skip_frames) {
-        aom_image_t *frame_to_encode;
-        if (input_shift || (do_16bit_internal && input.bit_depth == 8)) {
+        aom_image_t *frame_to_encode = input_img;
+        if (frame_avail &&
+            (input_shift || (do_16bit_internal && input.bit_depth == 8))) {
           assert(do_16bit_internal);
           // Input bit depth and stream bit depth do not match, so up
           // shift frame to stream bit depth
           if (!allocated_raw_shift) {
-            aom_img_alloc(&raw_shift, raw.fmt | AOM_IMG_FMT_HIGHBITDEPTH,
+            aom_img_alloc(&raw_shift, input_img->fmt | AOM_IMG_FMT_HIGHBITDEPTH,
                           input.width, input.height, 32);
             allocated_raw_shift = 1;
           }
-          aom_img_upshift(&raw_shift, &raw, input_shift);
+          aom_img_upshift(&raw_shift, input_img, input_shift);
           frame_to_encode = &raw_shift;
-        } else {
-          frame_to_encode = &raw;
         }
         aom_usec_timer_start(&timer);
-        if (do_16bit_internal) {
-          assert(frame_to_encode->fmt & AOM_IMG_FMT_HIGHBITDEPTH);
+        if (frame_queue) {
+#if CONFIG_MULTITHREAD
+          if (frame_avail)
+            stream_queue_push(frame_queue, frame_to_encode, frames_in);
+#endif
+        } else if (do_16bit_internal) {
+          assert(!frame_avail ||
+                 (frame_to_encode->fmt & AOM_IMG_FMT_HIGHBITDEPTH));
           FOREACH_STREAM(stream, streams) {
             if (stream->config.use_16bit_internal)
               encode_frame(stream, &global,
@@ -2523,7 +3082,8 @@ int main(int argc, const char **argv_) {
               assert(0);
           }
         } else {
-          assert((frame_to_encode->fmt & AOM_IMG_FMT_HIGHBITDEPTH) == 0);
+          assert(!frame_avail ||
+                 (frame_to_encode->fmt & AOM_IMG_FMT_HIGHBITDEPTH) == 0);
           FOREACH_STREAM(stream, streams) {
             encode_frame(stream, &global, frame_avail ? frame_to_encode : NULL,
                          frames_in);
@@ -2532,16 +3092,20 @@ int main(int argc, const char **argv_) {
         aom_usec_timer_mark(&timer);
         cx_time += aom_usec_timer_elapsed(&timer);
 
-        FOREACH_STREAM(stream, streams) { update_quantizer_histogram(stream); }
-
         got_data = 0;
-        FOREACH_STREAM(stream, streams) {
-          get_cx_data(stream, &global, &got_data);
-        }
+        if (!frame_queue) {
+          FOREACH_STREAM(stream, streams) {
+            update_quantizer_histogram(stream);
+          }
 
-        if (got_data && global.test_decode != TEST_DECODE_OFF) {
           FOREACH_STREAM(stream, streams) {
-            test_decode(stream, global.test_decode);
+            get_cx_data(stream, &global, &got_data);
+          }
+
+          if (got_data && global.test_decode != TEST_DECODE_OFF) {
+            FOREACH_STREAM(stream, streams) {
+              test_decode(stream, global.test_decode);
+            }
           }
         }
       }
@@ -2550,6 +3114,25 @@ int main(int argc, const char **argv_) {
       if (!global.quiet) fprintf(stderr, "\033[K");
     }
 
+#if CONFIG_MULTITHREAD
+    if (frame_queue) {
+      struct aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      finish_stream_threads(frame_queue, frames_in);
+      aom_usec_timer_mark(&timer);
+      cx_time += aom_usec_timer_elapsed(&timer);
+      // Each stream timed its own encoder calls on its thread.
+      if (!global.quiet) {
+        FOREACH_STREAM(stream, streams) {
+          fprintf(stderr, "\nStream %d: %4u frames  %6.2f fps", stream->index,
+                  stream->frames_out,
+                  usec_to_fps(stream->cx_time, stream->frames_out));
+        }
+        fprintf(stderr, "\n");
+      }
+    }
+#endif
+
     if (global.show_psnr >= 1) {
       if (get_fourcc_by_aom_encoder(global.codec) == AV1_FOURCC) {
         FOREACH_STREAM(stream, streams) {
@@ -2577,7 +3160,8 @@ int main(int argc, const char **argv_) {
       }
     }
 
-    if (pass == global.passes - 1) {
+    // The levels of the chunks are not reported by the main encoder.
+    if (pass == global.passes - 1 && !encode_chunks) {
       FOREACH_STREAM(stream, streams) {
         int num_operating_points;
         int levels[32];
@@ -2606,6 +3190,7 @@ int main(int argc, const char **argv_) {
       FOREACH_STREAM(stream, streams) { aom_codec_destroy(&stream->decoder); }
     }
 
+    frame_reader_destroy(reader);
     close_input_file(&input);
 
     if (global.test_decode == TEST_DECODE_FATAL) {
@@ -2655,7 +3240,6 @@ int main(int argc, const char **argv_) {
 #endif
 
   if (allocated_raw_shift) aom_img_free(&raw_shift);
-  aom_img_free(&raw);
   free(argv);
   free(streams);
   return res ? EXIT_FAILURE : EXIT_SUCCESS;
@@ -47,6 +47,10 @@ struct AvxEncoderConfig {
   int show_rate_hist_buckets;
   int disable_warnings;
   int disable_warning_prompt;
+  int parallel_streams;
+  int read_ahead;
+  int mmap_input;
+  int chunk_threads;
   int experimental_bitstream;
   aom_chroma_sample_position_t csp;
   cfg_options_t encoder_config;
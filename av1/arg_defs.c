@@ -197,6 +197,18 @@ const av1_codec_arg_definitions_t g_av1_codec_arg_defs = {
   .disable_warning_prompt =
       ARG_DEF("y", "disable-warning-prompt", 0,
               "Display warnings, but do not prompt user to continue"),
+  .parallel_streams =
+      ARG_DEF(NULL, "parallel-streams", 0,
+              "Encode each output stream on its own thread"),
+  .read_ahead = ARG_DEF(NULL, "read-ahead", 1,
+                        "Number of input frames to read ahead on a separate "
+                        "thread (default: 0)"),
+  .mmap_input = ARG_DEF(NULL, "mmap-input", 0,
+                        "Read input frames from a memory mapping of the file "
+                        "when possible"),
+  .chunk_threads = ARG_DEF(NULL, "chunk-threads", 1,
+                           "Split the second pass at scene cuts and encode "
+                           "the chunks on this many threads (default: 0)"),
   .bitdeptharg =
       ARG_DEF_ENUM("b", "bit-depth", 1, "Bit depth for codec (default is 10-bit)", bitdepth_enum),
   .inbitdeptharg = ARG_DEF(NULL, "input-bit-depth", 1, "Bit depth of input"),
@@ -754,5 +766,9 @@ const av1_codec_arg_definitions_t g_av1_codec_arg_defs = {
   .tpl_rd_mult = ARG_DEF(NULL, "tpl-rd-mult", 1,
                        "Multiplier for tpl rdmult "
                                   "(Meant for hyper-tuning, defaults to 100)"),
+  .async_psnr = ARG_DEF(NULL, "async-psnr", 1,
+                        "Compute the PSNR of each frame in the background and "
+                        "report it with the next frame (0: off (default), "
+                        "1: on)"),
 #endif  // CONFIG_AV1_ENCODER
 };
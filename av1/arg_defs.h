@@ -59,6 +59,10 @@ typedef struct av1_codec_arg_definitions {
   arg_def_t rate_hist_n;
   arg_def_t disable_warnings;
   arg_def_t disable_warning_prompt;
+  arg_def_t parallel_streams;
+  arg_def_t read_ahead;
+  arg_def_t mmap_input;
+  arg_def_t chunk_threads;
   arg_def_t bitdeptharg;
   arg_def_t inbitdeptharg;
   arg_def_t input_chroma_subsampling_x;
@@ -260,6 +264,7 @@ typedef struct av1_codec_arg_definitions {
   arg_def_t vmaf_rd_mult;
 #endif
   arg_def_t tpl_rd_mult;
+  arg_def_t async_psnr;
 #endif  // CONFIG_AV1_ENCODER
 } av1_codec_arg_definitions_t;
 
@@ -129,6 +129,8 @@ list(APPEND AOM_AV1_ENCODER_SOURCES
             "${AOM_ROOT}/av1/encoder/bitstream.c"
             "${AOM_ROOT}/av1/encoder/bitstream.h"
             "${AOM_ROOT}/av1/encoder/block.h"
+            "${AOM_ROOT}/av1/encoder/chunk_split.c"
+            "${AOM_ROOT}/av1/encoder/chunk_split.h"
             "${AOM_ROOT}/av1/encoder/cnn.c"
             "${AOM_ROOT}/av1/encoder/cnn.h"
             "${AOM_ROOT}/av1/encoder/compound_type.c"
@@ -237,6 +239,8 @@ list(APPEND AOM_AV1_ENCODER_SOURCES
             "${AOM_ROOT}/av1/encoder/temporal_filter.h"
             "${AOM_ROOT}/av1/encoder/thirdpass.c"
             "${AOM_ROOT}/av1/encoder/thirdpass.h"
+            "${AOM_ROOT}/av1/encoder/time_budget.c"
+            "${AOM_ROOT}/av1/encoder/time_budget.h"
             "${AOM_ROOT}/av1/encoder/tokenize.c"
             "${AOM_ROOT}/av1/encoder/tokenize.h"
             "${AOM_ROOT}/av1/encoder/tpl_model.c"
@@ -308,6 +312,9 @@ list(APPEND AOM_AV1_COMMON_INTRIN_AVX2
             "${AOM_ROOT}/av1/common/x86/warp_plane_avx2.c"
             "${AOM_ROOT}/av1/common/x86/wiener_convolve_avx2.c")
 
+list(APPEND AOM_AV1_COMMON_INTRIN_AVX512
+            "${AOM_ROOT}/av1/common/x86/convolve_2d_avx512.c")
+
 list(APPEND AOM_AV1_ENCODER_ASM_SSE2 "${AOM_ROOT}/av1/encoder/x86/dct_sse2.asm"
             "${AOM_ROOT}/av1/encoder/x86/error_sse2.asm")
 
@@ -354,6 +361,10 @@ list(APPEND AOM_AV1_ENCODER_INTRIN_AVX2
             "${AOM_ROOT}/av1/encoder/x86/pickrst_avx2.c"
             "${AOM_ROOT}/av1/encoder/x86/cnn_avx2.c")
 
+list(APPEND AOM_AV1_ENCODER_INTRIN_AVX512
+            "${AOM_ROOT}/av1/encoder/x86/error_intrin_avx512.c"
+            "${AOM_ROOT}/av1/encoder/x86/highbd_fwd_txfm_avx512.c")
+
 list(APPEND AOM_AV1_ENCODER_INTRIN_NEON
             "${AOM_ROOT}/av1/encoder/arm/neon/quantize_neon.c"
             "${AOM_ROOT}/av1/encoder/arm/neon/av1_highbd_quantize_neon.c"
@@ -423,6 +434,9 @@ if(CONFIG_AV1_TEMPORAL_DENOISING)
   list(APPEND AOM_AV1_ENCODER_INTRIN_SSE2
               "${AOM_ROOT}/av1/encoder/x86/av1_temporal_denoiser_sse2.c")
 
+  list(APPEND AOM_AV1_ENCODER_INTRIN_AVX2
+              "${AOM_ROOT}/av1/encoder/x86/av1_temporal_denoiser_avx2.c")
+
   list(APPEND AOM_AV1_ENCODER_INTRIN_NEON
               "${AOM_ROOT}/av1/encoder/arm/neon/av1_temporal_denoiser_neon.c")
 endif()
@@ -618,6 +632,19 @@ function(setup_av1_targets)
     endif()
   endif()
 
+  if(HAVE_AVX512)
+    require_compiler_flag_nomsvc("${AOM_AVX512_FLAGS}" NO)
+    add_intrinsics_object_library("${AOM_AVX512_FLAGS}" "avx512"
+                                  "aom_av1_common"
+                                  "AOM_AV1_COMMON_INTRIN_AVX512")
+
+    if(CONFIG_AV1_ENCODER)
+      add_intrinsics_object_library("${AOM_AVX512_FLAGS}" "avx512"
+                                    "aom_av1_encoder"
+                                    "AOM_AV1_ENCODER_INTRIN_AVX512")
+    endif()
+  endif()
+
   if(HAVE_NEON)
     if(AOM_AV1_COMMON_INTRIN_NEON)
       add_intrinsics_object_library("${AOM_NEON_INTRIN_FLAG}" "neon"
@@ -8,6 +8,7 @@
  * Media Patent License 1.0 was not distributed with this source code in the
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -21,7 +22,9 @@
 #include "aom/internal/aom_codec_internal.h"
 
 #include "av1/av1_iface_common.h"
+#include "av1/common/obu_util.h"
 #include "av1/encoder/bitstream.h"
+#include "av1/encoder/chunk_split.h"
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/encoder_utils.h"
 #include "av1/encoder/ethread.h"
@@ -36,6 +39,7 @@ struct av1_extracfg {
   unsigned int enable_auto_alt_ref;
   unsigned int enable_auto_bwd_ref;
   unsigned int noise_sensitivity;
+  unsigned int denoise_prepass;
   unsigned int sharpness;
   int quant_sharpness;
   unsigned int static_thresh;
@@ -231,6 +235,7 @@ static const struct av1_extracfg default_extra_cfg = {
   1,              // enable_auto_alt_ref
   0,              // enable_auto_bwd_ref
   0,              // noise_sensitivity
+  0,              // denoise_prepass
   0,              // sharpness
   0,              // quant_sharpness
   0,              // static_thresh
@@ -399,6 +404,7 @@ static const struct av1_extracfg default_extra_cfg = {
   1,              // enable_auto_alt_ref
   0,              // enable_auto_bwd_ref
   0,              // noise_sensitivity
+  0,              // denoise_prepass
   0,              // sharpness
   0,              // quant_sharpness
   0,              // static_thresh
@@ -588,6 +594,9 @@ struct aom_codec_alg_priv {
   // Number of stats buffers required for look ahead
   int num_lap_buffers;
   STATS_BUFFER_CTX stats_buf_context;
+  // Low-latency tile group output set with AV1E_SET_TILE_GROUP_OUTPUT_CB.
+  aom_tile_group_output_cb_t tg_output_cb;
+  int tg_output_partition_id;
 };
 
 static INLINE int gcd(int64_t a, int b) {
@@ -752,6 +761,7 @@ static aom_codec_err_t validate_config(aom_codec_alg_priv_t *ctx,
   RANGE_CHECK(extra_cfg, cpu_used, 0,
               (cfg->g_usage == AOM_USAGE_REALTIME) ? 10 : 9);
   RANGE_CHECK_HI(extra_cfg, noise_sensitivity, 6);
+  RANGE_CHECK_HI(extra_cfg, denoise_prepass, 1);
   RANGE_CHECK(extra_cfg, superblock_size, AOM_SUPERBLOCK_SIZE_64X64,
               AOM_SUPERBLOCK_SIZE_DYNAMIC);
   RANGE_CHECK_HI(cfg, large_scale_tile, 1);
@@ -1368,6 +1378,7 @@ static aom_codec_err_t set_encoder_config(AV1EncoderConfig *oxcf,
   } else {
     oxcf->noise_sensitivity = 0;
   }
+  oxcf->denoise_prepass = extra_cfg->denoise_prepass;
 #endif
   // Set Tile related configuration.
   tile_cfg->num_tile_groups = extra_cfg->num_tg;
@@ -1625,6 +1636,7 @@ static aom_codec_err_t encoder_set_config(aom_codec_alg_priv_t *ctx,
     set_encoder_config(&ctx->oxcf, &ctx->cfg, &ctx->extra_cfg);
     // On profile change, request a key frame
     force_key |= ctx->ppi->seq_params.profile != ctx->oxcf.profile;
+    av1_sync_async_psnr(ctx->ppi);
     bool is_sb_size_changed = false;
     av1_change_config_seq(ctx->ppi, &ctx->oxcf, &is_sb_size_changed);
     for (int i = 0; i < ctx->ppi->num_fp_contexts; i++) {
@@ -1683,6 +1695,7 @@ static aom_codec_err_t update_extra_cfg(aom_codec_alg_priv_t *ctx,
   if (res == AOM_CODEC_OK) {
     ctx->extra_cfg = *extra_cfg;
     set_encoder_config(&ctx->oxcf, &ctx->cfg, &ctx->extra_cfg);
+    av1_sync_async_psnr(ctx->ppi);
     av1_check_fpmt_config(ctx->ppi, &ctx->oxcf);
     bool is_sb_size_changed = false;
     av1_change_config_seq(ctx->ppi, &ctx->oxcf, &is_sb_size_changed);
@@ -1725,6 +1738,13 @@ static aom_codec_err_t ctrl_set_noise_sensitivity(aom_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static aom_codec_err_t ctrl_set_denoise_prepass(aom_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.denoise_prepass = CAST(AV1E_SET_DENOISE_PREPASS, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static aom_codec_err_t ctrl_set_sharpness(aom_codec_alg_priv_t *ctx,
                                           va_list args) {
   struct av1_extracfg extra_cfg = ctx->extra_cfg;
@@ -2825,6 +2845,7 @@ static aom_codec_err_t encoder_destroy(aom_codec_alg_priv_t *ctx) {
 
   if (ctx->ppi) {
     AV1_PRIMARY *ppi = ctx->ppi;
+    av1_sync_async_psnr(ppi);
     for (int i = 0; i < MAX_PARALLEL_FRAMES - 1; i++) {
       if (ppi->parallel_frames_data[i].cx_data) {
         free(ppi->parallel_frames_data[i].cx_data);
@@ -2885,6 +2906,68 @@ static INLINE int get_src_border_in_pixels(AV1_COMP *cpi, BLOCK_SIZE sb_size) {
   return border_in_pixels;
 }
 
+// Forwards a finished part of the frame to the application. The temporal
+// delimiter is only inserted after packing, so it is sent ahead of the first
+// part of a temporal unit here.
+static void encoder_tile_group_output(void *priv, const uint8_t *data,
+                                      size_t size, int is_last) {
+  aom_codec_alg_priv_t *const ctx = (aom_codec_alg_priv_t *)priv;
+  const aom_tile_group_output_cb_t *const cb = &ctx->tg_output_cb;
+  AV1_COMP *const cpi = ctx->ppi->cpi;
+
+  if (ctx->tg_output_partition_id == 0 && !cpi->common.spatial_layer_id &&
+      !ctx->pending_cx_data_sz) {
+    uint8_t td[2];
+    const uint32_t obu_header_size =
+        av1_write_obu_header(&ctx->ppi->level_params, &cpi->frame_header_count,
+                             OBU_TEMPORAL_DELIMITER, 0, td);
+    if (av1_write_uleb_obu_size(obu_header_size, 0, td) != AOM_CODEC_OK) {
+      aom_internal_error(&ctx->ppi->error, AOM_CODEC_ERROR, NULL);
+    }
+    cb->output_partition(cb->user_priv, td,
+                         obu_header_size + aom_uleb_size_in_bytes(0),
+                         ctx->tg_output_partition_id++, 0);
+  }
+  cb->output_partition(cb->user_priv, data, size,
+                       ctx->tg_output_partition_id++, is_last);
+  if (is_last) ctx->tg_output_partition_id = 0;
+}
+
+// Splits a packed frame whose tile groups could not be output as their tiles
+// were encoded into the same parts: the OBUs ahead of the tile groups, then
+// each tile group OBU with the redundant frame header that may precede it.
+static void output_frame_partitions(aom_codec_alg_priv_t *ctx,
+                                    const uint8_t *data, size_t size) {
+  size_t part_start = 0;
+  size_t pos = 0;
+  int in_head = 1;
+  while (pos < size) {
+    ObuHeader obu_header;
+    size_t payload_size, bytes_read;
+    if (aom_read_obu_header_and_size(data + pos, size - pos, 0, &obu_header,
+                                     &payload_size, &bytes_read) !=
+            AOM_CODEC_OK ||
+        payload_size > size - pos - bytes_read) {
+      aom_internal_error(&ctx->ppi->error, AOM_CODEC_ERROR, NULL);
+    }
+    const int is_tile_group =
+        obu_header.type == OBU_TILE_GROUP || obu_header.type == OBU_FRAME;
+    if (in_head &&
+        (is_tile_group || obu_header.type == OBU_REDUNDANT_FRAME_HEADER)) {
+      if (pos > 0) encoder_tile_group_output(ctx, data, pos, 0);
+      part_start = pos;
+      in_head = 0;
+    }
+    pos += bytes_read + payload_size;
+    if (is_tile_group) {
+      encoder_tile_group_output(ctx, data + part_start, pos - part_start,
+                                pos == size);
+      part_start = pos;
+    }
+  }
+  assert(ctx->tg_output_partition_id == 0);
+}
+
 // TODO(Mufaddal): Check feasibility of abstracting functions related to LAP
 // into a separate function.
 static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
@@ -2957,6 +3040,9 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
   }
 
   aom_codec_pkt_list_init(&ctx->pkt_list);
+  // The PSNR of the previous frame, if computed in the background, is
+  // reported with the output of this call.
+  av1_finish_async_psnr(ppi);
 
   volatile aom_enc_frame_flags_t flags = enc_flags;
 
@@ -3085,6 +3171,17 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
     cpi_data.cx_data = ctx->cx_data;
     cpi_data.cx_data_sz = ctx->cx_data_sz;
 
+    // Tile groups can only be handed out early when every call produces
+    // exactly one frame in the section 5 format.
+    const int tg_output = ctx->tg_output_cb.output_partition != NULL &&
+                          cpi->oxcf.gf_cfg.lag_in_frames == 0 &&
+                          !ctx->oxcf.save_as_annexb;
+    cpi->tg_output.output = tg_output ? encoder_tile_group_output : NULL;
+    cpi->tg_output.priv = ctx;
+    cpi->tg_output.early = 0;
+    cpi->tg_output.num_output = 0;
+    ctx->tg_output_partition_id = 0;
+
     /* Any pending invisible frames? */
     if (ctx->pending_cx_data_sz) {
       cpi_data.cx_data += ctx->pending_cx_data_sz;
@@ -3230,6 +3327,12 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
       const int write_temporal_delimiter =
           !cpi->common.spatial_layer_id && !ctx->pending_cx_data_sz;
 
+      // Frames output as they were encoded are already complete.
+      if (cpi->tg_output.output != NULL && cpi->tg_output.num_output == 0) {
+        output_frame_partitions(ctx, cpi_data.cx_data, cpi_data.frame_size);
+      }
+      cpi->tg_output.num_output = 0;
+
       if (write_temporal_delimiter) {
         uint32_t obu_header_size = 1;
         const uint32_t obu_payload_size = 0;
@@ -3462,6 +3565,17 @@ static aom_codec_err_t ctrl_set_active_map(aom_codec_alg_priv_t *ctx,
   }
 }
 
+static aom_codec_err_t ctrl_set_dirty_rects(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  const aom_dirty_rects_t *const dirty = va_arg(args, aom_dirty_rects_t *);
+
+  if (dirty == NULL || dirty->num_rects > INT_MAX)
+    return AOM_CODEC_INVALID_PARAM;
+  if (av1_set_dirty_rects(ctx->ppi->cpi, dirty->rects, (int)dirty->num_rects))
+    return AOM_CODEC_INVALID_PARAM;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_get_active_map(aom_codec_alg_priv_t *ctx,
                                            va_list args) {
   aom_active_map_t *const map = va_arg(args, aom_active_map_t *);
@@ -3595,6 +3709,15 @@ static aom_codec_err_t ctrl_set_svc_ref_frame_comp_pred(
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_svc_reuse_lower_layer_mv(
+    aom_codec_alg_priv_t *ctx, va_list args) {
+  AV1_COMP *const cpi = ctx->ppi->cpi;
+  const int arg = CAST(AV1E_SET_SVC_REUSE_LOWER_LAYER_MV, args);
+  if (arg < 0 || arg > 1) return AOM_CODEC_INVALID_PARAM;
+  cpi->svc.reuse_lower_layer_mv = arg;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_set_tune_content(aom_codec_alg_priv_t *ctx,
                                              va_list args) {
   struct av1_extracfg extra_cfg = ctx->extra_cfg;
@@ -4367,6 +4490,110 @@ static aom_codec_err_t ctrl_get_num_operating_points(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_async_psnr(aom_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  const int enable = CAST(AV1E_SET_ASYNC_PSNR, args);
+  if (enable < 0 || enable > 1) return AOM_CODEC_INVALID_PARAM;
+  ctx->ppi->async_psnr.enabled = enable;
+  return AOM_CODEC_OK;
+}
+
+static void add_stage_times(const AV1_COMP *cpi, aom_enc_stage_times_t *times) {
+  // The stages are the multi-threaded modules of the encoder, in the same
+  // order, apart from frame parallel encoding which spans all of them.
+  static const MULTI_THREADED_MODULES stage_module[AOM_ENC_STAGE_COUNT] = {
+    MOD_FP,
+    MOD_TF,
+    MOD_TPL,
+    MOD_GME,
+    MOD_ENC,
+    MOD_LPF,
+    MOD_CDEF_SEARCH,
+    MOD_CDEF,
+    MOD_LR,
+    MOD_PACK_BS,
+    MOD_METRICS,
+  };
+  if (cpi == NULL) return;
+  for (int i = 0; i < AOM_ENC_STAGE_COUNT; ++i)
+    times->time_us[i] += (int64_t)cpi->module_time[stage_module[i]];
+}
+
+static aom_codec_err_t ctrl_get_stage_times(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  aom_enc_stage_times_t *const times = va_arg(args, aom_enc_stage_times_t *);
+  if (times == NULL) return AOM_CODEC_INVALID_PARAM;
+  const AV1_PRIMARY *const ppi = ctx->ppi;
+  av1_zero(*times);
+  for (int i = 0; i < ppi->num_fp_contexts; ++i)
+    add_stage_times(ppi->parallel_cpi[i], times);
+  add_stage_times(ppi->cpi_lap, times);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_frame_time_budget(aom_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  ctx->ppi->cpi->time_budget.budget_us =
+      CAST(AV1E_SET_FRAME_TIME_BUDGET, args);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_frame_time_stats(aom_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  aom_enc_frame_time_stats_t *const stats =
+      va_arg(args, aom_enc_frame_time_stats_t *);
+  if (stats == NULL) return AOM_CODEC_INVALID_PARAM;
+  *stats = ctx->ppi->cpi->time_budget.stats;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_encode_chunks(aom_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  aom_encode_chunks_t *const arg = va_arg(args, aom_encode_chunks_t *);
+  if (arg == NULL || ctx->cfg.g_pass != AOM_RC_LAST_PASS)
+    return AOM_CODEC_INVALID_PARAM;
+  AV1ChunkSplitCfg split_cfg;
+  split_cfg.frame_width = ctx->cfg.g_w;
+  split_cfg.frame_height = ctx->cfg.g_h;
+  split_cfg.rc_mode = ctx->cfg.rc_end_usage;
+  split_cfg.vbrbias = ctx->cfg.rc_2pass_vbr_bias_pct;
+  split_cfg.vbrmin_section = ctx->cfg.rc_2pass_vbr_minsection_pct;
+  split_cfg.vbrmax_section = ctx->cfg.rc_2pass_vbr_maxsection_pct;
+  split_cfg.min_chunk_frames = arg->min_chunk_frames;
+  split_cfg.max_chunk_frames = arg->max_chunk_frames;
+  split_cfg.min_num_chunks = arg->min_num_chunks;
+  const int num_chunks =
+      av1_split_encode_chunks(&ctx->cfg.rc_twopass_stats_in, &split_cfg,
+                              arg->chunks, arg->max_chunks);
+  if (num_chunks < 0) return AOM_CODEC_INVALID_PARAM;
+  arg->num_chunks = num_chunks;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_encode_chunk_stats(aom_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  aom_encode_chunk_stats_t *const arg =
+      va_arg(args, aom_encode_chunk_stats_t *);
+  if (arg == NULL || ctx->cfg.g_pass != AOM_RC_LAST_PASS)
+    return AOM_CODEC_INVALID_PARAM;
+  if (av1_get_chunk_stats(&ctx->cfg.rc_twopass_stats_in, &arg->chunk,
+                          &arg->stats))
+    return AOM_CODEC_INVALID_PARAM;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_tile_group_output_cb(aom_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  const aom_tile_group_output_cb_t *const cb =
+      va_arg(args, aom_tile_group_output_cb_t *);
+  if (cb == NULL) {
+    av1_zero(ctx->tg_output_cb);
+  } else {
+    ctx->tg_output_cb = *cb;
+  }
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1_COPY_REFERENCE, ctrl_copy_reference },
   { AOME_USE_REFERENCE, ctrl_use_reference },
@@ -4541,6 +4768,16 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_GET_BASELINE_GF_INTERVAL, ctrl_get_baseline_gf_interval },
   { AV1E_GET_TARGET_SEQ_LEVEL_IDX, ctrl_get_target_seq_level_idx },
   { AV1E_GET_NUM_OPERATING_POINTS, ctrl_get_num_operating_points },
+  { AV1E_SET_TILE_GROUP_OUTPUT_CB, ctrl_set_tile_group_output_cb },
+  { AV1E_SET_ASYNC_PSNR, ctrl_set_async_psnr },
+  { AV1E_GET_STAGE_TIMES, ctrl_get_stage_times },
+  { AV1E_SET_SVC_REUSE_LOWER_LAYER_MV, ctrl_set_svc_reuse_lower_layer_mv },
+  { AV1E_SET_DIRTY_RECTS, ctrl_set_dirty_rects },
+  { AV1E_SET_DENOISE_PREPASS, ctrl_set_denoise_prepass },
+  { AV1E_SET_FRAME_TIME_BUDGET, ctrl_set_frame_time_budget },
+  { AV1E_GET_FRAME_TIME_STATS, ctrl_get_frame_time_stats },
+  { AV1E_GET_ENCODE_CHUNKS, ctrl_get_encode_chunks },
+  { AV1E_GET_ENCODE_CHUNK_STATS, ctrl_get_encode_chunk_stats },
 
   CTRL_MAP_END,
 };
@@ -57,6 +57,8 @@ struct aom_codec_alg_priv {
   unsigned int is_annexb;
   int operating_point;
   int output_all_layers;
+  int partial_input;
+  aom_row_output_cb_t row_output_cb;
 
   AVxWorker *frame_worker;
 
@@ -488,6 +490,17 @@ static INLINE void check_resync(aom_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+// Hands rows that became final in the frame being decoded to the application.
+static void decoder_row_output(void *priv, const YV12_BUFFER_CONFIG *buf,
+                               int row_start, int row_end) {
+  aom_codec_alg_priv_t *const ctx = (aom_codec_alg_priv_t *)priv;
+  aom_image_t img;
+  yuvconfig2image(&img, buf, NULL);
+  ctx->row_output_cb.output_rows(ctx->row_output_cb.user_priv, &img,
+                                 (unsigned int)row_start,
+                                 (unsigned int)row_end);
+}
+
 static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
                                   const uint8_t **data, size_t data_sz,
                                   void *user_priv) {
@@ -519,6 +532,11 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
   frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
   frame_worker_data->pbi->row_mt = ctx->row_mt;
   frame_worker_data->pbi->ext_refs = ctx->ext_refs;
+  frame_worker_data->pbi->partial_input =
+      ctx->partial_input && !ctx->is_annexb && !ctx->tile_mode;
+  frame_worker_data->pbi->row_output_cb =
+      ctx->row_output_cb.output_rows != NULL ? decoder_row_output : NULL;
+  frame_worker_data->pbi->row_output_priv = ctx;
 
   frame_worker_data->pbi->is_annexb = ctx->is_annexb;
 
@@ -675,6 +693,9 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
     res = init_decoder(ctx);
     if (res != AOM_CODEC_OK) return res;
   }
+  FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_worker->data1;
+  av1_reset_frame_times(frame_worker_data->pbi);
 
   const uint8_t *data_start = data;
   const uint8_t *data_end = data + data_sz;
@@ -812,11 +833,13 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
         RefCntBuffer *const output_frame_buf = pbi->output_frames[*index];
         ctx->last_show_frame = output_frame_buf;
         if (ctx->need_resync) return NULL;
+        av1_start_stage_timer(pbi, AOM_DEC_STAGE_OUTPUT);
         aom_img_remove_metadata(&ctx->img);
         yuvconfig2image(&ctx->img, sd, frame_worker_data->user_priv);
         move_decoder_metadata_to_img(pbi, &ctx->img);
 
         if (!pbi->ext_tile_debug && tiles->large_scale) {
+          av1_end_stage_timer(pbi, AOM_DEC_STAGE_OUTPUT);
           *index += 1;  // Advance the iterator to point to the next image
           aom_img_remove_metadata(&ctx->img);
           yuvconfig2image(&ctx->img, &pbi->tile_list_outbuf, NULL);
@@ -869,9 +892,12 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
         img = &ctx->img;
         img->temporal_id = output_frame_buf->temporal_id;
         img->spatial_id = output_frame_buf->spatial_id;
+        av1_end_stage_timer(pbi, AOM_DEC_STAGE_OUTPUT);
         if (pbi->skip_film_grain) grain_params->apply_grain = 0;
+        av1_start_stage_timer(pbi, AOM_DEC_STAGE_FILM_GRAIN);
         aom_image_t *res =
             add_grain_if_needed(ctx, img, &ctx->image_with_grain, grain_params);
+        av1_end_stage_timer(pbi, AOM_DEC_STAGE_FILM_GRAIN);
         if (!res) {
           aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
                              "Grain systhesis failed\n");
@@ -1628,6 +1654,44 @@ static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_partial_input(aom_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  ctx->partial_input = va_arg(args, int);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_row_output_cb(aom_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  const aom_row_output_cb_t *const cb = va_arg(args, aom_row_output_cb_t *);
+  if (cb == NULL) {
+    memset(&ctx->row_output_cb, 0, sizeof(ctx->row_output_cb));
+  } else {
+    ctx->row_output_cb = *cb;
+  }
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_frame_times(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  aom_dec_frame_times_t *const out = va_arg(args, aom_dec_frame_times_t *);
+  if (out == NULL || out->tile_time_us_size < 0 ||
+      (out->tile_time_us == NULL && out->tile_time_us_size > 0)) {
+    return AOM_CODEC_INVALID_PARAM;
+  }
+  if (ctx->frame_worker == NULL) return AOM_CODEC_ERROR;
+  const FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_worker->data1;
+  const DecFrameTimes *const times = &frame_worker_data->pbi->frame_times;
+  memcpy(out->time_us, times->stage_time_us, sizeof(out->time_us));
+  out->worker_idle_us = times->worker_idle_us;
+  out->num_frames = times->num_frames;
+  out->num_tiles = times->num_tiles;
+  const int num_tiles = AOMMIN(out->tile_time_us_size, times->num_tiles);
+  for (int i = 0; i < num_tiles; ++i)
+    out->tile_time_us[i] = times->tile_time_us[i];
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -1645,6 +1709,8 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_SET_INSPECTION_CALLBACK, ctrl_set_inspection_callback },
   { AV1D_EXT_TILE_DEBUG, ctrl_ext_tile_debug },
   { AV1D_SET_ROW_MT, ctrl_set_row_mt },
+  { AV1D_SET_PARTIAL_INPUT, ctrl_set_partial_input },
+  { AV1D_SET_ROW_OUTPUT_CB, ctrl_set_row_output_cb },
   { AV1D_SET_EXT_REF_PTR, ctrl_set_ext_ref_ptr },
   { AV1D_SET_SKIP_FILM_GRAIN, ctrl_set_skip_film_grain },
 
@@ -1677,6 +1743,7 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AOMD_GET_BASE_Q_IDX, ctrl_get_base_q_idx },
   { AOMD_GET_ORDER_HINT, ctrl_get_order_hint },
   { AV1D_GET_MI_INFO, ctrl_get_mi_info },
+  { AV1D_GET_FRAME_TIMES, ctrl_get_frame_times },
   CTRL_MAP_END,
 };
 
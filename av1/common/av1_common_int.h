@@ -1054,6 +1054,12 @@ typedef struct AV1Common {
    */
   int extend_border_mt[MAX_MB_PLANE];
 
+  /*!
+   * If not NULL, the last in-loop filter stage of the frame reports the rows
+   * it has finished here.
+   */
+  struct AV1FilterRowProgress *filter_row_progress;
+
 #if TXCOEFF_TIMER
   int64_t cum_txcoeff_timer;
   int64_t txcoeff_timer;
@@ -220,6 +220,13 @@ typedef struct {
 /*! \brief Stores the prediction/txfm mode of the current coding block
  */
 typedef struct MB_MODE_INFO {
+  /* The fields up to and including cdef_strength are the ones read when
+   * neighboring blocks are scanned (mv reference search, context derivation,
+   * loop filter level and transform edge lookup). They are kept together at
+   * the start of the struct so that such a scan touches as few cache lines per
+   * neighbor as possible. Fields only needed to reconstruct the block itself
+   * follow. */
+
   /*****************************************************************************
    * \name General Info of the Coding Block
    ****************************************************************************/
@@ -248,36 +255,6 @@ typedef struct MB_MODE_INFO {
   int_interpfilters interp_filters;
   /*! \brief The motion mode used by the inter prediction. */
   MOTION_MODE motion_mode;
-  /*! \brief Number of samples used by warp causal */
-  uint8_t num_proj_ref;
-  /*! \brief The number of overlapped neighbors above/left for obmc/warp motion
-   * mode. */
-  uint8_t overlappable_neighbors;
-  /*! \brief The parameters used in warp motion mode. */
-  WarpedMotionParams wm_params;
-  /*! \brief The type of intra mode used by inter-intra */
-  INTERINTRA_MODE interintra_mode;
-  /*! \brief The type of wedge used in interintra mode. */
-  int8_t interintra_wedge_index;
-  /*! \brief Struct that stores the data used in interinter compound mode. */
-  INTERINTER_COMPOUND_DATA interinter_comp;
-  /**@}*/
-
-  /*****************************************************************************
-   * \name Intra Mode Info
-   ****************************************************************************/
-  /**@{*/
-  /*! \brief Directional mode delta: the angle is base angle + (angle_delta *
-   * step). */
-  int8_t angle_delta[PLANE_TYPES];
-  /*! \brief The type of filter intra mode used (if applicable). */
-  FILTER_INTRA_MODE_INFO filter_intra_mode_info;
-  /*! \brief Chroma from Luma: Joint sign of alpha Cb and alpha Cr */
-  int8_t cfl_alpha_signs;
-  /*! \brief Chroma from Luma: Index of the alpha Cb and alpha Cr combination */
-  uint8_t cfl_alpha_idx;
-  /*! \brief Stores the size and colors of palette mode */
-  PALETTE_MODE_INFO palette_mode_info;
   /**@}*/
 
   /*****************************************************************************
@@ -328,6 +305,42 @@ typedef struct MB_MODE_INFO {
   /*! \brief CDEF strength per BLOCK_64X64 */
   int8_t cdef_strength;
 
+  /*****************************************************************************
+   * \name Inter Prediction Parameters
+   ****************************************************************************/
+  /**@{*/
+  /*! \brief Number of samples used by warp causal */
+  uint8_t num_proj_ref;
+  /*! \brief The number of overlapped neighbors above/left for obmc/warp motion
+   * mode. */
+  uint8_t overlappable_neighbors;
+  /*! \brief The parameters used in warp motion mode. */
+  WarpedMotionParams wm_params;
+  /*! \brief The type of intra mode used by inter-intra */
+  INTERINTRA_MODE interintra_mode;
+  /*! \brief The type of wedge used in interintra mode. */
+  int8_t interintra_wedge_index;
+  /*! \brief Struct that stores the data used in interinter compound mode. */
+  INTERINTER_COMPOUND_DATA interinter_comp;
+  /**@}*/
+
+  /*****************************************************************************
+   * \name Intra Mode Info
+   ****************************************************************************/
+  /**@{*/
+  /*! \brief Directional mode delta: the angle is base angle + (angle_delta *
+   * step). */
+  int8_t angle_delta[PLANE_TYPES];
+  /*! \brief The type of filter intra mode used (if applicable). */
+  FILTER_INTRA_MODE_INFO filter_intra_mode_info;
+  /*! \brief Chroma from Luma: Joint sign of alpha Cb and alpha Cr */
+  int8_t cfl_alpha_signs;
+  /*! \brief Chroma from Luma: Index of the alpha Cb and alpha Cr combination */
+  uint8_t cfl_alpha_idx;
+  /*! \brief Stores the size and colors of palette mode */
+  PALETTE_MODE_INFO palette_mode_info;
+  /**@}*/
+
 #if CONFIG_RD_DEBUG
   /*! \brief RD info used for debugging */
   RD_STATS rd_stats;
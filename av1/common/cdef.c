@@ -20,6 +20,7 @@
 #include "av1/common/cdef.h"
 #include "av1/common/cdef_block.h"
 #include "av1/common/reconinter.h"
+#include "av1/common/thread_common.h"
 
 static int is_8x8_block_skip(MB_MODE_INFO **grid, int mi_row, int mi_col,
                              int mi_stride) {
@@ -421,6 +422,14 @@ void av1_cdef_fb_row(const AV1_COMMON *const cm, MACROBLOCKD *xd,
       fb_info.frame_boundary[RIGHT] = 1;
     cdef_fb_col(cm, xd, &fb_info, colbuf, &cdef_left[0], fbc, fbr);
   }
+
+  const int num_planes = av1_num_planes(cm);
+  for (int plane = 0; plane < num_planes; ++plane) {
+    const int mi_high_l2 = MI_SIZE_LOG2 - xd->plane[plane].subsampling_y;
+    av1_filter_row_progress_mark(cm->filter_row_progress, plane,
+                                 (MI_SIZE_64X64 * fbr) << mi_high_l2,
+                                 (MI_SIZE_64X64 * (fbr + 1)) << mi_high_l2);
+  }
 }
 
 // Perform CDEF on input frame.
@@ -437,6 +446,8 @@ void av1_cdef_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *const cm,
 
   av1_setup_dst_planes(xd->plane, cm->seq_params->sb_size, frame, 0, 0, 0,
                        num_planes);
+  static const int kAllPlanes[MAX_MB_PLANE] = { 1, 1, 1 };
+  av1_filter_row_progress_reset(cm->filter_row_progress, cm, kAllPlanes, 0, 0);
 
   for (int fbr = 0; fbr < nvfb; fbr++)
     av1_cdef_fb_row(cm, xd, cm->cdef_info.linebuf, cm->cdef_info.colbuf,
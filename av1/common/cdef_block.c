@@ -280,18 +280,6 @@ void cdef_filter_16_3_c(void *dst16, int dstride, const uint16_t *in,
                              /*enable_primary=*/0, /*enable_secondary=*/0);
 }
 
-/* Compute the primary filter strength for an 8x8 block based on the
-   directional variance difference. A high variance difference means
-   that we have a highly directional pattern (e.g. a high contrast
-   edge), so we can apply more deringing. A low variance means that we
-   either have a low contrast edge, or a non-directional texture, so
-   we want to be careful not to blur. */
-static INLINE int adjust_strength(int strength, int32_t var) {
-  const int i = var >> 6 ? AOMMIN(get_msb(var >> 6), 12) : 0;
-  /* We use the variance of 8x8 blocks to adjust the strength. */
-  return var ? (strength * (4 + i) + 8) >> 4 : 0;
-}
-
 static AOM_INLINE void aom_cdef_find_dir(uint16_t *in, cdef_list *dlist,
                                          int var[CDEF_NBLOCKS][CDEF_NBLOCKS],
                                          int cdef_count, int coeff_shift,
@@ -10,6 +10,7 @@
  *
  */
 
+#include <limits.h>
 #include <math.h>
 
 #include "config/aom_config.h"
@@ -20,6 +21,7 @@
 #include "av1/common/av1_common_int.h"
 #include "av1/common/resize.h"
 #include "av1/common/restoration.h"
+#include "av1/common/thread_common.h"
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_mem/aom_mem.h"
 
@@ -1125,6 +1127,7 @@ void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
   lr_ctxt->on_rest_unit = filter_frame_on_unit;
   lr_ctxt->frame = frame;
   lr_ctxt->cm = cm;
+  int planes_to_lr[MAX_MB_PLANE] = { 0, 0, 0 };
   for (int plane = 0; plane < num_planes; ++plane) {
     RestorationInfo *rsi = &cm->rst_info[plane];
     RestorationType rtype = rsi->frame_restoration_type;
@@ -1133,6 +1136,7 @@ void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
     if (rtype == RESTORE_NONE) {
       continue;
     }
+    planes_to_lr[plane] = 1;
 
     const int is_uv = plane > 0;
     const int plane_width = frame->crop_widths[is_uv];
@@ -1156,6 +1160,8 @@ void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
     lr_plane_ctxt->tile_rect = av1_whole_frame_rect(cm, is_uv);
     lr_plane_ctxt->tile_stripe0 = 0;
   }
+  av1_filter_row_progress_reset(cm->filter_row_progress, cm, planes_to_lr, 0,
+                                0);
 }
 
 void av1_loop_restoration_copy_planes(AV1LrStruct *loop_rest_ctxt,
@@ -1190,6 +1196,72 @@ static void foreach_rest_unit_in_planes(AV1LrStruct *lr_ctxt, AV1_COMMON *cm,
   }
 }
 
+// Filters the restoration unit rows of all planes from the top of the frame
+// down, and copies the rows of each plane that the unit rows below no longer
+// read to the frame as it goes, so that they can be reported as final.
+static void foreach_rest_unit_row_in_planes(AV1LrStruct *lr_ctxt,
+                                            AV1_COMMON *cm, int num_planes) {
+  typedef void (*copy_fun)(const YV12_BUFFER_CONFIG *src_ybc,
+                           YV12_BUFFER_CONFIG *dst_ybc, int hstart, int hend,
+                           int vstart, int vend);
+  static const copy_fun copy_funs[3] = { aom_yv12_partial_coloc_copy_y,
+                                         aom_yv12_partial_coloc_copy_u,
+                                         aom_yv12_partial_coloc_copy_v };
+  FilterFrameCtxt *ctxt = lr_ctxt->ctxt;
+  int y0[MAX_MB_PLANE] = { 0, 0, 0 };
+  int unit_row[MAX_MB_PLANE] = { 0, 0, 0 };
+  int rows_copied[MAX_MB_PLANE] = { 0, 0, 0 };
+
+  while (1) {
+    // Pick the plane whose next unit row is highest in the frame.
+    int plane = -1;
+    int plane_top = INT_MAX;
+    for (int p = 0; p < num_planes; ++p) {
+      if (cm->rst_info[p].frame_restoration_type == RESTORE_NONE) continue;
+      const AV1PixelRect *tile_rect = &ctxt[p].tile_rect;
+      if (y0[p] >= tile_rect->bottom - tile_rect->top) continue;
+      if ((y0[p] << ctxt[p].ss_y) < plane_top) {
+        plane_top = y0[p] << ctxt[p].ss_y;
+        plane = p;
+      }
+    }
+    if (plane < 0) break;
+
+    const RestorationInfo *rsi = &cm->rst_info[plane];
+    const AV1PixelRect *tile_rect = &ctxt[plane].tile_rect;
+    const int unit_size = rsi->restoration_unit_size;
+    const int remaining_h = tile_rect->bottom - tile_rect->top - y0[plane];
+    const int h = (remaining_h < unit_size * 3 / 2) ? remaining_h : unit_size;
+
+    RestorationTileLimits limits;
+    limits.v_start = tile_rect->top + y0[plane];
+    limits.v_end = tile_rect->top + y0[plane] + h;
+    // Offset the tile upwards to align with the restoration processing stripe
+    const int voffset = RESTORATION_UNIT_OFFSET >> ctxt[plane].ss_y;
+    limits.v_start = AOMMAX(tile_rect->top, limits.v_start - voffset);
+    if (limits.v_end < tile_rect->bottom) limits.v_end -= voffset;
+
+    av1_foreach_rest_unit_in_row(
+        &limits, tile_rect, lr_ctxt->on_rest_unit, unit_row[plane],
+        unit_size, 0, rsi->horz_units_per_tile, rsi->vert_units_per_tile,
+        plane, &ctxt[plane], cm->rst_tmpbuf, cm->rlbs, av1_lr_sync_read_dummy,
+        av1_lr_sync_write_dummy, NULL);
+
+    // The next unit row reads up to RESTORATION_BORDER rows above it.
+    const int copy_end = limits.v_end == tile_rect->bottom
+                             ? tile_rect->bottom
+                             : limits.v_end - RESTORATION_BORDER;
+    copy_funs[plane](lr_ctxt->dst, lr_ctxt->frame, tile_rect->left,
+                     tile_rect->right, rows_copied[plane], copy_end);
+    av1_filter_row_progress_mark(cm->filter_row_progress, plane,
+                                 rows_copied[plane], copy_end);
+    rows_copied[plane] = copy_end;
+
+    y0[plane] += h;
+    ++unit_row[plane];
+  }
+}
+
 void av1_loop_restoration_filter_frame(YV12_BUFFER_CONFIG *frame,
                                        AV1_COMMON *cm, int optimized_lr,
                                        void *lr_ctxt) {
@@ -1202,6 +1274,11 @@ void av1_loop_restoration_filter_frame(YV12_BUFFER_CONFIG *frame,
                                          optimized_lr, num_planes,
                                          /* do_extend_border_mt */ 0);
 
+  if (cm->filter_row_progress != NULL) {
+    foreach_rest_unit_row_in_planes(loop_rest_ctxt, cm, num_planes);
+    return;
+  }
+
   foreach_rest_unit_in_planes(loop_rest_ctxt, cm, num_planes);
 
   av1_loop_restoration_copy_planes(loop_rest_ctxt, cm, num_planes);
@@ -177,6 +177,88 @@ void av1_free_cdef_sync(AV1CdefSync *cdef_sync) {
 #endif  // CONFIG_MULTITHREAD
 }
 
+void av1_filter_row_progress_dealloc(AV1FilterRowProgress *progress) {
+  if (progress == NULL) return;
+#if CONFIG_MULTITHREAD
+  if (progress->mutex_ != NULL) {
+    pthread_mutex_destroy(progress->mutex_);
+    aom_free(progress->mutex_);
+  }
+#endif  // CONFIG_MULTITHREAD
+  for (int plane = 0; plane < MAX_MB_PLANE; ++plane)
+    aom_free(progress->row_done[plane]);
+  av1_zero(*progress);
+}
+
+void av1_filter_row_progress_reset(AV1FilterRowProgress *progress,
+                                   AV1_COMMON *cm, const int planes[3],
+                                   int lag_y, int lag_uv) {
+  if (progress == NULL) return;
+#if CONFIG_MULTITHREAD
+  if (progress->mutex_ == NULL) {
+    CHECK_MEM_ERROR(cm, progress->mutex_,
+                    aom_malloc(sizeof(*(progress->mutex_))));
+    if (progress->mutex_) pthread_mutex_init(progress->mutex_, NULL);
+  }
+#endif  // CONFIG_MULTITHREAD
+  if (cm->height > progress->alloc_rows) {
+    for (int plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      aom_free(progress->row_done[plane]);
+      CHECK_MEM_ERROR(cm, progress->row_done[plane],
+                      aom_malloc(cm->height * sizeof(*progress->row_done[0])));
+    }
+    progress->alloc_rows = cm->height;
+  }
+
+  const int num_planes = av1_num_planes(cm);
+  progress->luma_rows = cm->height;
+  progress->rows_reported = 0;
+  for (int plane = 0; plane < MAX_MB_PLANE; ++plane) {
+    const int ss_y = plane > 0 && cm->seq_params->subsampling_y;
+    progress->ss_y[plane] = ss_y;
+    progress->plane_rows[plane] = (cm->height + ss_y) >> ss_y;
+    progress->lag[plane] = plane ? lag_uv : lag_y;
+    // Planes the stage leaves alone are final already.
+    progress->frontier[plane] = (plane < num_planes && planes[plane])
+                                    ? 0
+                                    : progress->plane_rows[plane];
+    memset(progress->row_done[plane], 0,
+           progress->plane_rows[plane] * sizeof(*progress->row_done[0]));
+  }
+}
+
+void av1_filter_row_progress_mark(AV1FilterRowProgress *progress, int plane,
+                                  int row_start, int row_end) {
+  if (progress == NULL) return;
+  row_start = AOMMAX(row_start, 0);
+  row_end = AOMMIN(row_end, progress->plane_rows[plane]);
+  if (row_start >= row_end) return;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(progress->mutex_);
+#endif  // CONFIG_MULTITHREAD
+  memset(progress->row_done[plane] + row_start, 1,
+         (row_end - row_start) * sizeof(*progress->row_done[0]));
+  int *const frontier = &progress->frontier[plane];
+  while (*frontier < progress->plane_rows[plane] &&
+         progress->row_done[plane][*frontier])
+    ++*frontier;
+
+  int rows = progress->luma_rows;
+  for (int p = 0; p < MAX_MB_PLANE; ++p) {
+    if (progress->frontier[p] == progress->plane_rows[p]) continue;
+    const int final_rows = AOMMAX(progress->frontier[p] - progress->lag[p], 0);
+    rows = AOMMIN(rows, final_rows << progress->ss_y[p]);
+  }
+  if (rows > progress->rows_reported) {
+    progress->rows_reported = rows;
+    progress->rows_done(progress->rows_done_priv, rows);
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(progress->mutex_);
+#endif  // CONFIG_MULTITHREAD
+}
+
 static INLINE void cdef_row_mt_sync_read(AV1CdefSync *const cdef_sync,
                                          int row) {
   if (!row) return;
@@ -399,6 +481,14 @@ static INLINE void thread_loop_filter_rows(
                                     mi_col);
       }
     }
+    // The rows of the superblock row are filtered, but for the bottom rows
+    // that the edges of the next one modify, see the lag of the progress.
+    for (int p = plane; p < plane + num_planes; ++p) {
+      const int ss_y = planes[p].subsampling_y;
+      av1_filter_row_progress_mark(
+          cm->filter_row_progress, p, (mi_row * MI_SIZE) >> ss_y,
+          ((mi_row + MAX_MIB_SIZE) * MI_SIZE) >> ss_y);
+    }
   }
 }
 
@@ -519,6 +609,10 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   }
   end_mi_row = start_mi_row + mi_rows_to_filter;
   av1_loop_filter_frame_init(cm, plane_start, plane_end);
+  // The deblocking filters modify at most 6 luma and 2 chroma rows on each
+  // side of an edge.
+  av1_filter_row_progress_reset(cm->filter_row_progress, cm, planes_to_lf,
+                                8, 4);
 
   if (num_workers > 1) {
     // Enqueue and execute loopfiltering jobs.
@@ -845,6 +939,9 @@ static int loop_restoration_row_worker(void *arg1, void *arg2) {
       copy_funs[plane](lr_ctxt->dst, lr_ctxt->frame, ctxt[plane].tile_rect.left,
                        ctxt[plane].tile_rect.right, cur_job_info->v_copy_start,
                        cur_job_info->v_copy_end);
+      av1_filter_row_progress_mark(lr_ctxt->cm->filter_row_progress, plane,
+                                   cur_job_info->v_copy_start,
+                                   cur_job_info->v_copy_end);
 
       if (lr_ctxt->cm->extend_border_mt[plane]) {
         aom_extend_frame_borders_plane_row(lr_ctxt->frame, plane,
@@ -1143,6 +1240,9 @@ void av1_cdef_frame_mt(AV1_COMMON *const cm, MACROBLOCKD *const xd,
   av1_setup_dst_planes(xd->plane, cm->seq_params->sb_size, frame, 0, 0, 0,
                        num_planes);
 
+  static const int kAllPlanes[MAX_MB_PLANE] = { 1, 1, 1 };
+  av1_filter_row_progress_reset(cm->filter_row_progress, cm, kAllPlanes, 0, 0);
+
   reset_cdef_job_info(cdef_sync);
   prepare_cdef_frame_workers(cm, xd, cdef_worker, cdef_sb_row_worker_hook,
                              workers, cdef_sync, num_workers,
@@ -132,6 +132,43 @@ typedef struct AV1CdefSyncData {
   int fbc;
 } AV1CdefSync;
 
+// Tracks the rows of each plane that the last in-loop filter stage of a frame
+// has finished, in any order, and reports the luma rows that are final in all
+// planes from the top of the frame down.
+typedef struct AV1FilterRowProgress {
+#if CONFIG_MULTITHREAD
+  // Serializes marking and the calls to rows_done.
+  pthread_mutex_t *mutex_;
+#endif  // CONFIG_MULTITHREAD
+  // Set for each finished row of each plane.
+  uint8_t *row_done[MAX_MB_PLANE];
+  int alloc_rows;
+  int plane_rows[MAX_MB_PLANE];
+  int ss_y[MAX_MB_PLANE];
+  // Number of rows of each plane finished from the top of the frame.
+  int frontier[MAX_MB_PLANE];
+  // Number of rows above the frontier of each plane that the stage may still
+  // modify.
+  int lag[MAX_MB_PLANE];
+  int luma_rows;
+  int rows_reported;
+  // Called with the number of luma rows that are final, each time it grows.
+  void (*rows_done)(void *priv, int row_end);
+  void *rows_done_priv;
+} AV1FilterRowProgress;
+
+void av1_filter_row_progress_dealloc(AV1FilterRowProgress *progress);
+
+// Starts tracking a filter stage that writes the planes set in planes[];
+// the other planes are final already. A no-op if progress is NULL.
+void av1_filter_row_progress_reset(AV1FilterRowProgress *progress,
+                                   AV1_COMMON *cm, const int planes[3],
+                                   int lag_y, int lag_uv);
+
+// Marks rows [row_start, row_end) of the plane as finished by the stage.
+void av1_filter_row_progress_mark(AV1FilterRowProgress *progress, int plane,
+                                  int row_start, int row_end);
+
 void av1_cdef_frame_mt(AV1_COMMON *const cm, MACROBLOCKD *const xd,
                        AV1CdefWorkerData *const cdef_worker,
                        AVxWorker *const workers, AV1CdefSync *const cdef_sync,
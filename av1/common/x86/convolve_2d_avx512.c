@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/aom_filter.h"
+#include "aom_ports/mem.h"
+#include "av1/common/convolve.h"
+#include "av1/common/filter.h"
+
+// Returns the number of taps of the 8-tap kernel that are not zero on both
+// sides, like av1_convolve_2d_sr_avx2().
+static INLINE int get_filter_taps(const int16_t *filter) {
+  if (!(filter[0] | filter[1] | filter[6] | filter[7])) return 4;
+  if (!(filter[0] | filter[7])) return 6;
+  return 8;
+}
+
+// Filters 32 pixels of a row horizontally into 16-bit values. coeffs[] hold
+// the pairs of taps halved to fit in signed bytes, which all the 8-bit
+// filters allow since their taps are even; the rounding shift makes up for
+// it.
+static INLINE __m512i convolve_x_32_avx512(const uint8_t *src, int pairs,
+                                           const __m512i *coeffs,
+                                           const __m512i round_const,
+                                           const __m128i round_shift) {
+  // Each 128-bit lane filters 8 pixels from the 8 + 2 * pairs - 1 pixels
+  // starting at its first one.
+  const __m256i a = _mm256_loadu_si256((const __m256i *)src);
+  const __m256i b = _mm256_maskz_loadu_epi8((1u << (23 + 2 * pairs)) - 1,
+                                            src + 8);
+  const __m512i ab = _mm512_inserti64x4(_mm512_castsi256_si512(a), b, 1);
+  const __m512i s = _mm512_shuffle_i64x2(ab, ab, 0xd8);
+  // Pixels j and j + 1 of each lane.
+  __m512i filt = _mm512_broadcast_i32x4(
+      _mm_setr_epi8(0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8));
+  __m512i sum = round_const;
+  for (int i = 0; i < pairs; ++i) {
+    sum = _mm512_add_epi16(
+        sum, _mm512_maddubs_epi16(_mm512_shuffle_epi8(s, filt), coeffs[i]));
+    filt = _mm512_add_epi8(filt, _mm512_set1_epi8(2));
+  }
+  return _mm512_sra_epi16(sum, round_shift);
+}
+
+static INLINE __m512i madd_pairs_avx512(const __m512i *s, int pairs,
+                                        const __m512i *coeffs, __m512i sum) {
+  for (int i = 0; i < pairs; ++i)
+    sum = _mm512_add_epi32(sum, _mm512_madd_epi16(s[i], coeffs[i]));
+  return sum;
+}
+
+// Filters a column of 32 pixels of the intermediate block vertically, two
+// rows at a time, and stores the 8-bit result. s[] hold the interleaved rows
+// of the taps of the even output rows and t[] those of the odd ones.
+static AOM_FORCE_INLINE void convolve_y_32_avx512(
+    const int16_t *im, int im_stride, uint8_t *dst, int dst_stride, int h,
+    int pairs, const __m512i *coeffs, const __m512i sum_round,
+    const __m128i sum_shift, const __m512i round_const,
+    const __m128i round_shift) {
+  const int taps = 2 * pairs;
+  __m512i s_lo[4], s_hi[4], t_lo[4], t_hi[4];
+  __m512i r[SUBPEL_TAPS];
+  for (int i = 0; i < taps - 1; ++i)
+    r[i] = _mm512_load_si512(im + i * im_stride);
+  for (int i = 0; i < pairs - 1; ++i) {
+    s_lo[i] = _mm512_unpacklo_epi16(r[2 * i], r[2 * i + 1]);
+    s_hi[i] = _mm512_unpackhi_epi16(r[2 * i], r[2 * i + 1]);
+    t_lo[i] = _mm512_unpacklo_epi16(r[2 * i + 1], r[2 * i + 2]);
+    t_hi[i] = _mm512_unpackhi_epi16(r[2 * i + 1], r[2 * i + 2]);
+  }
+  __m512i last = r[taps - 2];
+  im += (taps - 1) * im_stride;
+
+  for (int y = 0; y < h; y += 2) {
+    const __m512i r0 = _mm512_load_si512(im);
+    const __m512i r1 = _mm512_load_si512(im + im_stride);
+    s_lo[pairs - 1] = _mm512_unpacklo_epi16(last, r0);
+    s_hi[pairs - 1] = _mm512_unpackhi_epi16(last, r0);
+    t_lo[pairs - 1] = _mm512_unpacklo_epi16(r0, r1);
+    t_hi[pairs - 1] = _mm512_unpackhi_epi16(r0, r1);
+    last = r1;
+    im += 2 * im_stride;
+
+    __m512i res[4] = {
+      madd_pairs_avx512(s_lo, pairs, coeffs, sum_round),
+      madd_pairs_avx512(s_hi, pairs, coeffs, sum_round),
+      madd_pairs_avx512(t_lo, pairs, coeffs, sum_round),
+      madd_pairs_avx512(t_hi, pairs, coeffs, sum_round),
+    };
+    for (int i = 0; i < 4; ++i) {
+      res[i] = _mm512_sra_epi32(res[i], sum_shift);
+      res[i] = _mm512_sra_epi32(_mm512_add_epi32(res[i], round_const),
+                                round_shift);
+    }
+    // Packing undoes the interleaving of the unpacks.
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i row0 =
+        _mm512_max_epi16(_mm512_packs_epi32(res[0], res[1]), zero);
+    const __m512i row1 =
+        _mm512_max_epi16(_mm512_packs_epi32(res[2], res[3]), zero);
+    _mm256_storeu_si256((__m256i *)dst, _mm512_cvtusepi16_epi8(row0));
+    _mm256_storeu_si256((__m256i *)(dst + dst_stride),
+                        _mm512_cvtusepi16_epi8(row1));
+    dst += 2 * dst_stride;
+
+    for (int i = 0; i < pairs - 1; ++i) {
+      s_lo[i] = s_lo[i + 1];
+      s_hi[i] = s_hi[i + 1];
+      t_lo[i] = t_lo[i + 1];
+      t_hi[i] = t_hi[i + 1];
+    }
+  }
+}
+
+void av1_convolve_2d_sr_avx512(const uint8_t *src, int src_stride,
+                               uint8_t *dst, int dst_stride, int w, int h,
+                               const InterpFilterParams *filter_params_x,
+                               const InterpFilterParams *filter_params_y,
+                               const int subpel_x_qn, const int subpel_y_qn,
+                               ConvolveParams *conv_params) {
+  // Narrow blocks and the 12-tap filters are left to the AVX2 version.
+  if (w < 32 || filter_params_x->taps != SUBPEL_TAPS ||
+      filter_params_y->taps != SUBPEL_TAPS) {
+    av1_convolve_2d_sr_avx2(src, src_stride, dst, dst_stride, w, h,
+                            filter_params_x, filter_params_y, subpel_x_qn,
+                            subpel_y_qn, conv_params);
+    return;
+  }
+  assert(h % 2 == 0);
+  assert(conv_params->round_0 > 0);
+
+  DECLARE_ALIGNED(64, int16_t, im_block[(MAX_SB_SIZE + SUBPEL_TAPS - 1) * 32]);
+  const int bd = 8;
+  const int round_0 = conv_params->round_0;
+  const int round_1 = conv_params->round_1;
+  const int bits = FILTER_BITS * 2 - round_0 - round_1;
+  const int offset_bits = bd + 2 * FILTER_BITS - round_0;
+  const int16_t *x_filter = av1_get_interp_filter_subpel_kernel(
+      filter_params_x, subpel_x_qn & SUBPEL_MASK);
+  const int16_t *y_filter = av1_get_interp_filter_subpel_kernel(
+      filter_params_y, subpel_y_qn & SUBPEL_MASK);
+  const int x_taps = get_filter_taps(x_filter);
+  const int y_taps = get_filter_taps(y_filter);
+  x_filter += (SUBPEL_TAPS - x_taps) / 2;
+  y_filter += (SUBPEL_TAPS - y_taps) / 2;
+
+  __m512i x_coeffs[4], y_coeffs[4];
+  for (int i = 0; i < x_taps / 2; ++i) {
+    x_coeffs[i] = _mm512_set1_epi16(
+        (int16_t)((uint8_t)(x_filter[2 * i] >> 1) |
+                  ((uint8_t)(x_filter[2 * i + 1] >> 1) << 8)));
+  }
+  for (int i = 0; i < y_taps / 2; ++i) {
+    y_coeffs[i] = _mm512_set1_epi32(
+        (int32_t)((uint16_t)y_filter[2 * i] |
+                  ((uint32_t)(uint16_t)y_filter[2 * i + 1] << 16)));
+  }
+
+  const int im_h = h + y_taps - 1;
+  const __m512i round_const_h = _mm512_set1_epi16(
+      ((1 << (round_0 - 1)) >> 1) + (1 << (bd + FILTER_BITS - 2)));
+  const __m128i round_shift_h = _mm_cvtsi32_si128(round_0 - 1);
+  const __m512i sum_round_v =
+      _mm512_set1_epi32((1 << offset_bits) + ((1 << round_1) >> 1));
+  const __m128i sum_shift_v = _mm_cvtsi32_si128(round_1);
+  const __m512i round_const_v =
+      _mm512_set1_epi32(((1 << bits) >> 1) - (1 << (offset_bits - round_1)) -
+                        ((1 << (offset_bits - round_1)) >> 1));
+  const __m128i round_shift_v = _mm_cvtsi32_si128(bits);
+  const uint8_t *const src_horiz =
+      src - (y_taps / 2 - 1) * src_stride - (x_taps / 2 - 1);
+
+  // Filter columns of 32 pixels so that the intermediate block stays small.
+  for (int x = 0; x < w; x += 32) {
+    const uint8_t *s = src_horiz + x;
+    for (int y = 0; y < im_h; ++y) {
+      _mm512_store_si512(&im_block[y * 32],
+                         convolve_x_32_avx512(s, x_taps / 2, x_coeffs,
+                                              round_const_h, round_shift_h));
+      s += src_stride;
+    }
+
+    if (y_taps == 4) {
+      convolve_y_32_avx512(im_block, 32, dst + x, dst_stride, h, 2, y_coeffs,
+                           sum_round_v, sum_shift_v, round_const_v,
+                           round_shift_v);
+    } else if (y_taps == 6) {
+      convolve_y_32_avx512(im_block, 32, dst + x, dst_stride, h, 3, y_coeffs,
+                           sum_round_v, sum_shift_v, round_const_v,
+                           round_shift_v);
+    } else {
+      convolve_y_32_avx512(im_block, 32, dst + x, dst_stride, h, 4, y_coeffs,
+                           sum_round_v, sum_shift_v, round_const_v,
+                           round_shift_v);
+    }
+  }
+}
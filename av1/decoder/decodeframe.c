@@ -2588,6 +2588,15 @@ static INLINE void signal_decoding_done_for_erroneous_row(
              sb_cols_in_tile);
 }
 
+// Adds the time since |timer| was started to the time of |tile_data|.
+static AOM_INLINE void add_tile_time(AV1Decoder *pbi,
+                                     const TileDataDec *tile_data,
+                                     struct aom_usec_timer *timer) {
+  aom_usec_timer_mark(timer);
+  pbi->frame_times.tile_time_us[tile_data - pbi->tile_data] +=
+      aom_usec_timer_elapsed(timer);
+}
+
 static AOM_INLINE void decode_tile_sb_row(AV1Decoder *pbi, ThreadData *const td,
                                           const TileInfo *tile_info,
                                           const int mi_row) {
@@ -2841,7 +2850,10 @@ static const uint8_t *decode_tiles(AV1Decoder *pbi, const uint8_t *data,
       td->dcb.xd.tile_ctx = &tile_data->tctx;
 
       // decode tile
+      struct aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
       decode_tile(pbi, td, row, col);
+      add_tile_time(pbi, tile_data, &timer);
       aom_merge_corrupted_flag(&pbi->dcb.corrupted, td->dcb.corrupted);
       if (pbi->dcb.corrupted)
         aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
@@ -2956,7 +2968,10 @@ static int tile_worker_hook(void *arg1, void *arg2) {
       // decode tile
       int tile_row = tile_data->tile_info.tile_row;
       int tile_col = tile_data->tile_info.tile_col;
+      struct aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
       decode_tile(pbi, td, tile_row, tile_col);
+      add_tile_time(pbi, tile_data, &timer);
     } else {
       break;
     }
@@ -3213,10 +3228,15 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
       pthread_mutex_unlock(pbi->row_mt_mutex_);
 #endif
       // decode tile
+      struct aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
       parse_tile_row_mt(pbi, td, tile_data);
 #if CONFIG_MULTITHREAD
       pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
+      // Rows of the tile may be reconstructed by other threads at the same
+      // time, so the tile time is updated under the mutex.
+      add_tile_time(pbi, tile_data, &timer);
       tile_data->dec_row_mt_sync.num_threads_working--;
 #if CONFIG_MULTITHREAD
       pthread_mutex_unlock(pbi->row_mt_mutex_);
@@ -3271,11 +3291,14 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     av1_init_macroblockd(cm, &td->dcb.xd);
     td->dcb.xd.error_info = &thread_data->error_info;
 
+    struct aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
     decode_tile_sb_row(pbi, td, &tile_data->tile_info, mi_row);
 
 #if CONFIG_MULTITHREAD
     pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
+    add_tile_time(pbi, tile_data, &timer);
     dec_row_mt_sync->num_threads_working--;
 #if CONFIG_MULTITHREAD
     pthread_mutex_unlock(pbi->row_mt_mutex_);
@@ -5228,6 +5251,62 @@ static AOM_INLINE void setup_frame_info(AV1Decoder *pbi) {
   }
 }
 
+// Returns 1 if any in-loop filter still has to run over the frame once all
+// of its tiles are decoded.
+static int frame_needs_post_filtering(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  if (cm->features.allow_intrabc || cm->tiles.single_tile_decoding) return 0;
+  const int do_cdef =
+      !pbi->skip_loop_filter && !cm->features.coded_lossless &&
+      (cm->cdef_info.cdef_bits || cm->cdef_info.cdef_strengths[0] ||
+       cm->cdef_info.cdef_uv_strengths[0]);
+  return cm->lf.filter_level[0] || cm->lf.filter_level[1] || do_cdef ||
+         av1_superres_scaled(cm) ||
+         cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
+}
+
+// Reports the luma rows up to row_end that have not been reported yet.
+static void output_rows(void *priv, int row_end) {
+  AV1Decoder *const pbi = (AV1Decoder *)priv;
+  AV1_COMMON *const cm = &pbi->common;
+  row_end = AOMMIN(row_end, cm->height);
+  if (row_end > pbi->rows_output) {
+    pbi->row_output_cb(pbi->row_output_priv, &cm->cur_frame->buf,
+                       pbi->rows_output, row_end);
+    pbi->rows_output = row_end;
+  }
+}
+
+// Reports the rows of all tile rows completed up to and including end_tile
+// that have not been reported yet.
+static void output_decoded_rows(AV1Decoder *pbi, int end_tile) {
+  AV1_COMMON *const cm = &pbi->common;
+  const CommonTileParams *const tiles = &cm->tiles;
+  if (pbi->row_output_cb == NULL || tiles->large_scale) return;
+
+  // Tile groups cover tiles in raster order.
+  const int tile_rows_done = (end_tile + 1) / tiles->cols;
+  const int mi_row_end = AOMMIN(
+      tiles->row_start_sb[tile_rows_done] << cm->seq_params->mib_size_log2,
+      cm->mi_params.mi_rows);
+  output_rows(pbi, mi_row_end * MI_SIZE);
+}
+
+// Returns the row progress to hand to a filter stage: the rows of the frame
+// are output as the last stage finishes them.
+static AV1FilterRowProgress *get_filter_row_progress(AV1Decoder *pbi,
+                                                     int last_stage) {
+  if (!last_stage || pbi->row_output_cb == NULL ||
+      pbi->common.tiles.large_scale)
+    return NULL;
+  AV1FilterRowProgress *const progress = &pbi->filter_row_progress;
+  progress->rows_done = output_rows;
+  progress->rows_done_priv = pbi;
+  return progress;
+}
+
 void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                     const uint8_t *data_end,
                                     const uint8_t **p_data_end, int start_tile,
@@ -5237,9 +5316,17 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   MACROBLOCKD *const xd = &pbi->dcb.xd;
   const int tile_count_tg = end_tile - start_tile + 1;
 
-  if (initialize_flag) setup_frame_info(pbi);
+  if (initialize_flag) {
+    setup_frame_info(pbi);
+    pbi->rows_output = 0;
+    DecFrameTimes *const times = &pbi->frame_times;
+    times->num_tiles = tiles->rows * tiles->cols;
+    memset(times->tile_time_us, 0,
+           times->num_tiles * sizeof(*times->tile_time_us));
+  }
   const int num_planes = av1_num_planes(cm);
 
+  av1_start_stage_timer(pbi, AOM_DEC_STAGE_TILES);
   if (pbi->max_threads > 1 && !(tiles->large_scale && !pbi->ext_tile_debug) &&
       pbi->row_mt)
     *p_data_end =
@@ -5249,27 +5336,25 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
     *p_data_end = decode_tiles_mt(pbi, data, data_end, start_tile, end_tile);
   else
     *p_data_end = decode_tiles(pbi, data, data_end, start_tile, end_tile);
+  av1_end_stage_timer(pbi, AOM_DEC_STAGE_TILES);
 
   // If the bit stream is monochrome, set the U and V buffers to a constant.
   if (num_planes < 3) {
     set_planes_to_neutral_grey(cm->seq_params, xd->cur_buf, 1);
   }
 
+  if (!frame_needs_post_filtering(pbi)) output_decoded_rows(pbi, end_tile);
+
   if (end_tile != tiles->rows * tiles->cols - 1) {
     return;
   }
+  ++pbi->frame_times.num_frames;
 
   av1_alloc_cdef_buffers(cm, &pbi->cdef_worker, &pbi->cdef_sync,
                          pbi->num_workers, 1);
   av1_alloc_cdef_sync(cm, &pbi->cdef_sync, pbi->num_workers);
 
   if (!cm->features.allow_intrabc && !tiles->single_tile_decoding) {
-    if (cm->lf.filter_level[0] || cm->lf.filter_level[1]) {
-      av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, &pbi->dcb.xd, 0,
-                               num_planes, 0, pbi->tile_workers,
-                               pbi->num_workers, &pbi->lf_row_sync, 0);
-    }
-
     const int do_cdef =
         !pbi->skip_loop_filter && !cm->features.coded_lossless &&
         (cm->cdef_info.cdef_bits || cm->cdef_info.cdef_strengths[0] ||
@@ -5280,15 +5365,31 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
         cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
         cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
         cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
+
+    if (cm->lf.filter_level[0] || cm->lf.filter_level[1]) {
+      av1_start_stage_timer(pbi, AOM_DEC_STAGE_LOOP_FILTER);
+      cm->filter_row_progress = get_filter_row_progress(
+          pbi, !do_cdef && !do_superres && !do_loop_restoration);
+      av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, &pbi->dcb.xd, 0,
+                               num_planes, 0, pbi->tile_workers,
+                               pbi->num_workers, &pbi->lf_row_sync, 0);
+      av1_end_stage_timer(pbi, AOM_DEC_STAGE_LOOP_FILTER);
+    }
     // Frame border extension is not required in the decoder
     // as it happens in extend_mc_border().
     int do_extend_border_mt = 0;
     if (!optimized_loop_restoration) {
-      if (do_loop_restoration)
+      if (do_loop_restoration) {
+        av1_start_stage_timer(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 0);
+        av1_end_stage_timer(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
+      }
 
       if (do_cdef) {
+        av1_start_stage_timer(pbi, AOM_DEC_STAGE_CDEF);
+        cm->filter_row_progress = get_filter_row_progress(
+            pbi, !do_superres && !do_loop_restoration);
         if (pbi->num_workers > 1) {
           av1_cdef_frame_mt(cm, &pbi->dcb.xd, pbi->cdef_worker,
                             pbi->tile_workers, &pbi->cdef_sync,
@@ -5298,13 +5399,18 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
           av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->dcb.xd,
                          av1_cdef_init_fb_row);
         }
+        av1_end_stage_timer(pbi, AOM_DEC_STAGE_CDEF);
       }
 
+      av1_start_stage_timer(pbi, AOM_DEC_STAGE_SUPERRES);
       superres_post_decode(pbi);
+      av1_end_stage_timer(pbi, AOM_DEC_STAGE_SUPERRES);
 
       if (do_loop_restoration) {
+        av1_start_stage_timer(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 1);
+        cm->filter_row_progress = get_filter_row_progress(pbi, 1);
         if (pbi->num_workers > 1) {
           av1_loop_restoration_filter_frame_mt(
               (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
@@ -5315,11 +5421,14 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        av1_end_stage_timer(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
       }
     } else {
       // In no cdef and no superres case. Provide an optimized version of
       // loop_restoration_filter.
       if (do_loop_restoration) {
+        av1_start_stage_timer(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
+        cm->filter_row_progress = get_filter_row_progress(pbi, 1);
         if (pbi->num_workers > 1) {
           av1_loop_restoration_filter_frame_mt(
               (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
@@ -5330,8 +5439,10 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        av1_end_stage_timer(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
       }
     }
+    cm->filter_row_progress = NULL;
   }
 
   if (!pbi->dcb.corrupted) {
@@ -5345,6 +5456,8 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                        "Decode failed. Frame data is corrupted.");
   }
 
+  output_decoded_rows(pbi, end_tile);
+
 #if CONFIG_INSPECTION
   if (pbi->inspect_cb != NULL) {
     (*pbi->inspect_cb)(pbi, pbi->inspect_ctx);
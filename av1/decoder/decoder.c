@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <limits.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "config/av1_rtcd.h"
 #include "config/aom_dsp_rtcd.h"
@@ -219,6 +220,8 @@ void av1_decoder_remove(AV1Decoder *pbi) {
     av1_dealloc_dec_jobs(&pbi->tile_mt_info);
   }
 
+  av1_filter_row_progress_dealloc(&pbi->filter_row_progress);
+
   av1_dec_free_cb_buf(pbi);
 #if CONFIG_ACCOUNTING
   aom_accounting_clear(&pbi->accounting);
@@ -344,6 +347,7 @@ static void release_current_frame(AV1Decoder *pbi) {
   decrease_ref_count(cm->cur_frame, pool);
   unlock_buffer_pool(pool);
   cm->cur_frame = NULL;
+  pbi->partial_frame_pending = 0;
 }
 
 // If any buffer updating is signaled it should be done here.
@@ -438,7 +442,8 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     if (ref_buf != NULL) ref_buf->buf.corrupted = 1;
   }
 
-  if (assign_cur_frame_new_fb(cm) == NULL) {
+  // A partially received frame keeps decoding into the same buffer.
+  if (!pbi->partial_frame_pending && assign_cur_frame_new_fb(cm) == NULL) {
     pbi->error.error_code = AOM_CODEC_MEM_ERROR;
     return 1;
   }
@@ -475,6 +480,16 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     return 1;
   }
 
+  if (!frame_decoded && pbi->seen_frame_header) {
+    // Only possible with partial input: hold on to cm->cur_frame until the
+    // remaining tile groups arrive.
+    assert(pbi->partial_input);
+    pbi->partial_frame_pending = 1;
+    pbi->error.setjmp = 0;
+    return 0;
+  }
+  pbi->partial_frame_pending = 0;
+
 #if TXCOEFF_TIMER
   cm->cum_txcoeff_timer += cm->txcoeff_timer;
   fprintf(stderr,
@@ -532,3 +547,13 @@ int av1_get_frame_to_show(AV1Decoder *pbi, YV12_BUFFER_CONFIG *frame) {
   *frame = pbi->output_frames[pbi->num_output_frames - 1]->buf;
   return 0;
 }
+
+void av1_reset_frame_times(AV1Decoder *pbi) {
+  DecFrameTimes *const times = &pbi->frame_times;
+  memset(times->tile_time_us, 0,
+         times->num_tiles * sizeof(*times->tile_time_us));
+  av1_zero(times->stage_time_us);
+  times->worker_idle_us = 0;
+  times->num_frames = 0;
+  times->num_tiles = 0;
+}
@@ -15,7 +15,9 @@
 #include "config/aom_config.h"
 
 #include "aom/aom_codec.h"
+#include "aom/aomdx.h"
 #include "aom_dsp/bitreader.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_scale/yv12config.h"
 #include "aom_util/aom_thread.h"
 
@@ -229,6 +231,20 @@ typedef struct AV1DecTileMTData {
   int alloc_tile_cols;
 } AV1DecTileMT;
 
+// Time spent decoding since the last call to aom_codec_decode(), returned by
+// AV1D_GET_FRAME_TIMES.
+typedef struct DecFrameTimes {
+  int64_t stage_time_us[AOM_DEC_STAGE_COUNT];
+  struct aom_usec_timer stage_timer[AOM_DEC_STAGE_COUNT];
+  // Time spent in jobs by the tile workers when each stage started.
+  int64_t stage_busy_us[AOM_DEC_STAGE_COUNT];
+  int64_t worker_idle_us;
+  int num_frames;
+  int num_tiles;
+  // Time spent in each tile of the last frame, in raster order.
+  int64_t tile_time_us[MAX_TILE_ROWS * MAX_TILE_COLS];
+} DecFrameTimes;
+
 typedef struct AV1Decoder {
   DecoderCodingBlock dcb;
 
@@ -344,6 +360,22 @@ typedef struct AV1Decoder {
   int num_tile_groups;
   aom_s_frame_info sframe_info;
 
+  // If set, a frame may be split across calls to av1_receive_compressed_data().
+  // partial_frame_pending is set while the tile groups of cur_frame are still
+  // being received.
+  int partial_input;
+  int partial_frame_pending;
+
+  // Called with ranges of luma rows of cur_frame that are final; rows_output
+  // is the number of rows of the current frame reported so far.
+  void (*row_output_cb)(void *priv, const YV12_BUFFER_CONFIG *buf,
+                        int row_start, int row_end);
+  void *row_output_priv;
+  int rows_output;
+  // Tracks the rows finished by the last in-loop filter stage of the frame
+  // when row_output_cb is set.
+  AV1FilterRowProgress filter_row_progress;
+
   /*!
    * Elements part of the sequence header, that are applicable for all the
    * frames in the video.
@@ -369,6 +401,8 @@ typedef struct AV1Decoder {
    * Number of spatial layers: may be > 1 for SVC (scalable vector coding).
    */
   unsigned int number_spatial_layers;
+
+  DecFrameTimes frame_times;
 } AV1Decoder;
 
 // Returns 0 on success. Sets pbi->common.error.error_code to a nonzero error
@@ -382,6 +416,9 @@ int av1_get_raw_frame(AV1Decoder *pbi, size_t index, YV12_BUFFER_CONFIG **sd,
 
 int av1_get_frame_to_show(struct AV1Decoder *pbi, YV12_BUFFER_CONFIG *frame);
 
+// Clears the times returned by AV1D_GET_FRAME_TIMES.
+void av1_reset_frame_times(struct AV1Decoder *pbi);
+
 aom_codec_err_t av1_copy_reference_dec(struct AV1Decoder *pbi, int idx,
                                        YV12_BUFFER_CONFIG *sd);
 
@@ -421,6 +458,34 @@ static INLINE void decrease_ref_count(RefCntBuffer *const buf,
   }
 }
 
+static INLINE int64_t get_workers_busy_us(const AV1Decoder *pbi) {
+  int64_t busy_us = 0;
+  for (int i = 0; i < pbi->num_workers; ++i)
+    busy_us += pbi->tile_workers[i].busy_us;
+  return busy_us;
+}
+
+static INLINE void av1_start_stage_timer(AV1Decoder *pbi,
+                                         aom_dec_stage_t stage) {
+  DecFrameTimes *const times = &pbi->frame_times;
+  times->stage_busy_us[stage] = get_workers_busy_us(pbi);
+  aom_usec_timer_start(&times->stage_timer[stage]);
+}
+
+// Also counts as idle the time the tile workers did not spend in jobs, if
+// they were used by the stage.
+static INLINE void av1_end_stage_timer(AV1Decoder *pbi, aom_dec_stage_t stage) {
+  DecFrameTimes *const times = &pbi->frame_times;
+  aom_usec_timer_mark(&times->stage_timer[stage]);
+  const int64_t elapsed = aom_usec_timer_elapsed(&times->stage_timer[stage]);
+  times->stage_time_us[stage] += elapsed;
+  const int64_t busy_us =
+      get_workers_busy_us(pbi) - times->stage_busy_us[stage];
+  if (pbi->num_workers > 1 && busy_us > 0) {
+    times->worker_idle_us += AOMMAX(pbi->num_workers * elapsed - busy_us, 0);
+  }
+}
+
 #define ACCT_STR __func__
 static INLINE int av1_read_uniform(aom_reader *r, int n) {
   const int l = get_unsigned_bits(n);
@@ -278,8 +278,10 @@ static uint32_t read_frame_header_obu(AV1Decoder *pbi,
                                       const uint8_t *data,
                                       const uint8_t **p_data_end,
                                       int trailing_bits_present) {
+  av1_start_stage_timer(pbi, AOM_DEC_STAGE_HEADER);
   const uint32_t hdr_size =
       av1_decode_frame_headers_and_setup(pbi, rb, trailing_bits_present);
+  av1_end_stage_timer(pbi, AOM_DEC_STAGE_HEADER);
   const AV1_COMMON *cm = &pbi->common;
   if (cm->show_existing_frame) {
     *p_data_end = data + hdr_size;
@@ -558,7 +560,9 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
     assert(data <= data_end);
 
     // Copy the decoded tile to the tile list output buffer.
+    av1_start_stage_timer(pbi, AOM_DEC_STAGE_OUTPUT);
     copy_decoded_tile_to_tile_list_buffer(pbi, tile_idx);
+    av1_end_stage_timer(pbi, AOM_DEC_STAGE_OUTPUT);
     tile_idx++;
   }
 
@@ -861,11 +865,19 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
   // value will not be used.
   const uint8_t *frame_header = data;
   uint32_t frame_header_size = 0;
+  // When resuming a partially received frame, its frame header lives in an
+  // earlier input buffer and redundant copies cannot be compared to it.
+  const int resume_frame = pbi->partial_frame_pending;
   ObuHeader obu_header;
   memset(&obu_header, 0, sizeof(obu_header));
-  pbi->seen_frame_header = 0;
-  pbi->next_start_tile = 0;
-  pbi->num_tile_groups = 0;
+  if (resume_frame) {
+    frame_header_size = (uint32_t)pbi->frame_header_size;
+    is_first_tg_obu_received = pbi->num_tile_groups == 0;
+  } else {
+    pbi->seen_frame_header = 0;
+    pbi->next_start_tile = 0;
+    pbi->num_tile_groups = 0;
+  }
 
   if (data_end < data) {
     pbi->error.error_code = AOM_CODEC_CORRUPT_FRAME;
@@ -884,7 +896,9 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
     size_t bytes_read = 0;
     const size_t bytes_available = data_end - data;
 
-    if (bytes_available == 0 && !pbi->seen_frame_header) {
+    // With partial input the rest of the frame arrives in a later call.
+    if (bytes_available == 0 &&
+        (!pbi->seen_frame_header || pbi->partial_input)) {
       *p_data_end = data;
       pbi->error.error_code = AOM_CODEC_OK;
       break;
@@ -973,7 +987,8 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
           // Verify that the frame_header_obu is identical to the original
           // frame_header_obu.
           if (frame_header_size > payload_size ||
-              memcmp(data, frame_header, frame_header_size) != 0) {
+              (!resume_frame &&
+               memcmp(data, frame_header, frame_header_size) != 0)) {
             pbi->error.error_code = AOM_CODEC_CORRUPT_FRAME;
             return -1;
           }
@@ -172,8 +172,13 @@ void av1_cyclic_reset_segment_skip(const AV1_COMP *cpi, MACROBLOCK *const x,
   assert(cm->seg.enabled);
 
   if (!cr->skip_over4x4) {
-    mbmi->segment_id =
+    const int pred_segment_id =
         av1_get_spatial_seg_pred(cm, xd, &cdf_num, cr->skip_over4x4);
+    // Blocks inside or next to an inactive region (see av1_apply_active_map())
+    // keep their segment, since the skip feature changes how they are coded.
+    if (!segfeature_active(&cm->seg, prev_segment_id, SEG_LVL_SKIP) &&
+        !segfeature_active(&cm->seg, pred_segment_id, SEG_LVL_SKIP))
+      mbmi->segment_id = pred_segment_id;
     if (prev_segment_id != mbmi->segment_id) {
       const int block_index = mi_row * cm->mi_params.mi_cols + mi_col;
       for (int mi_y = 0; mi_y < ymis; mi_y++) {
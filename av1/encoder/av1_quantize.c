@@ -239,6 +239,39 @@ void av1_quantize_lp_c(const int16_t *coeff_ptr, intptr_t n_coeffs,
   *eob_ptr = eob + 1;
 }
 
+void av1_hadamard_quantize_rd_lp_c(const int16_t *src_diff, int diff_stride,
+                                   int tx_wd, int blocks_wide, int blocks_high,
+                                   const int16_t *round_ptr,
+                                   const int16_t *quant_ptr,
+                                   const int16_t *dequant_ptr,
+                                   const int16_t *scan, const int16_t *iscan,
+                                   uint16_t *eobs, int *rate, int64_t *dist) {
+  DECLARE_ALIGNED(32, int16_t, coeff[16 * 16]);
+  DECLARE_ALIGNED(32, int16_t, qcoeff[16 * 16]);
+  DECLARE_ALIGNED(32, int16_t, dqcoeff[16 * 16]);
+  const int n_coeffs = tx_wd * tx_wd;
+
+  assert(tx_wd == 8 || tx_wd == 16);
+  *rate = 0;
+  *dist = 0;
+  for (int r = 0; r < blocks_high; ++r) {
+    for (int c = 0; c < blocks_wide; ++c) {
+      const int16_t *const src = src_diff + (r * diff_stride + c) * tx_wd;
+      uint16_t *const eob = &eobs[r * blocks_wide + c];
+      if (tx_wd == 16)
+        aom_hadamard_lp_16x16_c(src, diff_stride, coeff);
+      else
+        aom_hadamard_lp_8x8_c(src, diff_stride, coeff);
+      av1_quantize_lp_c(coeff, n_coeffs, round_ptr, quant_ptr, qcoeff, dqcoeff,
+                        dequant_ptr, eob, scan, iscan);
+      // When the eob is 1 the only non-zero coefficient is the DC, so the
+      // satd is the rate estimate in all cases.
+      *rate += aom_satd_lp_c(qcoeff, n_coeffs);
+      *dist += av1_block_error_lp_c(coeff, dqcoeff, n_coeffs) >> 2;
+    }
+  }
+}
+
 void av1_quantize_fp_32x32_c(const tran_low_t *coeff_ptr, intptr_t n_coeffs,
                              const int16_t *zbin_ptr, const int16_t *round_ptr,
                              const int16_t *quant_ptr,
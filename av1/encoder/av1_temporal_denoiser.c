@@ -369,6 +369,69 @@ void av1_denoiser_denoise(AV1_COMP *cpi, MACROBLOCK *mb, int mi_row, int mi_col,
     *denoiser_decision = FILTER_ZEROMV_BLOCK;
 }
 
+int av1_denoiser_use_prepass(const AV1_COMP *cpi) {
+  const AV1_DENOISER *const denoiser = &cpi->denoiser;
+  // The pre-pass filters against LAST at zero motion, so it needs the
+  // non-svc buffer layout and a LAST reference that was denoised.
+  return cpi->oxcf.denoise_prepass && cpi->oxcf.noise_sensitivity > 0 &&
+         !cpi->ppi->use_svc && cpi->sf.rt_sf.use_nonrd_pick_mode &&
+         !frame_is_intra_only(&cpi->common) &&
+         (cpi->ref_frame_flags & AOM_LAST_FLAG) &&
+         denoiser->denoising_level > kDenLowLow && denoiser->reset == 0 &&
+         !is_frame_resize_pending(cpi) &&
+         denoiser->running_avg_y[LAST_FRAME].buffer_alloc != NULL;
+}
+
+void av1_denoiser_denoise_sb_row(AV1_COMP *cpi, const TileInfo *tile_info,
+                                 int mi_row) {
+  const AV1_COMMON *const cm = &cpi->common;
+  AV1_DENOISER *const denoiser = &cpi->denoiser;
+  const YV12_BUFFER_CONFIG *const last = &denoiser->running_avg_y[LAST_FRAME];
+  const YV12_BUFFER_CONFIG *const avg = &denoiser->running_avg_y[INTRA_FRAME];
+  const YV12_BUFFER_CONFIG *const src = cpi->source;
+  const BLOCK_SIZE bs = BLOCK_32X32;
+  const int bw = block_size_wide[bs];
+  const int bh = block_size_high[bs];
+  const int increase_denoising = denoiser->denoising_level == kDenHigh;
+  const unsigned int max_sse = sse_thresh(bs, increase_denoising);
+  const int mi_row_end =
+      AOMMIN(mi_row + cm->seq_params->mib_size, cm->mi_params.mi_rows);
+  const int x_start = tile_info->mi_col_start << MI_SIZE_LOG2;
+  const int x_end = tile_info->mi_col_end << MI_SIZE_LOG2;
+  const int y_end = mi_row_end << MI_SIZE_LOG2;
+
+  for (int y = mi_row << MI_SIZE_LOG2; y < y_end; y += bh) {
+    for (int x = x_start; x < x_end; x += bw) {
+      uint8_t *const sig = src->y_buffer + y * src->y_stride + x;
+      const uint8_t *const mc_avg = last->y_buffer + y * last->y_stride + x;
+      uint8_t *const avg_start = avg->y_buffer + y * avg->y_stride + x;
+      const int w = AOMMIN(bw, x_end - x);
+      const int h = AOMMIN(bh, y_end - y);
+      AV1_DENOISER_DECISION decision = COPY_BLOCK;
+      unsigned int sse = UINT_MAX;
+
+      // Blocks cut by the frame edge are copied, the same as the small blocks
+      // that perform_motion_compensation() skips.
+      if (w == bw && h == bh) {
+        cpi->ppi->fn_ptr[bs].vf(sig, src->y_stride, mc_avg, last->y_stride,
+                                &sse);
+      }
+      if (sse <= max_sse) {
+        decision = av1_denoiser_filter(sig, src->y_stride, mc_avg,
+                                       last->y_stride, avg_start, avg->y_stride,
+                                       increase_denoising, bs, 0);
+      }
+      if (decision == FILTER_BLOCK) {
+        aom_convolve_copy(avg_start, avg->y_stride, sig, src->y_stride, w, h);
+      } else {
+        for (int r = 0; r < h; ++r) {
+          memcpy(avg_start + r * avg->y_stride, sig + r * src->y_stride, w);
+        }
+      }
+    }
+  }
+}
+
 static void copy_frame(YV12_BUFFER_CONFIG *const dest,
                        const YV12_BUFFER_CONFIG *const src) {
   int r;
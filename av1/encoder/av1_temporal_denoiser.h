@@ -53,6 +53,9 @@ typedef struct av1_denoiser {
   unsigned int current_denoiser_frame;
   AV1_DENOISER_LEVEL denoising_level;
   AV1_DENOISER_LEVEL prev_denoising_level;
+  // Set per frame when each SB row is denoised before it is encoded, instead
+  // of each block inside the mode search.
+  int use_prepass;
 } AV1_DENOISER;
 
 typedef struct {
@@ -83,6 +86,11 @@ void av1_denoiser_denoise(struct AV1_COMP *cpi, MACROBLOCK *mb, int mi_row,
                           AV1_DENOISER_DECISION *denoiser_decision,
                           int use_gf_temporal_ref);
 
+int av1_denoiser_use_prepass(const struct AV1_COMP *cpi);
+
+void av1_denoiser_denoise_sb_row(struct AV1_COMP *cpi,
+                                 const TileInfo *tile_info, int mi_row);
+
 void av1_denoiser_reset_frame_stats(PICK_MODE_CONTEXT *ctx);
 
 void av1_denoiser_update_frame_stats(MB_MODE_INFO *mi, int64_t sse,
@@ -39,10 +39,13 @@
 #include "av1/encoder/bitstream.h"
 #include "av1/encoder/cost.h"
 #include "av1/encoder/encodemv.h"
+#include "av1/encoder/encoder_utils.h"
 #include "av1/encoder/encodetxb.h"
 #include "av1/encoder/ethread.h"
 #include "av1/encoder/mcomp.h"
 #include "av1/encoder/palette.h"
+#include "av1/encoder/pickcdef.h"
+#include "av1/encoder/picklpf.h"
 #include "av1/encoder/segmentation.h"
 #include "av1/encoder/tokenize.h"
 
@@ -3645,6 +3648,13 @@ static INLINE uint32_t pack_large_scale_tiles_in_tg_obus(
   return total_size;
 }
 
+// Returns 1 if the frame header and the only tile group of the frame are
+// written in one OBU_FRAME. Tile groups packed while the frame is encoded
+// precede the final frame header, which is then written separately.
+static INLINE int use_frame_obu(const AV1_COMP *const cpi) {
+  return cpi->num_tg == 1 && !cpi->tg_output.early;
+}
+
 // Writes obu, tile group and uncompressed headers to bitstream.
 void av1_write_obu_tg_tile_headers(AV1_COMP *const cpi, MACROBLOCKD *const xd,
                                    PackBSParams *const pack_bs_params,
@@ -3658,13 +3668,13 @@ void av1_write_obu_tg_tile_headers(AV1_COMP *const cpi, MACROBLOCKD *const xd,
   // Write Tile group, frame and OBU header
   // A new tile group begins at this tile.  Write the obu header and
   // tile group header
-  const OBU_TYPE obu_type = (cpi->num_tg == 1) ? OBU_FRAME : OBU_TILE_GROUP;
+  const OBU_TYPE obu_type = use_frame_obu(cpi) ? OBU_FRAME : OBU_TILE_GROUP;
   *curr_tg_hdr_size = av1_write_obu_header(
       &cpi->ppi->level_params, &cpi->frame_header_count, obu_type,
       pack_bs_params->obu_extn_header, pack_bs_params->tile_data_curr);
   pack_bs_params->obu_header_size = *curr_tg_hdr_size;
 
-  if (cpi->num_tg == 1)
+  if (use_frame_obu(cpi))
     *curr_tg_hdr_size += write_frame_header_obu(
         cpi, xd, pack_bs_params->saved_wb,
         pack_bs_params->tile_data_curr + *curr_tg_hdr_size, 0);
@@ -3735,7 +3745,7 @@ void av1_write_last_tile_info(
   *curr_tg_data_size += (int)length_field_size;
   *total_size += (uint32_t)length_field_size;
   *tile_data_start += length_field_size;
-  if (cpi->num_tg == 1) {
+  if (use_frame_obu(cpi)) {
     // if this tg is combined with the frame header then update saved
     // frame header base offset according to length field size
     saved_wb->bit_buffer += length_field_size;
@@ -4079,27 +4089,21 @@ static size_t av1_write_metadata_array(AV1_COMP *const cpi, uint8_t *dst) {
   return total_bytes_written;
 }
 
-int av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dst, size_t *size,
-                       int *const largest_tile_id) {
+// Writes the OBUs that precede the tile groups of the frame: the sequence
+// header of key and intra-only frames, the metadata and the frame header,
+// unless it is combined with the first tile group.
+static int write_frame_head(AV1_COMP *const cpi, MACROBLOCKD *const xd,
+                            uint8_t *const dst,
+                            struct aom_write_bit_buffer *saved_wb,
+                            FrameHeaderInfo *fh_info, uint32_t *size) {
   uint8_t *data = dst;
-  uint32_t data_size;
   AV1_COMMON *const cm = &cpi->common;
   AV1LevelParams *const level_params = &cpi->ppi->level_params;
   uint32_t obu_header_size = 0;
   uint32_t obu_payload_size = 0;
-  FrameHeaderInfo fh_info = { NULL, 0, 0 };
   const uint8_t obu_extension_header =
       cm->temporal_layer_id << 5 | cm->spatial_layer_id << 3 | 0;
 
-  // If no non-zero delta_q has been used, reset delta_q_present_flag
-  if (cm->delta_q_info.delta_q_present_flag && cpi->deltaq_used == 0) {
-    cm->delta_q_info.delta_q_present_flag = 0;
-  }
-
-#if CONFIG_BITSTREAM_DEBUG
-  bitstream_queue_reset_write();
-#endif
-
   cpi->frame_header_count = 0;
 
   // The TD is now written outside the frame encode loop
@@ -4127,43 +4131,254 @@ int av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dst, size_t *size,
   // write metadata obus before the frame obu that has the show_frame flag set
   if (cm->show_frame) data += av1_write_metadata_array(cpi, data);
 
-  const int write_frame_header =
-      (cpi->num_tg > 1 || encode_show_existing_frame(cm));
-  struct aom_write_bit_buffer saved_wb = { NULL, 0 };
-  size_t length_field = 0;
+  const int write_frame_header = (cpi->num_tg > 1 || cpi->tg_output.early ||
+                                  encode_show_existing_frame(cm));
   if (write_frame_header) {
     // Write Frame Header OBU.
-    fh_info.frame_header = data;
+    fh_info->frame_header = data;
     obu_header_size =
         av1_write_obu_header(level_params, &cpi->frame_header_count,
                              OBU_FRAME_HEADER, obu_extension_header, data);
-    obu_payload_size = write_frame_header_obu(cpi, &cpi->td.mb.e_mbd, &saved_wb,
+    obu_payload_size = write_frame_header_obu(cpi, xd, saved_wb,
                                               data + obu_header_size, 1);
 
-    length_field = av1_obu_memmove(obu_header_size, obu_payload_size, data);
+    const size_t length_field =
+        av1_obu_memmove(obu_header_size, obu_payload_size, data);
     if (av1_write_uleb_obu_size(obu_header_size, obu_payload_size, data) !=
         AOM_CODEC_OK) {
       return AOM_CODEC_ERROR;
     }
 
-    fh_info.obu_header_byte_offset = 0;
-    fh_info.total_length = obu_header_size + obu_payload_size + length_field;
-    data += fh_info.total_length;
+    // Since length_field is determined adaptively after frame header
+    // encoding, saved_wb must be adjusted accordingly.
+    if (saved_wb->bit_buffer != NULL) {
+      saved_wb->bit_buffer += length_field;
+    }
+
+    fh_info->obu_header_byte_offset = 0;
+    fh_info->total_length = obu_header_size + obu_payload_size + length_field;
+    data += fh_info->total_length;
   }
+  *size = (uint32_t)(data - dst);
+  return AOM_CODEC_OK;
+}
 
-  if (encode_show_existing_frame(cm)) {
-    data_size = 0;
+void av1_tile_group_output_init(AV1_COMP *const cpi) {
+  TileGroupOutput *const tg = &cpi->tg_output;
+  AV1_COMMON *const cm = &cpi->common;
+  const FeatureFlags *const features = &cm->features;
+
+  // Intra block copy and delta q are turned off after the frame is encoded if
+  // it does not use them, with error resilience each tile group but the first
+  // is preceded by a copy of the frame header, and the film grain parameters
+  // are only set once the frame is encoded.
+  tg->early = tg->early && tg->output != NULL && !cm->tiles.large_scale &&
+              !features->allow_intrabc &&
+              !cm->delta_q_info.delta_q_present_flag &&
+              !(features->error_resilient_mode && cpi->num_tg > 1) &&
+              !cm->seq_params->film_grain_params_present;
+#if CONFIG_BITSTREAM_DEBUG
+  tg->early = 0;
+#endif
+  if (!tg->early) return;
+
+  if (tg->td == NULL) {
+    CHECK_MEM_ERROR(cm, tg->td, aom_calloc(1, sizeof(*tg->td)));
+  }
+#if CONFIG_MULTITHREAD
+  if (tg->mutex_ == NULL) {
+    CHECK_MEM_ERROR(cm, tg->mutex_, aom_malloc(sizeof(*tg->mutex_)));
+    if (tg->mutex_) pthread_mutex_init(tg->mutex_, NULL);
+  }
+#endif
+  if (tg->buf_size < cpi->available_bs_size) {
+    aom_free(tg->buf);
+    tg->buf_size = 0;
+    CHECK_MEM_ERROR(cm, tg->buf, aom_malloc(cpi->available_bs_size));
+    tg->buf_size = cpi->available_bs_size;
+  }
+
+  // Fix the choices that are otherwise made once the frame is encoded: the
+  // segment map is coded spatially, the CDFs of the first tile are used for
+  // the next frame (context_update_tile_id stays 0), the loop filter levels
+  // and CDEF strengths are derived from q and loop restoration is off.
+  cm->seg.temporal_update = 0;
+  if (!features->coded_lossless) {
+    av1_pick_filter_level(cpi->source, cpi, LPF_PICK_FROM_Q);
   } else {
-    // Since length_field is determined adaptively after frame header
-    // encoding, saved_wb must be adjusted accordingly.
-    if (saved_wb.bit_buffer != NULL) {
-      saved_wb.bit_buffer += length_field;
+    cm->lf.filter_level[0] = 0;
+    cm->lf.filter_level[1] = 0;
+  }
+  CdefInfo *const cdef_info = &cm->cdef_info;
+  if (cm->seq_params->enable_cdef && !features->coded_lossless &&
+      !(cpi->oxcf.tool_cfg.cdef_control == CDEF_REFERENCE &&
+        cpi->rtc_ref.non_reference_frame)) {
+    av1_pick_cdef_from_qp(cm, cpi->sf.rt_sf.skip_cdef_sb,
+                          use_screen_content_cdef_model(cpi));
+  } else {
+    cdef_info->cdef_bits = 0;
+    cdef_info->cdef_strengths[0] = 0;
+    cdef_info->nb_cdef_strengths = 1;
+    cdef_info->cdef_uv_strengths[0] = 0;
+  }
+  for (int plane = 0; plane < MAX_MB_PLANE; ++plane)
+    cm->rst_info[plane].frame_restoration_type = RESTORE_NONE;
+
+  tg->td->mb = cpi->td.mb;
+  av1_reset_pack_bs_thread_data(tg->td);
+  av1_zero(tg->tile_done);
+  tg->next_tile = 0;
+
+  // The frame header is final, so it goes out ahead of the tiles.
+  struct aom_write_bit_buffer saved_wb = { NULL, 0 };
+  FrameHeaderInfo fh_info = { NULL, 0, 0 };
+  if (write_frame_head(cpi, &tg->td->mb.e_mbd, tg->buf, &saved_wb, &fh_info,
+                       &tg->size) != AOM_CODEC_OK) {
+    aom_internal_error(cm->error, AOM_CODEC_ERROR,
+                       "Error writing frame header OBU");
+  }
+  tg->output(tg->priv, tg->buf, tg->size, 0);
+  tg->num_output++;
+}
+
+void av1_tile_group_output_tile_done(AV1_COMP *const cpi, int tile_idx) {
+  TileGroupOutput *const tg = &cpi->tg_output;
+  AV1_COMMON *const cm = &cpi->common;
+  const CommonTileParams *const tiles = &cm->tiles;
+  const int num_tiles = tiles->cols * tiles->rows;
+  const int tg_size = (num_tiles + cpi->num_tg - 1) / cpi->num_tg;
+  const uint8_t obu_extn_header =
+      cm->temporal_layer_id << 5 | cm->spatial_layer_id << 3 | 0;
+  MACROBLOCKD *const xd = &tg->td->mb.e_mbd;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(tg->mutex_);
+#endif
+  tg->tile_done[tile_idx] = 1;
+  while (tg->next_tile < num_tiles && tg->tile_done[tg->next_tile]) {
+    const int idx = tg->next_tile++;
+    const int new_tg = idx % tg_size == 0;
+    const int is_last_tile_in_tg =
+        idx % tg_size == tg_size - 1 || idx == num_tiles - 1;
+    TileDataEnc *const this_tile = &cpi->tile_data[idx];
+
+    // The tile was encoded with its own adapted CDFs; it is packed starting
+    // from those of the frame, like in av1_finalize_encoded_frame().
+    this_tile->tctx = *cm->fc;
+    xd->tile_ctx = &this_tile->tctx;
+
+    PackBSParams pack_bs_params;
+    pack_bs_params.dst = tg->buf;
+    pack_bs_params.curr_tg_hdr_size = 0;
+    pack_bs_params.is_last_tile_in_tg = is_last_tile_in_tg;
+    pack_bs_params.new_tg = new_tg;
+    pack_bs_params.obu_extn_header = obu_extn_header;
+    pack_bs_params.obu_header_size = 0;
+    pack_bs_params.saved_wb = NULL;
+    pack_bs_params.tile_col = idx % tiles->cols;
+    pack_bs_params.tile_row = idx / tiles->cols;
+    pack_bs_params.tile_data_curr = tg->buf + tg->size;
+    pack_bs_params.total_size = &tg->size;
+
+    if (new_tg) {
+      tg->tg_start = tg->size;
+      av1_write_obu_tg_tile_headers(cpi, xd, &pack_bs_params, idx);
+      tg->obu_header_size = pack_bs_params.obu_header_size;
+    }
+    av1_pack_tile_info(cpi, tg->td, &pack_bs_params);
+    tg->size += (uint32_t)pack_bs_params.buf.size;
+
+    if (is_last_tile_in_tg) {
+      size_t tg_data_size = tg->size - tg->tg_start;
+      uint8_t *tile_data_start = tg->buf + tg->tg_start;
+      int largest_tile_id = 0;
+      int is_first_tg = 1;
+      av1_write_last_tile_info(cpi, NULL, NULL, &tg_data_size,
+                               tg->buf + tg->tg_start, &tg->size,
+                               &tile_data_start, &largest_tile_id,
+                               &is_first_tg, tg->obu_header_size,
+                               obu_extn_header);
+      tg->output(tg->priv, tg->buf + tg->tg_start, tg_data_size,
+                 idx == num_tiles - 1);
+      tg->num_output++;
     }
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(tg->mutex_);
+#endif
+}
+
+void av1_tile_group_output_dealloc(AV1_COMP *const cpi) {
+  TileGroupOutput *const tg = &cpi->tg_output;
+#if CONFIG_MULTITHREAD
+  if (tg->mutex_ != NULL) {
+    pthread_mutex_destroy(tg->mutex_);
+    aom_free(tg->mutex_);
+    tg->mutex_ = NULL;
+  }
+#endif
+  aom_free(tg->td);
+  tg->td = NULL;
+  aom_free(tg->buf);
+  tg->buf = NULL;
+  tg->buf_size = 0;
+}
+
+// Writes the frame packed and output while it was encoded.
+static uint32_t write_early_frame(AV1_COMP *const cpi, uint8_t *const dst) {
+  const TileGroupOutput *const tg = &cpi->tg_output;
+  assert(tg->next_tile == cpi->common.tiles.cols * cpi->common.tiles.rows);
+
+  memcpy(dst, tg->buf, tg->size);
+  av1_accumulate_pack_bs_thread_data(cpi, tg->td);
+  return tg->size;
+}
+
+int av1_pack_bitstream(AV1_COMP *const cpi, uint8_t *dst, size_t *size,
+                       int *const largest_tile_id) {
+  uint8_t *data = dst;
+  uint32_t data_size;
+  AV1_COMMON *const cm = &cpi->common;
+  FrameHeaderInfo fh_info = { NULL, 0, 0 };
+  const uint8_t obu_extension_header =
+      cm->temporal_layer_id << 5 | cm->spatial_layer_id << 3 | 0;
+
+  // If no non-zero delta_q has been used, reset delta_q_present_flag
+  if (cm->delta_q_info.delta_q_present_flag && cpi->deltaq_used == 0) {
+    cm->delta_q_info.delta_q_present_flag = 0;
+  }
+
+#if CONFIG_BITSTREAM_DEBUG
+  bitstream_queue_reset_write();
+#endif
+
+  if (cpi->tg_output.early) {
+    av1_start_module_timer(cpi, MOD_PACK_BS);
+    *size = write_early_frame(cpi, dst);
+    av1_end_module_timer(cpi, MOD_PACK_BS);
+    *largest_tile_id = 0;
+    cpi->tg_output.early = 0;
+    return AOM_CODEC_OK;
+  }
 
+  struct aom_write_bit_buffer saved_wb = { NULL, 0 };
+  uint32_t head_size;
+  if (write_frame_head(cpi, &cpi->td.mb.e_mbd, data, &saved_wb, &fh_info,
+                       &head_size) != AOM_CODEC_OK) {
+    return AOM_CODEC_ERROR;
+  }
+  data += head_size;
+
+  if (encode_show_existing_frame(cm)) {
+    data_size = 0;
+  } else {
     //  Each tile group obu will be preceded by 4-byte size of the tile group
     //  obu
-    data_size = write_tiles_in_tg_obus(
-        cpi, data, &saved_wb, obu_extension_header, &fh_info, largest_tile_id);
+    av1_start_module_timer(cpi, MOD_PACK_BS);
+    data_size =
+        write_tiles_in_tg_obus(cpi, data, &saved_wb, obu_extension_header,
+                               &fh_info, largest_tile_id);
+    av1_end_module_timer(cpi, MOD_PACK_BS);
   }
   data += data_size;
   *size = data - dst;
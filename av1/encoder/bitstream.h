@@ -126,6 +126,19 @@ void av1_write_obu_tg_tile_headers(struct AV1_COMP *const cpi,
                                    PackBSParams *const pack_bs_params,
                                    const int tile_idx);
 
+// Prepares the output of the tile groups of the frame about to be encoded as
+// soon as their tiles are encoded, when cpi->tg_output.early is set. Fixes the
+// frame level syntax and outputs the OBUs up to the frame header, or clears
+// cpi->tg_output.early if the frame has to be packed after it is encoded.
+void av1_tile_group_output_init(struct AV1_COMP *const cpi);
+
+// Called by the thread that finished encoding tile tile_idx. Packs the tiles
+// that are encoded in bitstream order, and outputs the tile groups completed.
+void av1_tile_group_output_tile_done(struct AV1_COMP *const cpi,
+                                     int tile_idx);
+
+void av1_tile_group_output_dealloc(struct AV1_COMP *const cpi);
+
 int av1_neg_interleave(int x, int ref, int max);
 #ifdef __cplusplus
 }  // extern "C"
@@ -1021,6 +1021,13 @@ typedef struct macroblock {
    */
   int force_zeromv_skip;
 
+  /*!\brief Speed level of the superblock row, for nonrd path.
+   *
+   * Raised above 0 when the frame is behind its time budget, see
+   * av1_time_budget_row_level().
+   */
+  int time_budget_level;
+
   /*! \brief Previous segment id for which qmatrices were updated.
    * This is used to bypass setting of qmatrices if no change in qindex.
    */
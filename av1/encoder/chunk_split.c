@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#include "av1/common/av1_common_int.h"
+#include "av1/encoder/chunk_split.h"
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/firstpass.h"
+#include "av1/encoder/pass2_strategy.h"
+
+#if CONFIG_REALTIME_ONLY
+// The first pass and the second pass strategy are not built, so there are no
+// stats to split.
+int av1_split_encode_chunks(const aom_fixed_buf_t *stats_in,
+                            const AV1ChunkSplitCfg *cfg,
+                            aom_encode_chunk_t *chunks, int max_chunks) {
+  (void)stats_in;
+  (void)cfg;
+  (void)chunks;
+  (void)max_chunks;
+  return -1;
+}
+
+int av1_get_chunk_stats(const aom_fixed_buf_t *stats_in,
+                        const aom_encode_chunk_t *chunk,
+                        aom_fixed_buf_t *chunk_stats) {
+  (void)stats_in;
+  (void)chunk;
+  (void)chunk_stats;
+  return -1;
+}
+#else
+// Returns the number of frame stats in |stats_in|, not counting the total,
+// or -1 if it is not a complete first pass output.
+static int get_num_frame_stats(const aom_fixed_buf_t *stats_in) {
+  const size_t packet_sz = sizeof(FIRSTPASS_STATS);
+  if (stats_in->buf == NULL || stats_in->sz % packet_sz ||
+      stats_in->sz < 2 * packet_sz) {
+    return -1;
+  }
+  const int num_stats = (int)(stats_in->sz / packet_sz) - 1;
+  const FIRSTPASS_STATS *const total =
+      (const FIRSTPASS_STATS *)stats_in->buf + num_stats;
+  if ((int)(total->count + 0.5) != num_stats) return -1;
+  return num_stats;
+}
+
+// Stores the chunk of |num_frames| frames from |start|, whose modified error
+// is |error|, if |chunks| has room for it.
+static void add_chunk(aom_encode_chunk_t *chunks, int max_chunks,
+                      int num_chunks, int start, int num_frames,
+                      double error) {
+  if (chunks == NULL || num_chunks >= max_chunks) return;
+  chunks[num_chunks].start = start;
+  chunks[num_chunks].num_frames = num_frames;
+  chunks[num_chunks].bitrate_scale = error;
+}
+
+int av1_split_encode_chunks(const aom_fixed_buf_t *stats_in,
+                            const AV1ChunkSplitCfg *cfg,
+                            aom_encode_chunk_t *chunks, int max_chunks) {
+  const int num_stats = get_num_frame_stats(stats_in);
+  if (num_stats < 0) return -1;
+  FIRSTPASS_STATS *const stats = (FIRSTPASS_STATS *)stats_in->buf;
+  const FIRSTPASS_STATS *const total = stats + num_stats;
+
+  FIRSTPASS_INFO firstpass_info;
+  av1_firstpass_info_init(&firstpass_info, stats, num_stats);
+
+  FRAME_INFO frame_info;
+  memset(&frame_info, 0, sizeof(frame_info));
+  const int mi_rows =
+      ALIGN_POWER_OF_TWO(cfg->frame_height, 3) >> MI_SIZE_LOG2;
+  frame_info.mb_rows = (mi_rows + 2) >> 2;
+  const int num_mbs = av1_get_MBs(cfg->frame_width, cfg->frame_height);
+  const int min_chunk_frames = AOMMAX(cfg->min_chunk_frames, 1);
+  int max_chunk_frames = cfg->max_chunk_frames;
+  if (cfg->min_num_chunks > 1) {
+    max_chunk_frames =
+        AOMMIN(max_chunk_frames, (num_stats + cfg->min_num_chunks - 1) /
+                                     cfg->min_num_chunks);
+  }
+  max_chunk_frames = AOMMAX(max_chunk_frames, min_chunk_frames);
+
+  // Same error bounds as av1_init_second_pass().
+  const double avg_error =
+      total->coded_error / DOUBLE_DIVIDE_CHECK(total->count);
+  const double modified_error_min = avg_error * cfg->vbrmin_section / 100;
+  const double modified_error_max = avg_error * cfg->vbrmax_section / 100;
+
+  int num_chunks = 0;
+  int chunk_start = 0;
+  double chunk_error = 0.0;
+  double total_error = 0.0;
+  for (int i = 0; i < num_stats; ++i) {
+    const int chunk_frames = i - chunk_start;
+    // The stats are indexed relative to frame 0, the current frame of
+    // firstpass_info. The last frame cannot be tested as a scene cut.
+    if (chunk_frames >= max_chunk_frames ||
+        (chunk_frames >= min_chunk_frames && i + 1 < num_stats &&
+         av1_test_candidate_kf(&firstpass_info, i, chunk_frames, cfg->rc_mode,
+                               ENABLE_SCENECUT_MODE_2, num_mbs))) {
+      add_chunk(chunks, max_chunks, num_chunks++, chunk_start, chunk_frames,
+                chunk_error);
+      chunk_start = i;
+      chunk_error = 0.0;
+    }
+    const double err = av1_calculate_modified_err_new(
+        &frame_info, total, &stats[i], cfg->vbrbias, modified_error_min,
+        modified_error_max);
+    chunk_error += err;
+    total_error += err;
+  }
+  add_chunk(chunks, max_chunks, num_chunks++, chunk_start,
+            num_stats - chunk_start, chunk_error);
+
+  // Turn the error of each chunk into its share of the bits relative to its
+  // share of the frames.
+  for (int i = 0; chunks != NULL && i < AOMMIN(num_chunks, max_chunks); ++i) {
+    chunks[i].bitrate_scale =
+        total_error > 0.0 ? chunks[i].bitrate_scale / total_error * num_stats /
+                                chunks[i].num_frames
+                          : 1.0;
+  }
+  return num_chunks;
+}
+
+int av1_get_chunk_stats(const aom_fixed_buf_t *stats_in,
+                        const aom_encode_chunk_t *chunk,
+                        aom_fixed_buf_t *chunk_stats) {
+  const int num_stats = get_num_frame_stats(stats_in);
+  if (num_stats < 0 || chunk->start < 0 || chunk->num_frames <= 0 ||
+      chunk->start + chunk->num_frames > num_stats) {
+    return -1;
+  }
+  const size_t sz = (chunk->num_frames + 1) * sizeof(FIRSTPASS_STATS);
+  if (chunk_stats->buf == NULL) {
+    chunk_stats->sz = sz;
+    return 0;
+  }
+  if (chunk_stats->sz < sz) return -1;
+  const FIRSTPASS_STATS *const stats =
+      (const FIRSTPASS_STATS *)stats_in->buf + chunk->start;
+  FIRSTPASS_STATS *const out = (FIRSTPASS_STATS *)chunk_stats->buf;
+
+  // Renumber the frames as a first pass of the chunk alone would have.
+  FIRSTPASS_STATS *const total = out + chunk->num_frames;
+  av1_twopass_zero_stats(total);
+  for (int i = 0; i < chunk->num_frames; ++i) {
+    out[i] = stats[i];
+    out[i].frame = i;
+    av1_accumulate_stats(total, &out[i]);
+  }
+  chunk_stats->sz = sz;
+  return 0;
+}
+#endif  // CONFIG_REALTIME_ONLY
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_CHUNK_SPLIT_H_
+#define AOM_AV1_ENCODER_CHUNK_SPLIT_H_
+
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\brief Settings of the second pass that affect how a sequence is split.
+ */
+typedef struct AV1ChunkSplitCfg {
+  /*!\cond */
+  int frame_width;
+  int frame_height;
+  enum aom_rc_mode rc_mode;
+  int vbrbias;
+  int vbrmin_section;
+  int vbrmax_section;
+  /*!\endcond */
+  /*!
+   * Chunks are only split at a scene cut once they have this many frames.
+   */
+  int min_chunk_frames;
+  /*!
+   * Chunks that reach this many frames are split without a scene cut.
+   */
+  int max_chunk_frames;
+  /*!
+   * Lowers max_chunk_frames so that a sequence without scene cuts is split
+   * into at least this many chunks of min_chunk_frames or more.
+   */
+  int min_num_chunks;
+} AV1ChunkSplitCfg;
+
+/*!\brief Splits a two pass encode into chunks
+ *
+ * \ingroup rate_control
+ * Scans the first pass stats of the whole sequence with the key frame
+ * detection of the second pass, and starts a new chunk at each scene cut
+ * found once the current chunk has cfg->min_chunk_frames frames, or after
+ * cfg->max_chunk_frames frames. The first frame of every chunk is coded as a
+ * key frame, so splitting at the scene cuts costs little compression.
+ *
+ * \param[in]   stats_in     First pass stats, as passed in
+ *                           rc_twopass_stats_in to the second pass.
+ * \param[in]   cfg          Split settings.
+ * \param[out]  chunks       Receives the first \p max_chunks chunks in
+ *                           display order, may be NULL.
+ * \param[in]   max_chunks   Number of entries of \p chunks.
+ *
+ * \return The number of chunks, or -1 if \p stats_in is invalid.
+ */
+int av1_split_encode_chunks(const aom_fixed_buf_t *stats_in,
+                            const AV1ChunkSplitCfg *cfg,
+                            aom_encode_chunk_t *chunks, int max_chunks);
+
+/*!\brief Extracts the first pass stats of a chunk
+ *
+ * \ingroup rate_control
+ * \param[in]     stats_in     First pass stats of the whole sequence.
+ * \param[in]     chunk        A chunk returned by av1_split_encode_chunks().
+ * \param[in,out] chunk_stats  Receives the stats of the frames of \p chunk
+ *                             followed by their total, to be passed in
+ *                             rc_twopass_stats_in to the encoder of the
+ *                             chunk. On return sz is the size of the stats;
+ *                             if buf is NULL nothing else is written.
+ *
+ * \return 0 on success, -1 if the chunk is invalid or buf is too small.
+ */
+int av1_get_chunk_stats(const aom_fixed_buf_t *stats_in,
+                        const aom_encode_chunk_t *chunk,
+                        aom_fixed_buf_t *chunk_stats);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_CHUNK_SPLIT_H_
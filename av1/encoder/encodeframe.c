@@ -48,6 +48,7 @@
 #include "av1/encoder/aq_complexity.h"
 #include "av1/encoder/aq_cyclicrefresh.h"
 #include "av1/encoder/aq_variance.h"
+#include "av1/encoder/bitstream.h"
 #include "av1/encoder/global_motion_facade.h"
 #include "av1/encoder/encodeframe.h"
 #include "av1/encoder/encodeframe_utils.h"
@@ -855,6 +856,16 @@ static AOM_INLINE void encode_sb_row(AV1_COMP *cpi, ThreadData *td,
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, encode_sb_row_time);
 #endif
+  const int64_t row_start_us = av1_time_budget_elapsed(&cpi->time_budget);
+  x->time_budget_level = av1_time_budget_row_level(cpi, mi_row);
+
+#if CONFIG_AV1_TEMPORAL_DENOISING
+  // Denoise the source of the row before any of its blocks are searched. With
+  // row-mt this runs on the worker that owns the row, while the rows above
+  // are still being encoded.
+  if (cpi->denoiser.use_prepass)
+    av1_denoiser_denoise_sb_row(cpi, tile_info, mi_row);
+#endif
 
   // Initialize the left context for the new SB row
   av1_zero_left_context(xd);
@@ -896,8 +907,11 @@ static AOM_INLINE void encode_sb_row(AV1_COMP *cpi, ThreadData *td,
       }
     }
 
+    // Get segment id and skip flag
+    const int seg_skip = av1_is_sb_seg_skip(cpi, mi_row, mi_col);
+
     // Update the rate cost tables for some symbols
-    av1_set_cost_upd_freq(cpi, td, tile_info, mi_row, mi_col);
+    av1_set_cost_upd_freq(cpi, td, tile_info, mi_row, mi_col, seg_skip);
 
     // Reset color coding related parameters
     x->color_sensitivity_sb[0] = 0;
@@ -920,26 +934,15 @@ static AOM_INLINE void encode_sb_row(AV1_COMP *cpi, ThreadData *td,
     x->source_variance = UINT_MAX;
     td->mb.cb_coef_buff = av1_get_cb_coeff_buffer(cpi, mi_row, mi_col);
 
-    // Get segment id and skip flag
-    const struct segmentation *const seg = &cm->seg;
-    int seg_skip = 0;
-    if (seg->enabled) {
-      const uint8_t *const map =
-          seg->update_map ? cpi->enc_seg.map : cm->last_frame_seg_map;
-      const int segment_id =
-          map ? get_segment_id(&cm->mi_params, map, sb_size, mi_row, mi_col)
-              : 0;
-      seg_skip = segfeature_active(seg, segment_id, SEG_LVL_SKIP);
-    }
-
     produce_gradients_for_sb(cpi, x, sb_size, mi_row, mi_col);
 
     init_src_var_info_of_4x4_sub_blocks(cpi, x->src_var_info_of_4x4_sub_blocks,
                                         sb_size);
 
     // Grade the temporal variation of the sb, the grade will be used to decide
-    // fast mode search strategy for coding blocks
-    grade_source_content_sb(cpi, x, mi_row, mi_col);
+    // fast mode search strategy for coding blocks. Not needed when the whole
+    // sb is coded as skip.
+    if (!seg_skip) grade_source_content_sb(cpi, x, mi_row, mi_col);
 
     // encode the superblock
     if (use_nonrd_mode) {
@@ -960,6 +963,9 @@ static AOM_INLINE void encode_sb_row(AV1_COMP *cpi, ThreadData *td,
                                sb_cols_in_tile);
   }
 
+  av1_time_budget_row_done(cpi, tile_info->tile_col, mi_row, row_start_us,
+                           x->time_budget_level);
+
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, encode_sb_row_time);
 #endif
@@ -1190,6 +1196,8 @@ static AOM_INLINE void encode_tiles(AV1_COMP *cpi) {
         av1_accumulate_rtc_counters(cpi, &cpi->td.mb);
       cpi->intrabc_used |= cpi->td.intrabc_used;
       cpi->deltaq_used |= cpi->td.deltaq_used;
+      if (cpi->tg_output.early)
+        av1_tile_group_output_tile_done(cpi, tile_row * tile_cols + tile_col);
     }
   }
 
@@ -1623,7 +1631,9 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, av1_compute_global_motion_time);
 #endif
+  av1_start_module_timer(cpi, MOD_GME);
   av1_compute_global_motion_facade(cpi);
+  av1_end_module_timer(cpi, MOD_GME);
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, av1_compute_global_motion_time);
 #endif
@@ -1655,6 +1665,27 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
   mt_info->pack_bs_mt_enabled = AOMMIN(mt_info->num_mod_workers[MOD_PACK_BS],
                                        cm->tiles.cols * cm->tiles.rows) > 1;
 
+#if CONFIG_AV1_TEMPORAL_DENOISING
+  cpi->denoiser.use_prepass = av1_denoiser_use_prepass(cpi);
+#endif
+
+  av1_compute_src_stats_8x8(cpi);
+
+  // Set the transform size appropriately before bitstream creation, which
+  // starts with the first tile encoded if tile groups are output early.
+  const MODE_EVAL_TYPE eval_type =
+      cpi->sf.winner_mode_sf.enable_winner_mode_for_tx_size_srch
+          ? WINNER_MODE_EVAL
+          : DEFAULT_EVAL;
+  const TX_SIZE_SEARCH_METHOD tx_search_type =
+      cpi->winner_mode_params.tx_size_search_methods[eval_type];
+  assert(oxcf->txfm_cfg.enable_tx64 || tx_search_type != USE_LARGESTALL);
+  features->tx_mode = select_tx_mode(cm, tx_search_type);
+
+  if (cpi->tg_output.early) av1_tile_group_output_init(cpi);
+
+  av1_time_budget_encode_start(cpi);
+  av1_start_module_timer(cpi, MOD_ENC);
   if (oxcf->row_mt && (mt_info->num_workers > 1)) {
     mt_info->row_mt_enabled = 1;
     enc_row_mt->sync_read_ptr = av1_row_mt_sync_read;
@@ -1674,6 +1705,8 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
       av1_free_pc_tree_recursive(td->rt_pc_root, av1_num_planes(cm), 0, 0);
     }
   }
+  av1_end_module_timer(cpi, MOD_ENC);
+  av1_time_budget_encode_end(cpi);
 
   // If intrabc is allowed but never selected, reset the allow_intrabc flag.
   if (features->allow_intrabc && !cpi->intrabc_used) {
@@ -1687,16 +1720,6 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
     cm->delta_q_info.delta_q_present_flag = 0;
   }
 
-  // Set the transform size appropriately before bitstream creation
-  const MODE_EVAL_TYPE eval_type =
-      cpi->sf.winner_mode_sf.enable_winner_mode_for_tx_size_srch
-          ? WINNER_MODE_EVAL
-          : DEFAULT_EVAL;
-  const TX_SIZE_SEARCH_METHOD tx_search_type =
-      cpi->winner_mode_params.tx_size_search_methods[eval_type];
-  assert(oxcf->txfm_cfg.enable_tx64 || tx_search_type != USE_LARGESTALL);
-  features->tx_mode = select_tx_mode(cm, tx_search_type);
-
   // Retain the frame level probability update conditions for parallel frames.
   // These conditions will be consumed during postencode stage to update the
   // probability.
@@ -1775,7 +1798,7 @@ static AOM_INLINE void encode_frame_internal(AV1_COMP *cpi) {
     }
   }
 
-  if (cm->seg.enabled) {
+  if (cm->seg.enabled && !cpi->tg_output.early) {
     cm->seg.temporal_update = 1;
     if (rdc->seg_tmp_pred_cost[0] < rdc->seg_tmp_pred_cost[1])
       cm->seg.temporal_update = 0;
@@ -1993,6 +2016,9 @@ void av1_encode_frame(AV1_COMP *cpi) {
 
     encode_frame_internal(cpi);
 
+    // The tiles are already packed if their tile groups were output early.
+    if (cpi->tg_output.early) return;
+
     if (current_frame->reference_mode == REFERENCE_MODE_SELECT) {
       // Use a flag that includes 4x4 blocks
       if (rdc->compound_ref_used_flag == 0) {
@@ -16,6 +16,7 @@
 #include "av1/encoder/encoder.h"
 #include "av1/encoder/encodeframe_utils.h"
 #include "av1/encoder/rdopt.h"
+#include "av1/encoder/var_based_part.h"
 
 void av1_set_ssim_rdmult(const AV1_COMP *const cpi, int *errorperbit,
                          const BLOCK_SIZE bsize, const int mi_row,
@@ -1404,6 +1405,7 @@ void av1_source_content_sb(AV1_COMP *cpi, MACROBLOCK *x, int mi_row,
         last_src += last_src_stride;
       }
     }
+    av1_update_src_stats_8x8_sb(cpi, mi_row, mi_col, bsize);
   }
 }
 
@@ -1581,7 +1583,7 @@ static int skip_dv_cost_update(AV1_COMP *cpi, const TileInfo *const tile_info,
 // by speed features
 void av1_set_cost_upd_freq(AV1_COMP *cpi, ThreadData *td,
                            const TileInfo *const tile_info, const int mi_row,
-                           const int mi_col) {
+                           const int mi_col, const int seg_skip) {
   AV1_COMMON *const cm = &cpi->common;
   const int num_planes = av1_num_planes(cm);
   MACROBLOCK *const x = &td->mb;
@@ -1601,6 +1603,11 @@ void av1_set_cost_upd_freq(AV1_COMP *cpi, ThreadData *td,
       if (skip_cost_update(cm->seq_params, tile_info, mi_row, mi_col,
                            cpi->sf.inter_sf.coeff_cost_upd_level))
         break;
+      // A superblock coded as skip by the segmentation has no coefficients,
+      // and at SB level the next superblock fills the costs again.
+      if (seg_skip &&
+          cpi->sf.inter_sf.coeff_cost_upd_level == INTERNAL_COST_UPD_SB)
+        break;
       av1_fill_coeff_costs(&x->coeff_costs, xd->tile_ctx, num_planes);
       break;
     default: assert(0);
@@ -308,6 +308,22 @@ static AOM_INLINE int set_segment_rdmult(const AV1_COMP *const cpi,
                              segment_qindex + cm->quant_params.y_dc_delta_q);
 }
 
+// Returns 1 if the segmentation codes the whole superblock at (mi_row, mi_col)
+// as skip, e.g. outside the active map.
+static AOM_INLINE int av1_is_sb_seg_skip(const AV1_COMP *const cpi, int mi_row,
+                                         int mi_col) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const struct segmentation *const seg = &cm->seg;
+  if (!seg->enabled) return 0;
+  const uint8_t *const map =
+      seg->update_map ? cpi->enc_seg.map : cm->last_frame_seg_map;
+  const int segment_id =
+      map ? get_segment_id(&cm->mi_params, map, cm->seq_params->sb_size,
+                           mi_row, mi_col)
+          : 0;
+  return segfeature_active(seg, segment_id, SEG_LVL_SKIP);
+}
+
 static AOM_INLINE int do_split_check(BLOCK_SIZE bsize) {
   return (bsize == BLOCK_16X16 || bsize == BLOCK_32X32);
 }
@@ -407,7 +423,7 @@ void av1_restore_sb_state(const SB_FIRST_PASS_STATS *sb_fp_stats, AV1_COMP *cpi,
 
 void av1_set_cost_upd_freq(AV1_COMP *cpi, ThreadData *td,
                            const TileInfo *const tile_info, const int mi_row,
-                           const int mi_col);
+                           const int mi_col, const int seg_skip);
 
 static AOM_INLINE void av1_dealloc_mb_data(struct AV1Common *cm,
                                            struct macroblock *mb) {
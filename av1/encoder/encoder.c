@@ -152,13 +152,58 @@ int av1_set_active_map(AV1_COMP *cpi, unsigned char *new_map_16x16, int rows,
         }
       }
       cpi->active_map.enabled = 1;
+    } else {
+      cpi->active_map.enabled = 0;
     }
+    cpi->active_map.update = 1;
+    cpi->active_map.expire = 0;
     return 0;
   }
 
   return -1;
 }
 
+int av1_set_dirty_rects(AV1_COMP *cpi, const aom_dirty_rect_t *rects,
+                        int num_rects) {
+  const CommonModeInfoParams *const mi_params = &cpi->common.mi_params;
+  unsigned char *const active_map_4x4 = cpi->active_map.map;
+  const int mi_rows = mi_params->mi_rows;
+  const int mi_cols = mi_params->mi_cols;
+  if (rects == NULL) {
+    cpi->active_map.enabled = 0;
+    cpi->active_map.update = 1;
+    cpi->active_map.expire = 0;
+    return 0;
+  }
+  for (int i = 0; i < num_rects; ++i) {
+    if (rects[i].x < 0 || rects[i].y < 0 || rects[i].width < 0 ||
+        rects[i].height < 0)
+      return -1;
+  }
+  memset(active_map_4x4, AM_SEGMENT_ID_INACTIVE, mi_rows * mi_cols);
+  for (int i = 0; i < num_rects; ++i) {
+    const aom_dirty_rect_t *const rect = &rects[i];
+    if (rect->width == 0 || rect->height == 0) continue;
+    // Mark every 4x4 block the rectangle touches as active.
+    const int row_start = AOMMIN(rect->y >> MI_SIZE_LOG2, mi_rows);
+    const int col_start = AOMMIN(rect->x >> MI_SIZE_LOG2, mi_cols);
+    const int row_end = (int)AOMMIN(
+        ((int64_t)rect->y + rect->height + MI_SIZE - 1) >> MI_SIZE_LOG2,
+        mi_rows);
+    const int col_end = (int)AOMMIN(
+        ((int64_t)rect->x + rect->width + MI_SIZE - 1) >> MI_SIZE_LOG2,
+        mi_cols);
+    for (int r = row_start; r < row_end; ++r) {
+      memset(active_map_4x4 + r * mi_cols + col_start, AM_SEGMENT_ID_ACTIVE,
+             col_end - col_start);
+    }
+  }
+  cpi->active_map.enabled = 1;
+  cpi->active_map.update = 1;
+  cpi->active_map.expire = 1;
+  return 0;
+}
+
 int av1_get_active_map(AV1_COMP *cpi, unsigned char *new_map_16x16, int rows,
                        int cols) {
   const CommonModeInfoParams *const mi_params = &cpi->common.mi_params;
@@ -1318,6 +1363,7 @@ AV1_COMP *av1_create_compressor(AV1_PRIMARY *ppi, const AV1EncoderConfig *oxcf,
   }
 
   av1_rc_init(&cpi->oxcf, &cpi->rc);
+  av1_time_budget_init(&cpi->time_budget);
 
   init_frame_info(&cpi->frame_info, cm);
   init_frame_index_set(&cpi->frame_index_set);
@@ -1566,6 +1612,10 @@ void av1_remove_primary_compressor(AV1_PRIMARY *ppi) {
   terminate_worker_data(ppi);
   free_thread_data(ppi);
 
+  assert(ppi->async_psnr.recon == NULL);
+  if (ppi->async_psnr.worker_created)
+    aom_get_worker_interface()->end(&ppi->async_psnr.worker);
+
   aom_free(ppi->p_mt_info.tile_thr_data);
   aom_free(ppi->p_mt_info.workers);
 
@@ -1602,6 +1652,7 @@ void av1_remove_compressor(AV1_COMP *cpi) {
 
   aom_free(cm->error);
   aom_free(cpi->td.tctx);
+  av1_tile_group_output_dealloc(cpi);
   MultiThreadInfo *const mt_info = &cpi->mt_info;
 #if CONFIG_MULTITHREAD
   pthread_mutex_t *const enc_row_mt_mutex_ = mt_info->enc_row_mt.mutex_;
@@ -1655,38 +1706,131 @@ void av1_remove_compressor(AV1_COMP *cpi) {
 #endif
 }
 
-static void generate_psnr_packet(AV1_COMP *cpi) {
+static void add_psnr_packet(AV1_PRIMARY *ppi, const PSNR_STATS *psnr,
+                            int has_hbd) {
   struct aom_codec_cx_pkt pkt;
   int i;
-  PSNR_STATS psnr;
-#if CONFIG_AV1_HIGHBITDEPTH
-  const uint32_t in_bit_depth = cpi->oxcf.input_cfg.input_bit_depth;
-  const uint32_t bit_depth = cpi->td.mb.e_mbd.bd;
-  aom_calc_highbd_psnr(cpi->source, &cpi->common.cur_frame->buf, &psnr,
-                       bit_depth, in_bit_depth);
-#else
-  aom_calc_psnr(cpi->source, &cpi->common.cur_frame->buf, &psnr);
-#endif
 
   for (i = 0; i < 4; ++i) {
-    pkt.data.psnr.samples[i] = psnr.samples[i];
-    pkt.data.psnr.sse[i] = psnr.sse[i];
-    pkt.data.psnr.psnr[i] = psnr.psnr[i];
+    pkt.data.psnr.samples[i] = psnr->samples[i];
+    pkt.data.psnr.sse[i] = psnr->sse[i];
+    pkt.data.psnr.psnr[i] = psnr->psnr[i];
   }
 
 #if CONFIG_AV1_HIGHBITDEPTH
-  if ((cpi->source->flags & YV12_FLAG_HIGHBITDEPTH) &&
-      (in_bit_depth < bit_depth)) {
+  if (has_hbd) {
     for (i = 0; i < 4; ++i) {
-      pkt.data.psnr.samples_hbd[i] = psnr.samples_hbd[i];
-      pkt.data.psnr.sse_hbd[i] = psnr.sse_hbd[i];
-      pkt.data.psnr.psnr_hbd[i] = psnr.psnr_hbd[i];
+      pkt.data.psnr.samples_hbd[i] = psnr->samples_hbd[i];
+      pkt.data.psnr.sse_hbd[i] = psnr->sse_hbd[i];
+      pkt.data.psnr.psnr_hbd[i] = psnr->psnr_hbd[i];
     }
   }
+#else
+  (void)has_hbd;
 #endif
 
   pkt.kind = AOM_CODEC_PSNR_PKT;
-  aom_codec_pkt_list_add(cpi->ppi->output_pkt_list, &pkt);
+  aom_codec_pkt_list_add(ppi->output_pkt_list, &pkt);
+}
+
+static void get_psnr_bit_depths(const AV1_COMP *cpi, uint32_t *bit_depth,
+                                uint32_t *in_bit_depth) {
+#if CONFIG_AV1_HIGHBITDEPTH
+  *in_bit_depth = cpi->oxcf.input_cfg.input_bit_depth;
+  *bit_depth = cpi->td.mb.e_mbd.bd;
+#else
+  (void)cpi;
+  *in_bit_depth = 8;
+  *bit_depth = 8;
+#endif
+}
+
+// Returns 1 if the PSNR also has to be reported at the stream bit depth.
+static int psnr_has_hbd(const YV12_BUFFER_CONFIG *source, uint32_t bit_depth,
+                        uint32_t in_bit_depth) {
+  return (source->flags & YV12_FLAG_HIGHBITDEPTH) && in_bit_depth < bit_depth;
+}
+
+// Computes the PSNR of the frame just encoded, spread over the encoder
+// workers.
+static void calc_frame_psnr(AV1_COMP *cpi, PSNR_STATS *psnr) {
+  uint32_t bit_depth, in_bit_depth;
+  get_psnr_bit_depths(cpi, &bit_depth, &in_bit_depth);
+  av1_start_module_timer(cpi, MOD_METRICS);
+  av1_calc_psnr_mt(&cpi->common, &cpi->mt_info, cpi->source,
+                   &cpi->common.cur_frame->buf, bit_depth, in_bit_depth, psnr);
+  av1_end_module_timer(cpi, MOD_METRICS);
+}
+
+static void generate_psnr_packet(AV1_COMP *cpi) {
+  PSNR_STATS psnr;
+  uint32_t bit_depth, in_bit_depth;
+  get_psnr_bit_depths(cpi, &bit_depth, &in_bit_depth);
+  calc_frame_psnr(cpi, &psnr);
+  add_psnr_packet(cpi->ppi, &psnr,
+                  psnr_has_hbd(cpi->source, bit_depth, in_bit_depth));
+}
+
+static int calc_async_psnr_hook(void *arg1, void *arg2) {
+  AsyncPsnrInfo *const info = (AsyncPsnrInfo *)arg1;
+  uint64_t sse[3] = { 0, 0, 0 };
+  uint64_t sse_hbd[3] = { 0, 0, 0 };
+  (void)arg2;
+  aom_calc_psnr_sse_rows(info->source, &info->recon->buf, 0,
+                         info->source->y_crop_height, info->bit_depth,
+                         info->in_bit_depth, sse, sse_hbd);
+  aom_calc_psnr_from_sse(info->source, sse, sse_hbd, info->bit_depth,
+                         info->in_bit_depth, &info->psnr);
+  return 1;
+}
+
+// Starts computing the PSNR of the frame just encoded on the background
+// worker. Returns 0 if the worker could not be started.
+static int launch_async_psnr(AV1_COMP *cpi) {
+  AsyncPsnrInfo *const info = &cpi->ppi->async_psnr;
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+
+  av1_finish_async_psnr(cpi->ppi);
+  if (!info->worker_created) {
+    winterface->init(&info->worker);
+    info->worker.thread_name = "aom psnr worker";
+    if (!winterface->reset(&info->worker)) {
+      winterface->end(&info->worker);
+      return 0;
+    }
+    info->worker_created = 1;
+  }
+
+  info->source = cpi->source;
+  info->recon = cpi->common.cur_frame;
+  // Keep the reconstruction alive until the computation has been synced.
+  ++info->recon->ref_count;
+  get_psnr_bit_depths(cpi, &info->bit_depth, &info->in_bit_depth);
+  info->has_hbd =
+      psnr_has_hbd(info->source, info->bit_depth, info->in_bit_depth);
+  info->worker.hook = calc_async_psnr_hook;
+  info->worker.data1 = info;
+  info->worker.data2 = NULL;
+  info->pending = 1;
+  winterface->launch(&info->worker);
+  return 1;
+}
+
+void av1_sync_async_psnr(AV1_PRIMARY *ppi) {
+  AsyncPsnrInfo *const info = &ppi->async_psnr;
+  if (info->recon == NULL) return;
+  aom_get_worker_interface()->sync(&info->worker);
+  --info->recon->ref_count;
+  info->recon = NULL;
+  info->source = NULL;
+}
+
+void av1_finish_async_psnr(AV1_PRIMARY *ppi) {
+  AsyncPsnrInfo *const info = &ppi->async_psnr;
+  av1_sync_async_psnr(ppi);
+  if (!info->pending) return;
+  add_psnr_packet(ppi, &info->psnr, info->has_hbd);
+  info->pending = 0;
 }
 
 int av1_use_as_reference(int *ext_ref_frame_flags, int ref_frame_flags) {
@@ -2196,19 +2340,35 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
     start_timing(cpi, cdef_time);
 #endif
     const int num_workers = cpi->mt_info.num_mod_workers[MOD_CDEF];
-    const int use_screen_content_model =
-        cm->quant_params.base_qindex >
-            AOMMAX(cpi->sf.rt_sf.screen_content_cdef_filter_qindex_thresh,
-                   cpi->rc.best_quality + 5) &&
-        cpi->oxcf.tune_cfg.content == AOM_CONTENT_SCREEN;
+    const int use_screen_content_model = use_screen_content_cdef_model(cpi);
     // Find CDEF parameters
+    // The frame header of tile groups output early already holds the
+    // strengths derived from q by av1_tile_group_output_init(), which are
+    // derived again here to reset the strengths of the superblocks.
+    const CDEF_PICK_METHOD pick_method = cpi->tg_output.early
+                                             ? CDEF_PICK_FROM_Q
+                                             : cpi->sf.lpf_sf.cdef_pick_method;
+#ifndef NDEBUG
+    const CdefInfo cdef_info = cm->cdef_info;
+#endif
+    av1_start_module_timer(cpi, MOD_CDEF_SEARCH);
     av1_cdef_search(&cpi->mt_info, &cm->cur_frame->buf, cpi->source, cm, xd,
-                    cpi->sf.lpf_sf.cdef_pick_method, cpi->td.mb.rdmult,
-                    cpi->sf.rt_sf.skip_cdef_sb, cpi->oxcf.tool_cfg.cdef_control,
-                    use_screen_content_model, cpi->rtc_ref.non_reference_frame);
+                    pick_method, cpi->sf.lpf_sf.prune_cdef_strengths,
+                    cpi->td.mb.rdmult, cpi->sf.rt_sf.skip_cdef_sb,
+                    cpi->oxcf.tool_cfg.cdef_control, use_screen_content_model,
+                    cpi->rtc_ref.non_reference_frame);
+    av1_end_module_timer(cpi, MOD_CDEF_SEARCH);
+    assert(IMPLIES(
+        cpi->tg_output.early,
+        cm->cdef_info.cdef_bits == cdef_info.cdef_bits &&
+            cm->cdef_info.cdef_damping == cdef_info.cdef_damping &&
+            cm->cdef_info.cdef_strengths[0] == cdef_info.cdef_strengths[0] &&
+            cm->cdef_info.cdef_uv_strengths[0] ==
+                cdef_info.cdef_uv_strengths[0]));
 
     // Apply the filter
     if (!cpi->rtc_ref.non_reference_frame) {
+      av1_start_module_timer(cpi, MOD_CDEF);
       if (num_workers > 1) {
         const int do_extend_border = do_extend_borders_with_cdef_mt(cm);
         av1_cdef_frame_mt(cm, xd, cpi->mt_info.cdef_worker,
@@ -2218,6 +2378,7 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
       } else {
         av1_cdef_frame(&cm->cur_frame->buf, cm, xd, av1_cdef_init_fb_row);
       }
+      av1_end_module_timer(cpi, MOD_CDEF);
     }
 #if CONFIG_COLLECT_COMPONENT_TIMING
     end_timing(cpi, cdef_time);
@@ -2238,6 +2399,7 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
   if (use_restoration) {
     MultiThreadInfo *const mt_info = &cpi->mt_info;
     const int num_workers = mt_info->num_mod_workers[MOD_LR];
+    av1_start_module_timer(cpi, MOD_LR);
     av1_loop_restoration_save_boundary_lines(&cm->cur_frame->buf, cm, 1);
     av1_pick_filter_restoration(cpi->source, cpi);
     if (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
@@ -2253,6 +2415,7 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
                                           &cpi->lr_ctxt);
       }
     }
+    av1_end_module_timer(cpi, MOD_LR);
   } else {
     cm->rst_info[0].frame_restoration_type = RESTORE_NONE;
     cm->rst_info[1].frame_restoration_type = RESTORE_NONE;
@@ -2282,7 +2445,10 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
       !cm->features.coded_lossless && !cm->tiles.large_scale;
   const int use_cdef = cm->seq_params->enable_cdef &&
                        !cm->features.coded_lossless && !cm->tiles.large_scale;
-  const int use_restoration = is_restoration_used(cm);
+  // The tiles of tile groups output early carry no loop restoration
+  // coefficients.
+  const int use_restoration =
+      is_restoration_used(cm) && !cpi->tg_output.early;
 
   // TODO(deepa.kg@ittiam.com): When cdef and loop-restoration are disabled,
   // multi-thread frame border extension along with loop filter frame.
@@ -2309,8 +2475,11 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, loop_filter_time);
 #endif
+  av1_start_module_timer(cpi, MOD_LPF);
   if (use_loopfilter) {
-    av1_pick_filter_level(cpi->source, cpi, cpi->sf.lpf_sf.lpf_pick);
+    // The levels of tile groups output early are already in the frame header.
+    if (!cpi->tg_output.early)
+      av1_pick_filter_level(cpi->source, cpi, cpi->sf.lpf_sf.lpf_pick);
   } else {
     lf->filter_level[0] = 0;
     lf->filter_level[1] = 0;
@@ -2322,6 +2491,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
                              mt_info->workers, num_workers,
                              &mt_info->lf_row_sync, lpf_opt_level);
   }
+  av1_end_module_timer(cpi, MOD_LPF);
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, loop_filter_time);
 #endif
@@ -2576,18 +2746,32 @@ static int encode_without_recode(AV1_COMP *cpi) {
   // frame.
   if (!frame_is_intra_only(cm)) av1_pick_and_set_high_precision_mv(cpi, q);
 
+  // Unless the frame is encoded again with superres, this is its final
+  // encode and its tile groups can be output as their tiles are encoded.
+  const int tg_output_early =
+      cpi->tg_output.output != NULL && !av1_superres_in_recode_allowed(cpi);
+  cpi->tg_output.early = tg_output_early;
+
+  // Adjust the refresh of the golden (longer-term) reference based on QP
+  // selected for this frame. This is for CBR with 1 layer/non-svc RTC mode.
+  // The refresh flags are in the frame header, so when it is output before
+  // the tiles are encoded, the adjustment is made first, without the motion
+  // statistics of the frame.
+  const int adjust_gf_refresh =
+      !frame_is_intra_only(cm) && cpi->oxcf.rc_cfg.mode == AOM_CBR &&
+      cpi->oxcf.mode == REALTIME && svc->number_spatial_layers == 1 &&
+      svc->number_temporal_layers == 1 && !cpi->rc.rtc_external_ratectrl &&
+      sf->rt_sf.gf_refresh_based_on_qp;
+  if (adjust_gf_refresh && tg_output_early)
+    av1_adjust_gf_refresh_qp_one_pass_rt(cpi);
+
   // transform / motion compensation build reconstruction frame
   av1_encode_frame(cpi);
 
   if (!cpi->rc.rtc_external_ratectrl && !frame_is_intra_only(cm))
     update_motion_stat(cpi);
 
-  // Adjust the refresh of the golden (longer-term) reference based on QP
-  // selected for this frame. This is for CBR with 1 layer/non-svc RTC mode.
-  if (!frame_is_intra_only(cm) && cpi->oxcf.rc_cfg.mode == AOM_CBR &&
-      cpi->oxcf.mode == REALTIME && svc->number_spatial_layers == 1 &&
-      svc->number_temporal_layers == 1 && !cpi->rc.rtc_external_ratectrl &&
-      sf->rt_sf.gf_refresh_based_on_qp)
+  if (adjust_gf_refresh && !tg_output_early)
     av1_adjust_gf_refresh_qp_one_pass_rt(cpi);
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
@@ -3889,10 +4073,12 @@ int av1_encode(AV1_COMP *const cpi, uint8_t *const dest,
 
   if (is_stat_generation_stage(cpi)) {
 #if !CONFIG_REALTIME_ONLY
+    av1_start_module_timer(cpi, MOD_FP);
     if (cpi->oxcf.q_cfg.use_fixed_qp_offsets)
       av1_noop_first_pass_frame(cpi, frame_input->ts_duration);
     else
       av1_first_pass(cpi, frame_input->ts_duration);
+    av1_end_module_timer(cpi, MOD_FP);
 #endif
   } else if (cpi->oxcf.pass == AOM_RC_ONE_PASS ||
              cpi->oxcf.pass >= AOM_RC_SECOND_PASS) {
@@ -4091,28 +4277,27 @@ static void compute_internal_stats(AV1_COMP *cpi, int frame_bytes) {
   if (cm->show_frame) {
     const YV12_BUFFER_CONFIG *orig = cpi->source;
     const YV12_BUFFER_CONFIG *recon = &cpi->common.cur_frame->buf;
-    double y, u, v, frame_all;
+    FrameQualityMetrics metrics;
 
     ppi->count[0]++;
     ppi->count[1]++;
+    av1_zero(metrics);
+    av1_start_module_timer(cpi, MOD_METRICS);
+    av1_calc_quality_metrics_mt(cm, &cpi->mt_info, orig, recon, bit_depth,
+                                in_bit_depth, cm->seq_params->use_highbitdepth,
+                                cpi->ppi->b_calculate_psnr, &metrics);
+    av1_end_module_timer(cpi, MOD_METRICS);
     if (cpi->ppi->b_calculate_psnr) {
       PSNR_STATS psnr;
-      double weight[2] = { 0.0, 0.0 };
-      double frame_ssim2[2] = { 0.0, 0.0 };
-#if CONFIG_AV1_HIGHBITDEPTH
-      aom_calc_highbd_psnr(orig, recon, &psnr, bit_depth, in_bit_depth);
-#else
-      aom_calc_psnr(orig, recon, &psnr);
-#endif
+      const double *const weight = metrics.ssim_weight;
+      const double *const frame_ssim2 = metrics.ssim;
+      calc_frame_psnr(cpi, &psnr);
       adjust_image_stat(psnr.psnr[1], psnr.psnr[2], psnr.psnr[3], psnr.psnr[0],
                         &(ppi->psnr[0]));
       ppi->total_sq_error[0] += psnr.sse[0];
       ppi->total_samples[0] += psnr.samples[0];
       samples = psnr.samples[0];
 
-      aom_calc_ssim(orig, recon, bit_depth, in_bit_depth,
-                    cm->seq_params->use_highbitdepth, weight, frame_ssim2);
-
       ppi->worst_ssim = AOMMIN(ppi->worst_ssim, frame_ssim2[0]);
       ppi->summed_quality += frame_ssim2[0] * weight[0];
       ppi->summed_weights += weight[0];
@@ -4172,11 +4357,11 @@ static void compute_internal_stats(AV1_COMP *cpi, int frame_bytes) {
       }
     }
 
-    frame_all =
-        aom_calc_fastssim(orig, recon, &y, &u, &v, bit_depth, in_bit_depth);
-    adjust_image_stat(y, u, v, frame_all, &ppi->fastssim);
-    frame_all = aom_psnrhvs(orig, recon, &y, &u, &v, bit_depth, in_bit_depth);
-    adjust_image_stat(y, u, v, frame_all, &ppi->psnrhvs);
+    adjust_image_stat(metrics.fastssim[1], metrics.fastssim[2],
+                      metrics.fastssim[3], metrics.fastssim[0],
+                      &ppi->fastssim);
+    adjust_image_stat(metrics.psnrhvs[1], metrics.psnrhvs[2],
+                      metrics.psnrhvs[3], metrics.psnrhvs[0], &ppi->psnrhvs);
   }
 }
 
@@ -4516,7 +4701,8 @@ void av1_post_encode_updates(AV1_COMP *const cpi,
   if (ppi->b_calculate_psnr && cpi_data->frame_size > 0) {
     if (cm->show_existing_frame ||
         (!is_stat_generation_stage(cpi) && cm->show_frame)) {
-      generate_psnr_packet(cpi);
+      if (!ppi->async_psnr.enabled || !launch_async_psnr(cpi))
+        generate_psnr_packet(cpi);
     }
   }
 
@@ -4544,6 +4730,8 @@ int av1_get_compressed_data(AV1_COMP *cpi, AV1_COMP_DATA *const cpi_data) {
   }
   cm->error->setjmp = 1;
 
+  av1_time_budget_frame_start(cpi);
+
 #if CONFIG_INTERNAL_STATS
   cpi->frame_recode_hits = 0;
   cpi->time_compress_data = 0;
@@ -4661,6 +4849,8 @@ int av1_get_compressed_data(AV1_COMP *cpi, AV1_COMP_DATA *const cpi_data) {
   cpi->time_compress_data += aom_usec_timer_elapsed(&cmptimer);
 #endif  // CONFIG_INTERNAL_STATS
 
+  if (!is_stat_generation_stage(cpi)) av1_time_budget_frame_end(cpi);
+
 #if CONFIG_SPEED_STATS
   if (!is_stat_generation_stage(cpi) && !cm->show_existing_frame) {
     cpi->tx_search_count += cpi->td.mb.txfm_search_info.tx_search_count;
@@ -49,12 +49,14 @@
 #include "av1/encoder/speed_features.h"
 #include "av1/encoder/svc_layercontext.h"
 #include "av1/encoder/temporal_filter.h"
+#include "av1/encoder/time_budget.h"
 #include "av1/encoder/thirdpass.h"
 #include "av1/encoder/tokenize.h"
 #include "av1/encoder/tpl_model.h"
 #include "av1/encoder/av1_noise_estimate.h"
 #include "av1/encoder/bitstream.h"
 
+#include "aom_dsp/psnr.h"
 #if CONFIG_INTERNAL_STATS
 #include "aom_dsp/ssim.h"
 #endif
@@ -73,6 +75,7 @@
 #endif
 
 #include "aom/internal/aom_codec_internal.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_util/aom_thread.h"
 
 #ifdef __cplusplus
@@ -201,6 +204,7 @@ typedef enum {
   MOD_CDEF,         // CDEF frame
   MOD_LR,           // Loop restoration filtering
   MOD_PACK_BS,      // Pack bitstream
+  MOD_METRICS,      // Frame quality metrics
   MOD_FRAME_ENC,    // Frame Parallel encode
   NUM_MT_MODULES
 } MULTI_THREADED_MODULES;
@@ -1000,6 +1004,8 @@ typedef struct AV1EncoderConfig {
 #if CONFIG_AV1_TEMPORAL_DENOISING
   // Noise sensitivity.
   int noise_sensitivity;
+  // Indicates whether to denoise each SB row before it is encoded.
+  int denoise_prepass;
 #endif
   // Bit mask to specify which tier each of the 32 possible operating points
   // conforms to.
@@ -1740,6 +1746,9 @@ typedef struct MultiThreadInfo {
 typedef struct ActiveMap {
   int enabled;
   int update;
+  // Set when the map was built from dirty rectangles, which only describe the
+  // next frame.
+  int expire;
   unsigned char *map;
 } ActiveMap;
 
@@ -1823,7 +1832,6 @@ typedef struct FramePartitionTimingStats {
 #endif  // CONFIG_COLLECT_PARTITION_STATS
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
-#include "aom_ports/aom_timer.h"
 // Adjust the following to add new components.
 enum {
   av1_encode_strategy_time,
@@ -2409,6 +2417,55 @@ typedef struct DuckyEncodeInfo {
 /*!\endcond */
 #endif
 
+/*!
+ * \brief Per 8x8 block statistics of the luma source, and zero motion SADs
+ * against LAST, gathered once per frame for variance based partitioning.
+ */
+typedef struct {
+  /*!
+   * Set when the statistics of the current frame are available.
+   */
+  int valid;
+  /*!
+   * Set when the statistics against LAST are available.
+   */
+  int has_last;
+  /*!
+   * Number of complete 8x8 luma blocks in a row and in a column of the frame,
+   * also the stride of the luma buffers.
+   */
+  int cols, rows;
+  /*!
+   * Number of complete 8x8 chroma blocks in a row and in a column of the
+   * frame, also the stride of the chroma buffers.
+   */
+  int uv_cols, uv_rows;
+  /*!
+   * Number of luma and chroma blocks the buffers are allocated for.
+   */
+  int alloc_size, uv_alloc_size;
+  /*!
+   * Sum of the source pixels of each block.
+   */
+  uint16_t *src_sum;
+  /*!
+   * Sum of squares of the source pixels of each block.
+   */
+  uint32_t *src_sse;
+  /*!
+   * Sum of the LAST pixels of each block.
+   */
+  uint16_t *last_sum;
+  /*!
+   * SAD of the source against LAST of each block.
+   */
+  uint16_t *last_sad;
+  /*!
+   * SAD of the source against LAST of each chroma block, for U and V.
+   */
+  uint16_t *last_sad_uv[2];
+} SrcStats8x8;
+
 /*!\cond */
 typedef struct RTC_REF {
   /*!
@@ -2480,6 +2537,91 @@ typedef struct AV1_COMP_DATA {
   int frame_display_order_hint;
 } AV1_COMP_DATA;
 
+/*!
+ * \brief Background PSNR computation (AV1E_SET_ASYNC_PSNR).
+ */
+typedef struct {
+  /*!
+   * When set, the PSNR of each shown frame is computed on worker while the
+   * application carries on, and reported with the next aom_codec_encode()
+   * call.
+   */
+  int enabled;
+
+  /*!
+   * Set once worker has been reset, i.e. owns a thread.
+   */
+  int worker_created;
+
+  /*!
+   * Set from the launch of a computation until its packet is emitted.
+   */
+  int pending;
+
+  /*!
+   * Set when the PSNR at the stream bit depth is reported as well.
+   */
+  int has_hbd;
+
+  /*!
+   * Worker computing the PSNR.
+   */
+  AVxWorker worker;
+
+  /*!
+   * Source frame of the computation.
+   */
+  const YV12_BUFFER_CONFIG *source;
+
+  /*!
+   * Reconstructed frame of the computation. A reference to it is held while
+   * the computation is in flight; NULL otherwise.
+   */
+  RefCntBuffer *recon;
+
+  /*!
+   * Bit depth of the frames.
+   */
+  uint32_t bit_depth;
+
+  /*!
+   * Input bit depth.
+   */
+  uint32_t in_bit_depth;
+
+  /*!
+   * Result of the computation.
+   */
+  PSNR_STATS psnr;
+} AsyncPsnrInfo;
+
+#if CONFIG_INTERNAL_STATS
+/*!
+ * \brief Frame level quality metrics collected for the internal stats.
+ */
+typedef struct {
+  /*!
+   * SSIM weights at the input and at the stream bit depth.
+   */
+  double ssim_weight[2];
+
+  /*!
+   * SSIM at the input and at the stream bit depth.
+   */
+  double ssim[2];
+
+  /*!
+   * Fast SSIM: total/y/u/v.
+   */
+  double fastssim[4];
+
+  /*!
+   * PSNR-HVS: total/y/u/v.
+   */
+  double psnrhvs[4];
+} FrameQualityMetrics;
+#endif  // CONFIG_INTERNAL_STATS
+
 /*!
  * \brief Top level primary encoder structure
  */
@@ -2621,6 +2763,11 @@ typedef struct AV1_PRIMARY {
    */
   int b_calculate_psnr;
 
+  /*!
+   * Background PSNR computation.
+   */
+  AsyncPsnrInfo async_psnr;
+
   /*!
    * Number of frames left to be encoded, is 0 if limit is not set.
    */
@@ -2765,6 +2912,72 @@ typedef struct AV1_PRIMARY {
   int valid_gm_model_found[FRAME_UPDATE_TYPES];
 } AV1_PRIMARY;
 
+/*!
+ * \brief Output of the tile groups of a frame as soon as their tiles are
+ * encoded.
+ */
+typedef struct {
+  /*!
+   * Called first with the OBUs that precede the tile groups, written before
+   * the frame is encoded, then with each tile group OBU as soon as its tiles
+   * are packed. is_last is set for the last tile group of the frame. NULL
+   * disables the output.
+   */
+  void (*output)(void *priv, const uint8_t *data, size_t size, int is_last);
+  /*!
+   * Opaque pointer passed to output().
+   */
+  void *priv;
+  /*!
+   * Set while the tile groups of the frame being encoded are packed and
+   * output as their tiles finish. The frame header is then fixed and output
+   * before the tiles are encoded.
+   */
+  int early;
+  /*!
+   * Number of calls to output() since it was last reset.
+   */
+  int num_output;
+  /*!
+   * Index of the next tile to pack, in bitstream order.
+   */
+  int next_tile;
+  /*!
+   * tile_done[i] is set once tile i has been encoded.
+   */
+  uint8_t tile_done[MAX_TILES];
+  /*!
+   * OBUs of the frame, packed one after the other.
+   */
+  uint8_t *buf;
+  /*!
+   * Allocated size of buf.
+   */
+  size_t buf_size;
+  /*!
+   * Number of bytes of buf filled so far.
+   */
+  uint32_t size;
+  /*!
+   * Offset in buf of the tile group being packed.
+   */
+  uint32_t tg_start;
+  /*!
+   * Size of the OBU header of the tile group being packed.
+   */
+  uint32_t obu_header_size;
+  /*!
+   * Thread data used to pack the tiles.
+   */
+  ThreadData *td;
+#if CONFIG_MULTITHREAD
+  /*!
+   * Serializes the packing of tiles finished by different threads.
+   */
+  pthread_mutex_t *mutex_;
+#endif
+} TileGroupOutput;
+
 /*!
  * \brief Top level encoder structure.
  */
@@ -3217,6 +3430,16 @@ typedef struct AV1_COMP {
   FramePartitionTimingStats partition_stats;
 #endif  // CONFIG_COLLECT_PARTITION_STATS
 
+  /*!
+   * Wall time in microseconds spent in each of the multi-threaded modules since
+   * the encoder started, whether or not a module ran on more than one thread.
+   */
+  uint64_t module_time[NUM_MT_MODULES];
+  /*!
+   * Timers of the modules accumulated in module_time[].
+   */
+  struct aom_usec_timer module_timer[NUM_MT_MODULES];
+
 #if CONFIG_COLLECT_COMPONENT_TIMING
   /*!
    * component_time[] are initialized to zero while encoder starts.
@@ -3447,6 +3670,16 @@ typedef struct AV1_COMP {
    */
   uint64_t *src_sad_blk_64x64;
 
+  /*!
+   * Per 8x8 block source statistics for variance based partitioning.
+   */
+  SrcStats8x8 src_stats_8x8;
+
+  /*!
+   * Deadline driven speed control, see AV1E_SET_FRAME_TIME_BUDGET.
+   */
+  TimeBudget time_budget;
+
   /*!
    * A flag to indicate whether the encoder is controlled by DuckyEncode or not.
    * 1:yes 0:no
@@ -3469,6 +3702,11 @@ typedef struct AV1_COMP {
    * Struct for the reference structure for RTC.
    */
   RTC_REF rtc_ref;
+
+  /*!
+   * Early output of tile groups for low-latency streaming.
+   */
+  TileGroupOutput tg_output;
 } AV1_COMP;
 
 /*!
@@ -3581,6 +3819,29 @@ void av1_init_seq_coding_tools(AV1_PRIMARY *const ppi,
 void av1_post_encode_updates(AV1_COMP *const cpi,
                              const AV1_COMP_DATA *const cpi_data);
 
+/*!\brief Waits for the background PSNR computation to finish
+ *
+ * \ingroup high_level_algo
+ *
+ * Waits for the PSNR being computed in the background (AV1E_SET_ASYNC_PSNR),
+ * if any, and releases its frames. Its packet stays pending. Must be called
+ * before the source or reconstruction buffers can be modified or freed.
+ *
+ * \param[in]    ppi           Top-level encoder structure
+ */
+void av1_sync_async_psnr(AV1_PRIMARY *ppi);
+
+/*!\brief Emits the PSNR computed in the background
+ *
+ * \ingroup high_level_algo
+ *
+ * Calls av1_sync_async_psnr() and adds the pending AOM_CODEC_PSNR_PKT, if
+ * any, to the output packet list.
+ *
+ * \param[in]    ppi           Top-level encoder structure
+ */
+void av1_finish_async_psnr(AV1_PRIMARY *ppi);
+
 void av1_scale_references_fpmt(AV1_COMP *cpi, int *ref_buffers_used_map);
 
 void av1_increment_scaled_ref_counts_fpmt(BufferPool *buffer_pool,
@@ -3678,6 +3939,9 @@ int av1_set_active_map(AV1_COMP *cpi, unsigned char *map, int rows, int cols);
 
 int av1_get_active_map(AV1_COMP *cpi, unsigned char *map, int rows, int cols);
 
+int av1_set_dirty_rects(AV1_COMP *cpi, const aom_dirty_rect_t *rects,
+                        int num_rects);
+
 int av1_set_internal_size(AV1EncoderConfig *const oxcf,
                           ResizePendingParams *resize_pending_params,
                           AOM_SCALING_MODE horiz_mode,
@@ -4201,6 +4465,16 @@ static INLINE int av1_get_bsize_idx_for_part_stats(BLOCK_SIZE bsize) {
 }
 #endif  // CONFIG_COLLECT_PARTITION_STATS
 
+static INLINE void av1_start_module_timer(AV1_COMP *cpi,
+                                          MULTI_THREADED_MODULES mod) {
+  aom_usec_timer_start(&cpi->module_timer[mod]);
+}
+static INLINE void av1_end_module_timer(AV1_COMP *cpi,
+                                        MULTI_THREADED_MODULES mod) {
+  aom_usec_timer_mark(&cpi->module_timer[mod]);
+  cpi->module_time[mod] += aom_usec_timer_elapsed(&cpi->module_timer[mod]);
+}
+
 #if CONFIG_COLLECT_COMPONENT_TIMING
 static INLINE void start_timing(AV1_COMP *cpi, int component) {
   aom_usec_timer_start(&cpi->component_timer[component]);
@@ -17,6 +17,7 @@
 #include "av1/encoder/encodetxb.h"
 #include "av1/encoder/ethread.h"
 #include "av1/encoder/intra_mode_search_utils.h"
+#include "av1/encoder/var_based_part.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -296,6 +297,9 @@ static AOM_INLINE void dealloc_compressor_data(AV1_COMP *cpi) {
   if (cpi->ppi->use_svc) av1_free_svc_cyclic_refresh(cpi);
   aom_free(cpi->svc.layer_context);
   cpi->svc.layer_context = NULL;
+  aom_free(cpi->svc.lower_layer_mvs.mvs);
+  cpi->svc.lower_layer_mvs.mvs = NULL;
+  cpi->svc.lower_layer_mvs.alloc_size = 0;
 
   if (cpi->consec_zero_mv) {
     aom_free(cpi->consec_zero_mv);
@@ -307,6 +311,9 @@ static AOM_INLINE void dealloc_compressor_data(AV1_COMP *cpi) {
     cpi->src_sad_blk_64x64 = NULL;
   }
 
+  av1_free_src_stats_8x8(&cpi->src_stats_8x8);
+  av1_time_budget_free(&cpi->time_budget);
+
   aom_free(cpi->mb_weber_stats);
   cpi->mb_weber_stats = NULL;
 
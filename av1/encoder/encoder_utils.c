@@ -425,17 +425,35 @@ void av1_apply_active_map(AV1_COMP *cpi) {
 
   assert(AM_SEGMENT_ID_ACTIVE == CR_SEGMENT_ID_BASE);
 
+  // Dirty rectangles only cover the frame they were set for. Without new ones
+  // the whole frame is active again.
+  if (cpi->active_map.expire && !cpi->active_map.update) {
+    cpi->active_map.enabled = 0;
+    cpi->active_map.update = 1;
+    cpi->active_map.expire = 0;
+  }
+
   if (frame_is_intra_only(&cpi->common)) {
     cpi->active_map.enabled = 0;
     cpi->active_map.update = 1;
   }
 
-  if (cpi->active_map.update) {
+  // Cyclic refresh rebuilds the segmentation of every frame, so the active map
+  // has to be applied again on top of it.
+  if (cpi->active_map.update ||
+      (cpi->active_map.enabled &&
+       cpi->oxcf.q_cfg.aq_mode == CYCLIC_REFRESH_AQ)) {
     if (cpi->active_map.enabled) {
+      // Inactive blocks override the cyclic refresh segments, and blocks that
+      // became active leave the inactive segment.
       for (i = 0;
            i < cpi->common.mi_params.mi_rows * cpi->common.mi_params.mi_cols;
-           ++i)
-        if (seg_map[i] == AM_SEGMENT_ID_ACTIVE) seg_map[i] = active_map[i];
+           ++i) {
+        if (active_map[i] == AM_SEGMENT_ID_INACTIVE)
+          seg_map[i] = AM_SEGMENT_ID_INACTIVE;
+        else if (seg_map[i] == AM_SEGMENT_ID_INACTIVE)
+          seg_map[i] = AM_SEGMENT_ID_ACTIVE;
+      }
       av1_enable_segmentation(seg);
       av1_enable_segfeature(seg, AM_SEGMENT_ID_INACTIVE, SEG_LVL_SKIP);
       av1_enable_segfeature(seg, AM_SEGMENT_ID_INACTIVE, SEG_LVL_ALT_LF_Y_H);
@@ -1138,6 +1156,9 @@ void av1_finalize_encoded_frame(AV1_COMP *const cpi) {
       cm->film_grain_params.random_seed = 7391;
   }
 
+  // The tiles are already packed if their tile groups were output early.
+  if (cpi->tg_output.early) return;
+
   // Initialise all tiles' contexts from the global frame context
   for (int tile_col = 0; tile_col < cm->tiles.cols; tile_col++) {
     for (int tile_row = 0; tile_row < cm->tiles.rows; tile_row++) {
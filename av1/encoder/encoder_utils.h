@@ -911,6 +911,15 @@ static AOM_INLINE void copy_frame_prob_info(AV1_COMP *cpi) {
 #endif
 }
 
+// Returns 1 if the CDEF strengths derived from q use the model fitted on
+// screen content.
+static AOM_INLINE int use_screen_content_cdef_model(const AV1_COMP *cpi) {
+  return cpi->common.quant_params.base_qindex >
+             AOMMAX(cpi->sf.rt_sf.screen_content_cdef_filter_qindex_thresh,
+                    cpi->rc.best_quality + 5) &&
+         cpi->oxcf.tune_cfg.content == AOM_CONTENT_SCREEN;
+}
+
 static AOM_INLINE void restore_cdef_coding_context(CdefInfo *const dst,
                                                    const CdefInfo *const src) {
   dst->cdef_bits = src->cdef_bits;
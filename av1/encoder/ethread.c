@@ -28,6 +28,7 @@
 #include "aom_dsp/aom_dsp_common.h"
 #include "av1/encoder/temporal_filter.h"
 #include "av1/encoder/tpl_model.h"
+#include "av1/encoder/var_based_part.h"
 
 static AOM_INLINE void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
   td->rd_counts.compound_ref_used_flag |=
@@ -514,9 +515,15 @@ static int enc_row_mt_worker_hook(void *arg1, void *unused) {
 #endif
     this_tile->abs_sum_level += td->abs_sum_level;
     row_mt_sync->num_threads_working--;
+    // The thread that finishes the last row of a tile passes it on.
+    const int tile_done =
+        row_mt_sync->num_threads_working == 0 &&
+        row_mt_sync->next_mi_row >= tile_info->mi_row_end;
 #if CONFIG_MULTITHREAD
     pthread_mutex_unlock(enc_row_mt_mutex_);
 #endif
+    if (tile_done && cpi->tg_output.early)
+      av1_tile_group_output_tile_done(cpi, cur_tile_id);
   }
 
   return 1;
@@ -542,6 +549,8 @@ static int enc_worker_hook(void *arg1, void *unused) {
     thread_data->td->mb.e_mbd.tile_ctx = &this_tile->tctx;
     thread_data->td->mb.tile_pb_ctx = &this_tile->tctx;
     av1_encode_tile(cpi, thread_data->td, tile_row, tile_col);
+    if (cpi->tg_output.early)
+      av1_tile_group_output_tile_done(cpi, tile_row * tile_cols + tile_col);
   }
 
   return 1;
@@ -2695,6 +2704,323 @@ void av1_cdef_mse_calc_frame_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
   sync_enc_workers(mt_info, cm, num_workers);
 }
 
+// Job data for the CDEF joint strength search multi-threading.
+typedef struct {
+  CdefSearchCtx *cdef_search_ctx;
+  CdefStrengthSearchResult *search_res;
+  int start_job;
+  int job_step;
+} CdefStrengthSearchJob;
+
+// Hook function for each thread in CDEF joint strength search
+// multi-threading. Jobs are assigned statically, the most expensive (largest
+// number of strength bits) first.
+static int cdef_strength_search_worker_hook(void *arg1, void *arg2) {
+  CdefStrengthSearchJob *const job = (CdefStrengthSearchJob *)arg1;
+  (void)arg2;
+  for (int i = job->start_job; i <= CDEF_MAX_SEARCHED_STRENGTH_BITS;
+       i += job->job_step) {
+    const int nb_strength_bits = CDEF_MAX_SEARCHED_STRENGTH_BITS - i;
+    av1_cdef_strength_search(job->cdef_search_ctx, nb_strength_bits,
+                             &job->search_res[nb_strength_bits]);
+  }
+  return 1;
+}
+
+// Implements multi-threading for the CDEF joint strength search. Each worker
+// searches the best set of strengths for a different number of signaling
+// bits.
+void av1_cdef_strength_search_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
+                                 CdefSearchCtx *cdef_search_ctx,
+                                 CdefStrengthSearchResult *search_res) {
+  CdefStrengthSearchJob jobs[CDEF_MAX_SEARCHED_STRENGTH_BITS + 1];
+  const int num_workers =
+      AOMMIN(mt_info->num_mod_workers[MOD_CDEF_SEARCH],
+             CDEF_MAX_SEARCHED_STRENGTH_BITS + 1);
+
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *worker = &mt_info->workers[i];
+    jobs[i].cdef_search_ctx = cdef_search_ctx;
+    jobs[i].search_res = search_res;
+    jobs[i].start_job = i;
+    jobs[i].job_step = num_workers;
+    worker->hook = cdef_strength_search_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+  }
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, cm, num_workers);
+}
+
+// Job data for the source SAD multi-threading of the real-time scene
+// detection.
+typedef struct {
+  const SourceSadParams *params;
+  int start_row;
+  int row_step;
+  SourceSadStats stats;
+} SourceSadJob;
+
+// Hook function for each thread in source SAD multi-threading. Superblock
+// rows are assigned statically.
+static int source_sad_worker_hook(void *arg1, void *arg2) {
+  SourceSadJob *const job = (SourceSadJob *)arg1;
+  (void)arg2;
+  av1_source_sad_rows(job->params, job->start_row, job->row_step,
+                      &job->stats);
+  return 1;
+}
+
+// Implements multi-threading for the source SAD of the real-time scene
+// detection, on the encode stage workers. The statistics are integer sums, so
+// the result is the same for any number of workers.
+void av1_source_sad_mt(AV1_COMP *cpi, const SourceSadParams *params,
+                       SourceSadStats *stats) {
+  MultiThreadInfo *const mt_info = &cpi->mt_info;
+  SourceSadJob jobs[MAX_NUM_THREADS];
+  const int num_workers =
+      AOMMIN(mt_info->num_mod_workers[MOD_ENC], params->sb_rows);
+
+  av1_zero(*stats);
+  if (num_workers <= 1) {
+    av1_source_sad_rows(params, 0, 1, stats);
+    return;
+  }
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *worker = &mt_info->workers[i];
+    av1_zero(jobs[i]);
+    jobs[i].params = params;
+    jobs[i].start_row = i;
+    jobs[i].row_step = num_workers;
+    worker->hook = source_sad_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+  }
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, &cpi->common, num_workers);
+  for (int i = 0; i < num_workers; i++) {
+    stats->sum_sad += jobs[i].stats.sum_sad;
+    stats->num_samples += jobs[i].stats.num_samples;
+    stats->num_zero_temp_sad += jobs[i].stats.num_zero_temp_sad;
+    stats->num_low_var_high_sumdiff += jobs[i].stats.num_low_var_high_sumdiff;
+  }
+}
+
+// Job data for the multi-threading of the per 8x8 source statistics.
+typedef struct {
+  AV1_COMP *cpi;
+  int start_row;
+  int row_step;
+} SrcStats8x8Job;
+
+// Hook function for each thread in the source statistics multi-threading.
+// Strips are assigned statically.
+static int src_stats_8x8_worker_hook(void *arg1, void *arg2) {
+  SrcStats8x8Job *const job = (SrcStats8x8Job *)arg1;
+  (void)arg2;
+  av1_compute_src_stats_8x8_rows(job->cpi, job->start_row, job->row_step);
+  return 1;
+}
+
+// Implements multi-threading for the per 8x8 source statistics of variance
+// based partitioning, on the encode stage workers. Each strip of the frame
+// writes its own part of the statistics.
+void av1_src_stats_8x8_mt(AV1_COMP *cpi) {
+  MultiThreadInfo *const mt_info = &cpi->mt_info;
+  SrcStats8x8Job jobs[MAX_NUM_THREADS];
+  const int strip_blks = SRC_STATS_STRIP_HEIGHT >> 3;
+  const int num_strips =
+      (cpi->src_stats_8x8.rows + strip_blks - 1) / strip_blks;
+  const int num_workers =
+      AOMMIN(mt_info->num_mod_workers[MOD_ENC], num_strips);
+
+  if (num_workers <= 1) {
+    av1_compute_src_stats_8x8_rows(cpi, 0, 1);
+    return;
+  }
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *worker = &mt_info->workers[i];
+    jobs[i].cpi = cpi;
+    jobs[i].start_row = i;
+    jobs[i].row_step = num_workers;
+    worker->hook = src_stats_8x8_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+  }
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, &cpi->common, num_workers);
+}
+
+// Height in luma rows of the strips a frame is split into for PSNR
+// multi-threading. A multiple of 16 keeps the strips aligned to the 16x16
+// blocks of the SSE kernels.
+#define PSNR_STRIP_HEIGHT 64
+
+// Job data for the PSNR multi-threading.
+typedef struct {
+  const YV12_BUFFER_CONFIG *source;
+  const YV12_BUFFER_CONFIG *recon;
+  uint32_t bit_depth;
+  uint32_t in_bit_depth;
+  int start_strip;
+  int strip_step;
+  uint64_t sse[3];
+  uint64_t sse_hbd[3];
+} PsnrJob;
+
+// Hook function for each thread in PSNR multi-threading. Row strips are
+// assigned statically.
+static int calc_psnr_worker_hook(void *arg1, void *arg2) {
+  PsnrJob *const job = (PsnrJob *)arg1;
+  const int height = job->source->y_crop_height;
+  (void)arg2;
+  for (int row = job->start_strip * PSNR_STRIP_HEIGHT; row < height;
+       row += job->strip_step * PSNR_STRIP_HEIGHT) {
+    aom_calc_psnr_sse_rows(job->source, job->recon, row,
+                           AOMMIN(row + PSNR_STRIP_HEIGHT, height),
+                           job->bit_depth, job->in_bit_depth, job->sse,
+                           job->sse_hbd);
+  }
+  return 1;
+}
+
+// Implements multi-threading for the PSNR of a frame. The per-plane SSE is an
+// integer sum, so the result is the same for any number of workers.
+void av1_calc_psnr_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
+                      const YV12_BUFFER_CONFIG *source,
+                      const YV12_BUFFER_CONFIG *recon, uint32_t bit_depth,
+                      uint32_t in_bit_depth, PSNR_STATS *psnr) {
+  PsnrJob jobs[MAX_NUM_THREADS];
+  const int num_strips =
+      (source->y_crop_height + PSNR_STRIP_HEIGHT - 1) / PSNR_STRIP_HEIGHT;
+  const int num_workers =
+      AOMMIN(mt_info->num_mod_workers[MOD_METRICS], num_strips);
+  uint64_t sse[3] = { 0, 0, 0 };
+  uint64_t sse_hbd[3] = { 0, 0, 0 };
+
+  if (num_workers <= 1) {
+    aom_calc_psnr_sse_rows(source, recon, 0, source->y_crop_height, bit_depth,
+                           in_bit_depth, sse, sse_hbd);
+  } else {
+    for (int i = num_workers - 1; i >= 0; i--) {
+      AVxWorker *worker = &mt_info->workers[i];
+      av1_zero(jobs[i]);
+      jobs[i].source = source;
+      jobs[i].recon = recon;
+      jobs[i].bit_depth = bit_depth;
+      jobs[i].in_bit_depth = in_bit_depth;
+      jobs[i].start_strip = i;
+      jobs[i].strip_step = num_workers;
+      worker->hook = calc_psnr_worker_hook;
+      worker->data1 = &jobs[i];
+      worker->data2 = NULL;
+    }
+    launch_workers(mt_info, num_workers);
+    sync_enc_workers(mt_info, cm, num_workers);
+    for (int i = 0; i < num_workers; i++) {
+      for (int plane = 0; plane < 3; plane++) {
+        sse[plane] += jobs[i].sse[plane];
+        sse_hbd[plane] += jobs[i].sse_hbd[plane];
+      }
+    }
+  }
+  aom_calc_psnr_from_sse(source, sse, sse_hbd, bit_depth, in_bit_depth, psnr);
+}
+
+#if CONFIG_INTERNAL_STATS
+// Frame level metrics of the internal stats, most expensive first.
+enum {
+  METRIC_PSNRHVS,
+  METRIC_FASTSSIM,
+  METRIC_SSIM,
+  NUM_QUALITY_METRICS
+} UENUM1BYTE(QUALITY_METRIC);
+
+// Job data for the internal stats metrics multi-threading.
+typedef struct {
+  const YV12_BUFFER_CONFIG *source;
+  const YV12_BUFFER_CONFIG *recon;
+  uint32_t bit_depth;
+  uint32_t in_bit_depth;
+  int is_hbd;
+  int calc_ssim;
+  FrameQualityMetrics *metrics;
+  int start_job;
+  int job_step;
+} QualityMetricsJob;
+
+// Hook function for each thread in internal stats metrics multi-threading.
+// Every metric covers the whole frame and is computed by a single worker, so
+// the results are the same as with a single thread.
+static int calc_quality_metrics_worker_hook(void *arg1, void *arg2) {
+  QualityMetricsJob *const job = (QualityMetricsJob *)arg1;
+  FrameQualityMetrics *const m = job->metrics;
+  (void)arg2;
+  for (int i = job->start_job; i < NUM_QUALITY_METRICS; i += job->job_step) {
+    switch (i) {
+      case METRIC_PSNRHVS:
+        m->psnrhvs[0] =
+            aom_psnrhvs(job->source, job->recon, &m->psnrhvs[1],
+                        &m->psnrhvs[2], &m->psnrhvs[3], job->bit_depth,
+                        job->in_bit_depth);
+        break;
+      case METRIC_FASTSSIM:
+        m->fastssim[0] =
+            aom_calc_fastssim(job->source, job->recon, &m->fastssim[1],
+                              &m->fastssim[2], &m->fastssim[3], job->bit_depth,
+                              job->in_bit_depth);
+        break;
+      case METRIC_SSIM:
+        if (job->calc_ssim) {
+          aom_calc_ssim(job->source, job->recon, job->bit_depth,
+                        job->in_bit_depth, job->is_hbd, m->ssim_weight,
+                        m->ssim);
+        }
+        break;
+      default: assert(0); break;
+    }
+  }
+  return 1;
+}
+
+// Computes the SSIM (when calc_ssim is set), fast SSIM and PSNR-HVS of a
+// frame, each metric on its own worker.
+void av1_calc_quality_metrics_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
+                                 const YV12_BUFFER_CONFIG *source,
+                                 const YV12_BUFFER_CONFIG *recon,
+                                 uint32_t bit_depth, uint32_t in_bit_depth,
+                                 int is_hbd, int calc_ssim,
+                                 FrameQualityMetrics *metrics) {
+  QualityMetricsJob jobs[NUM_QUALITY_METRICS];
+  const int num_workers = AOMMAX(
+      AOMMIN(mt_info->num_mod_workers[MOD_METRICS], NUM_QUALITY_METRICS), 1);
+
+  for (int i = num_workers - 1; i >= 0; i--) {
+    jobs[i].source = source;
+    jobs[i].recon = recon;
+    jobs[i].bit_depth = bit_depth;
+    jobs[i].in_bit_depth = in_bit_depth;
+    jobs[i].is_hbd = is_hbd;
+    jobs[i].calc_ssim = calc_ssim;
+    jobs[i].metrics = metrics;
+    jobs[i].start_job = i;
+    jobs[i].job_step = num_workers;
+  }
+  if (num_workers == 1) {
+    calc_quality_metrics_worker_hook(&jobs[0], NULL);
+    return;
+  }
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *worker = &mt_info->workers[i];
+    worker->hook = calc_quality_metrics_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+  }
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, cm, num_workers);
+}
+#endif  // CONFIG_INTERNAL_STATS
+
 // Computes num_workers for temporal filter multi-threading.
 static AOM_INLINE int compute_num_tf_workers(AV1_COMP *cpi) {
   // For single-pass encode, using no. of workers as per tf block size was not
@@ -2761,6 +3087,9 @@ int compute_num_mod_workers(AV1_COMP *cpi, MULTI_THREADED_MODULES mod_name) {
     case MOD_CDEF: num_mod_workers = compute_num_cdef_workers(cpi); break;
     case MOD_LR: num_mod_workers = compute_num_lr_workers(cpi); break;
     case MOD_PACK_BS: num_mod_workers = compute_num_pack_bs_workers(cpi); break;
+    case MOD_METRICS:
+      num_mod_workers = av1_compute_num_enc_workers(cpi, cpi->oxcf.max_threads);
+      break;
     case MOD_FRAME_ENC:
       num_mod_workers = cpi->ppi->p_mt_info.num_mod_workers[MOD_FRAME_ENC];
       break;
@@ -101,8 +101,31 @@ void av1_init_tile_thread_data(AV1_PRIMARY *ppi, int is_first_pass);
 void av1_cdef_mse_calc_frame_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
                                 CdefSearchCtx *cdef_search_ctx);
 
+void av1_cdef_strength_search_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
+                                 CdefSearchCtx *cdef_search_ctx,
+                                 CdefStrengthSearchResult *search_res);
+
 void av1_cdef_mt_dealloc(AV1CdefSync *cdef_sync);
 
+void av1_source_sad_mt(struct AV1_COMP *cpi, const SourceSadParams *params,
+                       SourceSadStats *stats);
+
+void av1_src_stats_8x8_mt(struct AV1_COMP *cpi);
+
+void av1_calc_psnr_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
+                      const YV12_BUFFER_CONFIG *source,
+                      const YV12_BUFFER_CONFIG *recon, uint32_t bit_depth,
+                      uint32_t in_bit_depth, PSNR_STATS *psnr);
+
+#if CONFIG_INTERNAL_STATS
+void av1_calc_quality_metrics_mt(AV1_COMMON *cm, MultiThreadInfo *mt_info,
+                                 const YV12_BUFFER_CONFIG *source,
+                                 const YV12_BUFFER_CONFIG *recon,
+                                 uint32_t bit_depth, uint32_t in_bit_depth,
+                                 int is_hbd, int calc_ssim,
+                                 FrameQualityMetrics *metrics);
+#endif  // CONFIG_INTERNAL_STATS
+
 void av1_write_tile_obu_mt(
     AV1_COMP *const cpi, uint8_t *const dst, uint32_t *total_size,
     struct aom_write_bit_buffer *saved_wb, uint8_t obu_extn_header,
@@ -210,6 +210,14 @@ static INLINE int subpel_select(AV1_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
   return cpi->sf.mv_sf.subpel_force_stop;
 }
 
+// Limits the subpel search to half pel when the frame is behind its time
+// budget.
+static INLINE void limit_subpel_for_time_budget(
+    const MACROBLOCK *x, SUBPEL_MOTION_SEARCH_PARAMS *ms_params) {
+  if (x->time_budget_level >= TIME_BUDGET_LEVEL_HALF_PEL)
+    ms_params->forced_stop = AOMMAX(ms_params->forced_stop, HALF_PEL);
+}
+
 /*!\brief Runs Motion Estimation for a specific block and specific ref frame.
  *
  * \ingroup nonrd_mode_search
@@ -268,12 +276,16 @@ static int combined_motion_search(AV1_COMP *cpi, MACROBLOCK *x,
                          num_planes);
   }
 
-  start_mv = get_fullmv_from_mv(&ref_mv);
-
-  if (!use_base_mv)
+  if (!use_base_mv) {
+    start_mv = get_fullmv_from_mv(&ref_mv);
     center_mv = ref_mv;
-  else
+  } else {
+    // The base MV is a good estimate already: start from it and only refine
+    // it locally.
+    start_mv = get_fullmv_from_mv(&tmp_mv->as_mv);
     center_mv = tmp_mv->as_mv;
+    step_param = AOMMAX(step_param, MAX_MVSEARCH_STEPS - 3);
+  }
 
   const SEARCH_METHODS search_method = sf->mv_sf.search_method;
   const MotionVectorSearchParams *mv_search_params = &cpi->mv_search_params;
@@ -310,6 +322,7 @@ static int combined_motion_search(AV1_COMP *cpi, MACROBLOCK *x,
         sf->rt_sf.reduce_mv_pel_precision_lowcomplex)
       ms_params.forced_stop = subpel_select(cpi, x, bsize, tmp_mv, ref_mv,
                                             start_mv, fullpel_performed_well);
+    limit_subpel_for_time_budget(x, &ms_params);
 
     MV subpel_start_mv = get_mv_from_fullmv(&tmp_mv->as_fullmv);
     if (sf->rt_sf.use_adaptive_subpel_search &&
@@ -404,6 +417,7 @@ static int search_new_mv(AV1_COMP *cpi, MACROBLOCK *x,
       ms_params.forced_stop =
           subpel_select(cpi, x, bsize, &best_mv, ref_mv, start_mv, false);
     }
+    limit_subpel_for_time_budget(x, &ms_params);
     MV start_mv = get_mv_from_fullmv(&best_mv.as_fullmv);
     cpi->mv_search_params.find_fractional_mv_step(
         xd, cm, &ms_params, start_mv, &best_mv.as_mv, &dis,
@@ -413,10 +427,18 @@ static int search_new_mv(AV1_COMP *cpi, MACROBLOCK *x,
     *rate_mv = av1_mv_bit_cost(&frame_mv[NEWMV][ref_frame].as_mv, &ref_mv,
                                x->mv_costs->nmv_joint_cost,
                                x->mv_costs->mv_cost_stack, MV_COST_WEIGHT);
-  } else if (!combined_motion_search(cpi, x, bsize, mi_row, mi_col,
-                                     &frame_mv[NEWMV][ref_frame], rate_mv,
-                                     best_rdc->rdcost, 0)) {
-    return -1;
+  } else {
+    // For the upper spatial layers, seed the LAST_FRAME search with the
+    // motion vector of the co-located block in the layer below.
+    const int use_base_mv =
+        ref_frame == LAST_FRAME && cpi->ppi->use_svc &&
+        cpi->svc.spatial_layer_id > 0 &&
+        av1_svc_get_lower_layer_mv(cpi, bsize, mi_row, mi_col,
+                                   &frame_mv[NEWMV][ref_frame].as_mv);
+    if (!combined_motion_search(cpi, x, bsize, mi_row, mi_col,
+                                &frame_mv[NEWMV][ref_frame], rate_mv,
+                                best_rdc->rdcost, use_base_mv))
+      return -1;
   }
 
   return 0;
@@ -459,7 +481,8 @@ static TX_SIZE calculate_tx_size(const AV1_COMP *const cpi, BLOCK_SIZE bsize,
   MACROBLOCKD *const xd = &x->e_mbd;
   TX_SIZE tx_size;
   const TxfmSearchParams *txfm_params = &x->txfm_search_params;
-  if (txfm_params->tx_mode_search_type == TX_MODE_SELECT) {
+  if (txfm_params->tx_mode_search_type == TX_MODE_SELECT &&
+      x->time_budget_level < TIME_BUDGET_LEVEL_LARGEST_TX) {
     int multiplier = 8;
     unsigned int var_thresh = 0;
     unsigned int is_high_var = 1;
@@ -980,8 +1003,36 @@ void av1_block_yrd(const AV1_COMP *const cpi, MACROBLOCK *x, int mi_row,
 
   this_rdc->dist = 0;
   this_rdc->rate = 0;
+  if (!use_hbd && tx_type != IDTX && tx_wd >= 8) {
+    // The Hadamard transform, quantization and rate/distortion estimation of
+    // all the transform blocks are fused in one call, so the coefficients are
+    // not written out and reloaded between the stages.
+    const SCAN_ORDER *const scan_order = &av1_scan_orders[tx_size][DCT_DCT];
+    const int blocks_wide = (max_blocks_wide + block_step - 1) / block_step;
+    const int blocks_high = (max_blocks_high + block_step - 1) / block_step;
+    uint16_t eobs[MAX_MIB_SIZE * MAX_MIB_SIZE / 4];
+    int rate;
+    int64_t dist;
+    assert(blocks_wide * blocks_high <= (int)(sizeof(eobs) / sizeof(*eobs)));
+    av1_hadamard_quantize_rd_lp(p->src_diff, bw, tx_wd, blocks_wide,
+                                blocks_high, p->round_fp_QTX, p->quant_fp_QTX,
+                                p->dequant_QTX, scan_order->scan,
+                                scan_order->iscan, eobs, &rate, &dist);
+    this_rdc->rate = rate;
+    this_rdc->dist = dist;
+    for (int r = 0; r < blocks_high; ++r) {
+      for (int c = 0; c < blocks_wide; ++c) {
+        const int ncoeffs = eobs[r * blocks_wide + c];
+        const int is_txfm_skip = (ncoeffs == 0);
+        const int tx_blk_id =
+            (r * block_step * num_blk_skip_w + c * block_step) >> sh_blk_skip;
+        *skippable &= is_txfm_skip;
+        x->txfm_search_info.blk_skip[tx_blk_id] = is_txfm_skip;
+        eob_cost += get_msb(ncoeffs + 1);
+      }
+    }
 #if !CONFIG_AV1_HIGHBITDEPTH
-  if (tx_type == IDTX) {
+  } else if (tx_type == IDTX) {
     // Keep track of the row and column of the blocks we use so that we know
     // if we are in the unrestricted motion border.
     for (int r = 0; r < max_blocks_high; r += block_step) {
@@ -1006,8 +1057,7 @@ void av1_block_yrd(const AV1_COMP *const cpi, MACROBLOCK *x, int mi_row,
     }
   } else {
 #else
-  {
-    (void)tx_wd;
+  } else {
 #endif
     // For block sizes 8x16 or above, Hadamard txfm of two adjacent 8x8 blocks
     // can be done per function call. Hence the call of Hadamard txfm is
@@ -2499,8 +2549,15 @@ void set_color_sensitivity(AV1_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
       const BLOCK_SIZE bs =
           get_plane_block_size(bsize, subsampling_x, subsampling_y);
 
-      const int uv_sad = cpi->ppi->fn_ptr[bs].sdf(
-          p->src.buf, p->src.stride, yv12_mb[i].buf, yv12_mb[i].stride);
+      // yv12_mb is LAST at zero motion, whose SAD may have been gathered at
+      // frame start.
+      unsigned int sad = av1_get_src_stats_last_sad(
+          &cpi->src_stats_8x8, i, x->e_mbd.mi_row, x->e_mbd.mi_col, bs,
+          subsampling_x, subsampling_y);
+      if (sad == UINT_MAX)
+        sad = cpi->ppi->fn_ptr[bs].sdf(p->src.buf, p->src.stride,
+                                       yv12_mb[i].buf, yv12_mb[i].stride);
+      const int uv_sad = (int)sad;
 
       const int norm_uv_sad =
           uv_sad >> (b_width_log2_lookup[bs] + b_height_log2_lookup[bs]);
@@ -2772,7 +2829,8 @@ void av1_nonrd_pick_inter_mode_sb(AV1_COMP *cpi, TileDataEnc *tile_data,
   int use_zeromv =
       cpi->oxcf.tune_cfg.content == AOM_CONTENT_SCREEN ||
       ((cpi->oxcf.speed >= 9 && cpi->rc.avg_frame_low_motion > 70) ||
-       cpi->sf.rt_sf.nonrd_agressive_skip || x->force_zeromv_skip);
+       cpi->sf.rt_sf.nonrd_agressive_skip || x->force_zeromv_skip ||
+       x->time_budget_level >= TIME_BUDGET_LEVEL_REDUCED_MODES);
   int skip_pred_mv = 0;
   const int num_inter_modes =
       use_zeromv ? NUM_INTER_MODES_REDUCED : NUM_INTER_MODES_RT;
@@ -3588,7 +3646,7 @@ void av1_nonrd_pick_inter_mode_sb(AV1_COMP *cpi, TileDataEnc *tile_data,
 #if CONFIG_AV1_TEMPORAL_DENOISING
   if (cpi->oxcf.noise_sensitivity > 0 && resize_pending == 0 &&
       denoise_svc_pickmode && cpi->denoiser.denoising_level > kDenLowLow &&
-      cpi->denoiser.reset == 0) {
+      cpi->denoiser.reset == 0 && !cpi->denoiser.use_prepass) {
     AV1_DENOISER_DECISION decision = COPY_BLOCK;
     ctx->sb_skip_denoising = 0;
     av1_pickmode_ctx_den_update(&ctx_den, zero_last_cost_orig, ref_costs_single,
@@ -454,11 +454,13 @@ static void encode_superblock(const AV1_COMP *const cpi, TileDataEnc *tile_data,
     // Predicted sample of inter mode (for Luma plane) cannot be reused if
     // nonrd_check_partition_merge_mode or nonrd_check_partition_split speed
     // feature is enabled, Since in such cases the buffer may not contain the
-    // predicted sample of best mode.
+    // predicted sample of best mode. The segment skip search does not build
+    // the prediction either.
     const int start_plane =
         (cpi->sf.rt_sf.reuse_inter_pred_nonrd &&
          (!cpi->sf.rt_sf.nonrd_check_partition_merge_mode) &&
          (!cpi->sf.rt_sf.nonrd_check_partition_split) &&
+         !segfeature_active(&cm->seg, mbmi->segment_id, SEG_LVL_SKIP) &&
          cm->seq_params->bit_depth == AOM_BITS_8)
             ? 1
             : 0;
@@ -694,7 +696,11 @@ static void setup_block_rdmult(const AV1_COMP *const cpi, MACROBLOCK *const x,
     x->rdmult = (int)(((int64_t)x->rdmult * x->intra_sb_rdmult_modifier) >> 7);
   }
 
-  if (cpi->oxcf.luma_bias != 0) {
+  // Blocks coded as skip by the segmentation make no rate-distortion
+  // decisions, so their brightness is not measured.
+  if (cpi->oxcf.luma_bias != 0 &&
+      (mbmi == NULL ||
+       !segfeature_active(&cpi->common.seg, mbmi->segment_id, SEG_LVL_SKIP))) {
     int avg_brightness;
     BitDepthInfo bd_info = get_bit_depth_info(&x->e_mbd);
     if (bd_info.use_highbitdepth_buf) {
@@ -1563,8 +1569,8 @@ static void encode_b(const AV1_COMP *const cpi, TileDataEnc *tile_data,
 
   av1_set_offsets_without_segment_id(cpi, tile, x, mi_row, mi_col, bsize);
   const int origin_mult = x->rdmult;
-  setup_block_rdmult(cpi, x, mi_row, mi_col, bsize, NO_AQ, NULL);
   MB_MODE_INFO *mbmi = xd->mi[0];
+  setup_block_rdmult(cpi, x, mi_row, mi_col, bsize, NO_AQ, mbmi);
   mbmi->partition = partition;
   av1_update_state(cpi, td, ctx, mi_row, mi_col, bsize, dry_run);
 
@@ -2218,8 +2224,8 @@ static void encode_b_nonrd(const AV1_COMP *const cpi, TileDataEnc *tile_data,
   MACROBLOCKD *xd = &x->e_mbd;
   av1_set_offsets_without_segment_id(cpi, tile, x, mi_row, mi_col, bsize);
   const int origin_mult = x->rdmult;
-  setup_block_rdmult(cpi, x, mi_row, mi_col, bsize, NO_AQ, NULL);
   MB_MODE_INFO *mbmi = xd->mi[0];
+  setup_block_rdmult(cpi, x, mi_row, mi_col, bsize, NO_AQ, mbmi);
   mbmi->partition = partition;
   av1_update_state(cpi, td, ctx, mi_row, mi_col, bsize, dry_run);
   const int subsampling_x = cpi->common.seq_params->subsampling_x;
@@ -2368,7 +2374,11 @@ static void pick_sb_modes_nonrd(AV1_COMP *const cpi, TileDataEnc *tile_data,
     p[i].txb_entropy_ctx = ctx->txb_entropy_ctx[i];
   }
   for (i = 0; i < 2; ++i) pd[i].color_index_map = ctx->color_index_map[i];
-  if (!x->force_zeromv_skip) {
+  const int seg_skip_active =
+      segfeature_active(&cm->seg, mbmi->segment_id, SEG_LVL_SKIP);
+  if (!x->force_zeromv_skip && !seg_skip_active &&
+      !av1_get_src_stats_variance(&cpi->src_stats_8x8, mi_row, mi_col, bsize,
+                                  &x->source_variance)) {
     x->source_variance = av1_get_perpixel_variance_facade(
         cpi, xd, &x->plane[0].src, bsize, AOM_PLANE_Y);
   }
@@ -2378,8 +2388,6 @@ static void pick_sb_modes_nonrd(AV1_COMP *const cpi, TileDataEnc *tile_data,
   // Set error per bit for current rdmult
   av1_set_error_per_bit(&x->errorperbit, x->rdmult);
 
-  const int seg_skip_active =
-      segfeature_active(&cm->seg, mbmi->segment_id, SEG_LVL_SKIP);
   // This is only needed for real time/allintra row-mt enabled multi-threaded
   // encoding with cost update frequency set to COST_UPD_TILE/COST_UPD_OFF.
   wait_for_top_right(cpi, &tile_data->row_mt_sync, &tile_data->tile_info,
@@ -2403,6 +2411,9 @@ static void pick_sb_modes_nonrd(AV1_COMP *const cpi, TileDataEnc *tile_data,
     if (seg_skip_active) {
       RD_STATS invalid_rd;
       av1_invalid_rd_stats(&invalid_rd);
+      // Unlike av1_nonrd_pick_inter_mode_sb(), the rd seg skip search expects
+      // the caller to have set the block size.
+      mbmi->bsize = bsize;
       // TODO(kyslov): add av1_nonrd_pick_inter_mode_sb_seg_skip
       av1_rd_pick_inter_mode_sb_seg_skip(cpi, tile_data, x, mi_row, mi_col,
                                          rd_cost, bsize, ctx,
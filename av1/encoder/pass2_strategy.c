@@ -62,11 +62,11 @@ static double calculate_active_area(const FRAME_INFO *frame_info,
 // Calculate a modified Error used in distributing bits between easier and
 // harder frames.
 #define ACT_AREA_CORRECTION 0.5
-static double calculate_modified_err_new(const FRAME_INFO *frame_info,
-                                         const FIRSTPASS_STATS *total_stats,
-                                         const FIRSTPASS_STATS *this_stats,
-                                         int vbrbias, double modified_error_min,
-                                         double modified_error_max) {
+double av1_calculate_modified_err_new(const FRAME_INFO *frame_info,
+                                      const FIRSTPASS_STATS *total_stats,
+                                      const FIRSTPASS_STATS *this_stats,
+                                      int vbrbias, double modified_error_min,
+                                      double modified_error_max) {
   if (total_stats == NULL) {
     return 0;
   }
@@ -94,7 +94,7 @@ static double calculate_modified_err(const FRAME_INFO *frame_info,
                                      const AV1EncoderConfig *oxcf,
                                      const FIRSTPASS_STATS *this_frame) {
   const FIRSTPASS_STATS *total_stats = twopass->stats_buf_ctx->total_stats;
-  return calculate_modified_err_new(
+  return av1_calculate_modified_err_new(
       frame_info, total_stats, this_frame, oxcf->rc_cfg.vbrbias,
       twopass->modified_error_min, twopass->modified_error_max);
 }
@@ -2728,10 +2728,10 @@ static double get_second_ref_usage_thresh(int frame_count_so_far) {
              second_ref_usage_thresh_max_delta;
 }
 
-static int test_candidate_kf(const FIRSTPASS_INFO *firstpass_info,
-                             int this_stats_index, int frame_count_so_far,
-                             enum aom_rc_mode rc_mode, int scenecut_mode,
-                             int num_mbs) {
+int av1_test_candidate_kf(const FIRSTPASS_INFO *firstpass_info,
+                          int this_stats_index, int frame_count_so_far,
+                          enum aom_rc_mode rc_mode, int scenecut_mode,
+                          int num_mbs) {
   const FIRSTPASS_STATS *last_stats =
       av1_firstpass_info_peek(firstpass_info, this_stats_index - 1);
   const FIRSTPASS_STATS *this_stats =
@@ -2934,7 +2934,7 @@ static int define_kf_interval(AV1_COMP *cpi,
 
       // Check for a scene cut.
       if (frames_since_key >= kf_cfg->key_freq_min) {
-        scenecut_detected = test_candidate_kf(
+        scenecut_detected = av1_test_candidate_kf(
             &twopass->firstpass_info, frames_to_key, frames_since_key,
             oxcf->rc_cfg.mode, cpi->ppi->p_rc.enable_scenecut_detection,
             num_mbs);
@@ -3255,7 +3255,7 @@ static void find_next_key_frame(AV1_COMP *cpi, FIRSTPASS_STATS *this_frame) {
         av1_firstpass_info_peek(&twopass->firstpass_info, i);
     if (this_stats != NULL) {
       // Accumulate kf group error.
-      kf_group_err += calculate_modified_err_new(
+      kf_group_err += av1_calculate_modified_err_new(
           frame_info, &firstpass_info->total_stats, this_stats,
           oxcf->rc_cfg.vbrbias, twopass->modified_error_min,
           twopass->modified_error_max);
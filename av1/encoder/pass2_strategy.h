@@ -148,6 +148,22 @@ void av1_identify_regions(const FIRSTPASS_STATS *const stats_start,
                           int total_frames, int offset, REGIONS *regions,
                           int *total_regions);
 
+// Returns the error of |this_stats| used to distribute bits between easier
+// and harder frames, given the totals of the sequence.
+double av1_calculate_modified_err_new(const FRAME_INFO *frame_info,
+                                      const FIRSTPASS_STATS *total_stats,
+                                      const FIRSTPASS_STATS *this_stats,
+                                      int vbrbias, double modified_error_min,
+                                      double modified_error_max);
+
+// Returns 1 if the frame at |this_stats_index| (relative to the current
+// frame of |firstpass_info|) looks like a scene cut that should start a new
+// key frame group, |frame_count_so_far| frames after the last key frame.
+int av1_test_candidate_kf(const FIRSTPASS_INFO *firstpass_info,
+                          int this_stats_index, int frame_count_so_far,
+                          enum aom_rc_mode rc_mode, int scenecut_mode,
+                          int num_mbs);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
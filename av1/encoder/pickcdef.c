@@ -132,12 +132,14 @@ static uint64_t search_one_dual(int *lev0, int *lev1, int nb_strengths,
                                 uint64_t (**mse)[TOTAL_STRENGTHS], int sb_count,
                                 CDEF_PICK_METHOD pick_method) {
   uint64_t tot_mse[TOTAL_STRENGTHS][TOTAL_STRENGTHS];
+  uint64_t row_mse[TOTAL_STRENGTHS];
   int i, j;
   uint64_t best_tot_mse = (uint64_t)1 << 63;
   int best_id0 = 0;
   int best_id1 = 0;
   const int total_strengths = nb_cdef_strengths[pick_method];
   memset(tot_mse, 0, sizeof(tot_mse));
+  memset(row_mse, 0, sizeof(row_mse));
   for (i = 0; i < sb_count; i++) {
     int gi;
     uint64_t best_mse = (uint64_t)1 << 63;
@@ -149,21 +151,29 @@ static uint64_t search_one_dual(int *lev0, int *lev1, int nb_strengths,
         best_mse = curr;
       }
     }
-    /* Find best mse when adding each possible new option. */
+    /* Find best mse when adding each possible new option. A luma option
+       that alone is no better than the already selected ones cannot win for
+       any chroma option, so its whole row is accounted for in row_mse[]. */
+    const uint64_t *const mse0 = mse[0][i];
+    const uint64_t *const mse1 = mse[1][i];
     for (j = 0; j < total_strengths; j++) {
-      int k;
-      for (k = 0; k < total_strengths; k++) {
-        uint64_t best = best_mse;
-        uint64_t curr = mse[0][i][j];
-        curr += mse[1][i][k];
-        if (curr < best) best = curr;
-        tot_mse[j][k] += best;
+      if (mse0[j] >= best_mse) {
+        row_mse[j] += best_mse;
+        continue;
+      }
+      uint64_t *const tot_row = tot_mse[j];
+      const uint64_t curr0 = mse0[j];
+      /* Branchless so that the compiler can vectorize the row update. */
+      for (int k = 0; k < total_strengths; k++) {
+        const uint64_t curr = curr0 + mse1[k];
+        tot_row[k] += curr < best_mse ? curr : best_mse;
       }
     }
   }
   for (j = 0; j < total_strengths; j++) {
     int k;
     for (k = 0; k < total_strengths; k++) {
+      tot_mse[j][k] += row_mse[j];
       if (tot_mse[j][k] < best_tot_mse) {
         best_tot_mse = tot_mse[j][k];
         best_id0 = j;
@@ -231,6 +241,24 @@ static uint64_t joint_strength_search_dual(int *best_lev0, int *best_lev1,
   return best_tot_mse;
 }
 
+void av1_cdef_strength_search(CdefSearchCtx *cdef_search_ctx,
+                              int nb_strength_bits,
+                              CdefStrengthSearchResult *result) {
+  const int nb_strengths = 1 << nb_strength_bits;
+  const CDEF_PICK_METHOD pick_method =
+      (CDEF_PICK_METHOD)cdef_search_ctx->pick_method;
+  memset(result->best_lev1, 0, sizeof(result->best_lev1));
+  if (cdef_search_ctx->num_planes > 1) {
+    result->tot_mse = joint_strength_search_dual(
+        result->best_lev0, result->best_lev1, nb_strengths,
+        cdef_search_ctx->mse, cdef_search_ctx->sb_count, pick_method);
+  } else {
+    result->tot_mse = joint_strength_search(
+        result->best_lev0, nb_strengths, cdef_search_ctx->mse[0],
+        cdef_search_ctx->sb_count, pick_method);
+  }
+}
+
 #if CONFIG_AV1_HIGHBITDEPTH
 static void copy_sb16_16_highbd(uint16_t *dst, int dstride, const void *src,
                                 int src_voffset, int src_hoffset, int sstride,
@@ -301,16 +329,45 @@ static uint64_t compute_cdef_dist(void *dst, int dstride, uint16_t *src,
   int src_stride, width, height, width_log2, height_log2;
   init_src_params(&src_stride, &width, &height, &width_log2, &height_log2,
                   bsize);
-  for (bi = 0; bi < cdef_count; bi++) {
+  // Runs of filtered blocks that are horizontally adjacent and span 16 pixels
+  // are handled by a single call, as the filtered output in src is packed
+  // block by block in dlist order.
+  const int blks_per_call = (width == height) ? 16 >> width_log2 : 1;
+  bi = 0;
+  while (bi < cdef_count) {
     by = dlist[bi].by;
     bx = dlist[bi].bx;
-    sum += aom_mse_wxh_16bit(
-        &dst_buff[(by << height_log2) * dstride + (bx << width_log2)], dstride,
-        &src[bi << (height_log2 + width_log2)], src_stride, width, height);
+    uint8_t *const dst_blk =
+        &dst_buff[(by << height_log2) * dstride + (bx << width_log2)];
+    uint16_t *const src_blk = &src[bi << (height_log2 + width_log2)];
+    if (blks_per_call > 1 && bi + blks_per_call <= cdef_count &&
+        dlist[bi + blks_per_call - 1].by == by &&
+        dlist[bi + blks_per_call - 1].bx == bx + blks_per_call - 1) {
+      sum += aom_mse_16xh_16bit(dst_blk, dstride, src_blk, width, height);
+      bi += blks_per_call;
+    } else {
+      sum += aom_mse_wxh_16bit(dst_blk, dstride, src_blk, src_stride, width,
+                               height);
+      bi++;
+    }
   }
   return sum >> 2 * coeff_shift;
 }
 
+// Returns 1 if the luma primary strengths pri0 and pri1 are adjusted to the
+// same value for every filtered 8x8 block, in which case both strengths
+// produce identical filter output.
+static INLINE int cdef_same_adjusted_strength(
+    int var[CDEF_NBLOCKS][CDEF_NBLOCKS], const cdef_list *dlist,
+    int cdef_count, int pri0, int pri1) {
+  for (int bi = 0; bi < cdef_count; bi++) {
+    const int32_t blk_var = var[dlist[bi].by][dlist[bi].bx];
+    if (adjust_strength(pri0, blk_var) != adjust_strength(pri1, blk_var))
+      return 0;
+  }
+  return 1;
+}
+
 // Calculates MSE at block level.
 // Inputs:
 //   cdef_search_ctx: Pointer to the structure containing parameters related to
@@ -387,10 +444,32 @@ void av1_cdef_mse_calc_block(CdefSearchCtx *cdef_search_ctx, int fbr, int fbc,
     cdef_search_ctx->copy_fn(&in[(-yoff * CDEF_BSTRIDE - xoff)], CDEF_BSTRIDE,
                              pd.dst.buf, row - yoff, col - xoff, pd.dst.stride,
                              ysize, xsize);
+    // Index of the last luma strength evaluated for each secondary strength,
+    // and the number of consecutive primary strength increases that made the
+    // luma MSE worse.
+    int prev_gi[CDEF_SEC_STRENGTHS] = { -1, -1, -1, -1 };
+    int prev_pri[CDEF_SEC_STRENGTHS] = { 0 };
+    int num_mse_rises[CDEF_SEC_STRENGTHS] = { 0 };
     for (int gi = 0; gi < cdef_search_ctx->total_strengths; gi++) {
       int pri_strength, sec_strength;
       get_cdef_filter_strengths(cdef_search_ctx->pick_method, &pri_strength,
                                 &sec_strength, gi);
+      const int track_luma = pli == 0 && sec_strength < CDEF_SEC_STRENGTHS;
+      if (track_luma && cdef_search_ctx->prune_strengths && dirinit) {
+        const int ref_gi = prev_gi[sec_strength];
+        if (ref_gi >= 0 && prev_pri[sec_strength] > 0 &&
+            (cdef_same_adjusted_strength(var, dlist, cdef_count,
+                                         prev_pri[sec_strength] << coeff_shift,
+                                         pri_strength << coeff_shift) ||
+             (cdef_search_ctx->prune_strengths >= 2 &&
+              num_mse_rises[sec_strength] >= 2))) {
+          cdef_search_ctx->mse[0][sb_count][gi] =
+              cdef_search_ctx->mse[0][sb_count][ref_gi];
+          prev_gi[sec_strength] = gi;
+          prev_pri[sec_strength] = pri_strength;
+          continue;
+        }
+      }
       av1_cdef_filter_fb(NULL, tmp_dst, CDEF_BSTRIDE, in,
                          cdef_search_ctx->xdec[pli], cdef_search_ctx->ydec[pli],
                          dir, &dirinit, var, pli, dlist, cdef_count,
@@ -399,6 +478,16 @@ void av1_cdef_mse_calc_block(CdefSearchCtx *cdef_search_ctx, int fbr, int fbc,
       const uint64_t curr_mse = cdef_search_ctx->compute_cdef_dist_fn(
           ref_buffer[pli], ref_stride[pli], tmp_dst, dlist, cdef_count,
           cdef_search_ctx->bsize[pli], coeff_shift, row, col);
+      if (track_luma) {
+        const int ref_gi = prev_gi[sec_strength];
+        if (ref_gi >= 0 &&
+            curr_mse > cdef_search_ctx->mse[0][sb_count][ref_gi])
+          num_mse_rises[sec_strength]++;
+        else
+          num_mse_rises[sec_strength] = 0;
+        prev_gi[sec_strength] = gi;
+        prev_pri[sec_strength] = pri_strength;
+      }
       if (pli < 2)
         cdef_search_ctx->mse[pli][sb_count][gi] = curr_mse;
       else
@@ -476,13 +565,15 @@ static AOM_INLINE void cdef_dealloc_data(CdefSearchCtx *cdef_search_ctx) {
 //   cdef_search_ctx: Pointer to the structure containing parameters related to
 //   CDEF search context.
 //   pick_method: Search method used to select CDEF parameters
+//   prune_strengths: Level of per-block pruning of the luma strengths
 // Returns:
 //   Nothing will be returned. Contents of cdef_search_ctx will be modified.
 static AOM_INLINE void cdef_params_init(const YV12_BUFFER_CONFIG *frame,
                                         const YV12_BUFFER_CONFIG *ref,
                                         AV1_COMMON *cm, MACROBLOCKD *xd,
                                         CdefSearchCtx *cdef_search_ctx,
-                                        CDEF_PICK_METHOD pick_method) {
+                                        CDEF_PICK_METHOD pick_method,
+                                        int prune_strengths) {
   const CommonModeInfoParams *const mi_params = &cm->mi_params;
   const int num_planes = av1_num_planes(cm);
   cdef_search_ctx->mi_params = &cm->mi_params;
@@ -496,6 +587,7 @@ static AOM_INLINE void cdef_params_init(const YV12_BUFFER_CONFIG *frame,
   cdef_search_ctx->total_strengths = nb_cdef_strengths[pick_method];
   cdef_search_ctx->num_planes = num_planes;
   cdef_search_ctx->pick_method = pick_method;
+  cdef_search_ctx->prune_strengths = prune_strengths;
   cdef_search_ctx->sb_count = 0;
   av1_setup_dst_planes(xd->plane, cm->seq_params->sb_size, frame, 0, 0, 0,
                        num_planes);
@@ -528,8 +620,8 @@ static AOM_INLINE void cdef_params_init(const YV12_BUFFER_CONFIG *frame,
 #endif
 }
 
-static void pick_cdef_from_qp(AV1_COMMON *const cm, int skip_cdef,
-                              int is_screen_content) {
+void av1_pick_cdef_from_qp(AV1_COMMON *const cm, int skip_cdef,
+                           int is_screen_content) {
   const int bd = cm->seq_params->bit_depth;
   const int q =
       av1_ac_quant_QTX(cm->quant_params.base_qindex, 0, bd) >> (bd - 8);
@@ -595,13 +687,19 @@ static void pick_cdef_from_qp(AV1_COMMON *const cm, int skip_cdef,
   cdef_info->cdef_uv_strengths[0] =
       predicted_uv_f1 * CDEF_SEC_STRENGTHS + predicted_uv_f2;
 
-  // mbmi->cdef_strength is already set in the encoding stage. We don't need to
-  // set it again here.
   if (skip_cdef) {
     cdef_info->cdef_strengths[1] = 0;
     cdef_info->cdef_uv_strengths[1] = 0;
-    return;
   }
+}
+
+static void pick_cdef_from_qp(AV1_COMMON *const cm, int skip_cdef,
+                              int is_screen_content) {
+  av1_pick_cdef_from_qp(cm, skip_cdef, is_screen_content);
+
+  // mbmi->cdef_strength is already set in the encoding stage. We don't need to
+  // set it again here.
+  if (skip_cdef) return;
 
   const CommonModeInfoParams *const mi_params = &cm->mi_params;
   const int nvfb = (mi_params->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
@@ -618,9 +716,10 @@ static void pick_cdef_from_qp(AV1_COMMON *const cm, int skip_cdef,
 
 void av1_cdef_search(MultiThreadInfo *mt_info, const YV12_BUFFER_CONFIG *frame,
                      const YV12_BUFFER_CONFIG *ref, AV1_COMMON *cm,
-                     MACROBLOCKD *xd, CDEF_PICK_METHOD pick_method, int rdmult,
-                     int skip_cdef_feature, CDEF_CONTROL cdef_control,
-                     const int is_screen_content, int non_reference_frame) {
+                     MACROBLOCKD *xd, CDEF_PICK_METHOD pick_method,
+                     int prune_strengths, int rdmult, int skip_cdef_feature,
+                     CDEF_CONTROL cdef_control, const int is_screen_content,
+                     int non_reference_frame) {
   assert(cdef_control != CDEF_NONE);
   if (cdef_control == CDEF_REFERENCE && non_reference_frame) {
     CdefInfo *const cdef_info = &cm->cdef_info;
@@ -642,7 +741,8 @@ void av1_cdef_search(MultiThreadInfo *mt_info, const YV12_BUFFER_CONFIG *frame,
   const int num_planes = av1_num_planes(cm);
   CdefSearchCtx cdef_search_ctx;
   // Initialize parameters related to CDEF search context.
-  cdef_params_init(frame, ref, cm, xd, &cdef_search_ctx, pick_method);
+  cdef_params_init(frame, ref, cm, xd, &cdef_search_ctx, pick_method,
+                   prune_strengths);
   // Allocate CDEF search context buffers.
   if (!cdef_alloc_data(&cdef_search_ctx)) {
     CdefInfo *const cdef_info = &cm->cdef_info;
@@ -659,7 +759,16 @@ void av1_cdef_search(MultiThreadInfo *mt_info, const YV12_BUFFER_CONFIG *frame,
     cdef_mse_calc_frame(&cdef_search_ctx);
   }
 
-  /* Search for different number of signaling bits. */
+  /* Search for different number of signaling bits. The searches are
+     independent of each other, so they are spread over the workers. */
+  CdefStrengthSearchResult search_res[CDEF_MAX_SEARCHED_STRENGTH_BITS + 1];
+  if (mt_info->num_workers > 1) {
+    av1_cdef_strength_search_mt(cm, mt_info, &cdef_search_ctx, search_res);
+  } else {
+    for (int i = 0; i <= CDEF_MAX_SEARCHED_STRENGTH_BITS; i++)
+      av1_cdef_strength_search(&cdef_search_ctx, i, &search_res[i]);
+  }
+
   int nb_strength_bits = 0;
   uint64_t best_rd = UINT64_MAX;
   CdefInfo *const cdef_info = &cm->cdef_info;
@@ -667,32 +776,21 @@ void av1_cdef_search(MultiThreadInfo *mt_info, const YV12_BUFFER_CONFIG *frame,
   uint64_t(*mse[2])[TOTAL_STRENGTHS];
   mse[0] = cdef_search_ctx.mse[0];
   mse[1] = cdef_search_ctx.mse[1];
-  for (int i = 0; i <= 3; i++) {
-    int best_lev0[CDEF_MAX_STRENGTHS];
-    int best_lev1[CDEF_MAX_STRENGTHS] = { 0 };
+  for (int i = 0; i <= CDEF_MAX_SEARCHED_STRENGTH_BITS; i++) {
     const int nb_strengths = 1 << i;
-    uint64_t tot_mse;
-    if (num_planes > 1) {
-      tot_mse = joint_strength_search_dual(best_lev0, best_lev1, nb_strengths,
-                                           mse, sb_count, pick_method);
-    } else {
-      tot_mse = joint_strength_search(best_lev0, nb_strengths, mse[0], sb_count,
-                                      pick_method);
-    }
-
     const int total_bits = sb_count * i + nb_strengths * CDEF_STRENGTH_BITS *
                                               (num_planes > 1 ? 2 : 1);
     const int rate_cost = av1_cost_literal(total_bits);
-    const uint64_t dist = tot_mse * 16;
+    const uint64_t dist = search_res[i].tot_mse * 16;
     const uint64_t rd = RDCOST(rdmult, rate_cost, dist);
     if (rd < best_rd) {
       best_rd = rd;
       nb_strength_bits = i;
-      memcpy(cdef_info->cdef_strengths, best_lev0,
-             nb_strengths * sizeof(best_lev0[0]));
+      memcpy(cdef_info->cdef_strengths, search_res[i].best_lev0,
+             nb_strengths * sizeof(search_res[i].best_lev0[0]));
       if (num_planes > 1) {
-        memcpy(cdef_info->cdef_uv_strengths, best_lev1,
-               nb_strengths * sizeof(best_lev1[0]));
+        memcpy(cdef_info->cdef_uv_strengths, search_res[i].best_lev1,
+               nb_strengths * sizeof(search_res[i].best_lev1[0]));
       }
     }
   }
@@ -81,6 +81,9 @@ struct MultiThreadInfo;
   (REDUCED_PRI_STRENGTHS_LVL4 * REDUCED_SEC_STRENGTHS_LVL5)
 #define TOTAL_STRENGTHS (CDEF_PRI_STRENGTHS * CDEF_SEC_STRENGTHS)
 
+// The frame level search considers up to (1 << 3) signaled strengths.
+#define CDEF_MAX_SEARCHED_STRENGTH_BITS 3
+
 //Full psy
 static const int priconv_q1[REDUCED_FULL_STRENGTHS_Q1] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 };
 //Full/L1 shared psy
@@ -165,6 +168,11 @@ typedef struct {
    * Search method used to select CDEF parameters
    */
   int pick_method;
+  /*!
+   * Level of per-block pruning of the luma strengths evaluated, see
+   * LOOP_FILTER_SPEED_FEATURES::prune_cdef_strengths
+   */
+  int prune_strengths;
   /*!
    * Number of planes
    */
@@ -261,8 +269,32 @@ static INLINE int cdef_sb_skip(const CommonModeInfoParams *const mi_params,
   return 0;
 }
 
+/*! \brief Result of the joint strength search for a given number of
+ * signaling bits.
+ */
+typedef struct {
+  /*!
+   * Selected luma strength indices
+   */
+  int best_lev0[CDEF_MAX_STRENGTHS];
+  /*!
+   * Selected chroma strength indices
+   */
+  int best_lev1[CDEF_MAX_STRENGTHS];
+  /*!
+   * Total MSE of the frame using the selected strengths
+   */
+  uint64_t tot_mse;
+} CdefStrengthSearchResult;
+
 void av1_cdef_mse_calc_block(CdefSearchCtx *cdef_search_ctx, int fbr, int fbc,
                              int sb_count);
+
+// Runs the joint strength search for (1 << nb_strength_bits) strengths over
+// the MSE collected in cdef_search_ctx.
+void av1_cdef_strength_search(CdefSearchCtx *cdef_search_ctx,
+                              int nb_strength_bits,
+                              CdefStrengthSearchResult *result);
 /*!\endcond */
 
 /*!\brief AV1 CDEF parameter search
@@ -277,6 +309,7 @@ void av1_cdef_mse_calc_block(CdefSearchCtx *cdef_search_ctx, int fbr, int fbc,
  * \param[in,out]  cm           Pointer to top level common structure
  * \param[in]      xd           Pointer to common current coding block structure
  * \param[in]      pick_method  The method used to select params
+ * \param[in]      prune_strengths  Level of per-block luma strength pruning
  * \param[in]      rdmult       rd multiplier to use in making param choices
  * \param[in]      skip_cdef_feature Speed feature to skip cdef
  * \param[in]      cdef_control  Parameter that controls CDEF application
@@ -298,9 +331,28 @@ void av1_cdef_mse_calc_block(CdefSearchCtx *cdef_search_ctx, int fbr, int fbc,
 void av1_cdef_search(struct MultiThreadInfo *mt_info,
                      const YV12_BUFFER_CONFIG *frame,
                      const YV12_BUFFER_CONFIG *ref, AV1_COMMON *cm,
-                     MACROBLOCKD *xd, CDEF_PICK_METHOD pick_method, int rdmult,
-                     int skip_cdef_feature, CDEF_CONTROL cdef_control,
-                     const int is_screen_content, int non_reference_frame);
+                     MACROBLOCKD *xd, CDEF_PICK_METHOD pick_method,
+                     int prune_strengths, int rdmult, int skip_cdef_feature,
+                     CDEF_CONTROL cdef_control, const int is_screen_content,
+                     int non_reference_frame);
+
+/*!\brief Derive the CDEF frame parameters from q
+ *
+ * \ingroup in_loop_cdef
+ *
+ * Sets the same frame level parameters as av1_cdef_search() with
+ * CDEF_PICK_FROM_Q, without resetting the strength of the superblocks, so it
+ * can be called before the frame is encoded.
+ *
+ * \param[in,out]  cm           Pointer to top level common structure
+ * \param[in]      skip_cdef    Speed feature to skip cdef
+ * \param[in]      is_screen_content   Whether it is screen content type
+ *
+ * \remark Nothing is returned. The parameters are stored in the \c cdef_info
+ * structure inside \c cm.
+ */
+void av1_pick_cdef_from_qp(AV1_COMMON *const cm, int skip_cdef,
+                           int is_screen_content);
 
 #ifdef __cplusplus
 }  // extern "C"
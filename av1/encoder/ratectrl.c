@@ -30,6 +30,7 @@
 
 #include "av1/encoder/encodemv.h"
 #include "av1/encoder/encode_strategy.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/gop_structure.h"
 #include "av1/encoder/random.h"
 #include "av1/encoder/ratectrl.h"
@@ -2718,6 +2719,49 @@ void av1_set_rtc_reference_structure_one_layer(AV1_COMP *cpi, int gf_update) {
     cpi->rt_reduce_num_ref_buffers &= (rtc_ref->ref_idx[2] < 7);
 }
 
+// Computes the source SAD of the sampled 64x64 blocks of every row_step-th
+// superblock row, starting at start_row. Rows can be split over workers.
+void av1_source_sad_rows(const SourceSadParams *params, int start_row,
+                         int row_step, SourceSadStats *stats) {
+  const uint64_t sum_sq_thresh = 10000;  // sum = sqrt(thresh / 64*64)) ~1.5
+  const int sb_cols = params->sb_cols;
+  const int sb_rows = params->sb_rows;
+  for (int sbi_row = start_row; sbi_row < sb_rows; sbi_row += row_step) {
+    const uint8_t *src_y = params->src_y + (sbi_row << 6) * params->src_ystride;
+    const uint8_t *last_src_y =
+        params->last_src_y + (sbi_row << 6) * params->last_src_ystride;
+    for (int sbi_col = 0; sbi_col < sb_cols; ++sbi_col) {
+      // Checker-board pattern, ignore boundary.
+      if (params->full_sampling ||
+          ((sbi_row > 0 && sbi_col > 0) &&
+           (sbi_row < sb_rows - 1 && sbi_col < sb_cols - 1) &&
+           ((sbi_row % 2 == 0 && sbi_col % 2 == 0) ||
+            (sbi_row % 2 != 0 && sbi_col % 2 != 0)))) {
+        const uint64_t tmp_sad = params->fn_ptr->sdf(
+            src_y, params->src_ystride, last_src_y, params->last_src_ystride);
+        if (params->sad_blk_64x64 != NULL)
+          params->sad_blk_64x64[sbi_col + sbi_row * sb_cols] = tmp_sad;
+        if (params->check_light_change) {
+          unsigned int sse, variance;
+          variance =
+              params->fn_ptr->vf(src_y, params->src_ystride, last_src_y,
+                                 params->last_src_ystride, &sse);
+          // Note: sse - variance = ((sum * sum) >> 12)
+          // Detect large lighting change.
+          if (variance < (sse >> 1) && (sse - variance) > sum_sq_thresh) {
+            stats->num_low_var_high_sumdiff++;
+          }
+        }
+        stats->sum_sad += tmp_sad;
+        stats->num_samples++;
+        if (tmp_sad == 0) stats->num_zero_temp_sad++;
+      }
+      src_y += 64;
+      last_src_y += 64;
+    }
+  }
+}
+
 /*!\brief Check for scene detection, for 1 pass real-time mode.
  *
  * Compute average source sad (temporal sad: between current source and
@@ -2775,15 +2819,10 @@ static void rc_scene_detection_onepass_rt(AV1_COMP *cpi,
   if (src_width == last_src_width && src_height == last_src_height) {
     const int num_mi_cols = cm->mi_params.mi_cols;
     const int num_mi_rows = cm->mi_params.mi_rows;
-    int num_zero_temp_sad = 0;
     uint32_t min_thresh = 10000;
     if (cpi->oxcf.tune_cfg.content != AOM_CONTENT_SCREEN) min_thresh = 100000;
     const BLOCK_SIZE bsize = BLOCK_64X64;
     int full_sampling = (cm->width * cm->height < 640 * 360) ? 1 : 0;
-    // Loop over sub-sample of frame, compute average sad over 64x64 blocks.
-    uint64_t avg_sad = 0;
-    uint64_t tmp_sad = 0;
-    int num_samples = 0;
     const int thresh = 6;
     // SAD is computed on 64x64 blocks
     const int sb_size_by_mb = (cm->seq_params->sb_size == BLOCK_128X128)
@@ -2791,9 +2830,6 @@ static void rc_scene_detection_onepass_rt(AV1_COMP *cpi,
                                   : cm->seq_params->mib_size;
     const int sb_cols = (num_mi_cols + sb_size_by_mb - 1) / sb_size_by_mb;
     const int sb_rows = (num_mi_rows + sb_size_by_mb - 1) / sb_size_by_mb;
-    uint64_t sum_sq_thresh = 10000;  // sum = sqrt(thresh / 64*64)) ~1.5
-    int num_low_var_high_sumdiff = 0;
-    int light_change = 0;
     // Flag to check light change or not.
     const int check_light_change = 0;
     // Store blkwise SAD for later use
@@ -2807,41 +2843,25 @@ static void rc_scene_detection_onepass_rt(AV1_COMP *cpi,
                                    sizeof(*cpi->src_sad_blk_64x64)));
       }
     }
-    for (int sbi_row = 0; sbi_row < sb_rows; ++sbi_row) {
-      for (int sbi_col = 0; sbi_col < sb_cols; ++sbi_col) {
-        // Checker-board pattern, ignore boundary.
-        if (full_sampling ||
-            ((sbi_row > 0 && sbi_col > 0) &&
-             (sbi_row < sb_rows - 1 && sbi_col < sb_cols - 1) &&
-             ((sbi_row % 2 == 0 && sbi_col % 2 == 0) ||
-              (sbi_row % 2 != 0 && sbi_col % 2 != 0)))) {
-          tmp_sad = cpi->ppi->fn_ptr[bsize].sdf(src_y, src_ystride, last_src_y,
-                                                last_src_ystride);
-          if (cpi->src_sad_blk_64x64 != NULL)
-            cpi->src_sad_blk_64x64[sbi_col + sbi_row * sb_cols] = tmp_sad;
-          if (check_light_change) {
-            unsigned int sse, variance;
-            variance = cpi->ppi->fn_ptr[bsize].vf(
-                src_y, src_ystride, last_src_y, last_src_ystride, &sse);
-            // Note: sse - variance = ((sum * sum) >> 12)
-            // Detect large lighting change.
-            if (variance < (sse >> 1) && (sse - variance) > sum_sq_thresh) {
-              num_low_var_high_sumdiff++;
-            }
-          }
-          avg_sad += tmp_sad;
-          num_samples++;
-          if (tmp_sad == 0) num_zero_temp_sad++;
-        }
-        src_y += 64;
-        last_src_y += 64;
-      }
-      src_y += (src_ystride << 6) - (sb_cols << 6);
-      last_src_y += (last_src_ystride << 6) - (sb_cols << 6);
-    }
-    if (check_light_change && num_samples > 0 &&
-        num_low_var_high_sumdiff > (num_samples >> 1))
-      light_change = 1;
+    // Loop over sub-sample of frame, compute average sad over 64x64 blocks.
+    const SourceSadParams params = { src_y,
+                                     src_ystride,
+                                     last_src_y,
+                                     last_src_ystride,
+                                     sb_cols,
+                                     sb_rows,
+                                     full_sampling,
+                                     check_light_change,
+                                     cpi->src_sad_blk_64x64,
+                                     &cpi->ppi->fn_ptr[bsize] };
+    SourceSadStats stats;
+    av1_source_sad_mt(cpi, &params, &stats);
+    uint64_t avg_sad = stats.sum_sad;
+    const int num_samples = stats.num_samples;
+    const int num_zero_temp_sad = stats.num_zero_temp_sad;
+    const int light_change =
+        check_light_change && num_samples > 0 &&
+        stats.num_low_var_high_sumdiff > (num_samples >> 1);
     if (num_samples > 0) avg_sad = avg_sad / num_samples;
     // Set high_source_sad flag if we detect very high increase in avg_sad
     // between current and previous frame value(s). Use minimum threshold
@@ -822,6 +822,36 @@ int av1_q_mode_get_q_index(int base_q_index, int gf_update_type,
 int av1_get_arf_q_index(int base_q_index, int gfu_boost, int bit_depth,
                         double arf_boost_factor);
 
+/*!\cond */
+// Inputs of the 64x64 source SAD analysis of the real-time scene detection.
+typedef struct {
+  const uint8_t *src_y;
+  int src_ystride;
+  const uint8_t *last_src_y;
+  int last_src_ystride;
+  int sb_cols;
+  int sb_rows;
+  int full_sampling;
+  int check_light_change;
+  // Per block SAD, may be NULL.
+  uint64_t *sad_blk_64x64;
+  const struct aom_variance_vtable *fn_ptr;
+} SourceSadParams;
+
+// Sums over the sampled blocks of a set of superblock rows.
+typedef struct {
+  uint64_t sum_sad;
+  int num_samples;
+  int num_zero_temp_sad;
+  int num_low_var_high_sumdiff;
+} SourceSadStats;
+
+// Adds the SAD statistics of rows start_row, start_row + row_step, ... to
+// |stats|.
+void av1_source_sad_rows(const SourceSadParams *params, int start_row,
+                         int row_step, SourceSadStats *stats);
+/*!\endcond */
+
 #if !CONFIG_REALTIME_ONLY
 struct TplDepFrame;
 /*!\brief Compute the q_indices for the ARF of a GOP in Q mode.
@@ -1339,6 +1339,16 @@ typedef struct LOOP_FILTER_SPEED_FEATURES {
   // Control how the CDEF strength is determined.
   CDEF_PICK_METHOD cdef_pick_method;
 
+  // Prune the luma CDEF strengths evaluated for each 64x64 block.
+  // 0: No pruning.
+  // 1: Reuse the MSE of a strength whose primary strength maps to the same
+  // variance-adjusted strength as the previous one for every 8x8 block. This
+  // is lossless.
+  // 2: Also stop increasing the primary strength once the luma MSE got worse
+  // twice in a row. Lossy, and not enabled by any speed until its BD-rate
+  // cost has been measured.
+  int prune_cdef_strengths;
+
   // Decoder side speed feature to add penalty for use of dual-sgr filters.
   // Takes values 0 - 10, 0 indicating no penalty and each additional level
   // adding a penalty of 1%
@@ -32,6 +32,7 @@ void av1_init_layer_context(AV1_COMP *const cpi) {
   svc->force_zero_mode_spatial_ref = 1;
   svc->num_encoded_top_layer = 0;
   svc->use_flexible_mode = 0;
+  svc->lower_layer_mvs.spatial_layer_id = -1;
 
   for (int sl = 0; sl < svc->number_spatial_layers; ++sl) {
     for (int tl = 0; tl < svc->number_temporal_layers; ++tl) {
@@ -228,12 +229,73 @@ void av1_restore_layer_context(AV1_COMP *const cpi) {
       svc->skip_mvsearch_altref = 1;
     }
   }
+  // The motion vectors of the layer below can seed the LAST_FRAME search only
+  // if both layers predict from their own frames of the same past superframe.
+  SVC_LAYER_MVS *const lmvs = &svc->lower_layer_mvs;
+  if (lmvs->spatial_layer_id >= 0) {
+    const int last_idx = rtc_ref->ref_idx[LAST_FRAME - 1];
+    if (!svc->reuse_lower_layer_mv || !rtc_ref->set_ref_frame_config ||
+        !rtc_ref->reference[LAST_FRAME - 1] ||
+        lmvs->spatial_layer_id != svc->spatial_layer_id - 1 ||
+        lmvs->superframe != svc->current_superframe ||
+        svc->buffer_spatial_layer[last_idx] != svc->spatial_layer_id ||
+        svc->buffer_time_index[last_idx] != lmvs->last_time_index)
+      lmvs->spatial_layer_id = -1;
+  }
+}
+
+// Keep the LAST_FRAME motion vectors of the spatial layer just encoded, at
+// 8x8 granularity, so the layer above can seed its motion search with them.
+static void store_lower_layer_mvs(AV1_COMP *const cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  SVC *const svc = &cpi->svc;
+  const RTC_REF *const rtc_ref = &cpi->rtc_ref;
+  SVC_LAYER_MVS *const lmvs = &svc->lower_layer_mvs;
+  const CommonModeInfoParams *const mi_params = &cm->mi_params;
+  lmvs->spatial_layer_id = -1;
+  if (svc->spatial_layer_id == svc->number_spatial_layers - 1 ||
+      !rtc_ref->set_ref_frame_config || frame_is_intra_only(cm) ||
+      !rtc_ref->reference[LAST_FRAME - 1])
+    return;
+  // The motion vectors are only meaningful to the layer above if LAST is a
+  // previous frame of this same spatial layer.
+  const int last_idx = rtc_ref->ref_idx[LAST_FRAME - 1];
+  if (svc->buffer_spatial_layer[last_idx] != svc->spatial_layer_id) return;
+  const int cols = (mi_params->mi_cols + 1) >> 1;
+  const int rows = (mi_params->mi_rows + 1) >> 1;
+  if (cols * rows > lmvs->alloc_size) {
+    aom_free(lmvs->mvs);
+    lmvs->alloc_size = 0;
+    CHECK_MEM_ERROR(cm, lmvs->mvs,
+                    aom_malloc(cols * rows * sizeof(*lmvs->mvs)));
+    lmvs->alloc_size = cols * rows;
+  }
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      const MB_MODE_INFO *const mi =
+          mi_params->mi_grid_base[(r << 1) * mi_params->mi_stride + (c << 1)];
+      int_mv *const mv = &lmvs->mvs[r * cols + c];
+      if (mi != NULL && mi->ref_frame[0] == LAST_FRAME &&
+          mi->ref_frame[1] <= INTRA_FRAME)
+        *mv = mi->mv[0];
+      else
+        mv->as_int = INVALID_MV;
+    }
+  }
+  lmvs->cols = cols;
+  lmvs->rows = rows;
+  lmvs->width = cm->width;
+  lmvs->height = cm->height;
+  lmvs->spatial_layer_id = svc->spatial_layer_id;
+  lmvs->superframe = svc->current_superframe;
+  lmvs->last_time_index = svc->buffer_time_index[last_idx];
 }
 
 void av1_save_layer_context(AV1_COMP *const cpi) {
   SVC *const svc = &cpi->svc;
   const AV1_COMMON *const cm = &cpi->common;
   LAYER_CONTEXT *lc = get_layer_context(cpi);
+  if (svc->reuse_lower_layer_mv) store_lower_layer_mvs(cpi);
   lc->rc = cpi->rc;
   lc->p_rc = cpi->ppi->p_rc;
   lc->target_bandwidth = (int)cpi->oxcf.rc_cfg.target_bandwidth;
@@ -526,3 +588,25 @@ void av1_svc_check_reset_layer_rc_flag(AV1_COMP *const cpi) {
     }
   }
 }
+
+int av1_svc_get_lower_layer_mv(const AV1_COMP *const cpi, BLOCK_SIZE bsize,
+                               int mi_row, int mi_col, MV *mv) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const SVC *const svc = &cpi->svc;
+  const SVC_LAYER_MVS *const lmvs = &svc->lower_layer_mvs;
+  if (lmvs->spatial_layer_id < 0 ||
+      lmvs->spatial_layer_id != svc->spatial_layer_id - 1)
+    return 0;
+  // Center of the block, in pixels of the current and of the lower layer.
+  const int x = (mi_col << MI_SIZE_LOG2) + (block_size_wide[bsize] >> 1);
+  const int y = (mi_row << MI_SIZE_LOG2) + (block_size_high[bsize] >> 1);
+  const int lx = (int)((int64_t)x * lmvs->width / cm->width);
+  const int ly = (int)((int64_t)y * lmvs->height / cm->height);
+  const int c = AOMMIN(lx >> 3, lmvs->cols - 1);
+  const int r = AOMMIN(ly >> 3, lmvs->rows - 1);
+  const int_mv lower_mv = lmvs->mvs[r * lmvs->cols + c];
+  if (lower_mv.as_int == INVALID_MV) return 0;
+  mv->row = (int16_t)(lower_mv.as_mv.row * cm->height / lmvs->height);
+  mv->col = (int16_t)(lower_mv.as_mv.col * cm->width / lmvs->width);
+  return 1;
+}
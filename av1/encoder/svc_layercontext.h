@@ -80,6 +80,51 @@ typedef struct {
   int max_mv_magnitude;
 } LAYER_CONTEXT;
 
+/*!
+ * \brief Motion vectors of the last encoded spatial layer, kept to seed the
+ * motion search of the layer above it.
+ * \ingroup SVC
+ */
+typedef struct {
+  /*!
+   * One motion vector per 8x8 block, INVALID_MV where the block was not
+   * predicted from LAST_FRAME alone.
+   */
+  int_mv *mvs;
+  /*!
+   * Number of motion vectors allocated in mvs.
+   */
+  int alloc_size;
+  /*!
+   * Number of 8x8 block columns, which is also the stride of mvs.
+   */
+  int cols;
+  /*!
+   * Number of 8x8 block rows.
+   */
+  int rows;
+  /*!
+   * Frame width of the layer.
+   */
+  int width;
+  /*!
+   * Frame height of the layer.
+   */
+  int height;
+  /*!
+   * Spatial layer the motion vectors come from, -1 if they cannot be used.
+   */
+  int spatial_layer_id;
+  /*!
+   * Superframe the motion vectors come from.
+   */
+  unsigned int superframe;
+  /*!
+   * Superframe of the LAST_FRAME reference the motion vectors point to.
+   */
+  unsigned int last_time_index;
+} SVC_LAYER_MVS;
+
 /*!
  * \brief The stucture of SVC.
  * \ingroup SVC
@@ -134,6 +179,17 @@ typedef struct SVC {
    * Force zero-mv in mode search for the spatial/inter-layer reference.
    */
   int force_zero_mode_spatial_ref;
+
+  /*!
+   * Seed the LAST_FRAME motion search of the upper spatial layers with the
+   * motion vectors of the layer below (AV1E_SET_SVC_REUSE_LOWER_LAYER_MV).
+   */
+  int reuse_lower_layer_mv;
+
+  /*!
+   * Motion vectors of the last encoded spatial layer.
+   */
+  SVC_LAYER_MVS lower_layer_mvs;
 } SVC;
 
 struct AV1_COMP;
@@ -273,6 +329,29 @@ void av1_get_layer_resolution(const int width_org, const int height_org,
                               const int num, const int den, int *width_out,
                               int *height_out);
 
+/*!\brief Get the motion vector of the lower spatial layer for a block.
+ *
+ * \ingroup SVC
+ * \callgraph
+ * \callergraph
+ *
+ * Looks up the LAST_FRAME motion vector of the block co-located with the
+ * center of the current block in the spatial layer below, and scales it to
+ * the resolution of the current layer. Only available when both layers
+ * predict from LAST_FRAME references of the same superframe.
+ *
+ * \param[in]       cpi     Top level encoder structure
+ * \param[in]       bsize   Current block size
+ * \param[in]       mi_row  Row index in 4x4 units
+ * \param[in]       mi_col  Column index in 4x4 units
+ * \param[out]      mv      Scaled motion vector, in 1/8 pel units
+ *
+ * \return 1 if a motion vector is available, 0 otherwise.
+ */
+int av1_svc_get_lower_layer_mv(const struct AV1_COMP *const cpi,
+                               BLOCK_SIZE bsize, int mi_row, int mi_col,
+                               MV *mv);
+
 void av1_set_svc_fixed_mode(struct AV1_COMP *const cpi);
 
 void av1_svc_check_reset_layer_rc_flag(struct AV1_COMP *const cpi);
@@ -1286,10 +1286,12 @@ void av1_temporal_filter(AV1_COMP *cpi, const int filter_frame_lookahead_idx,
   }
 
   // Perform temporal filtering process.
+  av1_start_module_timer(cpi, MOD_TF);
   if (mt_info->num_workers > 1)
     av1_tf_do_filtering_mt(cpi);
   else
     tf_do_filtering(cpi);
+  av1_end_module_timer(cpi, MOD_TF);
 
   if (compute_frame_diff) {
     *frame_diff = tf_data->diff;
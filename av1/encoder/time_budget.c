@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "aom_mem/aom_mem.h"
+
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/time_budget.h"
+
+// Number of consecutive fast frames after which the start level is lowered.
+#define FAST_FRAMES_TO_LOWER_LEVEL 4
+
+static int time_budget_active(const AV1_COMP *cpi) {
+  return cpi->time_budget.budget_us > 0 && cpi->oxcf.mode == REALTIME &&
+         cpi->sf.rt_sf.use_nonrd_pick_mode;
+}
+
+void av1_time_budget_init(TimeBudget *tb) {
+  av1_zero(*tb);
+  tb->post_encode_us = -1;
+}
+
+void av1_time_budget_free(TimeBudget *tb) {
+  aom_free(tb->row_time_us);
+  tb->row_time_us = NULL;
+  aom_free(tb->row_level);
+  tb->row_level = NULL;
+  tb->row_alloc_size = 0;
+}
+
+int64_t av1_time_budget_elapsed(const TimeBudget *tb) {
+  // Mark a copy so that the workers can read the time concurrently.
+  struct aom_usec_timer timer = tb->frame_timer;
+  aom_usec_timer_mark(&timer);
+  return aom_usec_timer_elapsed(&timer);
+}
+
+void av1_time_budget_frame_start(AV1_COMP *cpi) {
+  TimeBudget *const tb = &cpi->time_budget;
+  aom_usec_timer_start(&tb->frame_timer);
+  tb->frame_level = 0;
+  tb->sb_rows = 0;
+  tb->encode_start_us = 0;
+  tb->encode_end_us = 0;
+}
+
+void av1_time_budget_encode_start(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  TimeBudget *const tb = &cpi->time_budget;
+  const int sb_rows = CEIL_POWER_OF_TWO(cm->mi_params.mi_rows,
+                                        cm->seq_params->mib_size_log2);
+  const int size = sb_rows * cm->tiles.cols;
+
+  if (size > tb->row_alloc_size) {
+    av1_time_budget_free(tb);
+    CHECK_MEM_ERROR(cm, tb->row_time_us,
+                    aom_malloc(size * sizeof(*tb->row_time_us)));
+    CHECK_MEM_ERROR(cm, tb->row_level,
+                    aom_malloc(size * sizeof(*tb->row_level)));
+    tb->row_alloc_size = size;
+  }
+  memset(tb->row_time_us, 0, size * sizeof(*tb->row_time_us));
+  memset(tb->row_level, 0, size * sizeof(*tb->row_level));
+  tb->sb_rows = sb_rows;
+  tb->tile_cols = cm->tiles.cols;
+
+  tb->frame_level =
+      time_budget_active(cpi) ? tb->level[cpi->svc.spatial_layer_id] : 0;
+  tb->encode_start_us = av1_time_budget_elapsed(tb);
+  // Leave the time the rest of the frame took on the previous frames to the
+  // stages after the superblock rows.
+  const int64_t budget_us = tb->budget_us;
+  const int64_t remaining_us =
+      budget_us - tb->encode_start_us - AOMMAX(tb->post_encode_us, 0);
+  tb->encode_budget_us = AOMMAX(remaining_us, budget_us >> 2);
+}
+
+void av1_time_budget_encode_end(AV1_COMP *cpi) {
+  TimeBudget *const tb = &cpi->time_budget;
+  tb->encode_end_us = av1_time_budget_elapsed(tb);
+}
+
+int av1_time_budget_row_level(const AV1_COMP *cpi, int mi_row) {
+  const TimeBudget *const tb = &cpi->time_budget;
+  if (!time_budget_active(cpi)) return 0;
+
+  int level = tb->frame_level;
+  if (mi_row > 0) {
+    // The rows above are expected to have used their share of the budget.
+    const int64_t expected_us =
+        tb->encode_start_us +
+        tb->encode_budget_us * mi_row / cpi->common.mi_params.mi_rows;
+    const int64_t late_us = av1_time_budget_elapsed(tb) - expected_us;
+    const int64_t margin_us = tb->budget_us >> 4;
+    if (late_us > 4 * margin_us)
+      level += 2;
+    else if (late_us > margin_us)
+      level += 1;
+    else if (late_us < -2 * margin_us)
+      level -= 1;
+  }
+  return clamp(level, 0, MAX_TIME_BUDGET_LEVEL);
+}
+
+void av1_time_budget_row_done(AV1_COMP *cpi, int tile_col, int mi_row,
+                              int64_t start_us, int level) {
+  TimeBudget *const tb = &cpi->time_budget;
+  const int sb_row = mi_row >> cpi->common.seq_params->mib_size_log2;
+  const int idx = sb_row * tb->tile_cols + tile_col;
+  assert(idx < tb->sb_rows * tb->tile_cols);
+  tb->row_time_us[idx] = av1_time_budget_elapsed(tb) - start_us;
+  tb->row_level[idx] = (uint8_t)level;
+}
+
+void av1_time_budget_frame_end(AV1_COMP *cpi) {
+  const AV1_COMMON *const cm = &cpi->common;
+  TimeBudget *const tb = &cpi->time_budget;
+  aom_enc_frame_time_stats_t *const stats = &tb->stats;
+  const int64_t frame_time_us = av1_time_budget_elapsed(tb);
+
+  av1_zero(*stats);
+  stats->frame_time_us = frame_time_us;
+  stats->budget_us = tb->budget_us;
+  stats->dropped = cpi->is_dropped_frame;
+  // Nothing to learn from a frame whose superblocks were not encoded.
+  if (cpi->is_dropped_frame || tb->sb_rows == 0) return;
+
+  stats->sb_encode_time_us = tb->encode_end_us - tb->encode_start_us;
+  stats->start_speed_level = tb->frame_level;
+  stats->max_speed_level = tb->frame_level;
+  stats->num_sb_rows = tb->sb_rows * tb->tile_cols;
+  int level_sum = 0;
+  for (int i = 0; i < stats->num_sb_rows; ++i) {
+    stats->max_sb_row_time_us =
+        AOMMAX(stats->max_sb_row_time_us, tb->row_time_us[i]);
+    stats->max_speed_level = AOMMAX(stats->max_speed_level, tb->row_level[i]);
+    stats->num_boosted_sb_rows += tb->row_level[i] > tb->frame_level;
+    level_sum += tb->row_level[i];
+  }
+
+  const int64_t post_encode_us = frame_time_us - tb->encode_end_us;
+  tb->post_encode_us = tb->post_encode_us < 0
+                           ? post_encode_us
+                           : (3 * tb->post_encode_us + post_encode_us) >> 2;
+
+  // Key frames are much slower than the inter frames the levels are tuned
+  // for, keep them out of the start level.
+  if (!time_budget_active(cpi) || frame_is_intra_only(cm)) return;
+  const int sl = cpi->svc.spatial_layer_id;
+  const int64_t budget_us = tb->budget_us;
+  if (frame_time_us > budget_us) {
+    // Start at least at the level the late rows of this frame needed.
+    tb->level[sl] = AOMMIN(AOMMAX(tb->level[sl] + 1, stats->max_speed_level),
+                           MAX_TIME_BUDGET_LEVEL);
+    tb->fast_frames[sl] = 0;
+  } else if (2 * level_sum < (2 * tb->frame_level - 1) * stats->num_sb_rows) {
+    // Most rows were ahead of their share of the budget at a lower level.
+    tb->level[sl] = AOMMAX(tb->level[sl] - 1, 0);
+    tb->fast_frames[sl] = 0;
+  } else if (4 * frame_time_us < 3 * budget_us) {
+    if (++tb->fast_frames[sl] >= FAST_FRAMES_TO_LOWER_LEVEL) {
+      tb->level[sl] = AOMMAX(tb->level[sl] - 1, 0);
+      tb->fast_frames[sl] = 0;
+    }
+  } else {
+    tb->fast_frames[sl] = 0;
+  }
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_TIME_BUDGET_H_
+#define AOM_AV1_ENCODER_TIME_BUDGET_H_
+
+#include <stdint.h>
+
+#include "aom/aomcx.h"
+#include "aom_ports/aom_timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\cond */
+// Speed levels applied on top of the real-time speed features when a frame
+// runs late, see av1_time_budget_row_level().
+#define TIME_BUDGET_LEVEL_REDUCED_MODES 1
+#define TIME_BUDGET_LEVEL_HALF_PEL 2
+#define TIME_BUDGET_LEVEL_LARGEST_TX 3
+#define TIME_BUDGET_LEVEL_SHALLOW_PARTITION 4
+#define MAX_TIME_BUDGET_LEVEL TIME_BUDGET_LEVEL_SHALLOW_PARTITION
+/*!\endcond */
+
+/*!
+ * \brief Deadline driven speed control of real-time encoding.
+ *
+ * Each frame is timed from the start of av1_get_compressed_data(). Every
+ * superblock row of the nonrd encoder compares the elapsed time with its
+ * share of the budget and picks a speed level for the row. The level a
+ * frame starts at follows the time the previous frames of the same spatial
+ * layer took.
+ */
+typedef struct {
+  /*!
+   * Target encoding time of a frame in microseconds, 0 if disabled.
+   */
+  unsigned int budget_us;
+  /*!
+   * Speed level the next frame of each spatial layer starts at.
+   */
+  int level[AOM_MAX_SS_LAYERS];
+  /*!
+   * Number of consecutive frames of each spatial layer that took less than
+   * 3/4 of the budget.
+   */
+  int fast_frames[AOM_MAX_SS_LAYERS];
+  /*!
+   * Speed level the current frame started at.
+   */
+  int frame_level;
+  /*!
+   * Started at the beginning of the current frame.
+   */
+  struct aom_usec_timer frame_timer;
+  /*!
+   * Time elapsed in the frame when the superblock rows started.
+   */
+  int64_t encode_start_us;
+  /*!
+   * Time elapsed in the frame when the superblock rows were done.
+   */
+  int64_t encode_end_us;
+  /*!
+   * Share of the budget left to the superblock rows of the current frame.
+   */
+  int64_t encode_budget_us;
+  /*!
+   * Running average of the time spent after the superblock rows (loop
+   * filters, bitstream packing), -1 before the first frame.
+   */
+  int64_t post_encode_us;
+  /*!
+   * Time taken by each superblock row of each tile column.
+   */
+  int64_t *row_time_us;
+  /*!
+   * Speed level of each superblock row of each tile column.
+   */
+  uint8_t *row_level;
+  /*!
+   * Number of entries allocated in row_time_us and row_level.
+   */
+  int row_alloc_size;
+  /*!
+   * Number of superblock rows of the current frame.
+   */
+  int sb_rows;
+  /*!
+   * Number of tile columns of the current frame, the stride of the row
+   * arrays.
+   */
+  int tile_cols;
+  /*!
+   * Statistics of the last encoded frame.
+   */
+  aom_enc_frame_time_stats_t stats;
+} TimeBudget;
+
+/*!\cond */
+struct AV1_COMP;
+
+void av1_time_budget_init(TimeBudget *tb);
+
+void av1_time_budget_free(TimeBudget *tb);
+
+void av1_time_budget_frame_start(struct AV1_COMP *cpi);
+
+void av1_time_budget_encode_start(struct AV1_COMP *cpi);
+
+void av1_time_budget_encode_end(struct AV1_COMP *cpi);
+
+void av1_time_budget_frame_end(struct AV1_COMP *cpi);
+
+int64_t av1_time_budget_elapsed(const TimeBudget *tb);
+/*!\endcond */
+
+/*!\brief Returns the speed level of a superblock row
+ *
+ * \param[in]    cpi     Top level encoder instance structure
+ * \param[in]    mi_row  First mi row of the superblock row
+ *
+ * \return 0 when no budget is set, otherwise the level the frame started at,
+ * raised when the frame is behind its budget at this row and lowered when it
+ * is well ahead of it.
+ */
+int av1_time_budget_row_level(const struct AV1_COMP *cpi, int mi_row);
+
+/*!\brief Records the time and speed level of a superblock row
+ *
+ * Each row of each tile column is written by the thread that encodes it.
+ *
+ * \param[in]    cpi       Top level encoder instance structure
+ * \param[in]    tile_col  Tile column of the row
+ * \param[in]    mi_row    First mi row of the superblock row
+ * \param[in]    start_us  Time elapsed in the frame when the row started
+ * \param[in]    level     Speed level the row was encoded with
+ */
+void av1_time_budget_row_done(struct AV1_COMP *cpi, int tile_col, int mi_row,
+                              int64_t start_us, int level);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_TIME_BUDGET_H_
@@ -1717,6 +1717,7 @@ int av1_tpl_setup_stats(AV1_COMP *cpi, int gop_eval,
       continue;
 
     init_mc_flow_dispenser(cpi, frame_idx, pframe_qindex);
+    av1_start_module_timer(cpi, MOD_TPL);
     if (mt_info->num_workers > 1) {
       tpl_row_mt->sync_read_ptr = av1_tpl_row_mt_sync_read;
       tpl_row_mt->sync_write_ptr = av1_tpl_row_mt_sync_write;
@@ -1724,6 +1725,7 @@ int av1_tpl_setup_stats(AV1_COMP *cpi, int gop_eval,
     } else {
       mc_flow_dispenser(cpi);
     }
+    av1_end_module_timer(cpi, MOD_TPL);
     av1_tpl_txfm_stats_update_abs_coeff_mean(&cpi->td.tpl_txfm_stats);
     av1_tpl_store_txfm_stats(tpl_data, &cpi->td.tpl_txfm_stats, frame_idx);
 #if CONFIG_RATECTRL_LOG && CONFIG_THREE_PASS && CONFIG_BITRATE_ACCURACY
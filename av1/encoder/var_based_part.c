@@ -27,7 +27,9 @@
 #include "av1/common/blockd.h"
 
 #include "av1/encoder/encodeframe.h"
+#include "av1/encoder/encodeframe_utils.h"
 #include "av1/encoder/var_based_part.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/reconinter_enc.h"
 
 extern const uint8_t AV1_VAR_OFFS[];
@@ -48,6 +50,17 @@ typedef struct {
   VPartVar *split[4];
 } variance_node;
 
+// The per 8x8 source statistics of the frame, from the superblock origin.
+typedef struct {
+  const uint16_t *src_sum;
+  // NULL unless the partitioning predicts from LAST at zero motion.
+  const uint16_t *last_sum;
+  int stride;
+  // Number of complete 8x8 blocks right of and below the superblock origin.
+  int cols;
+  int rows;
+} SbSrcStats;
+
 static AOM_INLINE void tree_to_node(void *data, BLOCK_SIZE bsize,
                                     variance_node *node) {
   int i;
@@ -284,18 +297,34 @@ static AOM_INLINE void fill_variance_8x8avg_highbd(
 }
 #endif
 
-static AOM_INLINE void fill_variance_8x8avg_lowbd(const uint8_t *s, int sp,
-                                                  const uint8_t *d, int dp,
-                                                  int x16_idx, int y16_idx,
-                                                  VP16x16 *vst, int pixels_wide,
-                                                  int pixels_high,
-                                                  int is_key_frame) {
+static AOM_INLINE void fill_variance_8x8avg_lowbd(
+    const uint8_t *s, int sp, const uint8_t *d, int dp, int x16_idx,
+    int y16_idx, VP16x16 *vst, int pixels_wide, int pixels_high,
+    int is_key_frame, const SbSrcStats *sb_stats) {
   unsigned int sse[4] = { 0 };
   int sum[4] = { 0 };
   int d_avg[4] = { 128, 128, 128, 128 };
   int s_avg[4];
+  const int x8_blk = x16_idx >> 3;
+  const int y8_blk = y16_idx >> 3;
 
-  if (all_blks_inside(x16_idx, y16_idx, pixels_wide, pixels_high)) {
+  if (sb_stats != NULL && x8_blk + 2 <= sb_stats->cols &&
+      y8_blk + 2 <= sb_stats->rows) {
+    // Same rounding as aom_avg_8x8().
+    for (int k = 0; k < 4; k++) {
+      const int idx =
+          (y8_blk + (k >> 1)) * sb_stats->stride + x8_blk + (k & 1);
+      s_avg[k] = (sb_stats->src_sum[idx] + 32) >> 6;
+      if (sb_stats->last_sum != NULL)
+        d_avg[k] = (sb_stats->last_sum[idx] + 32) >> 6;
+    }
+    if (!is_key_frame && sb_stats->last_sum == NULL)
+      aom_avg_8x8_quad(d, dp, x16_idx, y16_idx, d_avg);
+    for (int k = 0; k < 4; k++) {
+      sum[k] = s_avg[k] - d_avg[k];
+      sse[k] = sum[k] * sum[k];
+    }
+  } else if (all_blks_inside(x16_idx, y16_idx, pixels_wide, pixels_high)) {
     aom_avg_8x8_quad(s, sp, x16_idx, y16_idx, s_avg);
     if (!is_key_frame) aom_avg_8x8_quad(d, dp, x16_idx, y16_idx, d_avg);
     for (int k = 0; k < 4; k++) {
@@ -327,7 +356,8 @@ static AOM_INLINE void fill_variance_8x8avg(const uint8_t *s, int sp,
                                             int x16_idx, int y16_idx,
                                             VP16x16 *vst, int highbd_flag,
                                             int pixels_wide, int pixels_high,
-                                            int is_key_frame) {
+                                            int is_key_frame,
+                                            const SbSrcStats *sb_stats) {
 #if CONFIG_AV1_HIGHBITDEPTH
   if (highbd_flag) {
     fill_variance_8x8avg_highbd(s, sp, d, dp, x16_idx, y16_idx, vst,
@@ -338,7 +368,7 @@ static AOM_INLINE void fill_variance_8x8avg(const uint8_t *s, int sp,
   (void)highbd_flag;
 #endif  // CONFIG_AV1_HIGHBITDEPTH
   fill_variance_8x8avg_lowbd(s, sp, d, dp, x16_idx, y16_idx, vst, pixels_wide,
-                             pixels_high, is_key_frame);
+                             pixels_high, is_key_frame, sb_stats);
 }
 
 static int compute_minmax_8x8(const uint8_t *s, int sp, const uint8_t *d,
@@ -922,6 +952,249 @@ void av1_set_variance_partition_thresholds(AV1_COMP *cpi, int q,
   }
 }
 
+void av1_free_src_stats_8x8(SrcStats8x8 *stats) {
+  aom_free(stats->src_sum);
+  aom_free(stats->src_sse);
+  aom_free(stats->last_sum);
+  aom_free(stats->last_sad);
+  aom_free(stats->last_sad_uv[0]);
+  aom_free(stats->last_sad_uv[1]);
+  av1_zero(*stats);
+}
+
+static void alloc_src_stats_8x8(AV1_COMMON *cm, SrcStats8x8 *stats, int size,
+                                int uv_size) {
+  if (size <= stats->alloc_size && uv_size <= stats->uv_alloc_size) return;
+  av1_free_src_stats_8x8(stats);
+  CHECK_MEM_ERROR(cm, stats->src_sum,
+                  aom_malloc(size * sizeof(*stats->src_sum)));
+  CHECK_MEM_ERROR(cm, stats->src_sse,
+                  aom_malloc(size * sizeof(*stats->src_sse)));
+  CHECK_MEM_ERROR(cm, stats->last_sum,
+                  aom_malloc(size * sizeof(*stats->last_sum)));
+  CHECK_MEM_ERROR(cm, stats->last_sad,
+                  aom_malloc(size * sizeof(*stats->last_sad)));
+  stats->alloc_size = size;
+  if (uv_size > 0) {
+    for (int i = 0; i < 2; ++i) {
+      CHECK_MEM_ERROR(cm, stats->last_sad_uv[i],
+                      aom_malloc(uv_size * sizeof(*stats->last_sad_uv[i])));
+    }
+    stats->uv_alloc_size = uv_size;
+  }
+}
+
+// A range of 8x8 blocks of the statistics.
+typedef struct {
+  int row_start, row_end;
+  int col_start, col_end;
+} SrcStatsBlkRange;
+
+static void compute_src_stats_8x8_blocks(AV1_COMP *cpi,
+                                         const SrcStatsBlkRange *y_range,
+                                         const SrcStatsBlkRange *uv_range) {
+  SrcStats8x8 *const stats = &cpi->src_stats_8x8;
+  const YV12_BUFFER_CONFIG *const src = cpi->source;
+  const YV12_BUFFER_CONFIG *const last =
+      stats->has_last ? get_ref_frame_yv12_buf(&cpi->common, LAST_FRAME)
+                      : NULL;
+  const int c0 = y_range->col_start;
+
+  for (int r = y_range->row_start; r < y_range->row_end; ++r) {
+    const int idx = r * stats->cols + c0;
+    aom_get_8x8_stats_row(
+        src->y_buffer + 8 * (r * src->y_stride + c0), src->y_stride,
+        last ? last->y_buffer + 8 * (r * last->y_stride + c0) : NULL,
+        last ? last->y_stride : 0, y_range->col_end - c0, stats->src_sum + idx,
+        stats->src_sse + idx, stats->last_sum + idx, stats->last_sad + idx);
+  }
+  if (last == NULL || stats->uv_cols == 0) return;
+
+  // Chroma blocks are gathered in chunks, only their SADs are kept.
+  uint16_t uv_sum[32], uv_last_sum[32];
+  uint32_t uv_sse[32];
+  const int uv_chunk = (int)(sizeof(uv_sum) / sizeof(uv_sum[0]));
+  for (int plane = 0; plane < 2; ++plane) {
+    const uint8_t *const src_buf = plane ? src->v_buffer : src->u_buffer;
+    const uint8_t *const last_buf = plane ? last->v_buffer : last->u_buffer;
+    for (int r = uv_range->row_start; r < uv_range->row_end; ++r) {
+      for (int c = uv_range->col_start; c < uv_range->col_end; c += uv_chunk) {
+        aom_get_8x8_stats_row(
+            src_buf + 8 * (r * src->uv_stride + c), src->uv_stride,
+            last_buf + 8 * (r * last->uv_stride + c), last->uv_stride,
+            AOMMIN(uv_chunk, uv_range->col_end - c), uv_sum, uv_sse,
+            uv_last_sum, stats->last_sad_uv[plane] + r * stats->uv_cols + c);
+      }
+    }
+  }
+}
+
+void av1_compute_src_stats_8x8_rows(AV1_COMP *cpi, int start_row,
+                                    int row_step) {
+  const SrcStats8x8 *const stats = &cpi->src_stats_8x8;
+  const int ss_y = cpi->common.seq_params->subsampling_y;
+  const int strip_blks = SRC_STATS_STRIP_HEIGHT >> 3;
+  const int num_strips = (stats->rows + strip_blks - 1) / strip_blks;
+
+  const int ss_x = cpi->common.seq_params->subsampling_x;
+  const int mib_size_log2 = cpi->common.seq_params->mib_size_log2;
+  const int sb_width = MI_SIZE << mib_size_log2;
+  const int width = stats->cols << 3;
+
+  for (int strip = start_row; strip < num_strips; strip += row_step) {
+    const int y0 = strip * SRC_STATS_STRIP_HEIGHT;
+    const int y1 = y0 + SRC_STATS_STRIP_HEIGHT;
+    const int mi_row = ((y0 >> MI_SIZE_LOG2) >> mib_size_log2)
+                       << mib_size_log2;
+    // Superblocks coded as skip by the segmentation never read the
+    // statistics, so only the runs of other superblocks are gathered.
+    int x0 = 0;
+    for (int x = 0; x < width + sb_width; x += sb_width) {
+      if (x < width && !av1_is_sb_seg_skip(cpi, mi_row, x >> MI_SIZE_LOG2))
+        continue;
+      const int x1 = AOMMIN(x, width);
+      if (x1 > x0) {
+        const SrcStatsBlkRange y_range = { y0 >> 3,
+                                           AOMMIN(y1 >> 3, stats->rows),
+                                           x0 >> 3, x1 >> 3 };
+        const SrcStatsBlkRange uv_range = {
+          (y0 >> ss_y) >> 3, AOMMIN((y1 >> ss_y) >> 3, stats->uv_rows),
+          (x0 >> ss_x) >> 3, AOMMIN((x1 >> ss_x) >> 3, stats->uv_cols)
+        };
+        compute_src_stats_8x8_blocks(cpi, &y_range, &uv_range);
+      }
+      x0 = x + sb_width;
+    }
+  }
+}
+
+void av1_update_src_stats_8x8_sb(AV1_COMP *cpi, int mi_row, int mi_col,
+                                 BLOCK_SIZE bsize) {
+  const SrcStats8x8 *const stats = &cpi->src_stats_8x8;
+  if (!stats->valid) return;
+  const int ss_x = cpi->common.seq_params->subsampling_x;
+  const int ss_y = cpi->common.seq_params->subsampling_y;
+  const int x0 = mi_col * MI_SIZE;
+  const int y0 = mi_row * MI_SIZE;
+  const int x1 = x0 + block_size_wide[bsize];
+  const int y1 = y0 + block_size_high[bsize];
+  const SrcStatsBlkRange y_range = { y0 >> 3, AOMMIN(y1 >> 3, stats->rows),
+                                     x0 >> 3, AOMMIN(x1 >> 3, stats->cols) };
+  const SrcStatsBlkRange uv_range = {
+    (y0 >> ss_y) >> 3, AOMMIN((y1 >> ss_y) >> 3, stats->uv_rows),
+    (x0 >> ss_x) >> 3, AOMMIN((x1 >> ss_x) >> 3, stats->uv_cols)
+  };
+  if (y_range.row_start >= y_range.row_end ||
+      y_range.col_start >= y_range.col_end)
+    return;
+  compute_src_stats_8x8_blocks(cpi, &y_range, &uv_range);
+}
+
+void av1_compute_src_stats_8x8(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  SrcStats8x8 *const stats = &cpi->src_stats_8x8;
+  const YV12_BUFFER_CONFIG *const src = cpi->source;
+  stats->valid = 0;
+  stats->has_last = 0;
+  // The lowbd partitioning reads the statistics as they are. The temporal
+  // denoiser filters the source in place while the frame is encoded.
+  if (cpi->sf.part_sf.partition_search_type != VAR_BASED_PARTITION ||
+      (src->flags & YV12_FLAG_HIGHBITDEPTH) || src->y_crop_width != cm->width ||
+      src->y_crop_height != cm->height)
+    return;
+#if CONFIG_AV1_TEMPORAL_DENOISING
+  if (cpi->oxcf.noise_sensitivity > 0) return;
+#endif
+  stats->cols = cm->width >> 3;
+  stats->rows = cm->height >> 3;
+  if (av1_num_planes(cm) > 1) {
+    stats->uv_cols = src->uv_crop_width >> 3;
+    stats->uv_rows = src->uv_crop_height >> 3;
+  } else {
+    stats->uv_cols = 0;
+    stats->uv_rows = 0;
+  }
+  if (stats->cols == 0 || stats->rows == 0) return;
+  alloc_src_stats_8x8(cm, stats, stats->cols * stats->rows,
+                      stats->uv_cols * stats->uv_rows);
+
+  if (!frame_is_intra_only(cm)) {
+    const YV12_BUFFER_CONFIG *const last =
+        get_ref_frame_yv12_buf(cm, LAST_FRAME);
+    stats->has_last = last != NULL && last->y_crop_width == cm->width &&
+                      last->y_crop_height == cm->height &&
+                      !(last->flags & YV12_FLAG_HIGHBITDEPTH);
+  }
+  stats->valid = 1;
+  av1_src_stats_8x8_mt(cpi);
+}
+
+// Returns 1 and the first block of the statistics covering the plane block
+// at pixel position (x, y), if it is made of complete 8x8 blocks of the frame.
+static AOM_INLINE int get_src_stats_blk(int x, int y, int bw, int bh, int cols,
+                                        int rows, int *blk_col, int *blk_row) {
+  if ((x | y | bw | bh) & 7) return 0;
+  if (((x + bw) >> 3) > cols || ((y + bh) >> 3) > rows) return 0;
+  *blk_col = x >> 3;
+  *blk_row = y >> 3;
+  return 1;
+}
+
+int av1_get_src_stats_variance(const SrcStats8x8 *stats, int mi_row,
+                               int mi_col, BLOCK_SIZE bsize,
+                               unsigned int *variance) {
+  const int bw = block_size_wide[bsize];
+  const int bh = block_size_high[bsize];
+  int blk_col, blk_row;
+  if (!stats->valid ||
+      !get_src_stats_blk(mi_col * MI_SIZE, mi_row * MI_SIZE, bw, bh,
+                         stats->cols, stats->rows, &blk_col, &blk_row))
+    return 0;
+
+  int64_t sum = 0;
+  uint64_t sse = 0;
+  for (int r = blk_row; r < blk_row + (bh >> 3); ++r) {
+    const int idx = r * stats->cols;
+    for (int c = blk_col; c < blk_col + (bw >> 3); ++c) {
+      sum += stats->src_sum[idx + c];
+      sse += stats->src_sse[idx + c];
+    }
+  }
+  // sse - sum^2 / N does not change when a constant is removed from the
+  // pixels, so this matches the variance against AV1_VAR_OFFS.
+  const int num_pels_log2 = num_pels_log2_lookup[bsize];
+  const unsigned int var =
+      (unsigned int)(sse - (uint64_t)((sum * sum) >> num_pels_log2));
+  *variance = ROUND_POWER_OF_TWO(var, num_pels_log2);
+  return 1;
+}
+
+unsigned int av1_get_src_stats_last_sad(const SrcStats8x8 *stats, int plane,
+                                        int mi_row, int mi_col,
+                                        BLOCK_SIZE plane_bsize, int ss_x,
+                                        int ss_y) {
+  if (!stats->has_last) return UINT_MAX;
+  const int is_uv = plane != AOM_PLANE_Y;
+  const int cols = is_uv ? stats->uv_cols : stats->cols;
+  const int rows = is_uv ? stats->uv_rows : stats->rows;
+  const uint16_t *const sad =
+      is_uv ? stats->last_sad_uv[plane - 1] : stats->last_sad;
+  const int bw = block_size_wide[plane_bsize];
+  const int bh = block_size_high[plane_bsize];
+  int blk_col, blk_row;
+  if (cols == 0 ||
+      !get_src_stats_blk((mi_col * MI_SIZE) >> ss_x, (mi_row * MI_SIZE) >> ss_y,
+                         bw, bh, cols, rows, &blk_col, &blk_row))
+    return UINT_MAX;
+
+  unsigned int sum = 0;
+  for (int r = blk_row; r < blk_row + (bh >> 3); ++r) {
+    for (int c = blk_col; c < blk_col + (bw >> 3); ++c)
+      sum += sad[r * cols + c];
+  }
+  return sum;
+}
+
 static AOM_INLINE void chroma_check(AV1_COMP *cpi, MACROBLOCK *x,
                                     BLOCK_SIZE bsize, unsigned int y_sad,
                                     unsigned int y_sad_g, int is_key_frame,
@@ -951,8 +1224,16 @@ static AOM_INLINE void chroma_check(AV1_COMP *cpi, MACROBLOCK *x,
         get_plane_block_size(bsize, pd->subsampling_x, pd->subsampling_y);
 
     if (bs != BLOCK_INVALID) {
+      // Zero motion SAD against LAST gathered at frame start, if any.
+      const unsigned int uv_sad_stats =
+          zero_motion ? av1_get_src_stats_last_sad(
+                            &cpi->src_stats_8x8, i, xd->mi_row, xd->mi_col,
+                            bs, pd->subsampling_x, pd->subsampling_y)
+                      : UINT_MAX;
       // For last:
-      if (zero_motion) {
+      if (uv_sad_stats != UINT_MAX) {
+        uv_sad[i - 1] = uv_sad_stats;
+      } else if (zero_motion) {
         if (mi->ref_frame[0] == LAST_FRAME) {
           uv_sad[i - 1] = cpi->ppi->fn_ptr[bs].sdf(
               p->src.buf, p->src.stride, pd->pre[0].buf, pd->pre[0].stride);
@@ -1000,7 +1281,8 @@ static void fill_variance_tree_leaves(
     AV1_COMP *cpi, MACROBLOCK *x, VP128x128 *vt, VP16x16 *vt2,
     PART_EVAL_STATUS *force_split, int avg_16x16[][4], int maxvar_16x16[][4],
     int minvar_16x16[][4], int *variance4x4downsample, int64_t *thresholds,
-    uint8_t *src, int src_stride, const uint8_t *dst, int dst_stride) {
+    uint8_t *src, int src_stride, const uint8_t *dst, int dst_stride,
+    const SbSrcStats *sb_stats) {
   AV1_COMMON *cm = &cpi->common;
   MACROBLOCKD *xd = &x->e_mbd;
   const int is_key_frame = frame_is_intra_only(cm);
@@ -1041,7 +1323,7 @@ static void fill_variance_tree_leaves(
         if (!is_key_frame) {
           fill_variance_8x8avg(src, src_stride, dst, dst_stride, x16_idx,
                                y16_idx, vst, is_cur_buf_hbd(xd), pixels_wide,
-                               pixels_high, is_key_frame);
+                               pixels_high, is_key_frame, sb_stats);
 
           fill_variance_tree(&vt->split[m].split[i].split[j], BLOCK_16X16);
           get_variance(&vt->split[m].split[i].split[j].part_variances.none);
@@ -1109,6 +1391,63 @@ static void fill_variance_tree_leaves(
   }
 }
 
+// Estimates the superblock motion from the motion vector of the co-located
+// block in the lower spatial layer: the scaled vector and its 4 full-pel
+// neighbours are checked against the zero vector. This replaces the
+// projection based search of av1_int_pro_motion_estimation().
+static unsigned int estimate_motion_from_lower_layer(const AV1_COMP *cpi,
+                                                     MACROBLOCK *x,
+                                                     BLOCK_SIZE bsize,
+                                                     const MV *lower_mv) {
+  MACROBLOCKD *const xd = &x->e_mbd;
+  MB_MODE_INFO *const mi = xd->mi[0];
+  const struct buf_2d *const src = &x->plane[0].src;
+  const struct buf_2d *const pre = &xd->plane[0].pre[0];
+  const aom_variance_fn_ptr_t *const fn_ptr = &cpi->ppi->fn_ptr[bsize];
+  static const FULLPEL_MV search_pos[4] = {
+    { -1, 0 }, { 0, -1 }, { 0, 1 }, { 1, 0 }
+  };
+  FULLPEL_MV best_mv = kZeroFullMv;
+  unsigned int best_sad = av1_get_src_stats_last_sad(
+      &cpi->src_stats_8x8, AOM_PLANE_Y, xd->mi_row, xd->mi_col, bsize, 0, 0);
+  if (best_sad == UINT_MAX)
+    best_sad = fn_ptr->sdf(src->buf, src->stride, pre->buf, pre->stride);
+
+  FULLPEL_MV this_mv = get_fullmv_from_mv(lower_mv);
+  // Keep the neighbours inside the motion vector range as well.
+  FullMvLimits mv_limits = x->mv_limits;
+  mv_limits.col_min += 1;
+  mv_limits.col_max -= 1;
+  mv_limits.row_min += 1;
+  mv_limits.row_max -= 1;
+  clamp_fullmv(&this_mv, &mv_limits);
+  const uint8_t *const ref_buf =
+      pre->buf + this_mv.row * pre->stride + this_mv.col;
+  const unsigned int this_sad =
+      fn_ptr->sdf(src->buf, src->stride, ref_buf, pre->stride);
+  if (this_sad < best_sad) {
+    best_sad = this_sad;
+    best_mv = this_mv;
+  }
+  const uint8_t *const pos[4] = {
+    ref_buf - pre->stride,
+    ref_buf - 1,
+    ref_buf + 1,
+    ref_buf + pre->stride,
+  };
+  unsigned int sad[4];
+  fn_ptr->sdx4df(src->buf, src->stride, pos, pre->stride, sad);
+  for (int i = 0; i < 4; ++i) {
+    if (sad[i] < best_sad) {
+      best_sad = sad[i];
+      best_mv.row = this_mv.row + search_pos[i].row;
+      best_mv.col = this_mv.col + search_pos[i].col;
+    }
+  }
+  mi->mv[0].as_mv = get_mv_from_fullmv(&best_mv);
+  return best_sad;
+}
+
 static void setup_planes(AV1_COMP *cpi, MACROBLOCK *x, unsigned int *y_sad,
                          unsigned int *y_sad_g, unsigned int *y_sad_last,
                          MV_REFERENCE_FRAME *ref_frame_partition, int mi_row,
@@ -1148,11 +1487,23 @@ static void setup_planes(AV1_COMP *cpi, MACROBLOCK *x, unsigned int *y_sad,
   mi->interp_filters = av1_broadcast_interp_filter(BILINEAR);
   if (cpi->sf.rt_sf.estimate_motion_for_var_based_partition) {
     if (xd->mb_to_right_edge >= 0 && xd->mb_to_bottom_edge >= 0) {
-      const MV dummy_mv = { 0, 0 };
-      *y_sad = av1_int_pro_motion_estimation(cpi, x, cm->seq_params->sb_size,
-                                             mi_row, mi_col, &dummy_mv);
+      MV lower_mv;
+      if (cpi->ppi->use_svc && cpi->svc.spatial_layer_id > 0 &&
+          av1_svc_get_lower_layer_mv(cpi, cm->seq_params->sb_size, mi_row,
+                                     mi_col, &lower_mv)) {
+        *y_sad = estimate_motion_from_lower_layer(
+            cpi, x, cm->seq_params->sb_size, &lower_mv);
+      } else {
+        const MV dummy_mv = { 0, 0 };
+        *y_sad = av1_int_pro_motion_estimation(
+            cpi, x, cm->seq_params->sb_size, mi_row, mi_col, &dummy_mv);
+      }
     }
   }
+  if (*y_sad == UINT_MAX) {
+    *y_sad = av1_get_src_stats_last_sad(&cpi->src_stats_8x8, AOM_PLANE_Y,
+                                        mi_row, mi_col, bsize, 0, 0);
+  }
   if (*y_sad == UINT_MAX) {
     *y_sad = cpi->ppi->fn_ptr[bsize].sdf(
         x->plane[0].src.buf, x->plane[0].src.stride, xd->plane[0].pre[0].buf,
@@ -1293,6 +1644,13 @@ int av1_choose_var_based_partitioning(AV1_COMP *cpi, const TileInfo *const tile,
                        x->content_state_sb.source_sad_nonrd,
                        x->content_state_sb.source_sad_rd, 0);
   }
+  // Split less at the two lowest partition levels when the frame is behind
+  // its time budget.
+  if (x->time_budget_level >= TIME_BUDGET_LEVEL_SHALLOW_PARTITION &&
+      !frame_is_intra_only(cm)) {
+    for (int idx = 2; idx < 4; ++idx)
+      if (thresholds[idx] < INT32_MAX) thresholds[idx] <<= 1;
+  }
 
   // For non keyframes, disable 4x4 average for low resolution when speed = 8
   threshold_4x4avg = INT64_MAX;
@@ -1385,9 +1743,31 @@ int av1_choose_var_based_partitioning(AV1_COMP *cpi, const TileInfo *const tile,
     CHECK_MEM_ERROR(cm, vt2, aom_malloc(sizeof(*vt2)));
   // Fill in the entire tree of 8x8 (or 4x4 under some conditions) variances
   // for splits.
+  // The 8x8 averages of the source, and of LAST at zero motion, are read
+  // from the statistics gathered at frame start where they cover the
+  // superblock.
+  const SrcStats8x8 *const src_stats = &cpi->src_stats_8x8;
+  const int sb_blk_col = (mi_col * MI_SIZE) >> 3;
+  const int sb_blk_row = (mi_row * MI_SIZE) >> 3;
+  SbSrcStats sb_stats_buf;
+  const SbSrcStats *sb_stats = NULL;
+  if (src_stats->valid && sb_blk_col < src_stats->cols &&
+      sb_blk_row < src_stats->rows) {
+    const int idx = sb_blk_row * src_stats->cols + sb_blk_col;
+    sb_stats_buf.src_sum = src_stats->src_sum + idx;
+    sb_stats_buf.last_sum = src_stats->has_last && !is_key_frame &&
+                                    zero_motion &&
+                                    ref_frame_partition == LAST_FRAME
+                                ? src_stats->last_sum + idx
+                                : NULL;
+    sb_stats_buf.stride = src_stats->cols;
+    sb_stats_buf.cols = src_stats->cols - sb_blk_col;
+    sb_stats_buf.rows = src_stats->rows - sb_blk_row;
+    sb_stats = &sb_stats_buf;
+  }
   fill_variance_tree_leaves(cpi, x, vt, vt2, force_split, avg_16x16,
                             maxvar_16x16, minvar_16x16, variance4x4downsample,
-                            thresholds, s, sp, d, dp);
+                            thresholds, s, sp, d, dp, sb_stats);
 
   avg_64x64 = 0;
   for (m = 0; m < num_64x64_blocks; ++m) {
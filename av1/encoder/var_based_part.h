@@ -83,6 +83,40 @@ int av1_choose_var_based_partitioning(AV1_COMP *cpi, const TileInfo *const tile,
                                       ThreadData *td, MACROBLOCK *x, int mi_row,
                                       int mi_col);
 
+// Height in luma rows of the strips the per 8x8 source statistics are
+// gathered in, the unit of their multi-threading.
+#define SRC_STATS_STRIP_HEIGHT 64
+
+// Gathers cpi->src_stats_8x8 for the current frame, or marks it invalid when
+// the frame does not use variance based partitioning.
+void av1_compute_src_stats_8x8(AV1_COMP *cpi);
+
+// Gathers the statistics of the 64 pixel high strips start_row,
+// start_row + row_step, ... of the frame.
+void av1_compute_src_stats_8x8_rows(AV1_COMP *cpi, int start_row,
+                                    int row_step);
+
+// Gathers again the statistics of the superblock, after its source was
+// filtered in place.
+void av1_update_src_stats_8x8_sb(AV1_COMP *cpi, int mi_row, int mi_col,
+                                 BLOCK_SIZE bsize);
+
+void av1_free_src_stats_8x8(SrcStats8x8 *stats);
+
+// Returns 1 and sets the per pixel variance of the source block, as
+// av1_get_perpixel_variance() computes it, when the statistics cover the
+// block. Returns 0 otherwise.
+int av1_get_src_stats_variance(const SrcStats8x8 *stats, int mi_row,
+                               int mi_col, BLOCK_SIZE bsize,
+                               unsigned int *variance);
+
+// Returns the zero motion SAD of the plane block against LAST, or UINT_MAX
+// when the statistics do not cover the block.
+unsigned int av1_get_src_stats_last_sad(const SrcStats8x8 *stats, int plane,
+                                        int mi_row, int mi_col,
+                                        BLOCK_SIZE plane_bsize, int ss_x,
+                                        int ss_y);
+
 // Read out the block's temporal variance for 64x64 SB case.
 int av1_get_force_skip_low_temp_var_small_sb(const uint8_t *variance_low,
                                              int mi_row, int mi_col,
@@ -9,12 +9,15 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <assert.h>
 #include <immintrin.h>
 
 #include "config/av1_rtcd.h"
 
 #include "aom/aom_integer.h"
 #include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/x86/hadamard_avx2.h"
+#include "aom_dsp/x86/synonyms.h"
 
 static INLINE void write_zero(tran_low_t *qcoeff) {
   const __m256i zero = _mm256_setzero_si256();
@@ -171,6 +174,206 @@ void av1_quantize_lp_avx2(const int16_t *coeff_ptr, intptr_t n_coeffs,
   *eob_ptr = accumulate_eob256(eob256);
 }
 
+// Quantizes 16 low precision coefficients and accumulates the eob, the sum of
+// the absolute quantized values and the squared dequantization error, without
+// writing the quantized coefficients out.
+static AOM_FORCE_INLINE void quantize_rd_lp_16(
+    __m256i coeff, const int16_t *iscan_ptr, const __m256i *round256,
+    const __m256i *quant256, const __m256i *dequant256, __m256i *eob,
+    __m256i *satd, __m256i *sse) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i abs_coeff = _mm256_abs_epi16(coeff);
+  const __m256i tmp_rnd = _mm256_adds_epi16(abs_coeff, *round256);
+  const __m256i abs_qcoeff = _mm256_mulhi_epi16(tmp_rnd, *quant256);
+  const __m256i qcoeff = _mm256_sign_epi16(abs_qcoeff, coeff);
+  const __m256i dqcoeff = _mm256_mullo_epi16(qcoeff, *dequant256);
+  const __m256i nz_mask = _mm256_cmpgt_epi16(abs_qcoeff, zero);
+
+  const __m256i iscan = _mm256_loadu_si256((const __m256i *)iscan_ptr);
+  const __m256i iscan_plus1 = _mm256_sub_epi16(iscan, nz_mask);
+  const __m256i nz_iscan = _mm256_and_si256(iscan_plus1, nz_mask);
+  *eob = _mm256_max_epi16(*eob, nz_iscan);
+
+  *satd = _mm256_add_epi32(
+      *satd, _mm256_madd_epi16(abs_qcoeff, _mm256_set1_epi16(1)));
+
+  const __m256i diff = _mm256_sub_epi16(dqcoeff, coeff);
+  const __m256i error = _mm256_madd_epi16(diff, diff);
+  *sse = _mm256_add_epi64(*sse, _mm256_unpacklo_epi32(error, zero));
+  *sse = _mm256_add_epi64(*sse, _mm256_unpackhi_epi32(error, zero));
+}
+
+// Reduces the per block accumulators of quantize_rd_lp_16() into the eob and
+// the running rate and distortion totals.
+static INLINE void store_rd_lp(__m256i eob, __m256i satd, __m256i sse,
+                               uint16_t *eob_ptr, int *rate, int64_t *dist) {
+  *eob_ptr = accumulate_eob256(eob);
+
+  __m128i satd_128 = _mm_add_epi32(_mm256_castsi256_si128(satd),
+                                   _mm256_extracti128_si256(satd, 1));
+  satd_128 = _mm_add_epi32(satd_128, _mm_srli_si128(satd_128, 8));
+  satd_128 = _mm_add_epi32(satd_128, _mm_srli_si128(satd_128, 4));
+  *rate += _mm_cvtsi128_si32(satd_128);
+
+  __m128i sse_128 = _mm_add_epi64(_mm256_castsi256_si128(sse),
+                                  _mm256_extracti128_si256(sse, 1));
+  sse_128 = _mm_add_epi64(sse_128, _mm_srli_si128(sse_128, 8));
+  int64_t block_sse;
+  xx_storel_64(&block_sse, sse_128);
+  *dist += block_sse >> 2;
+}
+
+// Quantizes one 8x8 transform block held in registers. qp[0..2] hold the
+// round, quant and dequant values with the DC constants in the first element,
+// and qp[3..5] the AC only constants.
+static AOM_FORCE_INLINE void quantize_rd_lp_8x8(const __m256i *coeff,
+                                                const int16_t *iscan,
+                                                const __m256i *qp,
+                                                uint16_t *eob_ptr, int *rate,
+                                                int64_t *dist) {
+  __m256i eob = _mm256_setzero_si256();
+  __m256i satd = _mm256_setzero_si256();
+  __m256i sse = _mm256_setzero_si256();
+
+  quantize_rd_lp_16(coeff[0], iscan, &qp[0], &qp[1], &qp[2], &eob, &satd,
+                    &sse);
+  for (int i = 1; i < 4; ++i) {
+    quantize_rd_lp_16(coeff[i], iscan + 16 * i, &qp[3], &qp[4], &qp[5], &eob,
+                      &satd, &sse);
+  }
+  store_rd_lp(eob, satd, sse, eob_ptr, rate, dist);
+}
+
+static INLINE void load_rows_8x8_dual(const int16_t *src_diff, int stride,
+                                      __m256i *in) {
+  for (int i = 0; i < 8; ++i)
+    in[i] = _mm256_loadu_si256((const __m256i *)(src_diff + i * stride));
+}
+
+static INLINE void load_rows_8x8(const int16_t *src_diff, int stride,
+                                 __m256i *in) {
+  for (int i = 0; i < 8; ++i) {
+    const __m128i row =
+        _mm_loadu_si128((const __m128i *)(src_diff + i * stride));
+    in[i] = _mm256_inserti128_si256(_mm256_setzero_si256(), row, 0);
+  }
+}
+
+// Gathers the 8x8 Hadamard output of one 128-bit lane into raster order, 16
+// coefficients per register.
+static INLINE void gather_8x8(const __m256i *in, int lane, __m256i *out) {
+  const int sel = lane ? 0x31 : 0x20;
+  out[0] = _mm256_permute2x128_si256(in[0], in[1], sel);
+  out[1] = _mm256_permute2x128_si256(in[2], in[3], sel);
+  out[2] = _mm256_permute2x128_si256(in[4], in[5], sel);
+  out[3] = _mm256_permute2x128_si256(in[6], in[7], sel);
+}
+
+// Same as aom_hadamard_lp_16x16_avx2() followed by quantize_rd_lp_8x8() on
+// all 256 coefficients, but each output register of the last Hadamard stage
+// is quantized as soon as it is formed.
+static INLINE void hadamard_quantize_rd_lp_16x16(const int16_t *src_diff,
+                                                 int stride,
+                                                 const int16_t *iscan,
+                                                 const __m256i *qp,
+                                                 uint16_t *eob_ptr, int *rate,
+                                                 int64_t *dist) {
+  __m256i top[8], bot[8];
+  __m256i eob = _mm256_setzero_si256();
+  __m256i satd = _mm256_setzero_si256();
+  __m256i sse = _mm256_setzero_si256();
+
+  load_rows_8x8_dual(src_diff, stride, top);
+  load_rows_8x8_dual(src_diff + 8 * stride, stride, bot);
+  hadamard_col8x2_avx2(top, 0);
+  hadamard_col8x2_avx2(top, 1);
+  hadamard_col8x2_avx2(bot, 0);
+  hadamard_col8x2_avx2(bot, 1);
+
+  for (int k = 0; k < 4; ++k) {
+    const __m256i tl =
+        _mm256_permute2x128_si256(top[2 * k], top[2 * k + 1], 0x20);
+    const __m256i tr =
+        _mm256_permute2x128_si256(top[2 * k], top[2 * k + 1], 0x31);
+    const __m256i bl =
+        _mm256_permute2x128_si256(bot[2 * k], bot[2 * k + 1], 0x20);
+    const __m256i br =
+        _mm256_permute2x128_si256(bot[2 * k], bot[2 * k + 1], 0x31);
+    const __m256i b0 = _mm256_srai_epi16(_mm256_add_epi16(tl, tr), 1);
+    const __m256i b1 = _mm256_srai_epi16(_mm256_sub_epi16(tl, tr), 1);
+    const __m256i b2 = _mm256_srai_epi16(_mm256_add_epi16(bl, br), 1);
+    const __m256i b3 = _mm256_srai_epi16(_mm256_sub_epi16(bl, br), 1);
+    // Only the first register of the first row holds the DC coefficient.
+    const __m256i *q = k == 0 ? &qp[0] : &qp[3];
+    quantize_rd_lp_16(_mm256_add_epi16(b0, b2), iscan + 16 * k, &q[0], &q[1],
+                      &q[2], &eob, &satd, &sse);
+    quantize_rd_lp_16(_mm256_add_epi16(b1, b3), iscan + 64 + 16 * k, &qp[3],
+                      &qp[4], &qp[5], &eob, &satd, &sse);
+    quantize_rd_lp_16(_mm256_sub_epi16(b0, b2), iscan + 128 + 16 * k, &qp[3],
+                      &qp[4], &qp[5], &eob, &satd, &sse);
+    quantize_rd_lp_16(_mm256_sub_epi16(b1, b3), iscan + 192 + 16 * k, &qp[3],
+                      &qp[4], &qp[5], &eob, &satd, &sse);
+  }
+  store_rd_lp(eob, satd, sse, eob_ptr, rate, dist);
+}
+
+void av1_hadamard_quantize_rd_lp_avx2(
+    const int16_t *src_diff, int diff_stride, int tx_wd, int blocks_wide,
+    int blocks_high, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *dequant_ptr, const int16_t *scan, const int16_t *iscan,
+    uint16_t *eobs, int *rate, int64_t *dist) {
+  (void)scan;
+  __m256i qp[6];
+
+  assert(tx_wd == 8 || tx_wd == 16);
+  qp[0] = _mm256_permute4x64_epi64(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)round_ptr)),
+      0x54);
+  qp[1] = _mm256_permute4x64_epi64(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)quant_ptr)),
+      0x54);
+  qp[2] = _mm256_permute4x64_epi64(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)dequant_ptr)),
+      0x54);
+  qp[3] = _mm256_permute2x128_si256(qp[0], qp[0], 0x31);
+  qp[4] = _mm256_permute2x128_si256(qp[1], qp[1], 0x31);
+  qp[5] = _mm256_permute2x128_si256(qp[2], qp[2], 0x31);
+
+  *rate = 0;
+  *dist = 0;
+  for (int r = 0; r < blocks_high; ++r) {
+    const int16_t *src = src_diff + r * tx_wd * diff_stride;
+    uint16_t *eob = eobs + r * blocks_wide;
+    if (tx_wd == 16) {
+      for (int c = 0; c < blocks_wide; ++c) {
+        hadamard_quantize_rd_lp_16x16(src + c * 16, diff_stride, iscan, qp,
+                                      &eob[c], rate, dist);
+      }
+    } else {
+      __m256i in[8], coeff[8];
+      int c = 0;
+      // Two horizontally adjacent 8x8 blocks share one pass of the Hadamard
+      // transform.
+      for (; c + 1 < blocks_wide; c += 2) {
+        load_rows_8x8_dual(src + c * 8, diff_stride, in);
+        hadamard_col8x2_avx2(in, 0);
+        hadamard_col8x2_avx2(in, 1);
+        gather_8x8(in, 0, coeff);
+        gather_8x8(in, 1, coeff + 4);
+        quantize_rd_lp_8x8(coeff, iscan, qp, &eob[c], rate, dist);
+        quantize_rd_lp_8x8(coeff + 4, iscan, qp, &eob[c + 1], rate, dist);
+      }
+      if (c < blocks_wide) {
+        load_rows_8x8(src + c * 8, diff_stride, in);
+        hadamard_col8x2_avx2(in, 0);
+        hadamard_col8x2_avx2(in, 1);
+        gather_8x8(in, 0, coeff);
+        quantize_rd_lp_8x8(coeff, iscan, qp, &eob[c], rate, dist);
+      }
+    }
+  }
+}
+
 static AOM_FORCE_INLINE __m256i get_max_lane_eob(const int16_t *iscan,
                                                  __m256i v_eobmax,
                                                  __m256i v_mask) {
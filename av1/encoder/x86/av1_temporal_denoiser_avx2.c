@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>  // AVX2
+
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "av1/common/reconinter.h"
+#include "av1/encoder/context_tree.h"
+#include "av1/encoder/av1_temporal_denoiser.h"
+
+// Compute the sum of all pixel differences in acc_diff.
+static INLINE int sum_diff_32x1(__m256i acc_diff) {
+  const __m256i k_1 = _mm256_set1_epi16(1);
+  const __m256i acc_diff_lo =
+      _mm256_srai_epi16(_mm256_unpacklo_epi8(acc_diff, acc_diff), 8);
+  const __m256i acc_diff_hi =
+      _mm256_srai_epi16(_mm256_unpackhi_epi8(acc_diff, acc_diff), 8);
+  const __m256i acc_diff_16 = _mm256_add_epi16(acc_diff_lo, acc_diff_hi);
+  const __m256i sum_32 = _mm256_madd_epi16(acc_diff_16, k_1);
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sum_32),
+                              _mm256_extracti128_si256(sum_32, 1));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+static INLINE __m256i load_16x2(const uint8_t *p, int stride) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+      _mm_loadu_si128((const __m128i *)(p + stride)), 1);
+}
+
+static INLINE void store_16x2(uint8_t *p, int stride, __m256i v) {
+  _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(v));
+  _mm_storeu_si128((__m128i *)(p + stride), _mm256_extracti128_si256(v, 1));
+}
+
+// Denoise 32 pixels. This is av1_denoiser_16x1_sse2() on twice the lanes.
+static INLINE __m256i denoiser_32_avx2(__m256i v_sig,
+                                       __m256i v_mc_running_avg_y,
+                                       __m256i *v_running_avg_y,
+                                       const __m256i *k_4, const __m256i *l3,
+                                       __m256i acc_diff) {
+  const __m256i k_0 = _mm256_setzero_si256();
+  const __m256i k_8 = _mm256_set1_epi8(8);
+  const __m256i k_16 = _mm256_set1_epi8(16);
+  const __m256i l32 = _mm256_set1_epi8(2);
+  const __m256i l21 = _mm256_set1_epi8(1);
+  const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+  const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+  // Obtain the sign. FF if diff is negative.
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+  // Clamp absolute difference to 16 so that the signed compares below work.
+  const __m256i clamped_absdiff =
+      _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_16);
+  // Get masks for l2 l1 and l0 adjustments.
+  const __m256i mask2 = _mm256_cmpgt_epi8(k_16, clamped_absdiff);
+  const __m256i mask1 = _mm256_cmpgt_epi8(k_8, clamped_absdiff);
+  const __m256i mask0 = _mm256_cmpgt_epi8(*k_4, clamped_absdiff);
+  // Get adjustments for l2, l1, and l0.
+  const __m256i adj2 = _mm256_and_si256(mask2, l32);
+  const __m256i adj1 = _mm256_and_si256(mask1, l21);
+  const __m256i adj0 = _mm256_and_si256(mask0, clamped_absdiff);
+  __m256i adj, padj, nadj;
+
+  // Combine the adjustments and get absolute adjustments.
+  adj = _mm256_sub_epi8(*l3, _mm256_add_epi8(adj2, adj1));
+  adj = _mm256_andnot_si256(mask0, adj);
+  adj = _mm256_or_si256(adj, adj0);
+
+  // Restore the sign and get positive and negative adjustments.
+  padj = _mm256_andnot_si256(diff_sign, adj);
+  nadj = _mm256_and_si256(diff_sign, adj);
+
+  // Calculate filtered value.
+  *v_running_avg_y = _mm256_subs_epu8(_mm256_adds_epu8(v_sig, padj), nadj);
+
+  // Adjustments <=7, and each element in acc_diff can fit in signed char.
+  acc_diff = _mm256_adds_epi8(acc_diff, padj);
+  return _mm256_subs_epi8(acc_diff, nadj);
+}
+
+// Move 32 pixels of the running average towards the source by up to k_delta.
+// This is av1_denoiser_adj_16x1_sse2() on twice the lanes.
+static INLINE __m256i denoiser_adj_32_avx2(__m256i v_sig,
+                                           __m256i v_mc_running_avg_y,
+                                           __m256i *v_running_avg_y,
+                                           __m256i k_delta, __m256i acc_diff) {
+  const __m256i pdiff = _mm256_subs_epu8(v_mc_running_avg_y, v_sig);
+  const __m256i ndiff = _mm256_subs_epu8(v_sig, v_mc_running_avg_y);
+  // Obtain the sign. FF if diff is negative.
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, _mm256_setzero_si256());
+  // Clamp absolute difference to delta to get the adjustment.
+  const __m256i adj = _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_delta);
+  // Restore the sign and get positive and negative adjustments.
+  const __m256i padj = _mm256_andnot_si256(diff_sign, adj);
+  const __m256i nadj = _mm256_and_si256(diff_sign, adj);
+  // Calculate filtered value.
+  *v_running_avg_y =
+      _mm256_adds_epu8(_mm256_subs_epu8(*v_running_avg_y, padj), nadj);
+
+  // Accumulate the adjustments.
+  acc_diff = _mm256_subs_epi8(acc_diff, padj);
+  return _mm256_adds_epi8(acc_diff, nadj);
+}
+
+// Denoise 16xN blocks, two rows at a time.
+static int denoiser_16xN_avx2(const uint8_t *sig, int sig_stride,
+                              const uint8_t *mc_running_avg_y,
+                              int mc_avg_y_stride, uint8_t *running_avg_y,
+                              int avg_y_stride, int increase_denoising,
+                              BLOCK_SIZE bs, int motion_magnitude) {
+  const int shift_inc =
+      (increase_denoising && motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD)
+          ? 1
+          : 0;
+  const __m256i k_4 = _mm256_set1_epi8(4 + shift_inc);
+  // Modify each level's adjustment according to motion_magnitude.
+  const __m256i l3 = _mm256_set1_epi8(
+      (motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ? 7 + shift_inc : 6);
+  const int b_height = block_size_high[bs];
+  __m256i acc_diff[2];
+  int r, sum_diff = 0, sum_diff_thresh;
+
+  assert(block_size_wide[bs] == 16 && b_height <= 32);
+  acc_diff[0] = acc_diff[1] = _mm256_setzero_si256();
+
+  for (r = 0; r < b_height; r += 2) {
+    __m256i v_running_avg_y;
+    acc_diff[r >> 4] =
+        denoiser_32_avx2(load_16x2(sig, sig_stride),
+                         load_16x2(mc_running_avg_y, mc_avg_y_stride),
+                         &v_running_avg_y, &k_4, &l3, acc_diff[r >> 4]);
+    store_16x2(running_avg_y, avg_y_stride, v_running_avg_y);
+    sig += 2 * sig_stride;
+    mc_running_avg_y += 2 * mc_avg_y_stride;
+    running_avg_y += 2 * avg_y_stride;
+  }
+  for (r = 0; r < b_height; r += 16)
+    sum_diff += sum_diff_32x1(acc_diff[r >> 4]);
+
+  sum_diff_thresh = total_adj_strong_thresh(bs, increase_denoising);
+  if (abs(sum_diff) > sum_diff_thresh) {
+    // See av1_denoiser_NxM_sse2_small() for the weaker filter.
+    const int delta =
+        ((abs(sum_diff) - sum_diff_thresh) >> num_pels_log2_lookup[bs]) + 1;
+    // Only apply the adjustment for max delta up to 3.
+    if (delta >= 4) return COPY_BLOCK;
+
+    const __m256i k_delta = _mm256_set1_epi8(delta);
+    sig -= sig_stride * b_height;
+    mc_running_avg_y -= mc_avg_y_stride * b_height;
+    running_avg_y -= avg_y_stride * b_height;
+    for (r = 0; r < b_height; r += 2) {
+      __m256i v_running_avg_y = load_16x2(running_avg_y, avg_y_stride);
+      acc_diff[r >> 4] = denoiser_adj_32_avx2(
+          load_16x2(sig, sig_stride),
+          load_16x2(mc_running_avg_y, mc_avg_y_stride), &v_running_avg_y,
+          k_delta, acc_diff[r >> 4]);
+      store_16x2(running_avg_y, avg_y_stride, v_running_avg_y);
+      sig += 2 * sig_stride;
+      mc_running_avg_y += 2 * mc_avg_y_stride;
+      running_avg_y += 2 * avg_y_stride;
+    }
+    sum_diff = 0;
+    for (r = 0; r < b_height; r += 16)
+      sum_diff += sum_diff_32x1(acc_diff[r >> 4]);
+    if (abs(sum_diff) > sum_diff_thresh) return COPY_BLOCK;
+  }
+  return FILTER_BLOCK;
+}
+
+// Denoise 32x16 to 128x128 blocks, 32 pixels at a time.
+static int denoiser_NxM_avx2(const uint8_t *sig, int sig_stride,
+                             const uint8_t *mc_running_avg_y,
+                             int mc_avg_y_stride, uint8_t *running_avg_y,
+                             int avg_y_stride, int increase_denoising,
+                             BLOCK_SIZE bs, int motion_magnitude) {
+  const int shift_inc =
+      (increase_denoising && motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD)
+          ? 1
+          : 0;
+  const __m256i k_4 = _mm256_set1_epi8(4 + shift_inc);
+  // Modify each level's adjustment according to motion_magnitude.
+  const __m256i l3 = _mm256_set1_epi8(
+      (motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ? 7 + shift_inc : 6);
+  const int b_width = block_size_wide[bs];
+  const int b_height = block_size_high[bs];
+  const int b_width_shift5 = b_width >> 5;
+  // Each accumulator covers 32 columns of 16 rows, so that every lane sums
+  // the same pixels as in the sse2 version.
+  __m256i acc_diff[4][8];
+  int r, c, sum_diff = 0, sum_diff_thresh;
+
+  assert(b_width >= 32 && b_width <= 128 && b_height <= 128);
+  for (r = 0; r < 8; ++r) {
+    for (c = 0; c < b_width_shift5; ++c)
+      acc_diff[c][r] = _mm256_setzero_si256();
+  }
+
+  for (r = 0; r < b_height; ++r) {
+    for (c = 0; c < b_width_shift5; ++c) {
+      __m256i v_running_avg_y;
+      acc_diff[c][r >> 4] = denoiser_32_avx2(
+          _mm256_loadu_si256((const __m256i *)(sig + 32 * c)),
+          _mm256_loadu_si256((const __m256i *)(mc_running_avg_y + 32 * c)),
+          &v_running_avg_y, &k_4, &l3, acc_diff[c][r >> 4]);
+      _mm256_storeu_si256((__m256i *)(running_avg_y + 32 * c),
+                          v_running_avg_y);
+    }
+    sig += sig_stride;
+    mc_running_avg_y += mc_avg_y_stride;
+    running_avg_y += avg_y_stride;
+  }
+  for (r = 0; r < b_height; r += 16) {
+    for (c = 0; c < b_width_shift5; ++c)
+      sum_diff += sum_diff_32x1(acc_diff[c][r >> 4]);
+  }
+
+  sum_diff_thresh = total_adj_strong_thresh(bs, increase_denoising);
+  if (abs(sum_diff) > sum_diff_thresh) {
+    const int delta =
+        ((abs(sum_diff) - sum_diff_thresh) >> num_pels_log2_lookup[bs]) + 1;
+    // Only apply the adjustment for max delta up to 3.
+    if (delta >= 4) return COPY_BLOCK;
+
+    const __m256i k_delta = _mm256_set1_epi8(delta);
+    sig -= sig_stride * b_height;
+    mc_running_avg_y -= mc_avg_y_stride * b_height;
+    running_avg_y -= avg_y_stride * b_height;
+    for (r = 0; r < b_height; ++r) {
+      for (c = 0; c < b_width_shift5; ++c) {
+        __m256i v_running_avg_y =
+            _mm256_loadu_si256((const __m256i *)(running_avg_y + 32 * c));
+        acc_diff[c][r >> 4] = denoiser_adj_32_avx2(
+            _mm256_loadu_si256((const __m256i *)(sig + 32 * c)),
+            _mm256_loadu_si256((const __m256i *)(mc_running_avg_y + 32 * c)),
+            &v_running_avg_y, k_delta, acc_diff[c][r >> 4]);
+        _mm256_storeu_si256((__m256i *)(running_avg_y + 32 * c),
+                            v_running_avg_y);
+      }
+      sig += sig_stride;
+      mc_running_avg_y += mc_avg_y_stride;
+      running_avg_y += avg_y_stride;
+    }
+    sum_diff = 0;
+    for (r = 0; r < b_height; r += 16) {
+      for (c = 0; c < b_width_shift5; ++c)
+        sum_diff += sum_diff_32x1(acc_diff[c][r >> 4]);
+    }
+    if (abs(sum_diff) > sum_diff_thresh) return COPY_BLOCK;
+  }
+  return FILTER_BLOCK;
+}
+
+int av1_denoiser_filter_avx2(const uint8_t *sig, int sig_stride,
+                             const uint8_t *mc_avg, int mc_avg_stride,
+                             uint8_t *avg, int avg_stride,
+                             int increase_denoising, BLOCK_SIZE bs,
+                             int motion_magnitude) {
+  // Rank by frequency of the block type to have an early termination.
+  if (bs == BLOCK_32X32 || bs == BLOCK_64X64 || bs == BLOCK_128X128 ||
+      bs == BLOCK_128X64 || bs == BLOCK_64X128 || bs == BLOCK_32X16 ||
+      bs == BLOCK_32X64 || bs == BLOCK_64X32) {
+    return denoiser_NxM_avx2(sig, sig_stride, mc_avg, mc_avg_stride, avg,
+                             avg_stride, increase_denoising, bs,
+                             motion_magnitude);
+  } else if (bs == BLOCK_16X16 || bs == BLOCK_16X32 || bs == BLOCK_16X8) {
+    return denoiser_16xN_avx2(sig, sig_stride, mc_avg, mc_avg_stride, avg,
+                              avg_stride, increase_denoising, bs,
+                              motion_magnitude);
+  }
+  return av1_denoiser_filter_sse2(sig, sig_stride, mc_avg, mc_avg_stride, avg,
+                                  avg_stride, increase_denoising, bs,
+                                  motion_magnitude);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX512
+
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_integer.h"
+
+// Loads 16 coefficients as 32-bit values.
+static INLINE __m512i read_coeff(const tran_low_t *coeff) {
+  if (sizeof(tran_low_t) == 4) {
+    return _mm512_loadu_si512((const __m512i *)coeff);
+  } else {
+    return _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *)coeff));
+  }
+}
+
+// Unlike the SSE2/AVX2 versions, the coefficients are not saturated to 16
+// bits, so the result matches av1_block_error_c() for any input range.
+int64_t av1_block_error_avx512(const tran_low_t *coeff,
+                               const tran_low_t *dqcoeff, intptr_t block_size,
+                               int64_t *ssz) {
+  __m512i sse = _mm512_setzero_si512();
+  __m512i sqc = _mm512_setzero_si512();
+
+  // block_size is always a multiple of 16.
+  for (intptr_t i = 0; i < block_size; i += 16) {
+    const __m512i c = read_coeff(coeff + i);
+    const __m512i d = read_coeff(dqcoeff + i);
+    const __m512i diff = _mm512_sub_epi32(c, d);
+    // _mm512_mul_epi32 multiplies the low signed 32 bits of each 64-bit lane,
+    // so square the even and odd elements separately.
+    const __m512i diff_odd = _mm512_srli_epi64(diff, 32);
+    const __m512i c_odd = _mm512_srli_epi64(c, 32);
+    sse = _mm512_add_epi64(sse, _mm512_mul_epi32(diff, diff));
+    sse = _mm512_add_epi64(sse, _mm512_mul_epi32(diff_odd, diff_odd));
+    sqc = _mm512_add_epi64(sqc, _mm512_mul_epi32(c, c));
+    sqc = _mm512_add_epi64(sqc, _mm512_mul_epi32(c_odd, c_odd));
+  }
+
+  *ssz = _mm512_reduce_add_epi64(sqc);
+  return _mm512_reduce_add_epi64(sse);
+}
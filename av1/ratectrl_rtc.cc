@@ -11,6 +11,8 @@
 
 #include "av1/ratectrl_rtc.h"
 
+#include <cstddef>
+#include <cstring>
 #include <memory>
 #include <new>
 
@@ -54,108 +56,172 @@ AV1RateControlRtcConfig::AV1RateControlRtcConfig() {
   min_quantizers[0] = min_quantizer;
 }
 
-std::unique_ptr<AV1RateControlRTC> AV1RateControlRTC::Create(
-    const AV1RateControlRtcConfig &cfg) {
-  std::unique_ptr<AV1RateControlRTC> rc_api(new (std::nothrow)
-                                                AV1RateControlRTC());
-  if (!rc_api) return nullptr;
-  rc_api->cpi_ = static_cast<AV1_COMP *>(aom_memalign(32, sizeof(*cpi_)));
-  if (!rc_api->cpi_) return nullptr;
-  av1_zero(*rc_api->cpi_);
-  rc_api->cpi_->ppi =
-      static_cast<AV1_PRIMARY *>(aom_memalign(32, sizeof(AV1_PRIMARY)));
-  if (!rc_api->cpi_->ppi) return nullptr;
-  av1_zero(*rc_api->cpi_->ppi);
-  rc_api->cpi_->common.seq_params = &rc_api->cpi_->ppi->seq_params;
-  av1_zero(*rc_api->cpi_->common.seq_params);
-  const int num_layers = cfg.ss_number_layers * cfg.ts_number_layers;
-  av1_alloc_layer_context(rc_api->cpi_, num_layers);
-  rc_api->InitRateControl(cfg);
-  if (cfg.aq_mode) {
-    AV1_COMP *const cpi = rc_api->cpi_;
-    cpi->enc_seg.map = static_cast<uint8_t *>(aom_calloc(
-        cpi->common.mi_params.mi_rows * cpi->common.mi_params.mi_cols,
-        sizeof(*cpi->enc_seg.map)));
-    if (!cpi->enc_seg.map) return nullptr;
-    cpi->cyclic_refresh = av1_cyclic_refresh_alloc(
-        cpi->common.mi_params.mi_rows, cpi->common.mi_params.mi_cols);
-    if (!cpi->cyclic_refresh) return nullptr;
-  }
-  return rc_api;
-}
+// Most of PRIMARY_RATE_CONTROL is taken by the first pass regions and, unless
+// the passive strategy is on, the q history. The one pass real-time rate
+// control uses neither, so only the bytes around them are kept per stream.
+constexpr size_t kRegionsBegin = offsetof(PRIMARY_RATE_CONTROL, regions);
+constexpr size_t kRegionsEnd =
+    kRegionsBegin + sizeof(PRIMARY_RATE_CONTROL::regions);
+#if RT_PASSIVE_STRATEGY
+constexpr size_t kQHistoryBegin = sizeof(PRIMARY_RATE_CONTROL);
+constexpr size_t kQHistoryEnd = sizeof(PRIMARY_RATE_CONTROL);
+#else
+constexpr size_t kQHistoryBegin = offsetof(PRIMARY_RATE_CONTROL, q_history);
+constexpr size_t kQHistoryEnd =
+    kQHistoryBegin + sizeof(PRIMARY_RATE_CONTROL::q_history);
+#endif
+static_assert(kRegionsEnd <= kQHistoryBegin,
+              "PRIMARY_RATE_CONTROL::regions must come before q_history");
+constexpr size_t kPackedPrimaryRcSize =
+    kRegionsBegin + (kQHistoryBegin - kRegionsEnd) +
+    (sizeof(PRIMARY_RATE_CONTROL) - kQHistoryEnd);
 
-AV1RateControlRTC::~AV1RateControlRTC() {
-  if (cpi_) {
-    if (cpi_->svc.number_spatial_layers > 1 ||
-        cpi_->svc.number_temporal_layers > 1) {
-      for (int sl = 0; sl < cpi_->svc.number_spatial_layers; sl++) {
-        for (int tl = 0; tl < cpi_->svc.number_temporal_layers; tl++) {
-          int layer =
-              LAYER_IDS_TO_IDX(sl, tl, cpi_->svc.number_temporal_layers);
-          LAYER_CONTEXT *const lc = &cpi_->svc.layer_context[layer];
-          aom_free(lc->map);
-        }
-      }
-    }
-    aom_free(cpi_->svc.layer_context);
-    cpi_->svc.layer_context = nullptr;
+// The rate control functions run on an AV1_COMP, but only read or write a
+// small part of it across frames. That part is kept here, one copy per
+// stream, and swapped in and out of an AV1_COMP shared by all the streams on
+// a thread, much like the layer context is for SVC.
+struct AV1RtcRcState {
+  AV1EncoderConfig oxcf;
+  RATE_CONTROL rc;
+  uint8_t p_rc[kPackedPrimaryRcSize];
+  SVC svc;
+  SequenceHeader seq_params;
+  CommonModeInfoParams mi_params;
+  CurrentFrame current_frame;
+  struct segmentation seg;
+  RefreshFrameInfo refresh_frame;
+  double framerate;
+  int initial_width;
+  int initial_height;
+  int width;
+  int height;
+  int base_qindex;
+  int max_mv_magnitude;
+  int use_svc;
+  unsigned char gf_frame_index;
+  // The gf group entry at gf_frame_index.
+  FRAME_UPDATE_TYPE update_type;
+  FRAME_TYPE frame_type;
+  REFBUF_STATE refbuf_state;
+  CYCLIC_REFRESH *cyclic_refresh;
+  uint8_t *seg_map;
+};
+
+namespace {
+
+struct SharedCpiDeleter {
+  void operator()(AV1_COMP *cpi) const {
+    aom_free(cpi->ppi);
+    aom_free(cpi);
+  }
+};
 
-    if (cpi_->oxcf.q_cfg.aq_mode == CYCLIC_REFRESH_AQ) {
-      aom_free(cpi_->enc_seg.map);
-      cpi_->enc_seg.map = nullptr;
-      av1_cyclic_refresh_free(cpi_->cyclic_refresh);
+// Returns the AV1_COMP shared by the rate control streams of this thread,
+// allocating it on first use. Returns nullptr if the allocation fails.
+AV1_COMP *GetSharedCpi() {
+  thread_local std::unique_ptr<AV1_COMP, SharedCpiDeleter> shared_cpi;
+  if (!shared_cpi) {
+    AV1_COMP *const cpi =
+        static_cast<AV1_COMP *>(aom_memalign(32, sizeof(*cpi)));
+    if (!cpi) return nullptr;
+    av1_zero(*cpi);
+    cpi->ppi = static_cast<AV1_PRIMARY *>(aom_memalign(32, sizeof(*cpi->ppi)));
+    if (!cpi->ppi) {
+      aom_free(cpi);
+      return nullptr;
     }
-    aom_free(cpi_->ppi);
-    aom_free(cpi_);
+    av1_zero(*cpi->ppi);
+    // Fields the rate control reads but never writes.
+    cpi->common.show_frame = 1;
+    cpi->sf.rt_sf.use_nonrd_pick_mode = 1;
+    for (auto &lvl_idx : cpi->ppi->level_params.target_seq_level_idx)
+      lvl_idx = SEQ_LEVEL_MAX;
+    shared_cpi.reset(cpi);
   }
+  return shared_cpi.get();
 }
 
-void AV1RateControlRTC::InitRateControl(const AV1RateControlRtcConfig &rc_cfg) {
-  AV1_COMMON *cm = &cpi_->common;
-  AV1EncoderConfig *oxcf = &cpi_->oxcf;
-  RATE_CONTROL *const rc = &cpi_->rc;
-  cm->seq_params->profile = PROFILE_0;
-  cm->seq_params->bit_depth = AOM_BITS_8;
-  cm->show_frame = 1;
-  oxcf->profile = cm->seq_params->profile;
-  oxcf->mode = REALTIME;
-  oxcf->rc_cfg.mode = AOM_CBR;
-  oxcf->pass = AOM_RC_ONE_PASS;
-  oxcf->q_cfg.aq_mode = rc_cfg.aq_mode ? CYCLIC_REFRESH_AQ : NO_AQ;
-  oxcf->tune_cfg.content = AOM_CONTENT_DEFAULT;
-  oxcf->rc_cfg.drop_frames_water_mark = 0;
-  oxcf->tool_cfg.bit_depth = AOM_BITS_8;
-  oxcf->tool_cfg.superblock_size = AOM_SUPERBLOCK_SIZE_DYNAMIC;
-  cm->current_frame.frame_number = 0;
-  cpi_->ppi->p_rc.kf_boost = DEFAULT_KF_BOOST_RT;
-  for (auto &lvl_idx : oxcf->target_seq_level_idx) lvl_idx = SEQ_LEVEL_MAX;
+// The skipped bytes are cleared, so that nothing left in them by another
+// stream sharing the AV1_COMP can be read.
+void LoadPrimaryRc(const uint8_t *packed, PRIMARY_RATE_CONTROL *p_rc) {
+  uint8_t *const bytes = reinterpret_cast<uint8_t *>(p_rc);
+  memcpy(bytes, packed, kRegionsBegin);
+  packed += kRegionsBegin;
+  memset(bytes + kRegionsBegin, 0, kRegionsEnd - kRegionsBegin);
+  memcpy(bytes + kRegionsEnd, packed, kQHistoryBegin - kRegionsEnd);
+  packed += kQHistoryBegin - kRegionsEnd;
+  memset(bytes + kQHistoryBegin, 0, kQHistoryEnd - kQHistoryBegin);
+  memcpy(bytes + kQHistoryEnd, packed,
+         sizeof(PRIMARY_RATE_CONTROL) - kQHistoryEnd);
+}
 
-  memcpy(cpi_->ppi->level_params.target_seq_level_idx,
-         oxcf->target_seq_level_idx, sizeof(oxcf->target_seq_level_idx));
-  UpdateRateControl(rc_cfg);
-  set_sb_size(cm->seq_params,
-              av1_select_sb_size(oxcf, cm->width, cm->height,
-                                 cpi_->svc.number_spatial_layers));
-  cpi_->ppi->use_svc = cpi_->svc.number_spatial_layers > 1 ||
-                       cpi_->svc.number_temporal_layers > 1;
-  av1_primary_rc_init(oxcf, &cpi_->ppi->p_rc);
-  rc->rc_1_frame = 0;
-  rc->rc_2_frame = 0;
-  av1_rc_init_minq_luts();
-  av1_rc_init(oxcf, rc);
-  // Enable external rate control.
-  cpi_->rc.rtc_external_ratectrl = 1;
-  cpi_->sf.rt_sf.use_nonrd_pick_mode = 1;
+void StorePrimaryRc(const PRIMARY_RATE_CONTROL *p_rc, uint8_t *packed) {
+  const uint8_t *const bytes = reinterpret_cast<const uint8_t *>(p_rc);
+  memcpy(packed, bytes, kRegionsBegin);
+  packed += kRegionsBegin;
+  memcpy(packed, bytes + kRegionsEnd, kQHistoryBegin - kRegionsEnd);
+  packed += kQHistoryBegin - kRegionsEnd;
+  memcpy(packed, bytes + kQHistoryEnd,
+         sizeof(PRIMARY_RATE_CONTROL) - kQHistoryEnd);
 }
 
-void AV1RateControlRTC::UpdateRateControl(
-    const AV1RateControlRtcConfig &rc_cfg) {
-  AV1_COMMON *cm = &cpi_->common;
-  AV1EncoderConfig *oxcf = &cpi_->oxcf;
-  RATE_CONTROL *const rc = &cpi_->rc;
+void LoadState(AV1RtcRcState *state, AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  cpi->oxcf = state->oxcf;
+  cpi->rc = state->rc;
+  LoadPrimaryRc(state->p_rc, &cpi->ppi->p_rc);
+  cpi->svc = state->svc;
+  cm->seq_params = &state->seq_params;
+  cm->mi_params = state->mi_params;
+  cm->current_frame = state->current_frame;
+  cm->seg = state->seg;
+  cpi->refresh_frame = state->refresh_frame;
+  cpi->framerate = state->framerate;
+  cm->width = state->width;
+  cm->height = state->height;
+  cm->quant_params.base_qindex = state->base_qindex;
+  cpi->mv_search_params.max_mv_magnitude = state->max_mv_magnitude;
+  cpi->ppi->use_svc = state->use_svc;
+  cpi->gf_frame_index = state->gf_frame_index;
+  GF_GROUP *const gf_group = &cpi->ppi->gf_group;
+  gf_group->update_type[cpi->gf_frame_index] = state->update_type;
+  gf_group->frame_type[cpi->gf_frame_index] = state->frame_type;
+  gf_group->refbuf_state[cpi->gf_frame_index] = state->refbuf_state;
+  cpi->cyclic_refresh = state->cyclic_refresh;
+  cpi->enc_seg.map = state->seg_map;
+}
+
+void StoreState(const AV1_COMP *cpi, AV1RtcRcState *state) {
+  const AV1_COMMON *const cm = &cpi->common;
+  state->oxcf = cpi->oxcf;
+  state->rc = cpi->rc;
+  StorePrimaryRc(&cpi->ppi->p_rc, state->p_rc);
+  state->svc = cpi->svc;
+  state->mi_params = cm->mi_params;
+  state->current_frame = cm->current_frame;
+  state->seg = cm->seg;
+  state->refresh_frame = cpi->refresh_frame;
+  state->framerate = cpi->framerate;
+  state->width = cm->width;
+  state->height = cm->height;
+  state->base_qindex = cm->quant_params.base_qindex;
+  state->max_mv_magnitude = cpi->mv_search_params.max_mv_magnitude;
+  state->use_svc = cpi->ppi->use_svc;
+  state->gf_frame_index = cpi->gf_frame_index;
+  const GF_GROUP *const gf_group = &cpi->ppi->gf_group;
+  state->update_type = gf_group->update_type[cpi->gf_frame_index];
+  state->frame_type = gf_group->frame_type[cpi->gf_frame_index];
+  state->refbuf_state = gf_group->refbuf_state[cpi->gf_frame_index];
+  state->cyclic_refresh = cpi->cyclic_refresh;
+  state->seg_map = cpi->enc_seg.map;
+}
+
+void SetRateControlConfig(AV1_COMP *cpi,
+                          const AV1RateControlRtcConfig &rc_cfg) {
+  AV1_COMMON *cm = &cpi->common;
+  AV1EncoderConfig *oxcf = &cpi->oxcf;
+  RATE_CONTROL *const rc = &cpi->rc;
 
-  initial_width_ = rc_cfg.width;
-  initial_height_ = rc_cfg.height;
   cm->width = rc_cfg.width;
   cm->height = rc_cfg.height;
   oxcf->frm_dim_cfg.width = rc_cfg.width;
@@ -175,17 +241,17 @@ void AV1RateControlRTC::UpdateRateControl(
   oxcf->rc_cfg.over_shoot_pct = rc_cfg.overshoot_pct;
   oxcf->rc_cfg.max_intra_bitrate_pct = rc_cfg.max_intra_bitrate_pct;
   oxcf->rc_cfg.max_inter_bitrate_pct = rc_cfg.max_inter_bitrate_pct;
-  cpi_->framerate = rc_cfg.framerate;
-  cpi_->svc.number_spatial_layers = rc_cfg.ss_number_layers;
-  cpi_->svc.number_temporal_layers = rc_cfg.ts_number_layers;
-  set_primary_rc_buffer_sizes(oxcf, cpi_->ppi);
+  cpi->framerate = rc_cfg.framerate;
+  cpi->svc.number_spatial_layers = rc_cfg.ss_number_layers;
+  cpi->svc.number_temporal_layers = rc_cfg.ts_number_layers;
+  set_primary_rc_buffer_sizes(oxcf, cpi->ppi);
   enc_set_mb_mi(&cm->mi_params, cm->width, cm->height, BLOCK_8X8);
   int64_t target_bandwidth_svc = 0;
-  for (int sl = 0; sl < cpi_->svc.number_spatial_layers; ++sl) {
-    for (int tl = 0; tl < cpi_->svc.number_temporal_layers; ++tl) {
+  for (int sl = 0; sl < cpi->svc.number_spatial_layers; ++sl) {
+    for (int tl = 0; tl < cpi->svc.number_temporal_layers; ++tl) {
       const int layer =
-          LAYER_IDS_TO_IDX(sl, tl, cpi_->svc.number_temporal_layers);
-      LAYER_CONTEXT *lc = &cpi_->svc.layer_context[layer];
+          LAYER_IDS_TO_IDX(sl, tl, cpi->svc.number_temporal_layers);
+      LAYER_CONTEXT *lc = &cpi->svc.layer_context[layer];
       RATE_CONTROL *const lrc = &lc->rc;
       lc->layer_target_bitrate = 1000 * rc_cfg.layer_target_bitrate[layer];
       lc->max_q = rc_cfg.max_quantizers[layer];
@@ -196,33 +262,122 @@ void AV1RateControlRTC::UpdateRateControl(
       lc->scaling_factor_num = rc_cfg.scaling_factor_num[sl];
       lc->scaling_factor_den = rc_cfg.scaling_factor_den[sl];
       lc->framerate_factor = rc_cfg.ts_rate_decimator[tl];
-      if (tl == cpi_->svc.number_temporal_layers - 1)
+      if (tl == cpi->svc.number_temporal_layers - 1)
         target_bandwidth_svc += lc->layer_target_bitrate;
     }
   }
-  av1_new_framerate(cpi_, cpi_->framerate);
-  if (cpi_->svc.number_temporal_layers > 1 ||
-      cpi_->svc.number_spatial_layers > 1) {
-    if (cm->current_frame.frame_number == 0) av1_init_layer_context(cpi_);
+  av1_new_framerate(cpi, cpi->framerate);
+  if (cpi->svc.number_temporal_layers > 1 ||
+      cpi->svc.number_spatial_layers > 1) {
+    if (cm->current_frame.frame_number == 0) av1_init_layer_context(cpi);
     // This is needed to initialize external RC flag in layer context structure.
-    cpi_->rc.rtc_external_ratectrl = 1;
-    av1_update_layer_context_change_config(cpi_, target_bandwidth_svc);
+    cpi->rc.rtc_external_ratectrl = 1;
+    av1_update_layer_context_change_config(cpi, target_bandwidth_svc);
   }
-  check_reset_rc_flag(cpi_);
+  check_reset_rc_flag(cpi);
 }
 
-void AV1RateControlRTC::ComputeQP(const AV1FrameParamsRTC &frame_params) {
-  AV1_COMMON *const cm = &cpi_->common;
+void InitRateControl(AV1_COMP *cpi, const AV1RateControlRtcConfig &rc_cfg) {
+  AV1_COMMON *cm = &cpi->common;
+  AV1EncoderConfig *oxcf = &cpi->oxcf;
+  RATE_CONTROL *const rc = &cpi->rc;
+  cm->seq_params->profile = PROFILE_0;
+  cm->seq_params->bit_depth = AOM_BITS_8;
+  oxcf->profile = cm->seq_params->profile;
+  oxcf->mode = REALTIME;
+  oxcf->rc_cfg.mode = AOM_CBR;
+  oxcf->pass = AOM_RC_ONE_PASS;
+  oxcf->q_cfg.aq_mode = rc_cfg.aq_mode ? CYCLIC_REFRESH_AQ : NO_AQ;
+  oxcf->tune_cfg.content = AOM_CONTENT_DEFAULT;
+  oxcf->rc_cfg.drop_frames_water_mark = 0;
+  oxcf->tool_cfg.bit_depth = AOM_BITS_8;
+  oxcf->tool_cfg.superblock_size = AOM_SUPERBLOCK_SIZE_DYNAMIC;
+  cm->current_frame.frame_number = 0;
+  cpi->ppi->p_rc.kf_boost = DEFAULT_KF_BOOST_RT;
+  for (auto &lvl_idx : oxcf->target_seq_level_idx) lvl_idx = SEQ_LEVEL_MAX;
+
+  SetRateControlConfig(cpi, rc_cfg);
+  set_sb_size(cm->seq_params,
+              av1_select_sb_size(oxcf, cm->width, cm->height,
+                                 cpi->svc.number_spatial_layers));
+  cpi->ppi->use_svc = cpi->svc.number_spatial_layers > 1 ||
+                      cpi->svc.number_temporal_layers > 1;
+  av1_primary_rc_init(oxcf, &cpi->ppi->p_rc);
+  rc->rc_1_frame = 0;
+  rc->rc_2_frame = 0;
+  av1_rc_init_minq_luts();
+  av1_rc_init(oxcf, rc);
+  // Enable external rate control.
+  cpi->rc.rtc_external_ratectrl = 1;
+}
+
+// Allocates the state of one stream. On failure, the state may be partially
+// allocated and must still be released with FreeState().
+bool InitState(const AV1RateControlRtcConfig &cfg, AV1RtcRcState *state) {
+  AV1_COMP *const cpi = GetSharedCpi();
+  if (!cpi) return false;
+  LoadState(state, cpi);
+  const int num_layers = cfg.ss_number_layers * cfg.ts_number_layers;
+  av1_alloc_layer_context(cpi, num_layers);
+  InitRateControl(cpi, cfg);
+  if (cfg.aq_mode) {
+    cpi->enc_seg.map = static_cast<uint8_t *>(aom_calloc(
+        cpi->common.mi_params.mi_rows * cpi->common.mi_params.mi_cols,
+        sizeof(*cpi->enc_seg.map)));
+    cpi->cyclic_refresh = av1_cyclic_refresh_alloc(
+        cpi->common.mi_params.mi_rows, cpi->common.mi_params.mi_cols);
+  }
+  StoreState(cpi, state);
+  state->initial_width = cfg.width;
+  state->initial_height = cfg.height;
+  return !cfg.aq_mode || (cpi->enc_seg.map && cpi->cyclic_refresh);
+}
+
+void FreeState(AV1RtcRcState *state) {
+  if (state->svc.number_spatial_layers > 1 ||
+      state->svc.number_temporal_layers > 1) {
+    for (int sl = 0; sl < state->svc.number_spatial_layers; sl++) {
+      for (int tl = 0; tl < state->svc.number_temporal_layers; tl++) {
+        int layer = LAYER_IDS_TO_IDX(sl, tl, state->svc.number_temporal_layers);
+        LAYER_CONTEXT *const lc = &state->svc.layer_context[layer];
+        aom_free(lc->map);
+      }
+    }
+  }
+  aom_free(state->svc.layer_context);
+  state->svc.layer_context = nullptr;
+
+  if (state->oxcf.q_cfg.aq_mode == CYCLIC_REFRESH_AQ) {
+    aom_free(state->seg_map);
+    state->seg_map = nullptr;
+    if (state->cyclic_refresh) av1_cyclic_refresh_free(state->cyclic_refresh);
+  }
+}
+
+void UpdateState(const AV1RateControlRtcConfig &rc_cfg, AV1RtcRcState *state) {
+  AV1_COMP *const cpi = GetSharedCpi();
+  if (!cpi) return;
+  LoadState(state, cpi);
+  SetRateControlConfig(cpi, rc_cfg);
+  StoreState(cpi, state);
+  state->initial_width = rc_cfg.width;
+  state->initial_height = rc_cfg.height;
+}
+
+void ComputeStateQP(const AV1FrameParamsRTC &frame_params, AV1_COMP *cpi,
+                    AV1RtcRcState *state) {
+  LoadState(state, cpi);
+  AV1_COMMON *const cm = &cpi->common;
   int width, height;
-  GF_GROUP *const gf_group = &cpi_->ppi->gf_group;
-  cpi_->svc.spatial_layer_id = frame_params.spatial_layer_id;
-  cpi_->svc.temporal_layer_id = frame_params.temporal_layer_id;
-  if (cpi_->svc.number_spatial_layers > 1) {
-    const int layer = LAYER_IDS_TO_IDX(cpi_->svc.spatial_layer_id,
-                                       cpi_->svc.temporal_layer_id,
-                                       cpi_->svc.number_temporal_layers);
-    LAYER_CONTEXT *lc = &cpi_->svc.layer_context[layer];
-    av1_get_layer_resolution(initial_width_, initial_height_,
+  GF_GROUP *const gf_group = &cpi->ppi->gf_group;
+  cpi->svc.spatial_layer_id = frame_params.spatial_layer_id;
+  cpi->svc.temporal_layer_id = frame_params.temporal_layer_id;
+  if (cpi->svc.number_spatial_layers > 1) {
+    const int layer = LAYER_IDS_TO_IDX(cpi->svc.spatial_layer_id,
+                                       cpi->svc.temporal_layer_id,
+                                       cpi->svc.number_temporal_layers);
+    LAYER_CONTEXT *lc = &cpi->svc.layer_context[layer];
+    av1_get_layer_resolution(state->initial_width, state->initial_height,
                              lc->scaling_factor_num, lc->scaling_factor_den,
                              &width, &height);
     cm->width = width;
@@ -230,79 +385,173 @@ void AV1RateControlRTC::ComputeQP(const AV1FrameParamsRTC &frame_params) {
   }
   enc_set_mb_mi(&cm->mi_params, cm->width, cm->height, BLOCK_8X8);
   cm->current_frame.frame_type = frame_params.frame_type;
-  cpi_->refresh_frame.golden_frame =
+  cpi->refresh_frame.golden_frame =
       (cm->current_frame.frame_type == KEY_FRAME) ? 1 : 0;
-  cpi_->sf.rt_sf.use_nonrd_pick_mode = 1;
 
   if (frame_params.frame_type == kKeyFrame) {
-    gf_group->update_type[cpi_->gf_frame_index] = KF_UPDATE;
-    gf_group->frame_type[cpi_->gf_frame_index] = KEY_FRAME;
-    gf_group->refbuf_state[cpi_->gf_frame_index] = REFBUF_RESET;
-    cpi_->rc.frames_since_key = 0;
-    if (cpi_->ppi->use_svc) {
-      const int layer = LAYER_IDS_TO_IDX(cpi_->svc.spatial_layer_id,
-                                         cpi_->svc.temporal_layer_id,
-                                         cpi_->svc.number_temporal_layers);
+    gf_group->update_type[cpi->gf_frame_index] = KF_UPDATE;
+    gf_group->frame_type[cpi->gf_frame_index] = KEY_FRAME;
+    gf_group->refbuf_state[cpi->gf_frame_index] = REFBUF_RESET;
+    cpi->rc.frames_since_key = 0;
+    if (cpi->ppi->use_svc) {
+      const int layer = LAYER_IDS_TO_IDX(cpi->svc.spatial_layer_id,
+                                         cpi->svc.temporal_layer_id,
+                                         cpi->svc.number_temporal_layers);
       if (cm->current_frame.frame_number > 0)
-        av1_svc_reset_temporal_layers(cpi_, 1);
-      cpi_->svc.layer_context[layer].is_key_frame = 1;
+        av1_svc_reset_temporal_layers(cpi, 1);
+      cpi->svc.layer_context[layer].is_key_frame = 1;
     }
   } else {
-    gf_group->update_type[cpi_->gf_frame_index] = LF_UPDATE;
-    gf_group->frame_type[cpi_->gf_frame_index] = INTER_FRAME;
-    gf_group->refbuf_state[cpi_->gf_frame_index] = REFBUF_UPDATE;
-    if (cpi_->ppi->use_svc) {
-      const int layer = LAYER_IDS_TO_IDX(cpi_->svc.spatial_layer_id,
-                                         cpi_->svc.temporal_layer_id,
-                                         cpi_->svc.number_temporal_layers);
-      cpi_->svc.layer_context[layer].is_key_frame = 0;
+    gf_group->update_type[cpi->gf_frame_index] = LF_UPDATE;
+    gf_group->frame_type[cpi->gf_frame_index] = INTER_FRAME;
+    gf_group->refbuf_state[cpi->gf_frame_index] = REFBUF_UPDATE;
+    if (cpi->ppi->use_svc) {
+      const int layer = LAYER_IDS_TO_IDX(cpi->svc.spatial_layer_id,
+                                         cpi->svc.temporal_layer_id,
+                                         cpi->svc.number_temporal_layers);
+      cpi->svc.layer_context[layer].is_key_frame = 0;
     }
-    cpi_->rc.frames_since_key++;
+    cpi->rc.frames_since_key++;
   }
-  if (cpi_->svc.number_spatial_layers > 1 ||
-      cpi_->svc.number_temporal_layers > 1) {
-    av1_update_temporal_layer_framerate(cpi_);
-    av1_restore_layer_context(cpi_);
+  if (cpi->svc.number_spatial_layers > 1 ||
+      cpi->svc.number_temporal_layers > 1) {
+    av1_update_temporal_layer_framerate(cpi);
+    av1_restore_layer_context(cpi);
   }
   int target = 0;
-  if (cpi_->oxcf.rc_cfg.mode == AOM_CBR) {
-    if (cpi_->oxcf.q_cfg.aq_mode == CYCLIC_REFRESH_AQ)
-      av1_cyclic_refresh_update_parameters(cpi_);
+  if (cpi->oxcf.rc_cfg.mode == AOM_CBR) {
+    if (cpi->oxcf.q_cfg.aq_mode == CYCLIC_REFRESH_AQ)
+      av1_cyclic_refresh_update_parameters(cpi);
     if (frame_is_intra_only(cm))
-      target = av1_calc_iframe_target_size_one_pass_cbr(cpi_);
+      target = av1_calc_iframe_target_size_one_pass_cbr(cpi);
     else
       target = av1_calc_pframe_target_size_one_pass_cbr(
-          cpi_, gf_group->update_type[cpi_->gf_frame_index]);
+          cpi, gf_group->update_type[cpi->gf_frame_index]);
   }
-  av1_rc_set_frame_target(cpi_, target, cm->width, cm->height);
+  av1_rc_set_frame_target(cpi, target, cm->width, cm->height);
 
   int bottom_index, top_index;
-  cpi_->common.quant_params.base_qindex =
-      av1_rc_pick_q_and_bounds(cpi_, cm->width, cm->height,
-                               cpi_->gf_frame_index, &bottom_index, &top_index);
+  cpi->common.quant_params.base_qindex =
+      av1_rc_pick_q_and_bounds(cpi, cm->width, cm->height,
+                               cpi->gf_frame_index, &bottom_index, &top_index);
 
-  if (cpi_->oxcf.q_cfg.aq_mode == CYCLIC_REFRESH_AQ)
-    av1_cyclic_refresh_setup(cpi_);
+  if (cpi->oxcf.q_cfg.aq_mode == CYCLIC_REFRESH_AQ)
+    av1_cyclic_refresh_setup(cpi);
+  StoreState(cpi, state);
 }
 
-int AV1RateControlRTC::GetQP() const {
-  return cpi_->common.quant_params.base_qindex;
+void PostEncodeUpdateState(uint64_t encoded_frame_size, AV1_COMP *cpi,
+                           AV1RtcRcState *state) {
+  LoadState(state, cpi);
+  av1_rc_postencode_update(cpi, encoded_frame_size);
+  if (cpi->svc.number_spatial_layers > 1 ||
+      cpi->svc.number_temporal_layers > 1)
+    av1_save_layer_context(cpi);
+  cpi->common.current_frame.frame_number++;
+  StoreState(cpi, state);
 }
 
+}  // namespace
+
+std::unique_ptr<AV1RateControlRTC> AV1RateControlRTC::Create(
+    const AV1RateControlRtcConfig &cfg) {
+  std::unique_ptr<AV1RateControlRTC> rc_api(new (std::nothrow)
+                                                AV1RateControlRTC());
+  if (!rc_api) return nullptr;
+  rc_api->state_ =
+      static_cast<AV1RtcRcState *>(aom_calloc(1, sizeof(*rc_api->state_)));
+  if (!rc_api->state_) return nullptr;
+  if (!InitState(cfg, rc_api->state_)) return nullptr;
+  return rc_api;
+}
+
+AV1RateControlRTC::~AV1RateControlRTC() {
+  if (state_) {
+    FreeState(state_);
+    aom_free(state_);
+  }
+}
+
+void AV1RateControlRTC::UpdateRateControl(
+    const AV1RateControlRtcConfig &rc_cfg) {
+  UpdateState(rc_cfg, state_);
+}
+
+void AV1RateControlRTC::ComputeQP(const AV1FrameParamsRTC &frame_params) {
+  AV1_COMP *const cpi = GetSharedCpi();
+  if (!cpi) return;
+  ComputeStateQP(frame_params, cpi, state_);
+}
+
+int AV1RateControlRTC::GetQP() const { return state_->base_qindex; }
+
 signed char *AV1RateControlRTC::GetCyclicRefreshMap() const {
-  return cpi_->cyclic_refresh->map;
+  return state_->cyclic_refresh->map;
 }
 
 int *AV1RateControlRTC::GetDeltaQ() const {
-  return cpi_->cyclic_refresh->qindex_delta;
+  return state_->cyclic_refresh->qindex_delta;
 }
 
 void AV1RateControlRTC::PostEncodeUpdate(uint64_t encoded_frame_size) {
-  av1_rc_postencode_update(cpi_, encoded_frame_size);
-  if (cpi_->svc.number_spatial_layers > 1 ||
-      cpi_->svc.number_temporal_layers > 1)
-    av1_save_layer_context(cpi_);
-  cpi_->common.current_frame.frame_number++;
+  AV1_COMP *const cpi = GetSharedCpi();
+  if (!cpi) return;
+  PostEncodeUpdateState(encoded_frame_size, cpi, state_);
+}
+
+std::unique_ptr<AV1RateControlRtcBatch> AV1RateControlRtcBatch::Create(
+    const AV1RateControlRtcConfig *cfgs, int num_streams) {
+  if (cfgs == nullptr || num_streams <= 0) return nullptr;
+  std::unique_ptr<AV1RateControlRtcBatch> batch(new (std::nothrow)
+                                                    AV1RateControlRtcBatch());
+  if (!batch) return nullptr;
+  batch->states_ = static_cast<AV1RtcRcState *>(
+      aom_calloc(num_streams, sizeof(*batch->states_)));
+  if (!batch->states_) return nullptr;
+  batch->num_streams_ = num_streams;
+  for (int i = 0; i < num_streams; ++i) {
+    if (!InitState(cfgs[i], &batch->states_[i])) return nullptr;
+  }
+  return batch;
+}
+
+AV1RateControlRtcBatch::~AV1RateControlRtcBatch() {
+  if (states_) {
+    for (int i = 0; i < num_streams_; ++i) FreeState(&states_[i]);
+    aom_free(states_);
+  }
+}
+
+void AV1RateControlRtcBatch::UpdateRateControl(
+    int stream, const AV1RateControlRtcConfig &rc_cfg) {
+  UpdateState(rc_cfg, &states_[stream]);
+}
+
+void AV1RateControlRtcBatch::ComputeQP(const AV1FrameParamsRTC *frame_params,
+                                       int *qps) {
+  AV1_COMP *const cpi = GetSharedCpi();
+  if (!cpi) return;
+  for (int i = 0; i < num_streams_; ++i) {
+    ComputeStateQP(frame_params[i], cpi, &states_[i]);
+    qps[i] = states_[i].base_qindex;
+  }
+}
+
+void AV1RateControlRtcBatch::PostEncodeUpdate(
+    const uint64_t *encoded_frame_sizes) {
+  AV1_COMP *const cpi = GetSharedCpi();
+  if (!cpi) return;
+  for (int i = 0; i < num_streams_; ++i) {
+    PostEncodeUpdateState(encoded_frame_sizes[i], cpi, &states_[i]);
+  }
+}
+
+signed char *AV1RateControlRtcBatch::GetCyclicRefreshMap(int stream) const {
+  return states_[stream].cyclic_refresh->map;
+}
+
+int *AV1RateControlRtcBatch::GetDeltaQ(int stream) const {
+  return states_[stream].cyclic_refresh->qindex_delta;
 }
 
 }  // namespace aom
@@ -15,10 +15,10 @@
 #include <cstdint>
 #include <memory>
 
-struct AV1_COMP;
-
 namespace aom {
 
+struct AV1RtcRcState;
+
 // These constants come from AV1 spec.
 static constexpr size_t kAV1MaxLayers = 32;
 static constexpr size_t kAV1MaxTemporalLayers = 8;
@@ -63,6 +63,10 @@ struct AV1FrameParamsRTC {
   int temporal_layer_id;
 };
 
+// Each instance only holds the rate control, SVC layer and cyclic refresh
+// state of one stream. The encoder context the rate control runs in is shared
+// by all the streams on a thread and allocated by the first call on that
+// thread; if that allocation fails, the call does nothing.
 class AV1RateControlRTC {
  public:
   static std::unique_ptr<AV1RateControlRTC> Create(
@@ -80,10 +84,33 @@ class AV1RateControlRTC {
 
  private:
   AV1RateControlRTC() = default;
-  void InitRateControl(const AV1RateControlRtcConfig &cfg);
-  AV1_COMP *cpi_;
-  int initial_width_;
-  int initial_height_;
+  AV1RtcRcState *state_ = nullptr;
+};
+
+// Rate control of many independent streams, each behaving as its own
+// AV1RateControlRTC. Every stream gets a frame in each ComputeQP() call, and
+// the states of all streams are kept in one contiguous array that the calls
+// walk in order.
+class AV1RateControlRtcBatch {
+ public:
+  static std::unique_ptr<AV1RateControlRtcBatch> Create(
+      const AV1RateControlRtcConfig *cfgs, int num_streams);
+  ~AV1RateControlRtcBatch();
+
+  int num_streams() const { return num_streams_; }
+  void UpdateRateControl(int stream, const AV1RateControlRtcConfig &rc_cfg);
+  // Computes the QP of the next frame of every stream. |frame_params| and
+  // |qps| have num_streams() entries.
+  void ComputeQP(const AV1FrameParamsRTC *frame_params, int *qps);
+  // Feedback with the sizes of the frames of the last ComputeQP() call.
+  void PostEncodeUpdate(const uint64_t *encoded_frame_sizes);
+  signed char *GetCyclicRefreshMap(int stream) const;
+  int *GetDeltaQ(int stream) const;
+
+ private:
+  AV1RateControlRtcBatch() = default;
+  AV1RtcRcState *states_ = nullptr;
+  int num_streams_ = 0;
 };
 
 }  // namespace aom
@@ -15,6 +15,10 @@ set(AOM_BUILD_CMAKE_AOM_OPTIMIZATION_CMAKE_ 1)
 
 include("${AOM_ROOT}/build/cmake/util.cmake")
 
+# The AVX-512 tier requires the F, CD, BW, DQ and VL subsets, i.e. the subsets
+# available on all AVX-512 capable client and server CPUs since Skylake-SP.
+set(AOM_AVX512_FLAGS "-mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl")
+
 # Translate $flag to one which MSVC understands, and write the new flag to the
 # variable named by $translated_flag (or unset it, when MSVC needs no flag).
 function(get_msvc_intrinsic_flag flag translated_flag)
@@ -22,9 +26,12 @@ function(get_msvc_intrinsic_flag flag translated_flag)
     set(${translated_flag} "/arch:AVX" PARENT_SCOPE)
   elseif("${flag}" STREQUAL "-mavx2")
     set(${translated_flag} "/arch:AVX2" PARENT_SCOPE)
+  elseif("${flag}" STREQUAL "${AOM_AVX512_FLAGS}")
+    set(${translated_flag} "/arch:AVX512" PARENT_SCOPE)
   else()
 
-    # MSVC does not need flags for intrinsics flavors other than AVX/AVX2.
+    # MSVC does not need flags for intrinsics flavors other than
+    # AVX/AVX2/AVX-512.
     unset(${translated_flag} PARENT_SCOPE)
   endif()
 endfunction()
@@ -254,3 +261,19 @@ function(add_rtcd_build_step config output source symbol)
   set_property(SOURCE ${source} PROPERTY OBJECT_DEPENDS ${output})
   set_property(SOURCE ${output} PROPERTY GENERATED TRUE)
 endfunction()
+
+# Adds a custom command that generates the microbenchmark tables of the
+# functions of ${config} for tools/rtcd_bench.c.
+function(add_rtcd_bench_step config output symbol)
+  add_custom_command(
+    OUTPUT ${output}
+    COMMAND ${PERL_EXECUTABLE} ARGS "${AOM_ROOT}/build/cmake/rtcd.pl"
+            --arch=${AOM_TARGET_CPU}
+            --sym=${symbol} ${AOM_RTCD_FLAGS} --bench
+            --config=${AOM_CONFIG_DIR}/config/aom_config.h ${config} > ${output}
+    DEPENDS ${config} "${AOM_ROOT}/build/cmake/rtcd.pl"
+    COMMENT "Generating ${output}"
+    WORKING_DIRECTORY ${AOM_CONFIG_DIR}
+    VERBATIM)
+  set_property(SOURCE ${output} PROPERTY GENERATED TRUE)
+endfunction()
@@ -37,6 +37,7 @@ GetOptions(
   'arch=s',
   'sym=s',
   'config=s',
+  'bench',
 );
 
 foreach my $opt (qw/arch config/) {
@@ -406,20 +407,200 @@ EOF
   common_bottom;
 }
 
+#
+# Helper functions for generating the microbenchmark tables
+#
+
+# Number of frames passed so far to the function being generated.
+my $bench_num_frames;
+
+# Scalar types that are passed a value chosen from the argument name.
+my %bench_int_types = map { $_ => 1 } (
+  "int", "unsigned int", "unsigned", "int8_t", "uint8_t", "int16_t",
+  "uint16_t", "int32_t", "uint32_t", "int64_t", "uint64_t", "ptrdiff_t",
+  "intptr_t", "size_t");
+
+# Other scalar types with the value they are passed.
+my %bench_enum_values = (
+  "BLOCK_SIZE" => "a->bsize", "TX_SIZE" => "a->tx_size",
+  "TX_TYPE" => "DCT_DCT", "TX_CLASS" => "TX_CLASS_2D",
+  "DIFFWTD_MASK_TYPE" => "DIFFWTD_38", "InterpFilter" => "EIGHTTAP_REGULAR",
+  "aom_bit_depth_t" => "(aom_bit_depth_t)a->bd");
+
+# Pointed-to types that are passed a buffer of random data, with the type of
+# the elements the buffer is filled with.
+my %bench_buf_types = (
+  "void" => "RTCD_BENCH_U8", "uint8_t" => "RTCD_BENCH_U8",
+  "unsigned char" => "RTCD_BENCH_U8", "int8_t" => "RTCD_BENCH_U8",
+  "qm_val_t" => "RTCD_BENCH_U8", "uint16_t" => "RTCD_BENCH_U16",
+  "int16_t" => "RTCD_BENCH_U16", "CONV_BUF_TYPE" => "RTCD_BENCH_U16",
+  "int" => "RTCD_BENCH_U32", "unsigned int" => "RTCD_BENCH_U32",
+  "unsigned" => "RTCD_BENCH_U32", "int32_t" => "RTCD_BENCH_U32",
+  "uint32_t" => "RTCD_BENCH_U32", "tran_low_t" => "RTCD_BENCH_U32",
+  "int64_t" => "RTCD_BENCH_U64", "uint64_t" => "RTCD_BENCH_U64",
+  "float" => "RTCD_BENCH_F32", "double" => "RTCD_BENCH_F64");
+
+# Pointed-to types that are passed a structure set up by the benchmark.
+my %bench_struct_args = (
+  "ConvolveParams" => "&a->conv_params",
+  "InterpFilterParams" => "a->filter_params",
+  "DIST_WTD_COMP_PARAMS" => "&a->jcp_param",
+  "TxfmParam" => "&a->txfm_param", "sgr_params_type" => "a->sgr_params");
+
+sub bench_scalar_value {
+  my ($fn, $name) = @_;
+  return "a->stride" if $name =~ /stride|pitch/ || $name eq "p";
+  return "a->w" if $name =~ /^(w|bw|wd|width|blk_w|block_width|cols)$/;
+  return "a->h" if $name =~ /^(h|bh|ht|height|blk_h|block_height|rows)$/;
+  return "a->bd" if $name =~ /^(bd|bit_depth)$/;
+  return "a->w * a->h" if $name =~ /^(n|N|count|n_coeffs|length|num)$/;
+  return "16" if $name =~ /step_q4$/;
+  return $fn =~ /_rs$/ ? "1 << 14" : "1 << 10" if $name =~ /step_qn$/;
+  return "8" if $name =~ /^subpel_[xy]_q/;
+  return "4" if $name =~ /^[xy]_?offset$/;
+  return "64" if $name =~ /^(dx|dy)$/;
+  return "3" if $name eq "num_planes";
+  return "0";
+}
+
+# Returns the C expression passed for the argument $arg of $fn, or undef if
+# it cannot be given generic data. The types of the buffers passed so far are
+# pushed to @$tags.
+sub bench_arg {
+  my ($fn, $arg, $tags) = @_;
+  my ($type, $name, $array) = ($arg, "", "");
+  if ($arg =~ /^(.*?)\s*(\w+)\s*((?:\[[^\]]*\])*)$/ && $1 ne "" &&
+      $2 ne "const") {
+    ($type, $name, $array) = ($1, $2, $3);
+  }
+  my $depth = ($type =~ tr/*//) + ($array ne "" ? 1 : 0);
+  (my $base = $type) =~ s/\bconst\b|\*//g;
+  $base =~ s/^\s+|\s+$//g;
+  $base =~ s/\s+/ /g;
+  $base =~ s/^struct //;
+  if ($depth == 0) {
+    return bench_scalar_value($fn, $name) if $bench_int_types{$base};
+    return $bench_enum_values{$base};
+  }
+  # Arrays are passed as pointers to their first element.
+  my @dims = $array =~ /\[[^\]]*\]/g;
+  my $cast = @dims ? "$type (*)" . join("", @dims[1 .. $#dims]) : $type;
+  $cast =~ s/ \(\*\)$/ */;
+  my $tag = $bench_buf_types{$base};
+  my $k = scalar @$tags;
+  # High bitdepth functions take most 16-bit pixel buffers as uint8_t
+  # pointers that are converted back with CONVERT_TO_SHORTPTR().
+  my $hbd = $fn =~ /highbd|high_bd|_u16$/ && $base eq "uint8_t" &&
+      $name !~ /mask|msk|limit|thresh/;
+  if ($depth == 2 && $array ne "" && $tag && $k < 16) {
+    # Array of pointers to a few blocks of the same buffer.
+    push @$tags, $hbd ? "RTCD_BENCH_U16" : $tag;
+    return "($cast)a->" . ($hbd ? "blocks_hbd" : "blocks") . "[$k]";
+  }
+  return undef if $depth > 1;
+  return "($cast)$bench_struct_args{$base}" if $bench_struct_args{$base};
+  if ($base eq "yv12_buffer_config" || $base eq "YV12_BUFFER_CONFIG") {
+    # Source and destination frames.
+    return undef if $bench_num_frames == 2;
+    return "($cast)&a->frames[" . $bench_num_frames++ . "]";
+  }
+  return "($cast)a->filter" if $base eq "InterpKernel" ||
+      $base eq "int16_t" && $name =~ /filter|kernel/;
+  return undef if !$tag || $k >= 16;
+  push @$tags, $hbd ? "RTCD_BENCH_U16" : $tag;
+  return "($cast)" . ($hbd ? "CONVERT_TO_BYTEPTR(a->buf[$k])" : "a->buf[$k]");
+}
+
+sub bench() {
+  my $include_guard = uc($opts{sym})."_BENCH_H_";
+  print <<EOF;
+// This file is generated. Do not edit.
+#ifndef ${include_guard}
+#define ${include_guard}
+
+// Microbenchmark tables of the functions of config/$opts{sym}.h, included by
+// tools/rtcd_bench.c which defines the types used here.
+#include "config/$opts{sym}.h"
+
+EOF
+  my @kernels;
+  my @skipped;
+  foreach my $fn (sort keys %ALL_FUNCS) {
+    my @val = @{$ALL_FUNCS{$fn}};
+    my $args = pop @val;
+    my $rtyp = "@val";
+    my @tags;
+    my @exprs;
+    my $unsupported;
+    my $sized = 0;
+    $bench_num_frames = 0;
+    if ($args =~ /\(/) {
+      $unsupported = $args;
+    } elsif ($args !~ /^\s*void\s*$/) {
+      foreach my $arg (split /,/, $args) {
+        $arg =~ s/^\s+|\s+$//g;
+        my $expr = bench_arg($fn, $arg, \@tags);
+        if (!defined $expr) {
+          $unsupported = $arg;
+          last;
+        }
+        $sized = 1 if $expr =~
+            /a->(w|h|bsize|tx_size|txfm_param|filter_params)\b/;
+        push @exprs, $expr;
+      }
+    }
+    if (defined $unsupported) {
+      push @skipped, "  { \"$fn\", \"$unsupported\" },\n";
+      next;
+    }
+
+    # Functions of a single block size are benchmarked on that size only.
+    my ($w, $h) = $fn =~ /(\d+)x(\d+)/ ? ($1, $2) : (0, 0);
+    $sized = 0 if $w;
+    print "static void ${fn}_bench(rtcd_bench_fn fn, " .
+        "const RtcdBenchArgs *a) {\n";
+    print "  (void)a;\n" if !@exprs;
+    print "  (($rtyp(*)($args))fn)(" . join(", ", @exprs) . ");\n}\n\n";
+
+    my @variants;
+    foreach my $opt ("c", @ALL_ARCHS) {
+      my $ofn = eval "\$${fn}_${opt}";
+      next if !$ofn;
+      my $flag = $opt eq "c" || $opts{arch} =~ /^mips/ ? "0" : "HAS_".uc($opt);
+      push @variants, "{ \"$opt\", $flag, (rtcd_bench_fn)$ofn }";
+    }
+    push @kernels, "  { \"$fn\", ${fn}_bench, $w, $h, $sized, { " .
+        (join(", ", @tags) || "0") . " },\n    { " .
+        join(",\n      ", @variants) . " } },\n";
+  }
+  print "static const RtcdBenchKernel $opts{sym}_bench_kernels[] = {\n";
+  print @kernels;
+  print "};\n\n";
+  print "static const RtcdBenchSkipped $opts{sym}_bench_skipped[] = {\n";
+  print @skipped ? @skipped : "  { NULL, NULL },\n";
+  print "};\n\n#endif\n";
+}
+
 #
 # Main Driver
 #
 
+# Generates the RTCD header with $gen, or the microbenchmark tables.
+sub generate {
+  my $gen = shift;
+  $opts{bench} ? bench() : $gen->();
+}
+
 &require("c");
 &require(keys %required);
 if ($opts{arch} eq 'x86') {
-  @ALL_ARCHS = filter(qw/mmx sse sse2 sse3 ssse3 sse4_1 sse4_2 avx avx2/);
-  x86;
+  @ALL_ARCHS = filter(qw/mmx sse sse2 sse3 ssse3 sse4_1 sse4_2 avx avx2 avx512/);
+  generate(\&x86);
 } elsif ($opts{arch} eq 'x86_64') {
-  @ALL_ARCHS = filter(qw/mmx sse sse2 sse3 ssse3 sse4_1 sse4_2 avx avx2/);
+  @ALL_ARCHS = filter(qw/mmx sse sse2 sse3 ssse3 sse4_1 sse4_2 avx avx2 avx512/);
   @REQUIRES = filter(qw/mmx sse sse2/);
   &require(@REQUIRES);
-  x86;
+  generate(\&x86);
 } elsif ($opts{arch} eq 'mips32' || $opts{arch} eq 'mips64') {
   @ALL_ARCHS = filter("$opts{arch}");
   if (aom_config("HAVE_DSPR2") eq "yes") {
@@ -427,19 +608,19 @@ if ($opts{arch} eq 'x86') {
   } elsif (aom_config("HAVE_MSA") eq "yes") {
     @ALL_ARCHS = filter("$opts{arch}", qw/msa/);
   }
-  mips;
+  generate(\&mips);
 } elsif ($opts{arch} =~ /armv[78]\w?/) {
   @ALL_ARCHS = filter(qw/neon/);
-  arm;
+  generate(\&arm);
 } elsif ($opts{arch} eq 'arm64' ) {
   @ALL_ARCHS = filter(qw/neon/);
   &require("neon");
-  arm;
+  generate(\&arm);
 } elsif ($opts{arch} eq 'ppc') {
   @ALL_ARCHS = filter(qw/vsx/);
-  ppc;
+  generate(\&ppc);
 } else {
-  unoptimized;
+  generate(\&unoptimized);
 }
 
 __END__
@@ -457,7 +638,8 @@ See 'perldoc rtcd.pl' for more details.
 =head1 DESCRIPTION
 
 Reads the Run Time CPU Detections definitions from FILE and generates a
-C header file on stdout.
+C header file on stdout. With --bench, generates instead the tables of the
+microbenchmark of all the versions of the functions (tools/rtcd_bench.c).
 
 =head1 OPTIONS
 
@@ -467,3 +649,4 @@ Options:
   --require-EXT     Require support for EXT extensions
   --sym=SYMBOL      Unique symbol to use for RTCD initialization function
   --config=FILE     Path to file containing C preprocessor directives to parse
+  --bench           Generate the microbenchmark tables
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Enable POSIX extensions in glibc so that we can call fileno() and
+// posix_madvise(). This must be before any #include statements.
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "common/file_map.h"
+
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#if HAVE_UNISTD_H && !defined(_WIN32)
+#define HAVE_FILE_MAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define HAVE_FILE_MAP 0
+#endif
+
+int file_map_open(FILE *file, FileMap *map) {
+  memset(map, 0, sizeof(*map));
+#if HAVE_FILE_MAP
+  const int fd = fileno(file);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return -1;
+  if (st.st_size <= 0 || (uint64_t)st.st_size > SIZE_MAX) return -1;
+  void *const data =
+      mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) return -1;
+  map->data = (const uint8_t *)data;
+  map->size = (size_t)st.st_size;
+  return 0;
+#else
+  (void)file;
+  return -1;
+#endif
+}
+
+void file_map_close(FileMap *map) {
+#if HAVE_FILE_MAP
+  if (map->data) munmap((void *)map->data, map->size);
+#endif
+  memset(map, 0, sizeof(*map));
+}
+
+void file_map_prefetch(const FileMap *map, size_t offset, size_t size) {
+#if HAVE_FILE_MAP
+  if (offset >= map->size) return;
+  if (size > map->size - offset) size = map->size - offset;
+  const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t start = offset & ~(page_size - 1);
+  posix_madvise((void *)(map->data + start), offset + size - start,
+                POSIX_MADV_WILLNEED);
+#else
+  (void)map;
+  (void)offset;
+  (void)size;
+#endif
+}
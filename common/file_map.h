@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#ifndef AOM_COMMON_FILE_MAP_H_
+#define AOM_COMMON_FILE_MAP_H_
+
+#include <stdio.h>
+
+#include "aom/aom_integer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A read-only mapping of a whole file.
+typedef struct FileMap {
+  const uint8_t *data;
+  size_t size;
+} FileMap;
+
+// Maps |file| into memory. Returns 0 on success and -1 if the file cannot be
+// mapped, e.g. because it is a pipe or memory mapping is not supported on
+// this platform. The mapping does not depend on the current position of
+// |file| and stays valid after |file| is closed.
+int file_map_open(FILE *file, FileMap *map);
+
+void file_map_close(FileMap *map);
+
+// Hints that [offset, offset + size) of the mapping will be read soon.
+void file_map_prefetch(const FileMap *map, size_t offset, size_t size);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_COMMON_FILE_MAP_H_
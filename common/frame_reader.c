@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "common/frame_reader.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#include "aom_util/aom_thread.h"
+#include "common/file_map.h"
+#include "common/y4minput.h"
+
+typedef struct FrameSlot {
+  aom_image_t img;
+  // Y4M frame buffer the slot is read and converted into. Unused for raw
+  // input, which is read straight into |img|.
+  unsigned char *y4m_buf;
+  int filled;
+  int eos;
+} FrameSlot;
+
+struct FrameReader {
+  struct AvxInputContext *input;
+  FrameSlot *slots;
+  int num_slots;
+  // The slot returned by the last call to frame_reader_next(), or -1.
+  int held;
+  int read_idx;
+  int eos;
+  // The Y4M reader's own frame buffer, restored on destruction.
+  unsigned char *orig_y4m_buf;
+
+  // Memory mapped input.
+  FileMap map;
+  const uint8_t *map_pos;
+  size_t frame_size;
+  int prefetch_frames;
+  aom_image_t map_img;
+
+#if CONFIG_MULTITHREAD
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int thread_started;
+  int quit;
+#endif
+};
+
+static int read_frame_into(FrameReader *reader, FrameSlot *slot) {
+  struct AvxInputContext *const input = reader->input;
+  if (input->file_type == FILE_TYPE_Y4M) {
+    input->y4m.dst_buf = slot->y4m_buf;
+    return y4m_input_fetch_frame(&input->y4m, input->file, &slot->img) > 0;
+  }
+  return !read_yuv_frame(input, &slot->img);
+}
+
+#if CONFIG_MULTITHREAD
+static THREADFN read_ahead_hook(void *arg) {
+  FrameReader *const reader = (FrameReader *)arg;
+  int write_idx = 0;
+  for (;;) {
+    FrameSlot *const slot = &reader->slots[write_idx];
+    pthread_mutex_lock(&reader->mutex);
+    while (slot->filled && !reader->quit)
+      pthread_cond_wait(&reader->cond, &reader->mutex);
+    const int quit = reader->quit;
+    pthread_mutex_unlock(&reader->mutex);
+    if (quit) break;
+
+    const int eos = !read_frame_into(reader, slot);
+    pthread_mutex_lock(&reader->mutex);
+    slot->eos = eos;
+    slot->filled = 1;
+    pthread_cond_broadcast(&reader->cond);
+    pthread_mutex_unlock(&reader->mutex);
+    if (eos) break;
+    write_idx = (write_idx + 1) % reader->num_slots;
+  }
+  return THREAD_RETURN(NULL);
+}
+#endif  // CONFIG_MULTITHREAD
+
+static int raw_fmt_can_map(aom_img_fmt_t fmt) {
+  switch (fmt & ~AOM_IMG_FMT_HIGHBITDEPTH) {
+    case AOM_IMG_FMT_I420:
+    case AOM_IMG_FMT_YV12:
+    case AOM_IMG_FMT_I422:
+    case AOM_IMG_FMT_I444: return 1;
+    default: return 0;
+  }
+}
+
+// Points the planes of |img| at a raw frame stored at |data|, in the same
+// layout read_yuv_frame() expects.
+static void set_raw_planes(aom_image_t *img, const uint8_t *data) {
+  const size_t y_size = (size_t)img->stride[AOM_PLANE_Y] * img->d_h;
+  const size_t uv_size =
+      (size_t)img->stride[AOM_PLANE_U] * aom_img_plane_height(img, 1);
+  unsigned char *const y = (unsigned char *)data;
+  const int is_yv12 = img->fmt == AOM_IMG_FMT_YV12;
+  img->planes[AOM_PLANE_Y] = y;
+  img->planes[is_yv12 ? AOM_PLANE_V : AOM_PLANE_U] = y + y_size;
+  img->planes[is_yv12 ? AOM_PLANE_U : AOM_PLANE_V] = y + y_size + uv_size;
+}
+
+static int map_input(FrameReader *reader, int read_ahead) {
+  struct AvxInputContext *const input = reader->input;
+  const int64_t pos = (int64_t)ftello(input->file);
+  if (pos < 0) return 0;
+  size_t start = (size_t)pos;
+  // Raw input still has the bytes read for file type detection buffered.
+  if (input->file_type == FILE_TYPE_RAW)
+    start -= input->detect.buf_read - input->detect.position;
+
+  if (file_map_open(input->file, &reader->map)) return 0;
+  if (start > reader->map.size) {
+    file_map_close(&reader->map);
+    return 0;
+  }
+  reader->map_pos = reader->map.data + start;
+
+  if (input->file_type == FILE_TYPE_Y4M) {
+    reader->frame_size = input->y4m.dst_buf_read_sz;
+  } else {
+    aom_image_t *const img = &reader->map_img;
+    if (!aom_img_wrap(img, input->fmt, input->width, input->height, 1,
+                      (unsigned char *)reader->map_pos)) {
+      file_map_close(&reader->map);
+      return 0;
+    }
+    const int bytes = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    img->stride[AOM_PLANE_Y] = img->d_w * bytes;
+    img->stride[AOM_PLANE_U] = img->stride[AOM_PLANE_V] =
+        aom_img_plane_width(img, 1) * bytes;
+    reader->frame_size =
+        (size_t)img->stride[AOM_PLANE_Y] * img->d_h +
+        2 * (size_t)img->stride[AOM_PLANE_U] * aom_img_plane_height(img, 1);
+  }
+  reader->prefetch_frames = read_ahead > 1 ? read_ahead : 1;
+  file_map_prefetch(&reader->map, start,
+                    reader->frame_size * reader->prefetch_frames);
+  return 1;
+}
+
+static aom_image_t *map_next_frame(FrameReader *reader) {
+  const uint8_t *const end = reader->map.data + reader->map.size;
+  aom_image_t *const img = &reader->map_img;
+  if (reader->input->file_type == FILE_TYPE_Y4M) {
+    const y4m_input *const y4m = &reader->input->y4m;
+    if (y4m_input_wrap_frame(y4m, &reader->map_pos, end, img) < 1) return NULL;
+  } else {
+    if ((size_t)(end - reader->map_pos) < reader->frame_size) return NULL;
+    set_raw_planes(img, reader->map_pos);
+    reader->map_pos += reader->frame_size;
+  }
+  file_map_prefetch(&reader->map, reader->map_pos - reader->map.data,
+                    reader->frame_size * reader->prefetch_frames);
+  return img;
+}
+
+FrameReader *frame_reader_create(struct AvxInputContext *input, int read_ahead,
+                                 int use_mmap) {
+  FrameReader *const reader = (FrameReader *)calloc(1, sizeof(*reader));
+  if (!reader) return NULL;
+  reader->input = input;
+  reader->held = -1;
+
+  const int is_y4m = input->file_type == FILE_TYPE_Y4M;
+  if (use_mmap && (is_y4m ? y4m_input_is_passthrough(&input->y4m)
+                          : raw_fmt_can_map(input->fmt))) {
+    if (map_input(reader, read_ahead)) return reader;
+  }
+
+  reader->num_slots = 1;
+#if CONFIG_MULTITHREAD
+  if (read_ahead > 0) reader->num_slots = read_ahead + 1;
+#endif
+  reader->slots =
+      (FrameSlot *)calloc(reader->num_slots, sizeof(*reader->slots));
+  if (!reader->slots) goto fail;
+  if (is_y4m) reader->orig_y4m_buf = input->y4m.dst_buf;
+  for (int i = 0; i < reader->num_slots; ++i) {
+    FrameSlot *const slot = &reader->slots[i];
+    if (is_y4m) {
+      const size_t bytes_per_sample = input->y4m.bit_depth > 8 ? 2 : 1;
+      slot->y4m_buf =
+          i == 0 ? reader->orig_y4m_buf
+                 : (unsigned char *)malloc(input->y4m.dst_buf_sz *
+                                           bytes_per_sample);
+      if (!slot->y4m_buf) goto fail;
+    } else if (!aom_img_alloc(&slot->img, input->fmt, input->width,
+                              input->height, 32)) {
+      goto fail;
+    }
+  }
+
+#if CONFIG_MULTITHREAD
+  if (reader->num_slots > 1) {
+    pthread_mutex_init(&reader->mutex, NULL);
+    pthread_cond_init(&reader->cond, NULL);
+    if (pthread_create(&reader->thread, NULL, read_ahead_hook, reader)) {
+      pthread_cond_destroy(&reader->cond);
+      pthread_mutex_destroy(&reader->mutex);
+      goto fail;
+    }
+    reader->thread_started = 1;
+  }
+#endif
+  return reader;
+
+fail:
+  frame_reader_destroy(reader);
+  return NULL;
+}
+
+aom_image_t *frame_reader_next(FrameReader *reader) {
+  if (reader->eos) return NULL;
+  if (reader->map.data) {
+    aom_image_t *const img = map_next_frame(reader);
+    reader->eos = img == NULL;
+    return img;
+  }
+#if CONFIG_MULTITHREAD
+  if (reader->thread_started) {
+    FrameSlot *const slot = &reader->slots[reader->read_idx];
+    pthread_mutex_lock(&reader->mutex);
+    if (reader->held >= 0) {
+      reader->slots[reader->held].filled = 0;
+      reader->held = -1;
+      pthread_cond_broadcast(&reader->cond);
+    }
+    while (!slot->filled) pthread_cond_wait(&reader->cond, &reader->mutex);
+    pthread_mutex_unlock(&reader->mutex);
+    if (slot->eos) {
+      reader->eos = 1;
+      return NULL;
+    }
+    reader->held = reader->read_idx;
+    reader->read_idx = (reader->read_idx + 1) % reader->num_slots;
+    return &slot->img;
+  }
+#endif
+  if (!read_frame_into(reader, &reader->slots[0])) {
+    reader->eos = 1;
+    return NULL;
+  }
+  return &reader->slots[0].img;
+}
+
+void frame_reader_destroy(FrameReader *reader) {
+  if (!reader) return;
+#if CONFIG_MULTITHREAD
+  if (reader->thread_started) {
+    pthread_mutex_lock(&reader->mutex);
+    reader->quit = 1;
+    pthread_cond_broadcast(&reader->cond);
+    pthread_mutex_unlock(&reader->mutex);
+    pthread_join(reader->thread, NULL);
+    pthread_cond_destroy(&reader->cond);
+    pthread_mutex_destroy(&reader->mutex);
+  }
+#endif
+  if (reader->map.data) file_map_close(&reader->map);
+  if (reader->slots) {
+    const int is_y4m = reader->input->file_type == FILE_TYPE_Y4M;
+    for (int i = 0; i < reader->num_slots; ++i) {
+      FrameSlot *const slot = &reader->slots[i];
+      if (!is_y4m)
+        aom_img_free(&slot->img);
+      else if (slot->y4m_buf != reader->orig_y4m_buf)
+        free(slot->y4m_buf);
+    }
+    if (is_y4m) reader->input->y4m.dst_buf = reader->orig_y4m_buf;
+    free(reader->slots);
+  }
+  free(reader);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#ifndef AOM_COMMON_FRAME_READER_H_
+#define AOM_COMMON_FRAME_READER_H_
+
+#include "aom/aom_image.h"
+#include "common/tools_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reads raw or Y4M frames from an input opened by the encoder applications.
+typedef struct FrameReader FrameReader;
+
+// Creates a reader for |input|, whose format and dimensions must be final.
+//
+// If |read_ahead| is greater than 0 and the library was built with
+// CONFIG_MULTITHREAD, frames are read (and converted, for Y4M input) on a
+// separate thread into a ring of |read_ahead| + 1 frame buffers.
+//
+// If |use_mmap| is set and |input| is a regular file, frames that need no
+// conversion are returned directly from a memory mapping of the file without
+// being copied; the next |read_ahead| frames (at least one) are prefetched.
+// Other inputs fall back to reading from the file.
+//
+// Returns NULL on allocation failure.
+FrameReader *frame_reader_create(struct AvxInputContext *input, int read_ahead,
+                                 int use_mmap);
+
+// Returns the next frame, or NULL at the end of the input or on a read error.
+// The frame stays valid until the next call to frame_reader_next() or
+// frame_reader_destroy().
+aom_image_t *frame_reader_next(FrameReader *reader);
+
+// Stops any read-ahead thread and frees the reader. Must be called before the
+// input is closed.
+void frame_reader_destroy(FrameReader *reader);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_COMMON_FRAME_READER_H_
@@ -20,17 +20,21 @@
  * Still in the public domain.
  */
 
+#include <stdint.h> /* for uintptr_t */
 #include <string.h> /* for memcpy() */
 
 #include "common/md5_utils.h"
 
+static int isLittleEndian(void) {
+  int i = 1;
+  return *(char *)&i == 1;
+}
+
 static void byteSwap(UWORD32 *buf, unsigned words) {
   md5byte *p;
 
   /* Only swap bytes for big endian machines */
-  int i = 1;
-
-  if (*(char *)&i == 1) return;
+  if (isLittleEndian()) return;
 
   p = (md5byte *)buf;
 
@@ -83,7 +87,15 @@ void MD5Update(struct MD5Context *ctx, md5byte const *buf, unsigned len) {
   buf += t;
   len -= t;
 
-  /* Process data in 64-byte chunks */
+  /* Process data in 64-byte chunks, straight from the caller's buffer when
+     no byte swapping is needed and it is suitably aligned. */
+  if (isLittleEndian() && ((uintptr_t)buf & (sizeof(UWORD32) - 1)) == 0) {
+    while (len >= 64) {
+      MD5Transform(ctx->buf, (UWORD32 const *)buf);
+      buf += 64;
+      len -= 64;
+    }
+  }
   while (len >= 64) {
     memcpy(ctx->in, buf, 64);
     byteSwap(ctx->in, 16);
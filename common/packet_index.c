@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "common/packet_index.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "aom_ports/mem_ops.h"
+#include "av1/common/obu_util.h"
+
+#define IVF_FILE_HDR_SZ 32
+#define IVF_FRAME_HDR_SZ 12
+#define MAX_PACKET_SIZE (256 * 1024 * 1024)
+
+typedef struct {
+  int has_sequence_header;
+  int reduced_still_picture_header;
+  int has_frame_header;
+  int is_keyframe;
+} TemporalUnitInfo;
+
+// Inspects the OBUs in |data| and records what is needed to tell key frames
+// apart in |info|. When |stop_at_temporal_delimiter| is set, stops before
+// the first temporal delimiter that is not at the start of |data|. Returns
+// the number of bytes consumed in |consumed|. Returns 0 on success and -1 if
+// the OBUs are malformed or truncated.
+static int parse_obus(const uint8_t *data, size_t size, int is_annexb,
+                      int stop_at_temporal_delimiter, TemporalUnitInfo *info,
+                      size_t *consumed) {
+  size_t pos = 0;
+  while (pos < size) {
+    ObuHeader obu_header;
+    size_t header_size = 0;
+    size_t payload_size = 0;
+    if (aom_read_obu_header_and_size(data + pos, size - pos, is_annexb,
+                                     &obu_header, &payload_size,
+                                     &header_size) != AOM_CODEC_OK ||
+        payload_size > size - pos - header_size) {
+      return -1;
+    }
+    if (stop_at_temporal_delimiter && pos > 0 &&
+        obu_header.type == OBU_TEMPORAL_DELIMITER) {
+      break;
+    }
+
+    const uint8_t *const payload = data + pos + header_size;
+    if (obu_header.type == OBU_SEQUENCE_HEADER && payload_size > 0) {
+      // seq_profile (3 bits), still_picture (1 bit),
+      // reduced_still_picture_header (1 bit).
+      info->has_sequence_header = 1;
+      info->reduced_still_picture_header = (payload[0] >> 3) & 1;
+    } else if ((obu_header.type == OBU_FRAME ||
+                obu_header.type == OBU_FRAME_HEADER) &&
+               !info->has_frame_header && payload_size > 0) {
+      info->has_frame_header = 1;
+      if (info->has_sequence_header) {
+        if (info->reduced_still_picture_header) {
+          info->is_keyframe = 1;
+        } else {
+          // show_existing_frame (1 bit), frame_type (2 bits), show_frame
+          // (1 bit). A frame_type of 0 is KEY_FRAME.
+          const int show_existing_frame = payload[0] >> 7;
+          const int frame_type = (payload[0] >> 5) & 3;
+          const int show_frame = (payload[0] >> 4) & 1;
+          info->is_keyframe =
+              !show_existing_frame && frame_type == 0 && show_frame;
+        }
+      }
+    }
+    pos += header_size + payload_size;
+  }
+  *consumed = pos;
+  return 0;
+}
+
+static int add_entry(PacketIndex *index, size_t *capacity, size_t offset,
+                     size_t size, aom_codec_pts_t pts, int is_keyframe) {
+  if (index->num_entries == *capacity) {
+    const size_t new_capacity = *capacity ? 2 * *capacity : 256;
+    PacketIndexEntry *const entries = (PacketIndexEntry *)realloc(
+        index->entries, new_capacity * sizeof(*entries));
+    if (!entries) {
+      fprintf(stderr, "packet_index: Failed to allocate the index.\n");
+      return -1;
+    }
+    index->entries = entries;
+    *capacity = new_capacity;
+  }
+  const size_t n = index->num_entries;
+  PacketIndexEntry *const entry = &index->entries[n];
+  entry->offset = offset;
+  entry->size = size;
+  entry->pts = pts;
+  entry->is_keyframe = is_keyframe;
+  if (is_keyframe) {
+    entry->keyframe = n;
+    ++index->num_keyframes;
+  } else {
+    entry->keyframe = n ? index->entries[n - 1].keyframe
+                        : PACKET_INDEX_NO_KEYFRAME;
+  }
+  ++index->num_entries;
+  return 0;
+}
+
+static int index_ivf(PacketIndex *index) {
+  const uint8_t *const data = index->map.data;
+  const size_t size = index->map.size;
+  size_t capacity = 0;
+  if (size < IVF_FILE_HDR_SZ || memcmp(data, "DKIF", 4) != 0) return -1;
+
+  size_t pos = IVF_FILE_HDR_SZ;
+  while (pos < size) {
+    if (size - pos < IVF_FRAME_HDR_SZ) {
+      fprintf(stderr, "Warning: Failed to read frame size\n");
+      break;
+    }
+    const size_t frame_size = mem_get_le32(data + pos);
+    aom_codec_pts_t pts = mem_get_le32(data + pos + 4);
+    pts += (aom_codec_pts_t)mem_get_le32(data + pos + 8) << 32;
+    pos += IVF_FRAME_HDR_SZ;
+    if (frame_size > MAX_PACKET_SIZE || frame_size > size - pos) {
+      fprintf(stderr, "Warning: Failed to read full frame\n");
+      break;
+    }
+    // The payload is only inspected for key frames; other codecs in IVF are
+    // still indexed.
+    TemporalUnitInfo info = { 0, 0, 0, 0 };
+    size_t consumed;
+    if (parse_obus(data + pos, frame_size, 0, 0, &info, &consumed) != 0) {
+      info.is_keyframe = 0;
+    }
+    if (add_entry(index, &capacity, pos, frame_size, pts, info.is_keyframe))
+      return -1;
+    pos += frame_size;
+  }
+  return 0;
+}
+
+static int index_obu(PacketIndex *index) {
+  const uint8_t *const data = index->map.data;
+  const size_t size = index->map.size;
+  size_t capacity = 0;
+
+  size_t pos = 0;
+  while (pos < size) {
+    TemporalUnitInfo info = { 0, 0, 0, 0 };
+    size_t tu_size;
+    if (parse_obus(data + pos, size - pos, 0, 1, &info, &tu_size) != 0) {
+      if (index->num_entries == 0) return -1;
+      fprintf(stderr, "obudec: Failed to read full temporal unit\n");
+      break;
+    }
+    if (add_entry(index, &capacity, pos, tu_size, index->num_entries,
+                  info.is_keyframe)) {
+      return -1;
+    }
+    pos += tu_size;
+  }
+  return 0;
+}
+
+static int index_annexb(PacketIndex *index) {
+  const uint8_t *const data = index->map.data;
+  const size_t size = index->map.size;
+  size_t capacity = 0;
+
+  size_t pos = 0;
+  while (pos < size) {
+    uint64_t tu_size;
+    size_t tu_length_size;
+    if (aom_uleb_decode(data + pos, size - pos, &tu_size, &tu_length_size) !=
+            0 ||
+        tu_size > size - pos - tu_length_size) {
+      if (index->num_entries == 0) return -1;
+      fprintf(stderr, "obudec: Failed to read full temporal unit\n");
+      break;
+    }
+
+    TemporalUnitInfo info = { 0, 0, 0, 0 };
+    const uint8_t *const tu = data + pos + tu_length_size;
+    size_t tu_pos = 0;
+    while (tu_pos < tu_size) {
+      uint64_t fu_size;
+      size_t fu_length_size;
+      size_t consumed;
+      if (aom_uleb_decode(tu + tu_pos, (size_t)tu_size - tu_pos, &fu_size,
+                          &fu_length_size) != 0 ||
+          fu_size > tu_size - tu_pos - fu_length_size ||
+          parse_obus(tu + tu_pos + fu_length_size, (size_t)fu_size, 1, 0,
+                     &info, &consumed) != 0 ||
+          consumed != fu_size) {
+        fprintf(stderr, "obudec: Invalid frame unit in temporal unit %u\n",
+                (unsigned int)index->num_entries);
+        return -1;
+      }
+      tu_pos += fu_length_size + (size_t)fu_size;
+    }
+
+    const size_t entry_size = tu_length_size + (size_t)tu_size;
+    if (add_entry(index, &capacity, pos, entry_size, index->num_entries,
+                  info.is_keyframe)) {
+      return -1;
+    }
+    pos += entry_size;
+  }
+  return 0;
+}
+
+int packet_index_open(FILE *file, PacketIndexFormat format,
+                      PacketIndex *index) {
+  memset(index, 0, sizeof(*index));
+  if (file_map_open(file, &index->map) != 0) return -1;
+
+  int status;
+  switch (format) {
+    case PACKET_INDEX_IVF: status = index_ivf(index); break;
+    case PACKET_INDEX_OBU: status = index_obu(index); break;
+    case PACKET_INDEX_ANNEXB: status = index_annexb(index); break;
+    default: status = -1; break;
+  }
+  if (status != 0) {
+    packet_index_close(index);
+    return -1;
+  }
+  return 0;
+}
+
+void packet_index_close(PacketIndex *index) {
+  file_map_close(&index->map);
+  free(index->entries);
+  memset(index, 0, sizeof(*index));
+}
+
+int packet_index_read(PacketIndex *index, const uint8_t **data, size_t *size,
+                      aom_codec_pts_t *pts) {
+  if (index->next >= index->num_entries) return 1;
+  const PacketIndexEntry *const entry = &index->entries[index->next++];
+  *data = index->map.data + entry->offset;
+  *size = entry->size;
+  if (pts) *pts = entry->pts;
+  // Start paging in the packet after this one while this one is decoded.
+  if (index->next < index->num_entries) {
+    const PacketIndexEntry *const next = &index->entries[index->next];
+    file_map_prefetch(&index->map, next->offset, next->size);
+  }
+  return 0;
+}
+
+int packet_index_seek(PacketIndex *index, size_t entry) {
+  if (entry > index->num_entries) return -1;
+  index->next = entry;
+  return 0;
+}
+
+int packet_index_seek_keyframe(PacketIndex *index, size_t entry,
+                               size_t *keyframe) {
+  if (entry >= index->num_entries) return -1;
+  const size_t keyframe_entry = index->entries[entry].keyframe;
+  if (keyframe_entry == PACKET_INDEX_NO_KEYFRAME) return -1;
+  index->next = keyframe_entry;
+  *keyframe = keyframe_entry;
+  return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#ifndef AOM_COMMON_PACKET_INDEX_H_
+#define AOM_COMMON_PACKET_INDEX_H_
+
+#include <stdio.h>
+
+#include "aom/aom_codec.h"
+#include "aom/aom_integer.h"
+#include "common/file_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Value of PacketIndexEntry.keyframe when no key frame precedes the entry.
+#define PACKET_INDEX_NO_KEYFRAME SIZE_MAX
+
+typedef enum {
+  PACKET_INDEX_IVF,
+  PACKET_INDEX_OBU,     // Section 5 low overhead bitstream format.
+  PACKET_INDEX_ANNEXB,  // Annex B length delimited bitstream format.
+} PacketIndexFormat;
+
+typedef struct PacketIndexEntry {
+  // Position of the temporal unit in the mapping, as it is passed to the
+  // decoder (without the IVF frame header, with the Annex B size field).
+  size_t offset;
+  size_t size;
+  // The IVF frame timestamp, or the entry number for the other formats.
+  aom_codec_pts_t pts;
+  // Set when decoding can start at this entry: the temporal unit carries a
+  // sequence header and a shown key frame.
+  int is_keyframe;
+  // Entry number of the latest key frame at or before this entry.
+  size_t keyframe;
+} PacketIndexEntry;
+
+// An index of the temporal units of a whole file, built over a read-only
+// mapping of it. Packets are handed out as pointers into the mapping, so
+// no data is copied.
+typedef struct PacketIndex {
+  FileMap map;
+  PacketIndexEntry *entries;
+  size_t num_entries;
+  size_t num_keyframes;
+  // Entry returned by the next packet_index_read() call.
+  size_t next;
+} PacketIndex;
+
+// Maps |file| and indexes all of its temporal units. The index does not
+// depend on the current position of |file|. Returns 0 on success and -1 if
+// the file cannot be mapped or is not a valid stream of |format|. A
+// truncated last packet is left out of the index with a warning.
+int packet_index_open(FILE *file, PacketIndexFormat format,
+                      PacketIndex *index);
+
+void packet_index_close(PacketIndex *index);
+
+// Returns the next temporal unit in |data| and |size|, and its timestamp in
+// |pts| if |pts| is not NULL. |data| stays valid until the index is closed.
+// Returns 0 on success and 1 at the end of the stream.
+int packet_index_read(PacketIndex *index, const uint8_t **data, size_t *size,
+                      aom_codec_pts_t *pts);
+
+// Makes |entry| the next entry to be read. |entry| may be num_entries, which
+// positions the index at the end of the stream. Returns 0 on success and -1
+// if |entry| is out of range.
+int packet_index_seek(PacketIndex *index, size_t entry);
+
+// Makes the latest key frame at or before |entry| the next entry to be read
+// and returns its entry number in |keyframe|. Returns 0 on success and -1 if
+// |entry| is out of range or no key frame precedes it.
+int packet_index_seek_keyframe(PacketIndex *index, size_t entry,
+                               size_t *keyframe);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_COMMON_PACKET_INDEX_H_
@@ -468,38 +468,25 @@ static void y4m_422jpeg_420jpeg_helper(unsigned char *_dst,
                                        int _c_h) {
   int y;
   int x;
-  /*Filter: [3 -17 78 78 -17 3]/128, derived from a 6-tap Lanczos window.*/
-  for (x = 0; x < _c_w; x++) {
-    for (y = 0; y < OC_MINI(_c_h, 2); y += 2) {
-      _dst[(y >> 1) * _c_w] =
-          OC_CLAMPI(0,
-                    (64 * _src[0] + 78 * _src[OC_MINI(1, _c_h - 1) * _c_w] -
-                     17 * _src[OC_MINI(2, _c_h - 1) * _c_w] +
-                     3 * _src[OC_MINI(3, _c_h - 1) * _c_w] + 64) >>
-                        7,
-                    255);
+  /*Filter: [3 -17 78 78 -17 3]/128, derived from a 6-tap Lanczos window.
+    Rows outside the plane are clamped to the nearest edge row.
+    The inner loop runs along a row so that all six taps are contiguous in
+     memory and the compiler can vectorize it.*/
+  for (y = 0; y < _c_h; y += 2) {
+    const unsigned char *r0 = _src + OC_MAXI(y - 2, 0) * _c_w;
+    const unsigned char *r1 = _src + OC_MAXI(y - 1, 0) * _c_w;
+    const unsigned char *r2 = _src + y * _c_w;
+    const unsigned char *r3 = _src + OC_MINI(y + 1, _c_h - 1) * _c_w;
+    const unsigned char *r4 = _src + OC_MINI(y + 2, _c_h - 1) * _c_w;
+    const unsigned char *r5 = _src + OC_MINI(y + 3, _c_h - 1) * _c_w;
+    unsigned char *dst = _dst + (y >> 1) * _c_w;
+    for (x = 0; x < _c_w; x++) {
+      dst[x] = OC_CLAMPI(0,
+                         (3 * (r0[x] + r5[x]) - 17 * (r1[x] + r4[x]) +
+                          78 * (r2[x] + r3[x]) + 64) >>
+                             7,
+                         255);
     }
-    for (; y < _c_h - 3; y += 2) {
-      _dst[(y >> 1) * _c_w] =
-          OC_CLAMPI(0,
-                    (3 * (_src[(y - 2) * _c_w] + _src[(y + 3) * _c_w]) -
-                     17 * (_src[(y - 1) * _c_w] + _src[(y + 2) * _c_w]) +
-                     78 * (_src[y * _c_w] + _src[(y + 1) * _c_w]) + 64) >>
-                        7,
-                    255);
-    }
-    for (; y < _c_h; y += 2) {
-      _dst[(y >> 1) * _c_w] = OC_CLAMPI(
-          0,
-          (3 * (_src[(y - 2) * _c_w] + _src[(_c_h - 1) * _c_w]) -
-           17 * (_src[(y - 1) * _c_w] + _src[OC_MINI(y + 2, _c_h - 1) * _c_w]) +
-           78 * (_src[y * _c_w] + _src[OC_MINI(y + 1, _c_h - 1) * _c_w]) +
-           64) >>
-              7,
-          255);
-    }
-    _src++;
-    _dst++;
   }
 }
 
@@ -1159,13 +1146,40 @@ void y4m_input_close(y4m_input *_y4m) {
   free(_y4m->aux_buf);
 }
 
-int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, aom_image_t *_img) {
-  char frame[6];
+/*Fills in the frame buffer pointers for a converted frame stored in _buf.
+  We don't use aom_img_wrap() because it forces padding for odd picture sizes,
+   which would require a separate fread call for every row.*/
+static void y4m_set_image(const y4m_input *_y4m, unsigned char *_buf,
+                          aom_image_t *_img) {
   int pic_sz;
   int c_w;
   int c_h;
   int c_sz;
   int bytes_per_sample = _y4m->bit_depth > 8 ? 2 : 1;
+  memset(_img, 0, sizeof(*_img));
+  /*Y4M has the planes in Y'CbCr order, which libaom calls Y, U, and V.*/
+  _img->fmt = _y4m->aom_fmt;
+  _img->w = _img->d_w = _y4m->pic_w;
+  _img->h = _img->d_h = _y4m->pic_h;
+  _img->x_chroma_shift = _y4m->dst_c_dec_h >> 1;
+  _img->y_chroma_shift = _y4m->dst_c_dec_v >> 1;
+  _img->bps = _y4m->bps;
+
+  /*Set up the buffer pointers.*/
+  pic_sz = _y4m->pic_w * _y4m->pic_h * bytes_per_sample;
+  c_w = (_y4m->pic_w + _y4m->dst_c_dec_h - 1) / _y4m->dst_c_dec_h;
+  c_w *= bytes_per_sample;
+  c_h = (_y4m->pic_h + _y4m->dst_c_dec_v - 1) / _y4m->dst_c_dec_v;
+  c_sz = c_w * c_h;
+  _img->stride[AOM_PLANE_Y] = _y4m->pic_w * bytes_per_sample;
+  _img->stride[AOM_PLANE_U] = _img->stride[AOM_PLANE_V] = c_w;
+  _img->planes[AOM_PLANE_Y] = _buf;
+  _img->planes[AOM_PLANE_U] = _buf + pic_sz;
+  _img->planes[AOM_PLANE_V] = _buf + pic_sz + c_sz;
+}
+
+int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, aom_image_t *_img) {
+  char frame[6];
   /*Read and skip the frame header.*/
   if (!file_read(frame, 6, _fin)) return 0;
   if (memcmp(frame, "FRAME", 5)) {
@@ -1194,28 +1208,37 @@ int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, aom_image_t *_img) {
   }
   /*Now convert the just read frame.*/
   (*_y4m->convert)(_y4m, _y4m->dst_buf, _y4m->aux_buf);
-  /*Fill in the frame buffer pointers.
-    We don't use aom_img_wrap() because it forces padding for odd picture
-     sizes, which would require a separate fread call for every row.*/
-  memset(_img, 0, sizeof(*_img));
-  /*Y4M has the planes in Y'CbCr order, which libaom calls Y, U, and V.*/
-  _img->fmt = _y4m->aom_fmt;
-  _img->w = _img->d_w = _y4m->pic_w;
-  _img->h = _img->d_h = _y4m->pic_h;
-  _img->x_chroma_shift = _y4m->dst_c_dec_h >> 1;
-  _img->y_chroma_shift = _y4m->dst_c_dec_v >> 1;
-  _img->bps = _y4m->bps;
+  y4m_set_image(_y4m, _y4m->dst_buf, _img);
+  return 1;
+}
 
-  /*Set up the buffer pointers.*/
-  pic_sz = _y4m->pic_w * _y4m->pic_h * bytes_per_sample;
-  c_w = (_y4m->pic_w + _y4m->dst_c_dec_h - 1) / _y4m->dst_c_dec_h;
-  c_w *= bytes_per_sample;
-  c_h = (_y4m->pic_h + _y4m->dst_c_dec_v - 1) / _y4m->dst_c_dec_v;
-  c_sz = c_w * c_h;
-  _img->stride[AOM_PLANE_Y] = _y4m->pic_w * bytes_per_sample;
-  _img->stride[AOM_PLANE_U] = _img->stride[AOM_PLANE_V] = c_w;
-  _img->planes[AOM_PLANE_Y] = _y4m->dst_buf;
-  _img->planes[AOM_PLANE_U] = _y4m->dst_buf + pic_sz;
-  _img->planes[AOM_PLANE_V] = _y4m->dst_buf + pic_sz + c_sz;
+int y4m_input_is_passthrough(const y4m_input *_y4m) {
+  return _y4m->convert == y4m_convert_null;
+}
+
+int y4m_input_wrap_frame(const y4m_input *_y4m, const unsigned char **_data,
+                         const unsigned char *_end, aom_image_t *_img) {
+  const unsigned char *p = *_data;
+  int j;
+  assert(y4m_input_is_passthrough(_y4m));
+  if (p == _end) return 0;
+  /*Skip the frame header.*/
+  if (_end - p < 6 || memcmp(p, "FRAME", 5)) {
+    fprintf(stderr, "Loss of framing in Y4M input data\n");
+    return -1;
+  }
+  p += 5;
+  for (j = 0; j < 80 && p < _end && *p != '\n'; j++) p++;
+  if (p == _end || *p != '\n') {
+    fprintf(stderr, "Error parsing Y4M frame header\n");
+    return -1;
+  }
+  p++;
+  if ((size_t)(_end - p) < _y4m->dst_buf_read_sz) {
+    fprintf(stderr, "Error reading Y4M frame data.\n");
+    return -1;
+  }
+  y4m_set_image(_y4m, (unsigned char *)p, _img);
+  *_data = p + _y4m->dst_buf_read_sz;
   return 1;
 }
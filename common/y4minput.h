@@ -75,6 +75,21 @@ int y4m_input_open(y4m_input *y4m_ctx, FILE *file, char *skip_buffer,
 void y4m_input_close(y4m_input *_y4m);
 int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, aom_image_t *img);
 
+/**
+ * Returns 1 if frames are stored in the file exactly as they are returned in
+ * |img|, i.e. no chroma conversion is needed.
+ */
+int y4m_input_is_passthrough(const y4m_input *_y4m);
+
+/**
+ * Points |img| at the frame starting at |*data| without copying it. Only valid
+ * when y4m_input_is_passthrough() returns 1. On success |*data| is advanced
+ * past the frame and 1 is returned. Returns 0 when |*data| == |end| and -1 if
+ * the frame is malformed or truncated.
+ */
+int y4m_input_wrap_frame(const y4m_input *_y4m, const unsigned char **data,
+                         const unsigned char *end, aom_image_t *img);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
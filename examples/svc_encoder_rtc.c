@@ -38,6 +38,7 @@ typedef struct {
   int layering_mode;
   int output_obu;
   int decode;
+  int reuse_lower_layer_mv;
 } AppInput;
 
 typedef enum {
@@ -91,6 +92,10 @@ static const arg_def_t output_obu_arg =
 static const arg_def_t test_decode_arg =
     ARG_DEF(NULL, "test-decode", 1,
             "Attempt to test decoding the output when set to 1. Default is 1.");
+static const arg_def_t reuse_lower_layer_mv_arg =
+    ARG_DEF(NULL, "reuse-lower-layer-mv", 1,
+            "Seed the motion search of the upper spatial layers with the "
+            "motion vectors of the layer below when set to 1.");
 
 #if CONFIG_AV1_HIGHBITDEPTH
 static const struct arg_enum_list bitdepth_enum[] = {
@@ -125,6 +130,7 @@ static const arg_def_t *svc_args[] = { &frames_arg,
                                        &error_resilient_arg,
                                        &output_obu_arg,
                                        &test_decode_arg,
+                                       &reuse_lower_layer_mv_arg,
                                        NULL };
 
 #define zero(Dest) memset(&(Dest), 0, sizeof(Dest))
@@ -279,6 +285,7 @@ static void parse_command_line(int argc, const char **argv_,
   app_input->layering_mode = 0;
   app_input->output_obu = 0;
   app_input->decode = 1;
+  app_input->reuse_lower_layer_mv = 0;
   enc_cfg->g_threads = 1;
   enc_cfg->rc_end_usage = AOM_CBR;
 
@@ -365,6 +372,12 @@ static void parse_command_line(int argc, const char **argv_,
       if (app_input->decode != 0 && app_input->decode != 1)
         die("Invalid value for test decode flag (0, 1): %d.",
             app_input->decode);
+    } else if (arg_match(&arg, &reuse_lower_layer_mv_arg, argi)) {
+      app_input->reuse_lower_layer_mv = arg_parse_uint(&arg);
+      if (app_input->reuse_lower_layer_mv != 0 &&
+          app_input->reuse_lower_layer_mv != 1)
+        die("Invalid value for reuse lower layer mv flag (0, 1): %d.",
+            app_input->reuse_lower_layer_mv);
     } else {
       ++argj;
     }
@@ -1320,6 +1333,8 @@ int main(int argc, const char **argv) {
     svc_params.scaling_factor_den[1] = 2;
   }
   aom_codec_control(&codec, AV1E_SET_SVC_PARAMS, &svc_params);
+  aom_codec_control(&codec, AV1E_SET_SVC_REUSE_LOWER_LAYER_MV,
+                    app_input.reuse_lower_layer_mv);
   // TODO(aomedia:3032): Configure KSVC in fixed mode.
 
   // This controls the maximum target size of the key frame.
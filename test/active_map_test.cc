@@ -16,6 +16,7 @@
 #include "test/encode_test_driver.h"
 #include "test/i420_video_source.h"
 #include "test/util.h"
+#include "test/video_source.h"
 
 namespace {
 
@@ -94,4 +95,95 @@ AV1_INSTANTIATE_TEST_SUITE(ActiveMapTest,
                            ::testing::Values(::libaom_test::kRealTime),
                            ::testing::Range(5, 9));
 
+class DirtyRectsTest
+    : public ::libaom_test::CodecTestWith3Params<libaom_test::TestMode, int,
+                                                 int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  static const int kWidth = 208;
+  static const int kHeight = 144;
+  static const int kCols = (kWidth + 15) / 16;
+  static const int kRows = (kHeight + 15) / 16;
+  static const int kSetFrame = 3;
+  static const int kResetFrame = 7;
+  static const int kClearFrame = 8;
+
+  DirtyRectsTest() : EncoderTest(GET_PARAM(0)) {}
+  virtual ~DirtyRectsTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig(GET_PARAM(1));
+    cpu_used_ = GET_PARAM(2);
+    aq_mode_ = GET_PARAM(3);
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    frame_ = video->frame();
+    if (frame_ == 0) {
+      encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+      encoder->Control(AV1E_SET_AQ_MODE, aq_mode_);
+      encoder->Control(AV1E_SET_ENABLE_GLOBAL_MOTION, 0);
+    } else if (frame_ >= kSetFrame && frame_ < kResetFrame) {
+      // Covers the 16x16 blocks of rows 2-3 and columns 1-3. The rectangles
+      // only apply to one frame, so they are set again before each frame.
+      static const aom_dirty_rect_t kRects[2] = { { 16, 32, 40, 8 },
+                                                  { 20, 40, 36, 12 } };
+      aom_dirty_rects_t dirty = { kRects, 2 };
+      encoder->Control(AV1E_SET_DIRTY_RECTS, &dirty);
+    } else if (frame_ == kClearFrame) {
+      // A NULL rects pointer overrides the rectangles set before it.
+      static const aom_dirty_rect_t kRect = { 0, 0, 16, 16 };
+      aom_dirty_rects_t dirty = { &kRect, 1 };
+      encoder->Control(AV1E_SET_DIRTY_RECTS, &dirty);
+      dirty.rects = nullptr;
+      dirty.num_rects = 0;
+      encoder->Control(AV1E_SET_DIRTY_RECTS, &dirty);
+    }
+  }
+
+  virtual void PostEncodeFrameHook(::libaom_test::Encoder *encoder) {
+    if (frame_ < kSetFrame) return;
+    uint8_t active_map[kRows * kCols];
+    aom_active_map_t map = { active_map, kRows, kCols };
+    encoder->Control(AV1E_GET_ACTIVEMAP, &map);
+    for (int r = 0; r < kRows; ++r) {
+      for (int c = 0; c < kCols; ++c) {
+        // From kResetFrame on the rectangles have expired.
+        const int expected = frame_ >= kResetFrame ||
+                             (r >= 2 && r <= 3 && c >= 1 && c <= 3);
+        EXPECT_EQ(active_map[r * kCols + c], expected)
+            << "frame " << frame_ << " row " << r << " col " << c;
+      }
+    }
+  }
+
+  void DoTest() {
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_target_bitrate = 400;
+    cfg_.rc_resize_mode = 0;
+    cfg_.g_pass = AOM_RC_ONE_PASS;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.kf_max_dist = 90000;
+    ::libaom_test::RandomVideoSource video;
+    video.SetSize(kWidth, kHeight);
+    video.set_limit(10);
+
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+  int cpu_used_;
+  int aq_mode_;
+  unsigned int frame_;
+};
+
+TEST_P(DirtyRectsTest, Test) { DoTest(); }
+
+// Runs without AQ and with cyclic refresh (aq mode 3), whose segments must
+// leave the blocks outside the dirty rectangles alone; the encode/decode
+// mismatch check covers it.
+AV1_INSTANTIATE_TEST_SUITE(DirtyRectsTest,
+                           ::testing::Values(::libaom_test::kRealTime),
+                           ::testing::Range(7, 11), ::testing::Values(0, 3));
+
 }  // namespace
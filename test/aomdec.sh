@@ -141,6 +141,49 @@ aomdec_av1_obu_section5() {
   fi
 }
 
+# Decodes a stream with frequent key frames serially and with
+# --segment-threads, and compares the MD5 of the output.
+aomdec_av1_ivf_segment_threads() {
+  if [ "$(aomdec_can_decode_av1)" = "yes" ] && \
+     [ "$(multithread_available)" = "yes" ]; then
+    local file="av1.segments.ivf"
+    if [ ! -e "${file}" ]; then
+      encode_yuv_raw_input_av1 "${file}" --ivf --kf-max-dist=3 || return 1
+    fi
+    local decoder="$(aom_tool_path aomdec)"
+    local md5file="${AOM_TEST_OUTPUT_DIR}/av1.segments.md5"
+    eval "${AOM_TEST_PREFIX}" "${decoder}" --md5 "${file}" \
+      ">" "${md5file}" 2>&1 || return 1
+    for threads in 1 2 4; do
+      eval "${AOM_TEST_PREFIX}" "${decoder}" --md5 "${file}" \
+        --segment-threads=${threads} ">" "${md5file}.${threads}" 2>&1 \
+        || return 1
+      diff "${md5file}" "${md5file}.${threads}" || return 1
+    done
+  fi
+}
+
+# Decodes a stream serially and with --pipeline, and compares the MD5 of the
+# output.
+aomdec_av1_ivf_pipeline() {
+  if [ "$(aomdec_can_decode_av1)" = "yes" ] && \
+     [ "$(multithread_available)" = "yes" ]; then
+    local file="${AV1_IVF_FILE}"
+    if [ ! -e "${file}" ]; then
+      encode_yuv_raw_input_av1 "${file}" --ivf || return 1
+    fi
+    local decoder="$(aom_tool_path aomdec)"
+    local md5file="${AOM_TEST_OUTPUT_DIR}/av1.pipeline.md5"
+    eval "${AOM_TEST_PREFIX}" "${decoder}" --md5 --i420 "${file}" \
+      ">" "${md5file}" 2>&1 || return 1
+    for depth in 1 4; do
+      eval "${AOM_TEST_PREFIX}" "${decoder}" --md5 --i420 "${file}" \
+        --pipeline=${depth} ">" "${md5file}.${depth}" 2>&1 || return 1
+      diff "${md5file}" "${md5file}.${depth}" || return 1
+    done
+  fi
+}
+
 aomdec_av1_webm() {
   if [ "$(aomdec_can_decode_av1)" = "yes" ] && \
      [ "$(webm_io_available)" = "yes" ]; then
@@ -179,6 +222,8 @@ aomdec_tests="aomdec_av1_ivf
               aomdec_av1_ivf_multithread
               aomdec_av1_ivf_multithread_row_mt
               aomdec_aom_ivf_pipe_input
+              aomdec_av1_ivf_segment_threads
+              aomdec_av1_ivf_pipeline
               aomdec_av1_monochrome_yuv_8bit"
 
 if [ ! "$(realtime_only_build)" = "yes" ]; then
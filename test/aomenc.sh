@@ -206,6 +206,123 @@ aomenc_av1_webm_1pass() {
   fi
 }
 
+aomenc_av1_ivf_chunk_threads() {
+  if [ "$(aomenc_can_encode_av1)" = "yes" ] && \
+     [ "$(multithread_available)" = "yes" ]; then
+    local output="${AOM_TEST_OUTPUT_DIR}/av1_chunk_threads.ivf"
+    aomenc $(yuv_raw_input) \
+      $(aomenc_encode_test_fast_params) \
+      --chunk-threads=2 \
+      --ivf \
+      --output="${output}" || return 1
+
+    if [ ! -e "${output}" ]; then
+      elog "Output file does not exist."
+      return 1
+    fi
+
+    # The chunks must make up a single stream holding every frame.
+    if [ "$(av1_decode_available)" = "yes" ]; then
+      local decoder="$(aom_tool_path aomdec)"
+      local decoded="${AOM_TEST_OUTPUT_DIR}/av1_chunk_threads.yuv"
+      eval "${AOM_TEST_PREFIX}" "${decoder}" "${output}" --i420 \
+        --output="${decoded}" ${devnull} || return 1
+      local frame_size=$((YUV_RAW_INPUT_WIDTH * YUV_RAW_INPUT_HEIGHT * 3 / 2))
+      local frames=$(($(wc -c < "${decoded}") / frame_size))
+      local expected_frames="${AV1_ENCODE_TEST_FRAME_LIMIT}"
+      if [ "${frames}" -ne "${expected_frames}" ]; then
+        elog "Decoded ${frames} frames, expected ${expected_frames}."
+        return 1
+      fi
+    fi
+  fi
+}
+
+# Encodes a two stream ladder serially and with --parallel-streams, and
+# checks that the outputs are identical.
+aomenc_av1_ivf_parallel_streams() {
+  if [ "$(aomenc_can_encode_av1)" = "yes" ] && \
+     [ "$(multithread_available)" = "yes" ]; then
+    local output="${AOM_TEST_OUTPUT_DIR}/av1_parallel_streams"
+    aomenc $(yuv_raw_input) \
+      $(aomenc_encode_test_rt_params) \
+      --ivf \
+      --output="${output}_0.ivf" --target-bitrate=400 \
+      -- --output="${output}_1.ivf" --target-bitrate=200 || return 1
+    aomenc $(yuv_raw_input) \
+      $(aomenc_encode_test_rt_params) \
+      --parallel-streams \
+      --ivf \
+      --output="${output}_parallel_0.ivf" --target-bitrate=400 \
+      -- --output="${output}_parallel_1.ivf" --target-bitrate=200 || return 1
+
+    for stream in 0 1; do
+      if ! cmp -s "${output}_${stream}.ivf" \
+          "${output}_parallel_${stream}.ivf"; then
+        elog "Stream ${stream} differs with --parallel-streams."
+        return 1
+      fi
+    done
+  fi
+}
+
+# Encodes with --read-ahead and checks that the output is identical to the
+# output of the default input reader.
+aomenc_av1_ivf_read_ahead() {
+  if [ "$(aomenc_can_encode_av1)" = "yes" ] && \
+     [ "$(multithread_available)" = "yes" ]; then
+    local output="${AOM_TEST_OUTPUT_DIR}/av1_read_ahead"
+    aomenc $(yuv_raw_input) \
+      $(aomenc_encode_test_rt_params) \
+      --ivf \
+      --output="${output}.ivf" || return 1
+    for frames in 1 4; do
+      aomenc $(yuv_raw_input) \
+        $(aomenc_encode_test_rt_params) \
+        --read-ahead=${frames} \
+        --ivf \
+        --output="${output}_${frames}.ivf" || return 1
+      if ! cmp -s "${output}.ivf" "${output}_${frames}.ivf"; then
+        elog "Output differs with --read-ahead=${frames}."
+        return 1
+      fi
+    done
+  fi
+}
+
+# Encodes with --mmap-input, alone and with --read-ahead, and checks that the
+# output is identical to the output of the default input reader.
+aomenc_av1_ivf_mmap_input() {
+  if [ "$(aomenc_can_encode_av1)" = "yes" ]; then
+    local output="${AOM_TEST_OUTPUT_DIR}/av1_mmap_input"
+    aomenc $(yuv_raw_input) \
+      $(aomenc_encode_test_rt_params) \
+      --ivf \
+      --output="${output}.ivf" || return 1
+    aomenc $(yuv_raw_input) \
+      $(aomenc_encode_test_rt_params) \
+      --mmap-input \
+      --ivf \
+      --output="${output}_mmap.ivf" || return 1
+    if ! cmp -s "${output}.ivf" "${output}_mmap.ivf"; then
+      elog "Output differs with --mmap-input."
+      return 1
+    fi
+    if [ "$(multithread_available)" = "yes" ]; then
+      aomenc $(yuv_raw_input) \
+        $(aomenc_encode_test_rt_params) \
+        --mmap-input \
+        --read-ahead=4 \
+        --ivf \
+        --output="${output}_mmap_read_ahead.ivf" || return 1
+      if ! cmp -s "${output}.ivf" "${output}_mmap_read_ahead.ivf"; then
+        elog "Output differs with --mmap-input --read-ahead=4."
+        return 1
+      fi
+    fi
+  fi
+}
+
 aomenc_av1_ivf_lossless() {
   if [ "$(aomenc_can_encode_av1)" = "yes" ]; then
     local output="${AOM_TEST_OUTPUT_DIR}/av1_lossless.ivf"
@@ -301,6 +418,10 @@ else
                 aomenc_av1_obu_section5
                 aomenc_av1_webm
                 aomenc_av1_webm_1pass
+                aomenc_av1_ivf_chunk_threads
+                aomenc_av1_ivf_parallel_streams
+                aomenc_av1_ivf_read_ahead
+                aomenc_av1_ivf_mmap_input
                 aomenc_av1_ivf_lossless
                 aomenc_av1_ivf_minq0_maxq0
                 aomenc_av1_ivf_use_16bit_internal
@@ -675,6 +675,27 @@ INSTANTIATE_TEST_SUITE_P(AVX2, AV1HighbdFwdTxfm2dTest,
                                  Values(av1_highbd_fwd_txfm)));
 #endif  // HAVE_AVX2
 
+#if HAVE_AVX512
+// av1_highbd_fwd_txfm() only reaches the AVX-512 transforms on CPUs that
+// support them, call them directly instead.
+static void highbd_fwd_txfm_avx512(const int16_t *src_diff, tran_low_t *coeff,
+                                   int diff_stride, TxfmParam *txfm_param) {
+  if (txfm_param->tx_size == TX_32X32) {
+    av1_fwd_txfm2d_32x32_avx512(src_diff, coeff, diff_stride,
+                                txfm_param->tx_type, txfm_param->bd);
+  } else {
+    av1_fwd_txfm2d_64x64_avx512(src_diff, coeff, diff_stride,
+                                txfm_param->tx_type, txfm_param->bd);
+  }
+}
+
+static TX_SIZE Highbd_fwd_txfm_for_avx512[] = { TX_32X32, TX_64X64 };
+
+INSTANTIATE_TEST_SUITE_P(AVX512, AV1HighbdFwdTxfm2dTest,
+                         Combine(ValuesIn(Highbd_fwd_txfm_for_avx512),
+                                 Values(highbd_fwd_txfm_avx512)));
+#endif  // HAVE_AVX512
+
 #if HAVE_NEON
 static TX_SIZE Highbd_fwd_txfm_for_neon[] = {
   TX_4X4,  TX_8X8,  TX_16X16, TX_32X32, TX_64X64, TX_4X8,   TX_8X4,
@@ -122,6 +122,24 @@ INSTANTIATE_TEST_SUITE_P(
                       make_tuple(&av1_denoiser_filter_sse2, BLOCK_128X128)));
 #endif  // HAVE_SSE2
 
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, AV1DenoiserTest,
+    ::testing::Values(make_tuple(&av1_denoiser_filter_avx2, BLOCK_8X8),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_8X16),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_16X8),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_16X16),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_16X32),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_32X16),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_32X32),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_32X64),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_64X32),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_64X64),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_128X64),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_64X128),
+                      make_tuple(&av1_denoiser_filter_avx2, BLOCK_128X128)));
+#endif  // HAVE_AVX2
+
 #if HAVE_NEON
 INSTANTIATE_TEST_SUITE_P(
     NEON, AV1DenoiserTest,
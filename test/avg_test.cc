@@ -522,6 +522,128 @@ TEST_P(IntProColTest, DISABLED_Speed) {
   FillRandom();
   RunSpeedTest();
 }
+typedef void (*Stats8x8RowFunc)(const uint8_t *src, int src_stride,
+                                const uint8_t *ref, int ref_stride,
+                                int num_blks, uint16_t *src_sum,
+                                uint32_t *src_sse, uint16_t *ref_sum,
+                                uint16_t *sad);
+
+// Params: number of 8x8 blocks, asm function, c function.
+typedef std::tuple<int, Stats8x8RowFunc, Stats8x8RowFunc> Stats8x8RowParam;
+
+class Stats8x8RowTest : public ::testing::TestWithParam<Stats8x8RowParam> {
+ public:
+  Stats8x8RowTest()
+      : num_blks_(GET_PARAM(0)), asm_func_(GET_PARAM(1)),
+        c_func_(GET_PARAM(2)), rnd_(ACMRandom::DeterministicSeed()) {}
+
+ protected:
+  static const int kMaxBlocks = 32;
+  static const int kStride = 8 * kMaxBlocks + 8;
+
+  void FillConstant(uint8_t src_value, uint8_t ref_value) {
+    memset(src_, src_value, sizeof(src_));
+    memset(ref_, ref_value, sizeof(ref_));
+  }
+
+  void FillRandom() {
+    for (int i = 0; i < 8 * kStride; ++i) {
+      src_[i] = rnd_.Rand8();
+      ref_[i] = rnd_.Rand8();
+    }
+  }
+
+  void RunComparison(bool with_ref) {
+    uint16_t sum_c[kMaxBlocks], ref_sum_c[kMaxBlocks], sad_c[kMaxBlocks];
+    uint16_t sum_asm[kMaxBlocks], ref_sum_asm[kMaxBlocks], sad_asm[kMaxBlocks];
+    uint32_t sse_c[kMaxBlocks], sse_asm[kMaxBlocks];
+    const uint8_t *const ref = with_ref ? ref_ : nullptr;
+    // Unaligned source and reference, as the blocks of a frame row are.
+    const int src_offset = rnd_(8);
+    const int ref_offset = rnd_(8);
+    API_REGISTER_STATE_CHECK(
+        c_func_(src_ + src_offset, kStride, ref ? ref + ref_offset : nullptr,
+                kStride, num_blks_, sum_c, sse_c, ref_sum_c, sad_c));
+    API_REGISTER_STATE_CHECK(asm_func_(
+        src_ + src_offset, kStride, ref ? ref + ref_offset : nullptr, kStride,
+        num_blks_, sum_asm, sse_asm, ref_sum_asm, sad_asm));
+    for (int b = 0; b < num_blks_; ++b) {
+      EXPECT_EQ(sum_c[b], sum_asm[b]) << "block " << b;
+      EXPECT_EQ(sse_c[b], sse_asm[b]) << "block " << b;
+      if (with_ref) {
+        EXPECT_EQ(ref_sum_c[b], ref_sum_asm[b]) << "block " << b;
+        EXPECT_EQ(sad_c[b], sad_asm[b]) << "block " << b;
+      }
+    }
+  }
+
+  void RunSpeedTest() {
+    const int numIter = 20000000 / num_blks_;
+    uint16_t sum[kMaxBlocks], ref_sum[kMaxBlocks], sad[kMaxBlocks];
+    uint32_t sse[kMaxBlocks];
+    printf("Blocks = %d number of iteration is %d \n", num_blks_, numIter);
+    aom_usec_timer c_timer_;
+    aom_usec_timer_start(&c_timer_);
+    for (int i = 0; i < numIter; i++) {
+      c_func_(src_, kStride, ref_, kStride, num_blks_, sum, sse, ref_sum, sad);
+    }
+    aom_usec_timer_mark(&c_timer_);
+
+    aom_usec_timer asm_timer_;
+    aom_usec_timer_start(&asm_timer_);
+    for (int i = 0; i < numIter; i++) {
+      asm_func_(src_, kStride, ref_, kStride, num_blks_, sum, sse, ref_sum,
+                sad);
+    }
+    aom_usec_timer_mark(&asm_timer_);
+
+    const int c_sum_time = static_cast<int>(aom_usec_timer_elapsed(&c_timer_));
+    const int asm_sum_time =
+        static_cast<int>(aom_usec_timer_elapsed(&asm_timer_));
+
+    printf("c_time = %d \t simd_time = %d \t Gain = %4.2f \n", c_sum_time,
+           asm_sum_time,
+           (static_cast<float>(c_sum_time) / static_cast<float>(asm_sum_time)));
+  }
+
+  int num_blks_;
+  Stats8x8RowFunc asm_func_;
+  Stats8x8RowFunc c_func_;
+  ACMRandom rnd_;
+  uint8_t src_[8 * kStride];
+  uint8_t ref_[8 * kStride];
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(Stats8x8RowTest);
+
+TEST_P(Stats8x8RowTest, MinValue) {
+  FillConstant(0, 255);
+  RunComparison(true);
+}
+
+TEST_P(Stats8x8RowTest, MaxValue) {
+  FillConstant(255, 0);
+  RunComparison(true);
+}
+
+TEST_P(Stats8x8RowTest, Random) {
+  for (int i = 0; i < 16; ++i) {
+    FillRandom();
+    RunComparison(true);
+  }
+}
+
+TEST_P(Stats8x8RowTest, RandomNoRef) {
+  for (int i = 0; i < 16; ++i) {
+    FillRandom();
+    RunComparison(false);
+  }
+}
+
+TEST_P(Stats8x8RowTest, DISABLED_Speed) {
+  FillRandom();
+  RunSpeedTest();
+}
+
 class VectorVarTestBase : public ::testing::Test {
  public:
   explicit VectorVarTestBase(int bwl) { m_bwl = bwl; }
@@ -716,6 +838,15 @@ INSTANTIATE_TEST_SUITE_P(
                       make_tuple(64, &aom_int_pro_col_sse2, &aom_int_pro_col_c),
                       make_tuple(128, &aom_int_pro_col_sse2,
                                  &aom_int_pro_col_c)));
+
+INSTANTIATE_TEST_SUITE_P(
+    SSE2, Stats8x8RowTest,
+    ::testing::Values(
+        make_tuple(1, &aom_get_8x8_stats_row_sse2, &aom_get_8x8_stats_row_c),
+        make_tuple(2, &aom_get_8x8_stats_row_sse2, &aom_get_8x8_stats_row_c),
+        make_tuple(7, &aom_get_8x8_stats_row_sse2, &aom_get_8x8_stats_row_c),
+        make_tuple(32, &aom_get_8x8_stats_row_sse2,
+                   &aom_get_8x8_stats_row_c)));
 #endif
 
 #if HAVE_AVX2
@@ -724,6 +855,15 @@ INSTANTIATE_TEST_SUITE_P(
     ::testing::Values(make_tuple(16, 16, 8, 0, 16, &aom_avg_8x8_quad_avx2),
                       make_tuple(32, 32, 8, 16, 16, &aom_avg_8x8_quad_avx2),
                       make_tuple(32, 32, 8, 8, 16, &aom_avg_8x8_quad_avx2)));
+
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, Stats8x8RowTest,
+    ::testing::Values(
+        make_tuple(1, &aom_get_8x8_stats_row_avx2, &aom_get_8x8_stats_row_c),
+        make_tuple(4, &aom_get_8x8_stats_row_avx2, &aom_get_8x8_stats_row_c),
+        make_tuple(7, &aom_get_8x8_stats_row_avx2, &aom_get_8x8_stats_row_c),
+        make_tuple(32, &aom_get_8x8_stats_row_avx2,
+                   &aom_get_8x8_stats_row_c)));
 #endif
 
 #if HAVE_NEON
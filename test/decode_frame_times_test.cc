@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom/aom_decoder.h"
+#include "aom/aom_encoder.h"
+
+namespace {
+
+constexpr int kWidth = 256;
+constexpr int kHeight = 256;
+constexpr int kNumFrames = 3;
+constexpr int kNumTiles = 4;
+
+// Encodes kNumFrames real-time frames with 2x2 tiles.
+void EncodeFrames(std::vector<std::vector<uint8_t>> *frames) {
+  aom_image_t img;
+  ASSERT_EQ(aom_img_alloc(&img, AOM_IMG_FMT_I420, kWidth, kHeight, 1), &img);
+
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, AOM_USAGE_REALTIME),
+            AOM_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 0;
+
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(aom_codec_enc_init(&enc, iface, &cfg, 0), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AOME_SET_CPUUSED, 9), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_TILE_COLUMNS, 1), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_TILE_ROWS, 1), AOM_CODEC_OK);
+
+  frames->resize(kNumFrames);
+  for (int i = 0; i < kNumFrames; ++i) {
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? kWidth / 2 : kWidth;
+      const int h = plane ? kHeight / 2 : kHeight;
+      for (int r = 0; r < h; ++r) {
+        for (int c = 0; c < w; ++c) {
+          img.planes[plane][r * img.stride[plane] + c] =
+              static_cast<uint8_t>(((r + i) * (c + 2 * i)) >> 3);
+        }
+      }
+    }
+    ASSERT_EQ(aom_codec_encode(&enc, &img, i, 1, 0), AOM_CODEC_OK);
+    aom_codec_iter_t iter = nullptr;
+    const aom_codec_cx_pkt_t *pkt;
+    while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      const uint8_t *const buf =
+          static_cast<const uint8_t *>(pkt->data.frame.buf);
+      (*frames)[i].insert((*frames)[i].end(), buf, buf + pkt->data.frame.sz);
+    }
+  }
+
+  aom_img_free(&img);
+  EXPECT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
+}
+
+void DecodeWithFrameTimes(unsigned int threads) {
+  std::vector<std::vector<uint8_t>> frames;
+  ASSERT_NO_FATAL_FAILURE(EncodeFrames(&frames));
+
+  aom_codec_dec_cfg_t cfg = { threads, 0, 0, !FORCE_HIGHBITDEPTH_DECODING };
+  aom_codec_ctx_t dec;
+  ASSERT_EQ(aom_codec_dec_init(&dec, aom_codec_av1_dx(), &cfg, 0),
+            AOM_CODEC_OK);
+
+  aom_dec_frame_times_t times = {};
+  EXPECT_EQ(aom_codec_control(&dec, AV1D_GET_FRAME_TIMES, nullptr),
+            AOM_CODEC_INVALID_PARAM);
+  // Nothing has been decoded yet.
+  EXPECT_EQ(aom_codec_control(&dec, AV1D_GET_FRAME_TIMES, &times),
+            AOM_CODEC_ERROR);
+
+  for (const std::vector<uint8_t> &frame : frames) {
+    ASSERT_EQ(aom_codec_decode(&dec, frame.data(), frame.size(), nullptr),
+              AOM_CODEC_OK);
+    aom_codec_iter_t iter = nullptr;
+    ASSERT_NE(aom_codec_get_frame(&dec, &iter), nullptr);
+
+    // Only the first two tiles fit, the last element must be left alone.
+    std::vector<int64_t> tile_times(3, -1);
+    times = {};
+    times.tile_time_us = tile_times.data();
+    times.tile_time_us_size = 2;
+    ASSERT_EQ(aom_codec_control(&dec, AV1D_GET_FRAME_TIMES, &times),
+              AOM_CODEC_OK);
+    EXPECT_EQ(times.num_frames, 1);
+    EXPECT_EQ(times.num_tiles, kNumTiles);
+    for (int i = 0; i < AOM_DEC_STAGE_COUNT; ++i) {
+      EXPECT_GE(times.time_us[i], 0);
+    }
+    EXPECT_GE(tile_times[0], 0);
+    EXPECT_GE(tile_times[1], 0);
+    EXPECT_EQ(tile_times[2], -1);
+    EXPECT_GE(times.worker_idle_us, 0);
+    if (threads == 1) {
+      EXPECT_EQ(times.worker_idle_us, 0);
+    }
+  }
+
+  // Flushing keeps the times of the last frame.
+  ASSERT_EQ(aom_codec_decode(&dec, nullptr, 0, nullptr), AOM_CODEC_OK);
+  times = {};
+  ASSERT_EQ(aom_codec_control(&dec, AV1D_GET_FRAME_TIMES, &times),
+            AOM_CODEC_OK);
+  EXPECT_EQ(times.num_frames, 1);
+
+  EXPECT_EQ(aom_codec_destroy(&dec), AOM_CODEC_OK);
+}
+
+TEST(DecodeFrameTimesTest, SingleThread) { DecodeWithFrameTimes(1); }
+
+TEST(DecodeFrameTimesTest, MultiThread) { DecodeWithFrameTimes(4); }
+
+}  // namespace
@@ -11,6 +11,7 @@
 
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include "config/aom_version.h"
 
@@ -23,6 +24,7 @@
 #include "test/ivf_video_source.h"
 #include "test/md5_helper.h"
 #include "test/util.h"
+#include "test/video_source.h"
 #include "test/webm_video_source.h"
 
 using std::make_tuple;
@@ -106,8 +108,7 @@ class AV1NewEncodeDecodePerfTest
   virtual ~AV1NewEncodeDecodePerfTest() {}
 
   virtual void SetUp() {
-    InitializeConfig();
-    SetMode(encoding_mode_);
+    InitializeConfig(encoding_mode_);
 
     cfg_.g_lag_in_frames = 25;
     cfg_.rc_min_quantizer = 2;
@@ -244,4 +245,113 @@ TEST_P(AV1NewEncodeDecodePerfTest, PerfTest) {
 
 AV1_INSTANTIATE_TEST_SUITE(AV1NewEncodeDecodePerfTest,
                            ::testing::Values(::libaom_test::kTwoPassGood));
+
+// Synthetic 4K content: a diagonal gradient that pans by a few pixels per
+// frame, so that motion search and the mode info of neighboring blocks are
+// exercised without depending on a large test vector.
+class Panning4KVideoSource : public ::libaom_test::DummyVideoSource {
+ public:
+  Panning4KVideoSource() { SetSize(3840, 2160); }
+
+ protected:
+  virtual void FillFrame() {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int ss = plane ? 1 : 0;
+      const int w = (img_->d_w + ss) >> ss;
+      const int h = (img_->d_h + ss) >> ss;
+      const int shift = (frame_ * 3) >> ss;
+      uint8_t *row = img_->planes[plane];
+      for (int r = 0; r < h; ++r, row += img_->stride[plane]) {
+        for (int c = 0; c < w; ++c) {
+          row[c] = static_cast<uint8_t>(((c + shift) ^ (r >> 2)) + (r >> 3));
+        }
+      }
+    }
+  }
+};
+
+// Measures encode and decode speed at 3840x2160, the resolution at which the
+// per-4x4 mode info grid no longer fits in cache.
+class AV1EncodeDecode4KPerfTest
+    : public ::libaom_test::CodecTestWith2Params<libaom_test::TestMode, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1EncodeDecode4KPerfTest()
+      : EncoderTest(GET_PARAM(0)), encoding_mode_(GET_PARAM(1)),
+        speed_(GET_PARAM(2)) {}
+
+  virtual ~AV1EncodeDecode4KPerfTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig(encoding_mode_);
+    cfg_.g_threads = 4;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.rc_target_bitrate = 12000;
+    if (encoding_mode_ == ::libaom_test::kRealTime) cfg_.g_lag_in_frames = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, speed_);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 2);
+      encoder->Control(AV1E_SET_ROW_MT, 1);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf = static_cast<const uint8_t *>(pkt->data.frame.buf);
+    packets_.emplace_back(buf, buf + pkt->data.frame.sz);
+  }
+
+  virtual bool DoDecode() const { return false; }
+
+  libaom_test::TestMode encoding_mode_;
+  int speed_;
+  std::vector<std::vector<uint8_t> > packets_;
+};
+
+TEST_P(AV1EncodeDecode4KPerfTest, PerfTest) {
+  const unsigned int kFrames = 10;
+  Panning4KVideoSource video;
+  video.set_limit(kFrames);
+
+  aom_usec_timer t;
+  aom_usec_timer_start(&t);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  aom_usec_timer_mark(&t);
+  const double encode_secs =
+      static_cast<double>(aom_usec_timer_elapsed(&t)) / kUsecsInSec;
+
+  aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+  cfg.threads = 1;
+  cfg.allow_lowbitdepth = 1;
+  libaom_test::AV1Decoder decoder(cfg, 0);
+
+  aom_usec_timer_start(&t);
+  for (const std::vector<uint8_t> &packet : packets_) {
+    ASSERT_EQ(decoder.DecodeFrame(packet.data(), packet.size()), AOM_CODEC_OK);
+  }
+  aom_usec_timer_mark(&t);
+  const double decode_secs =
+      static_cast<double>(aom_usec_timer_elapsed(&t)) / kUsecsInSec;
+  const unsigned decode_frames = static_cast<unsigned>(packets_.size());
+
+  printf("{\n");
+  printf("\t\"type\" : \"encode_decode_4k_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+  printf("\t\"encodingMode\" : %d,\n", encoding_mode_);
+  printf("\t\"speed\" : %d,\n", speed_);
+  printf("\t\"encodeTimeSecs\" : %f,\n", encode_secs);
+  printf("\t\"encodeFramesPerSecond\" : %f,\n", kFrames / encode_secs);
+  printf("\t\"decodeTimeSecs\" : %f,\n", decode_secs);
+  printf("\t\"decodeFramesPerSecond\" : %f\n", decode_frames / decode_secs);
+  printf("}\n");
+}
+
+AV1_INSTANTIATE_TEST_SUITE(AV1EncodeDecode4KPerfTest,
+                           ::testing::Values(::libaom_test::kRealTime,
+                                             ::libaom_test::kOnePassGood),
+                           ::testing::Values(5, 6));
 }  // namespace
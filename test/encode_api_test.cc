@@ -10,12 +10,16 @@
  */
 
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
 #include "config/aom_config.h"
 
 #include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom/aom_decoder.h"
 #include "aom/aom_encoder.h"
 #include "aom/aom_image.h"
 
@@ -106,6 +110,333 @@ TEST(EncodeAPI, SetSFrameOnFirstFrame) {
   EXPECT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
 }
 
+struct TileGroupOutput {
+  std::vector<uint8_t> data;
+  int num_partitions;
+  int num_frames;
+};
+
+void CollectPartition(void *user_priv, const uint8_t *data, size_t size,
+                      int partition_id, int is_last) {
+  TileGroupOutput *const out = static_cast<TileGroupOutput *>(user_priv);
+  // The partitions come in bitstream order, headers first.
+  EXPECT_EQ(partition_id, out->num_partitions);
+  out->data.insert(out->data.end(), data, data + size);
+  ++out->num_partitions;
+  if (is_last) ++out->num_frames;
+}
+
+void EncodeWithTileGroupOutput(unsigned int threads, int row_mt) {
+  constexpr int kWidth = 256;
+  constexpr int kHeight = 128;
+  aom_image_t img;
+  ASSERT_EQ(aom_img_alloc(&img, AOM_IMG_FMT_I420, kWidth, kHeight, 1), &img);
+
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, AOM_USAGE_REALTIME),
+            AOM_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 0;
+  cfg.g_threads = threads;
+
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(aom_codec_enc_init(&enc, iface, &cfg, 0), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AOME_SET_CPUUSED, 9), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_ROW_MT, row_mt), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_TILE_COLUMNS, 1), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_NUM_TG, 2), AOM_CODEC_OK);
+  TileGroupOutput out = {};
+  aom_tile_group_output_cb_t cb = { CollectPartition, &out };
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_TILE_GROUP_OUTPUT_CB, &cb),
+            AOM_CODEC_OK);
+#if CONFIG_AV1_DECODER
+  aom_codec_ctx_t dec;
+  ASSERT_EQ(aom_codec_dec_init(&dec, aom_codec_av1_dx(), nullptr, 0),
+            AOM_CODEC_OK);
+#endif
+
+  for (int frame = 0; frame < 3; ++frame) {
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? kWidth / 2 : kWidth;
+      const int h = plane ? kHeight / 2 : kHeight;
+      for (int r = 0; r < h; ++r) {
+        for (int c = 0; c < w; ++c) {
+          img.planes[plane][r * img.stride[plane] + c] =
+              static_cast<uint8_t>((r * 3 + c * 7 + frame * 11) & 0xff);
+        }
+      }
+    }
+    out.data.clear();
+    out.num_partitions = 0;
+    ASSERT_EQ(aom_codec_encode(&enc, &img, frame, 1, 0), AOM_CODEC_OK);
+    // Temporal delimiter, headers and one partition per tile group.
+    ASSERT_EQ(out.num_partitions, 4);
+    EXPECT_EQ(out.num_frames, frame + 1);
+    const std::vector<uint8_t> &data = out.data;
+
+    aom_codec_iter_t iter = nullptr;
+    const aom_codec_cx_pkt_t *pkt;
+    int num_packets = 0;
+    while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      ASSERT_EQ(pkt->kind, AOM_CODEC_CX_FRAME_PKT);
+      const uint8_t *const buf =
+          static_cast<const uint8_t *>(pkt->data.frame.buf);
+      // The partitions must add up to the packet.
+      EXPECT_EQ(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz), data);
+      ++num_packets;
+    }
+    EXPECT_EQ(num_packets, 1);
+#if CONFIG_AV1_DECODER
+    ASSERT_EQ(aom_codec_decode(&dec, data.data(), data.size(), nullptr),
+              AOM_CODEC_OK);
+    aom_codec_iter_t dec_iter = nullptr;
+    const aom_image_t *const dec_img = aom_codec_get_frame(&dec, &dec_iter);
+    ASSERT_NE(dec_img, nullptr);
+    aom_image_t enc_img;
+    ASSERT_EQ(aom_codec_control(&enc, AV1_GET_NEW_FRAME_IMAGE, &enc_img),
+              AOM_CODEC_OK);
+    for (unsigned int r = 0; r < dec_img->d_h; ++r) {
+      ASSERT_EQ(memcmp(dec_img->planes[0] + r * dec_img->stride[0],
+                       enc_img.planes[0] + r * enc_img.stride[0],
+                       dec_img->d_w),
+                0)
+          << "frame " << frame << " row " << r;
+    }
+#endif
+  }
+
+#if CONFIG_AV1_DECODER
+  EXPECT_EQ(aom_codec_destroy(&dec), AOM_CODEC_OK);
+#endif
+  aom_img_free(&img);
+  EXPECT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
+}
+
+TEST(EncodeAPI, TileGroupOutput) {
+  ASSERT_NO_FATAL_FAILURE(EncodeWithTileGroupOutput(1, 0));
+  // The tile groups are output from the worker threads, with tile based and
+  // row based multi-threading.
+  ASSERT_NO_FATAL_FAILURE(EncodeWithTileGroupOutput(2, 0));
+  ASSERT_NO_FATAL_FAILURE(EncodeWithTileGroupOutput(2, 1));
+}
+
+// Encodes kNumFrames frames and returns, for each aom_codec_encode() call
+// (the last one being the flush call), the PSNR packets it produced.
+void EncodeWithPsnr(unsigned int threads, bool async_psnr,
+                    std::vector<std::vector<aom_codec_cx_pkt_t>> *psnr) {
+  constexpr int kWidth = 200;
+  constexpr int kHeight = 150;
+  constexpr int kNumFrames = 4;
+  aom_image_t img;
+  ASSERT_EQ(aom_img_alloc(&img, AOM_IMG_FMT_I420, kWidth, kHeight, 1), &img);
+
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, AOM_USAGE_REALTIME),
+            AOM_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 0;
+  cfg.g_threads = threads;
+
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(aom_codec_enc_init(&enc, iface, &cfg, AOM_CODEC_USE_PSNR),
+            AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AOME_SET_CPUUSED, 9), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_ASYNC_PSNR, async_psnr),
+            AOM_CODEC_OK);
+
+  psnr->clear();
+  for (int frame = 0; frame <= kNumFrames; ++frame) {
+    for (int plane = 0; plane < 3 && frame < kNumFrames; ++plane) {
+      const int w = plane ? (kWidth + 1) / 2 : kWidth;
+      const int h = plane ? (kHeight + 1) / 2 : kHeight;
+      for (int r = 0; r < h; ++r) {
+        for (int c = 0; c < w; ++c) {
+          img.planes[plane][r * img.stride[plane] + c] =
+              static_cast<uint8_t>((r * 5 + c * 3 + frame * 13) & 0xff);
+        }
+      }
+    }
+    ASSERT_EQ(aom_codec_encode(&enc, frame < kNumFrames ? &img : nullptr,
+                               frame, 1, 0),
+              AOM_CODEC_OK);
+    psnr->emplace_back();
+    aom_codec_iter_t iter = nullptr;
+    const aom_codec_cx_pkt_t *pkt;
+    while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      if (pkt->kind == AOM_CODEC_PSNR_PKT) psnr->back().push_back(*pkt);
+    }
+  }
+
+  aom_img_free(&img);
+  EXPECT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
+}
+
+TEST(EncodeAPI, AsyncPsnr) {
+  std::vector<std::vector<aom_codec_cx_pkt_t>> mt;
+  std::vector<std::vector<aom_codec_cx_pkt_t>> async;
+  // The synchronous PSNR is spread over the encoder workers in row strips,
+  // the asynchronous one is computed by a single background worker.
+  ASSERT_NO_FATAL_FAILURE(EncodeWithPsnr(4, false, &mt));
+  ASSERT_NO_FATAL_FAILURE(EncodeWithPsnr(4, true, &async));
+  ASSERT_EQ(mt.size(), async.size());
+  // Nothing is reported with the flush call in synchronous mode, nothing with
+  // the first call in asynchronous mode.
+  EXPECT_TRUE(mt.back().empty());
+  EXPECT_TRUE(async.front().empty());
+  for (size_t i = 0; i + 1 < mt.size(); ++i) {
+    ASSERT_EQ(mt[i].size(), 1u);
+    ASSERT_EQ(async[i + 1].size(), 1u);
+    const aom_codec_cx_pkt_t &a = mt[i][0];
+    const aom_codec_cx_pkt_t &b = async[i + 1][0];
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_EQ(a.data.psnr.sse[j], b.data.psnr.sse[j]);
+      EXPECT_EQ(a.data.psnr.samples[j], b.data.psnr.samples[j]);
+      EXPECT_EQ(a.data.psnr.psnr[j], b.data.psnr.psnr[j]);
+    }
+  }
+}
+
+TEST(EncodeAPI, StageTimes) {
+  constexpr int kWidth = 128;
+  constexpr int kHeight = 64;
+  aom_image_t img;
+  ASSERT_EQ(aom_img_alloc(&img, AOM_IMG_FMT_I420, kWidth, kHeight, 1), &img);
+  memset(img.img_data, 128, img.sz);
+
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, AOM_USAGE_REALTIME),
+            AOM_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(aom_codec_enc_init(&enc, iface, &cfg, 0), AOM_CODEC_OK);
+  EXPECT_EQ(aom_codec_control(&enc, AV1E_GET_STAGE_TIMES, nullptr),
+            AOM_CODEC_INVALID_PARAM);
+
+  aom_enc_stage_times_t times;
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_GET_STAGE_TIMES, &times),
+            AOM_CODEC_OK);
+  for (int i = 0; i < AOM_ENC_STAGE_COUNT; ++i) EXPECT_EQ(times.time_us[i], 0);
+
+  for (int frame = 0; frame < 2; ++frame) {
+    ASSERT_EQ(aom_codec_encode(&enc, &img, frame, 1, 0), AOM_CODEC_OK);
+  }
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_GET_STAGE_TIMES, &times),
+            AOM_CODEC_OK);
+  for (int i = 0; i < AOM_ENC_STAGE_COUNT; ++i) EXPECT_GE(times.time_us[i], 0);
+  EXPECT_GT(times.time_us[AOM_ENC_STAGE_ENCODE], 0);
+  // Real-time mode has no first pass.
+  EXPECT_EQ(times.time_us[AOM_ENC_STAGE_FIRST_PASS], 0);
+
+  aom_img_free(&img);
+  EXPECT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
+}
+
+// Encodes a moving noise pattern in real-time mode, checks that each frame
+// decodes to the encoder reconstruction and returns the time statistics of
+// the last frame.
+void EncodeWithTimeBudget(aom_codec_ctx_t *enc, aom_codec_ctx_t *dec,
+                          aom_image_t *img, int first_frame, int num_frames,
+                          aom_enc_frame_time_stats_t *stats) {
+  for (int frame = first_frame; frame < first_frame + num_frames; ++frame) {
+    uint8_t *const buf = img->img_data;
+    for (size_t i = 0; i < img->sz; ++i)
+      buf[i] = static_cast<uint8_t>(((i + 3 * frame) * 2654435761u) >> 24);
+    ASSERT_EQ(aom_codec_encode(enc, img, frame, 1, 0), AOM_CODEC_OK);
+    aom_codec_iter_t iter = nullptr;
+    const aom_codec_cx_pkt_t *pkt;
+    while ((pkt = aom_codec_get_cx_data(enc, &iter)) != nullptr) {
+      if (pkt->kind != AOM_CODEC_CX_FRAME_PKT) continue;
+      const uint8_t *const data =
+          static_cast<const uint8_t *>(pkt->data.frame.buf);
+      ASSERT_EQ(aom_codec_decode(dec, data, pkt->data.frame.sz, nullptr),
+                AOM_CODEC_OK);
+      aom_codec_iter_t dec_iter = nullptr;
+      const aom_image_t *const dec_img = aom_codec_get_frame(dec, &dec_iter);
+      ASSERT_NE(dec_img, nullptr);
+      aom_image_t enc_img;
+      ASSERT_EQ(aom_codec_control(enc, AV1_GET_NEW_FRAME_IMAGE, &enc_img),
+                AOM_CODEC_OK);
+      for (unsigned int r = 0; r < dec_img->d_h; ++r) {
+        ASSERT_EQ(memcmp(dec_img->planes[0] + r * dec_img->stride[0],
+                         enc_img.planes[0] + r * enc_img.stride[0],
+                         dec_img->d_w),
+                  0)
+            << "frame " << frame << " row " << r;
+      }
+    }
+  }
+  ASSERT_EQ(aom_codec_control(enc, AV1E_GET_FRAME_TIME_STATS, stats),
+            AOM_CODEC_OK);
+}
+
+TEST(EncodeAPI, FrameTimeBudget) {
+  constexpr int kWidth = 320;
+  constexpr int kHeight = 240;
+  aom_image_t img;
+  ASSERT_EQ(aom_img_alloc(&img, AOM_IMG_FMT_I420, kWidth, kHeight, 1), &img);
+
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, AOM_USAGE_REALTIME),
+            AOM_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.rc_end_usage = AOM_CBR;
+  cfg.rc_target_bitrate = 500;
+  cfg.rc_dropframe_thresh = 0;
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(aom_codec_enc_init(&enc, iface, &cfg, 0), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AOME_SET_CPUUSED, 9), AOM_CODEC_OK);
+  EXPECT_EQ(aom_codec_control(&enc, AV1E_GET_FRAME_TIME_STATS, nullptr),
+            AOM_CODEC_INVALID_PARAM);
+  aom_codec_ctx_t dec;
+  ASSERT_EQ(aom_codec_dec_init(&dec, aom_codec_av1_dx(), nullptr, 0),
+            AOM_CODEC_OK);
+
+  // Without a budget the statistics are reported, the speed is left alone.
+  aom_enc_frame_time_stats_t stats;
+  ASSERT_NO_FATAL_FAILURE(EncodeWithTimeBudget(&enc, &dec, &img, 0, 3, &stats));
+  EXPECT_GT(stats.frame_time_us, 0);
+  EXPECT_GT(stats.sb_encode_time_us, 0);
+  EXPECT_LE(stats.sb_encode_time_us, stats.frame_time_us);
+  EXPECT_LE(stats.max_sb_row_time_us, stats.sb_encode_time_us);
+  EXPECT_EQ(stats.budget_us, 0u);
+  EXPECT_EQ(stats.start_speed_level, 0);
+  EXPECT_EQ(stats.max_speed_level, 0);
+  EXPECT_EQ(stats.num_sb_rows, (kHeight + 63) / 64);
+  EXPECT_EQ(stats.num_boosted_sb_rows, 0);
+  EXPECT_EQ(stats.dropped, 0);
+
+  // A budget no frame can meet: the rows and then the frames speed up.
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_FRAME_TIME_BUDGET, 1u),
+            AOM_CODEC_OK);
+  ASSERT_NO_FATAL_FAILURE(EncodeWithTimeBudget(&enc, &dec, &img, 3, 1, &stats));
+  EXPECT_EQ(stats.budget_us, 1u);
+  EXPECT_EQ(stats.start_speed_level, 0);
+  EXPECT_GT(stats.max_speed_level, 0);
+  EXPECT_EQ(stats.num_boosted_sb_rows, stats.num_sb_rows - 1);
+  ASSERT_NO_FATAL_FAILURE(EncodeWithTimeBudget(&enc, &dec, &img, 4, 4, &stats));
+  EXPECT_GT(stats.start_speed_level, 0);
+  EXPECT_GE(stats.max_speed_level, stats.start_speed_level);
+
+  // Removing the budget goes back to the normal speed features.
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_FRAME_TIME_BUDGET, 0u),
+            AOM_CODEC_OK);
+  ASSERT_NO_FATAL_FAILURE(EncodeWithTimeBudget(&enc, &dec, &img, 8, 1, &stats));
+  EXPECT_EQ(stats.start_speed_level, 0);
+  EXPECT_EQ(stats.max_speed_level, 0);
+
+  aom_img_free(&img);
+  EXPECT_EQ(aom_codec_destroy(&dec), AOM_CODEC_OK);
+  EXPECT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
+}
+
 #if !CONFIG_REALTIME_ONLY
 TEST(EncodeAPI, AllIntraMode) {
   aom_codec_iface_t *iface = aom_codec_av1_cx();
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <tuple>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
+#include "av1/common/quant_common.h"
+#include "av1/common/scan.h"
+#include "test/acm_random.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+typedef void (*HadamardQuantizeRdFunc)(
+    const int16_t *src_diff, int diff_stride, int tx_wd, int blocks_wide,
+    int blocks_high, const int16_t *round_ptr, const int16_t *quant_ptr,
+    const int16_t *dequant_ptr, const int16_t *scan, const int16_t *iscan,
+    uint16_t *eobs, int *rate, int64_t *dist);
+
+// <function, transform width>
+typedef std::tuple<HadamardQuantizeRdFunc, int> HadamardQuantizeRdParam;
+
+const int kMaxBlocks = 16;
+const int kDiffStride = 128;
+
+// The composition of the per stage functions this kernel replaces in the
+// nonrd transform search.
+void ReferenceHadamardQuantizeRd(const int16_t *src_diff, int diff_stride,
+                                 int tx_wd, int blocks_wide, int blocks_high,
+                                 const int16_t *round_ptr,
+                                 const int16_t *quant_ptr,
+                                 const int16_t *dequant_ptr,
+                                 const int16_t *scan, const int16_t *iscan,
+                                 uint16_t *eobs, int *rate, int64_t *dist) {
+  DECLARE_ALIGNED(32, int16_t, coeff[16 * 16]);
+  DECLARE_ALIGNED(32, int16_t, qcoeff[16 * 16]);
+  DECLARE_ALIGNED(32, int16_t, dqcoeff[16 * 16]);
+  const int n_coeffs = tx_wd * tx_wd;
+  *rate = 0;
+  *dist = 0;
+  for (int r = 0; r < blocks_high; ++r) {
+    for (int c = 0; c < blocks_wide; ++c) {
+      const int16_t *const src = src_diff + (r * diff_stride + c) * tx_wd;
+      uint16_t *const eob = &eobs[r * blocks_wide + c];
+      if (tx_wd == 16)
+        aom_hadamard_lp_16x16(src, diff_stride, coeff);
+      else
+        aom_hadamard_lp_8x8(src, diff_stride, coeff);
+      av1_quantize_lp(coeff, n_coeffs, round_ptr, quant_ptr, qcoeff, dqcoeff,
+                      dequant_ptr, eob, scan, iscan);
+      if (*eob == 1)
+        *rate += abs(qcoeff[0]);
+      else if (*eob > 1)
+        *rate += aom_satd_lp(qcoeff, n_coeffs);
+      *dist += av1_block_error_lp(coeff, dqcoeff, n_coeffs) >> 2;
+    }
+  }
+}
+
+class HadamardQuantizeRdTest
+    : public ::testing::TestWithParam<HadamardQuantizeRdParam> {
+ public:
+  HadamardQuantizeRdTest()
+      : func_(GET_PARAM(0)), tx_wd_(GET_PARAM(1)),
+        rnd_(ACMRandom::DeterministicSeed()) {}
+
+ protected:
+  void SetQuantizer(int qindex) {
+    const int16_t dc = av1_dc_quant_QTX(qindex, 0, AOM_BITS_8);
+    const int16_t ac = av1_ac_quant_QTX(qindex, 0, AOM_BITS_8);
+    for (int i = 0; i < 8; ++i) {
+      const int16_t q = i == 0 ? dc : ac;
+      dequant_[i] = q;
+      quant_[i] = (1 << 16) / q;
+      round_[i] = (64 * q) >> 7;
+    }
+  }
+
+  void FillRandom(int max_diff) {
+    for (int i = 0; i < kDiffStride * kDiffStride; ++i)
+      src_diff_[i] = rnd_(2 * max_diff + 1) - max_diff;
+  }
+
+  void FillExtreme() {
+    for (int i = 0; i < kDiffStride * kDiffStride; ++i)
+      src_diff_[i] = rnd_.Rand8() & 1 ? 255 : -255;
+  }
+
+  void CheckOutput(int blocks_wide, int blocks_high) {
+    const SCAN_ORDER *const scan_order =
+        &av1_scan_orders[tx_wd_ == 16 ? TX_16X16 : TX_8X8][DCT_DCT];
+    uint16_t ref_eobs[kMaxBlocks * kMaxBlocks];
+    uint16_t eobs[kMaxBlocks * kMaxBlocks];
+    int ref_rate, rate;
+    int64_t ref_dist, dist;
+    ReferenceHadamardQuantizeRd(
+        src_diff_, kDiffStride, tx_wd_, blocks_wide, blocks_high, round_,
+        quant_, dequant_, scan_order->scan, scan_order->iscan, ref_eobs,
+        &ref_rate, &ref_dist);
+    API_REGISTER_STATE_CHECK(func_(src_diff_, kDiffStride, tx_wd_, blocks_wide,
+                                   blocks_high, round_, quant_, dequant_,
+                                   scan_order->scan, scan_order->iscan, eobs,
+                                   &rate, &dist));
+    ASSERT_EQ(ref_rate, rate)
+        << "blocks: " << blocks_wide << "x" << blocks_high;
+    ASSERT_EQ(ref_dist, dist)
+        << "blocks: " << blocks_wide << "x" << blocks_high;
+    for (int i = 0; i < blocks_wide * blocks_high; ++i)
+      ASSERT_EQ(ref_eobs[i], eobs[i]) << "block " << i;
+  }
+
+  void RunCheckOutput(bool extreme) {
+    const int max_blocks = kDiffStride / tx_wd_;
+    for (int qindex = 0; qindex < 256; qindex += 15) {
+      SetQuantizer(qindex);
+      for (int blocks_high = 1; blocks_high <= 3; ++blocks_high) {
+        for (int blocks_wide = 1; blocks_wide <= max_blocks; ++blocks_wide) {
+          if (extreme)
+            FillExtreme();
+          else
+            FillRandom(rnd_.Rand8() & 1 ? 255 : 32);
+          CheckOutput(blocks_wide, blocks_high);
+        }
+      }
+    }
+  }
+
+  void RunSpeedTest(int blocks_wide, int blocks_high) {
+    const SCAN_ORDER *const scan_order =
+        &av1_scan_orders[tx_wd_ == 16 ? TX_16X16 : TX_8X8][DCT_DCT];
+    const int num_loops = 1000000 / (blocks_wide * blocks_high);
+    uint16_t eobs[kMaxBlocks * kMaxBlocks];
+    int rate;
+    int64_t dist;
+    SetQuantizer(120);
+    FillRandom(64);
+
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < num_loops; ++i) {
+      ReferenceHadamardQuantizeRd(src_diff_, kDiffStride, tx_wd_, blocks_wide,
+                                  blocks_high, round_, quant_, dequant_,
+                                  scan_order->scan, scan_order->iscan, eobs,
+                                  &rate, &dist);
+    }
+    aom_usec_timer_mark(&timer);
+    const int ref_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < num_loops; ++i) {
+      func_(src_diff_, kDiffStride, tx_wd_, blocks_wide, blocks_high, round_,
+            quant_, dequant_, scan_order->scan, scan_order->iscan, eobs, &rate,
+            &dist);
+    }
+    aom_usec_timer_mark(&timer);
+    const int test_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+
+    printf("tx %dx%d, %dx%d blocks: composition %d us, fused %d us (%4.2fx)\n",
+           tx_wd_, tx_wd_, blocks_wide, blocks_high, ref_time, test_time,
+           static_cast<double>(ref_time) / test_time);
+  }
+
+  HadamardQuantizeRdFunc func_;
+  int tx_wd_;
+  ACMRandom rnd_;
+  DECLARE_ALIGNED(16, int16_t, src_diff_[kDiffStride * kDiffStride]);
+  DECLARE_ALIGNED(16, int16_t, round_[8]);
+  DECLARE_ALIGNED(16, int16_t, quant_[8]);
+  DECLARE_ALIGNED(16, int16_t, dequant_[8]);
+};
+
+TEST_P(HadamardQuantizeRdTest, CheckOutput) { RunCheckOutput(false); }
+
+TEST_P(HadamardQuantizeRdTest, CheckOutputExtreme) { RunCheckOutput(true); }
+
+TEST_P(HadamardQuantizeRdTest, DISABLED_Speed) {
+  RunSpeedTest(1, 1);
+  RunSpeedTest(2, 2);
+  RunSpeedTest(64 / tx_wd_, 64 / tx_wd_);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    C, HadamardQuantizeRdTest,
+    ::testing::Values(
+        HadamardQuantizeRdParam(&av1_hadamard_quantize_rd_lp_c, 8),
+        HadamardQuantizeRdParam(&av1_hadamard_quantize_rd_lp_c, 16)));
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, HadamardQuantizeRdTest,
+    ::testing::Values(
+        HadamardQuantizeRdParam(&av1_hadamard_quantize_rd_lp_avx2, 8),
+        HadamardQuantizeRdParam(&av1_hadamard_quantize_rd_lp_avx2, 16)));
+#endif  // HAVE_AVX2
+
+}  // namespace
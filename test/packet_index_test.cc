@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom/aom_decoder.h"
+#include "aom/aom_encoder.h"
+#include "common/ivfenc.h"
+#include "common/packet_index.h"
+#include "test/md5_helper.h"
+#include "test/video_source.h"
+
+namespace {
+
+constexpr int kWidth = 64;
+constexpr int kHeight = 64;
+constexpr int kNumFrames = 7;
+constexpr int kKeyFrameInterval = 3;
+constexpr uint32_t kAv1FourCC = 0x31305641;
+
+typedef std::vector<uint8_t> Packet;
+
+class PacketIndexTest : public ::testing::TestWithParam<PacketIndexFormat> {
+ protected:
+  // Encodes kNumFrames real-time frames with a key frame every
+  // kKeyFrameInterval frames and writes them to file_ in the tested format.
+  void EncodeFile() {
+    const PacketIndexFormat format = GetParam();
+    aom_image_t img;
+    ASSERT_EQ(aom_img_alloc(&img, AOM_IMG_FMT_I420, kWidth, kHeight, 1), &img);
+
+    aom_codec_iface_t *iface = aom_codec_av1_cx();
+    aom_codec_enc_cfg_t cfg;
+    ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, AOM_USAGE_REALTIME),
+              AOM_CODEC_OK);
+    cfg.g_w = kWidth;
+    cfg.g_h = kHeight;
+    cfg.g_lag_in_frames = 0;
+    cfg.kf_min_dist = kKeyFrameInterval;
+    cfg.kf_max_dist = kKeyFrameInterval;
+    cfg.save_as_annexb = format == PACKET_INDEX_ANNEXB;
+
+    aom_codec_ctx_t enc;
+    ASSERT_EQ(aom_codec_enc_init(&enc, iface, &cfg, 0), AOM_CODEC_OK);
+    ASSERT_EQ(aom_codec_control(&enc, AOME_SET_CPUUSED, 9), AOM_CODEC_OK);
+
+    FILE *const file = file_.file();
+    ASSERT_NE(file, nullptr);
+    if (format == PACKET_INDEX_IVF) {
+      ivf_write_file_header(file, &cfg, kAv1FourCC, kNumFrames);
+    }
+    for (int i = 0; i < kNumFrames; ++i) {
+      for (int plane = 0; plane < 3; ++plane) {
+        const int w = plane ? kWidth / 2 : kWidth;
+        const int h = plane ? kHeight / 2 : kHeight;
+        for (int r = 0; r < h; ++r) {
+          memset(img.planes[plane] + r * img.stride[plane],
+                 (r * 3 + i * 17 + plane * 40) & 0xff, w);
+        }
+      }
+      ASSERT_EQ(aom_codec_encode(&enc, &img, i, 1, 0), AOM_CODEC_OK);
+      aom_codec_iter_t iter = nullptr;
+      const aom_codec_cx_pkt_t *pkt;
+      while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != nullptr) {
+        if (pkt->kind != AOM_CODEC_CX_FRAME_PKT) continue;
+        const uint8_t *const buf =
+            static_cast<const uint8_t *>(pkt->data.frame.buf);
+        packets_.emplace_back(buf, buf + pkt->data.frame.sz);
+        if (format == PACKET_INDEX_IVF) {
+          ivf_write_frame_header(file, pkt->data.frame.pts,
+                                 pkt->data.frame.sz);
+        }
+        ASSERT_EQ(fwrite(buf, 1, pkt->data.frame.sz, file),
+                  pkt->data.frame.sz);
+      }
+    }
+    fflush(file);
+
+    aom_img_free(&img);
+    EXPECT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
+  }
+
+  // Decodes the packets read from index_ until the end of the stream and
+  // returns the MD5 of each output frame in md5s.
+  void Decode(std::vector<std::string> *md5s) {
+    aom_codec_ctx_t dec;
+    ASSERT_EQ(aom_codec_dec_init(&dec, aom_codec_av1_dx(), nullptr, 0),
+              AOM_CODEC_OK);
+    ASSERT_EQ(aom_codec_control(&dec, AV1D_SET_IS_ANNEXB,
+                                GetParam() == PACKET_INDEX_ANNEXB),
+              AOM_CODEC_OK);
+    const uint8_t *data;
+    size_t size;
+    while (packet_index_read(&index_, &data, &size, nullptr) == 0) {
+      ASSERT_EQ(aom_codec_decode(&dec, data, size, nullptr), AOM_CODEC_OK);
+      aom_codec_iter_t iter = nullptr;
+      const aom_image_t *img;
+      while ((img = aom_codec_get_frame(&dec, &iter)) != nullptr) {
+        libaom_test::MD5 md5;
+        md5.Add(img);
+        md5s->push_back(md5.Get());
+      }
+    }
+    EXPECT_EQ(aom_codec_destroy(&dec), AOM_CODEC_OK);
+  }
+
+  libaom_test::TempOutFile file_;
+  std::vector<Packet> packets_;
+  PacketIndex index_;
+};
+
+TEST_P(PacketIndexTest, IndexAndSeek) {
+  ASSERT_NO_FATAL_FAILURE(EncodeFile());
+  ASSERT_EQ(packets_.size(), static_cast<size_t>(kNumFrames));
+  ASSERT_EQ(packet_index_open(file_.file(), GetParam(), &index_), 0);
+
+  ASSERT_EQ(index_.num_entries, packets_.size());
+  EXPECT_EQ(index_.num_keyframes,
+            static_cast<size_t>((kNumFrames - 1) / kKeyFrameInterval + 1));
+  for (size_t i = 0; i < index_.num_entries; ++i) {
+    const PacketIndexEntry &entry = index_.entries[i];
+    EXPECT_EQ(entry.is_keyframe, i % kKeyFrameInterval == 0) << i;
+    EXPECT_EQ(entry.keyframe, i - i % kKeyFrameInterval) << i;
+    ASSERT_EQ(entry.size, packets_[i].size()) << i;
+    EXPECT_EQ(memcmp(index_.map.data + entry.offset, packets_[i].data(),
+                     entry.size),
+              0)
+        << i;
+    if (GetParam() == PACKET_INDEX_IVF) {
+      EXPECT_EQ(entry.pts, static_cast<aom_codec_pts_t>(i));
+    }
+  }
+
+  std::vector<std::string> ref_md5s;
+  ASSERT_NO_FATAL_FAILURE(Decode(&ref_md5s));
+  ASSERT_EQ(ref_md5s.size(), packets_.size());
+
+  // Decoding from a key frame found by seeking reproduces the tail of the
+  // full decode.
+  size_t keyframe;
+  ASSERT_EQ(packet_index_seek_keyframe(&index_, kNumFrames - 2, &keyframe), 0);
+  EXPECT_EQ(keyframe, static_cast<size_t>(kKeyFrameInterval));
+  std::vector<std::string> md5s;
+  ASSERT_NO_FATAL_FAILURE(Decode(&md5s));
+  ASSERT_EQ(md5s.size(), packets_.size() - keyframe);
+  for (size_t i = 0; i < md5s.size(); ++i) {
+    EXPECT_EQ(md5s[i], ref_md5s[keyframe + i]) << i;
+  }
+
+  EXPECT_EQ(packet_index_seek_keyframe(&index_, kNumFrames, &keyframe), -1);
+  EXPECT_EQ(packet_index_seek(&index_, kNumFrames + 1), -1);
+  ASSERT_EQ(packet_index_seek(&index_, kNumFrames), 0);
+  const uint8_t *data;
+  size_t size;
+  EXPECT_EQ(packet_index_read(&index_, &data, &size, nullptr), 1);
+
+  packet_index_close(&index_);
+}
+
+INSTANTIATE_TEST_SUITE_P(All, PacketIndexTest,
+                         ::testing::Values(PACKET_INDEX_IVF, PACKET_INDEX_OBU,
+                                           PACKET_INDEX_ANNEXB));
+
+}  // namespace
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom/aom_decoder.h"
+#include "aom/aom_encoder.h"
+#include "test/acm_random.h"
+#include "test/md5_helper.h"
+
+namespace {
+
+constexpr int kWidth = 256;
+// Tall enough for two loop restoration unit rows in the chroma planes.
+constexpr int kHeight = 384;
+constexpr int kNumFrames = 4;
+
+typedef std::vector<uint8_t> Partition;
+
+struct EncodedFrame {
+  std::vector<uint8_t> tu;
+  std::vector<Partition> partitions;
+};
+
+void CollectPartition(void *user_priv, const uint8_t *data, size_t size,
+                      int partition_id, int is_last) {
+  EncodedFrame *const frame = static_cast<EncodedFrame *>(user_priv);
+  // The encoder hands the partitions out in bitstream order.
+  EXPECT_EQ(partition_id, static_cast<int>(frame->partitions.size()));
+  EXPECT_EQ(is_last != 0, partition_id == 3);
+  frame->partitions.emplace_back(data, data + size);
+}
+
+enum class Filters { kNone, kDeblocking, kDefault, kRestoration };
+
+struct RowLog {
+  unsigned int rows_done;
+  int num_calls;
+  // Number of decode calls made so far for the current frame.
+  int partitions_fed;
+  int partitions_at_first_rows;
+  // The same frame decoded in one go.
+  const aom_image_t *ref;
+};
+
+// Returns true if rows [row_start, row_end) of the plane are the same in both
+// images.
+bool RowsMatch(const aom_image_t *img, const aom_image_t *ref, int plane,
+               unsigned int row_start, unsigned int row_end) {
+  const int bytes_per_sample = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  const size_t row_bytes =
+      static_cast<size_t>(aom_img_plane_width(img, plane)) * bytes_per_sample;
+  for (unsigned int r = row_start; r < row_end; ++r) {
+    if (memcmp(img->planes[plane] + r * img->stride[plane],
+               ref->planes[plane] + r * ref->stride[plane], row_bytes) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void LogRows(void *user_priv, const aom_image_t *img, unsigned int row_start,
+             unsigned int row_end) {
+  RowLog *const log = static_cast<RowLog *>(user_priv);
+  EXPECT_EQ(row_start, log->rows_done);
+  EXPECT_GT(row_end, row_start);
+  EXPECT_LE(row_end, img->d_h);
+  // Rows reported final must not change any more.
+  EXPECT_TRUE(RowsMatch(img, log->ref, AOM_PLANE_Y, row_start, row_end));
+  for (int plane = AOM_PLANE_U; plane <= AOM_PLANE_V; ++plane) {
+    const unsigned int ss_y = img->y_chroma_shift;
+    const unsigned int chroma_end =
+        row_end == img->d_h ? (row_end + ss_y) >> ss_y : row_end >> ss_y;
+    EXPECT_TRUE(RowsMatch(img, log->ref, plane, row_start >> ss_y, chroma_end));
+  }
+  if (log->rows_done == 0) log->partitions_at_first_rows = log->partitions_fed;
+  log->rows_done = row_end;
+  ++log->num_calls;
+}
+
+// Encodes kNumFrames frames with two tile rows, each in its own tile group.
+void EncodeFrames(Filters filters, std::vector<EncodedFrame> *frames) {
+  aom_image_t img;
+  ASSERT_EQ(aom_img_alloc(&img, AOM_IMG_FMT_I420, kWidth, kHeight, 1), &img);
+
+  // Real-time speeds never use loop restoration.
+  const bool realtime = filters != Filters::kRestoration;
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  const unsigned int usage =
+      realtime ? AOM_USAGE_REALTIME : AOM_USAGE_GOOD_QUALITY;
+  ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, usage), AOM_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 0;
+  // Loop restoration is off in tile groups output as their tiles are
+  // encoded. Error resilient frames with several tile groups are only split
+  // into partitions once they are packed, so they keep it.
+  if (filters == Filters::kRestoration) {
+    cfg.g_error_resilient = AOM_ERROR_RESILIENT_DEFAULT;
+  }
+
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(aom_codec_enc_init(&enc, iface, &cfg, 0), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AOME_SET_CPUUSED, realtime ? 9 : 4),
+            AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_TILE_ROWS, 1), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_NUM_TG, 2), AOM_CODEC_OK);
+  if (filters == Filters::kNone) {
+    ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_LOOPFILTER_CONTROL, 0),
+              AOM_CODEC_OK);
+    ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_ENABLE_CDEF, 0), AOM_CODEC_OK);
+    ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_ENABLE_RESTORATION, 0),
+              AOM_CODEC_OK);
+  } else if (filters == Filters::kDeblocking) {
+    ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_ENABLE_CDEF, 0), AOM_CODEC_OK);
+  } else if (filters == Filters::kRestoration) {
+    ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_ENABLE_RESTORATION, 1),
+              AOM_CODEC_OK);
+  }
+
+  libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+  frames->resize(kNumFrames);
+  for (int i = 0; i < kNumFrames; ++i) {
+    EncodedFrame *const frame = &(*frames)[i];
+    aom_tile_group_output_cb_t cb = { CollectPartition, frame };
+    ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_TILE_GROUP_OUTPUT_CB, &cb),
+              AOM_CODEC_OK);
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? kWidth / 2 : kWidth;
+      const int h = plane ? kHeight / 2 : kHeight;
+      for (int r = 0; r < h; ++r) {
+        for (int c = 0; c < w; ++c) {
+          // Noise gives loop restoration something to remove.
+          img.planes[plane][r * img.stride[plane] + c] = static_cast<uint8_t>(
+              (((r + i) * (c + 2 * i)) >> 3) + (rnd.Rand8() & 15));
+        }
+      }
+    }
+    ASSERT_EQ(aom_codec_encode(&enc, &img, i, 1, 0), AOM_CODEC_OK);
+    aom_codec_iter_t iter = nullptr;
+    const aom_codec_cx_pkt_t *pkt;
+    while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      const uint8_t *const buf =
+          static_cast<const uint8_t *>(pkt->data.frame.buf);
+      frame->tu.insert(frame->tu.end(), buf, buf + pkt->data.frame.sz);
+    }
+  }
+
+  aom_img_free(&img);
+  EXPECT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
+}
+
+void DecodePartialInput(Filters filters, unsigned int threads) {
+  std::vector<EncodedFrame> frames;
+  ASSERT_NO_FATAL_FAILURE(EncodeFrames(filters, &frames));
+
+  aom_codec_ctx_t ref_dec;
+  aom_codec_ctx_t dec;
+  aom_codec_dec_cfg_t cfg = {};
+  cfg.allow_lowbitdepth = 1;
+  cfg.threads = threads;
+  ASSERT_EQ(aom_codec_dec_init(&ref_dec, aom_codec_av1_dx(), nullptr, 0),
+            AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_dec_init(&dec, aom_codec_av1_dx(), &cfg, 0),
+            AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&dec, AV1D_SET_PARTIAL_INPUT, 1), AOM_CODEC_OK);
+  RowLog log = {};
+  aom_row_output_cb_t cb = { LogRows, &log };
+  ASSERT_EQ(aom_codec_control(&dec, AV1D_SET_ROW_OUTPUT_CB, &cb),
+            AOM_CODEC_OK);
+
+  for (const EncodedFrame &frame : frames) {
+    // Temporal delimiter, frame header and two tile groups.
+    ASSERT_EQ(frame.partitions.size(), 4u);
+
+    ASSERT_EQ(aom_codec_decode(&ref_dec, frame.tu.data(), frame.tu.size(),
+                               nullptr),
+              AOM_CODEC_OK);
+    aom_codec_iter_t iter = nullptr;
+    const aom_image_t *const ref_img = aom_codec_get_frame(&ref_dec, &iter);
+    ASSERT_NE(ref_img, nullptr);
+    libaom_test::MD5 ref_md5;
+    ref_md5.Add(ref_img);
+
+    log = {};
+    log.ref = ref_img;
+    // The TD and the frame header go in together; each tile group follows in
+    // a call of its own.
+    std::vector<uint8_t> head = frame.partitions[0];
+    head.insert(head.end(), frame.partitions[1].begin(),
+                frame.partitions[1].end());
+    std::vector<Partition> inputs = { head, frame.partitions[2],
+                                      frame.partitions[3] };
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      log.partitions_fed = static_cast<int>(i) + 1;
+      ASSERT_EQ(aom_codec_decode(&dec, inputs[i].data(), inputs[i].size(),
+                                 nullptr),
+                AOM_CODEC_OK);
+      iter = nullptr;
+      const aom_image_t *const img = aom_codec_get_frame(&dec, &iter);
+      if (i + 1 < inputs.size()) {
+        EXPECT_EQ(img, nullptr);
+      } else {
+        ASSERT_NE(img, nullptr);
+        libaom_test::MD5 md5;
+        md5.Add(img);
+        EXPECT_STREQ(md5.Get(), ref_md5.Get());
+      }
+    }
+    EXPECT_EQ(log.rows_done, static_cast<unsigned int>(kHeight));
+    // Without in-loop filtering the top tile row is available before the
+    // last tile group has been received. With filtering the rows follow the
+    // last filter through the frame instead of coming all at once.
+    if (filters == Filters::kNone) {
+      EXPECT_EQ(log.partitions_at_first_rows, 2);
+    } else {
+      EXPECT_GT(log.num_calls, 1);
+    }
+  }
+
+  EXPECT_EQ(aom_codec_destroy(&dec), AOM_CODEC_OK);
+  EXPECT_EQ(aom_codec_destroy(&ref_dec), AOM_CODEC_OK);
+}
+
+TEST(PartialDecodeTest, TileGroupsWithDeblocking) {
+  DecodePartialInput(Filters::kDeblocking, 1);
+}
+
+TEST(PartialDecodeTest, TileGroupsWithDeblockingMultiThreaded) {
+  DecodePartialInput(Filters::kDeblocking, 4);
+}
+
+TEST(PartialDecodeTest, TileGroupsWithLoopFilters) {
+  DecodePartialInput(Filters::kDefault, 1);
+}
+
+TEST(PartialDecodeTest, TileGroupsWithLoopFiltersMultiThreaded) {
+  DecodePartialInput(Filters::kDefault, 4);
+}
+
+TEST(PartialDecodeTest, TileGroupsWithLoopRestoration) {
+  DecodePartialInput(Filters::kRestoration, 1);
+}
+
+TEST(PartialDecodeTest, TileGroupsWithLoopRestorationMultiThreaded) {
+  DecodePartialInput(Filters::kRestoration, 4);
+}
+
+TEST(PartialDecodeTest, TileGroupsWithoutLoopFilters) {
+  DecodePartialInput(Filters::kNone, 1);
+}
+
+}  // namespace
@@ -11,8 +11,11 @@
 
 #include "av1/ratectrl_rtc.h"
 
+#include <cstdio>
 #include <memory>
+#include <vector>
 
+#include "aom_ports/aom_timer.h"
 #include "test/codec_factory.h"
 #include "test/encode_test_driver.h"
 #include "test/util.h"
@@ -273,4 +276,313 @@ TEST_P(RcInterfaceTest, Svc) { RunSvc(); }
 
 AV1_INSTANTIATE_TEST_SUITE(RcInterfaceTest, ::testing::Values(0, 3));
 
+constexpr int kSimKeyInterval = 20;
+
+// Models the size of a coded frame from its QP, which makes the QP sequence
+// of the rate control deterministic.
+uint64_t ModelFrameSize(const aom::AV1RateControlRtcConfig &cfg, int sl,
+                        int superframe, int qp, bool is_key) {
+  const uint64_t pixels = static_cast<uint64_t>(cfg.width) * cfg.height *
+                          cfg.scaling_factor_num[sl] *
+                          cfg.scaling_factor_num[sl] /
+                          (cfg.scaling_factor_den[sl] *
+                           cfg.scaling_factor_den[sl]);
+  const uint64_t size = pixels * (10 + superframe % 5) / (20 * (qp + 4));
+  return is_key ? 4 * size : size;
+}
+
+aom::AV1FrameParamsRTC SimFrameParams(const aom::AV1RateControlRtcConfig &cfg,
+                                      int sl, int superframe) {
+  aom::AV1FrameParamsRTC frame_params;
+  frame_params.spatial_layer_id = sl;
+  frame_params.temporal_layer_id =
+      cfg.ts_number_layers > 1 ? kTemporalId[superframe % 4] : 0;
+  // Only the base layer of every kSimKeyInterval-th superframe is a key
+  // frame.
+  frame_params.frame_type = sl == 0 && superframe % kSimKeyInterval == 0
+                                ? aom::kKeyFrame
+                                : aom::kInterFrame;
+  return frame_params;
+}
+
+// Drives the rate control without an encoder.
+class RcSimulator {
+ public:
+  explicit RcSimulator(const aom::AV1RateControlRtcConfig &cfg)
+      : cfg_(cfg), rc_api_(aom::AV1RateControlRTC::Create(cfg)),
+        superframe_(0) {}
+
+  bool Initialized() const { return rc_api_ != nullptr; }
+
+  // Codes one frame in every spatial layer.
+  void CodeSuperframe() {
+    for (int sl = 0; sl < cfg_.ss_number_layers; ++sl) {
+      const aom::AV1FrameParamsRTC frame_params =
+          SimFrameParams(cfg_, sl, superframe_);
+      rc_api_->ComputeQP(frame_params);
+      const int qp = rc_api_->GetQP();
+      qps_.push_back(qp);
+      rc_api_->PostEncodeUpdate(
+          ModelFrameSize(cfg_, sl, superframe_, qp,
+                         frame_params.frame_type == aom::kKeyFrame));
+    }
+    ++superframe_;
+  }
+
+  const std::vector<int> &qps() const { return qps_; }
+
+ private:
+  const aom::AV1RateControlRtcConfig cfg_;
+  std::unique_ptr<aom::AV1RateControlRTC> rc_api_;
+  int superframe_;
+  std::vector<int> qps_;
+};
+
+aom::AV1RateControlRtcConfig OneLayerConfig(int aq_mode) {
+  aom::AV1RateControlRtcConfig rc_cfg;
+  rc_cfg.width = 1280;
+  rc_cfg.height = 720;
+  rc_cfg.max_quantizer = 52;
+  rc_cfg.min_quantizer = 2;
+  rc_cfg.target_bandwidth = 1000;
+  rc_cfg.buf_initial_sz = 600;
+  rc_cfg.buf_optimal_sz = 600;
+  rc_cfg.buf_sz = 1000;
+  rc_cfg.undershoot_pct = 50;
+  rc_cfg.overshoot_pct = 50;
+  rc_cfg.max_intra_bitrate_pct = 1000;
+  rc_cfg.framerate = 30.0;
+  rc_cfg.ss_number_layers = 1;
+  rc_cfg.ts_number_layers = 1;
+  rc_cfg.layer_target_bitrate[0] = 1000;
+  rc_cfg.max_quantizers[0] = 52;
+  rc_cfg.min_quantizers[0] = 2;
+  rc_cfg.aq_mode = aq_mode;
+  return rc_cfg;
+}
+
+aom::AV1RateControlRtcConfig SvcConfig(int aq_mode) {
+  aom::AV1RateControlRtcConfig rc_cfg = OneLayerConfig(aq_mode);
+  static constexpr int kLayerTargetBitrate[9] = { 100, 140, 200, 250, 350,
+                                                  500, 450, 630, 900 };
+  rc_cfg.ss_number_layers = 3;
+  rc_cfg.ts_number_layers = 3;
+  for (int sl = 0; sl < 3; ++sl) {
+    rc_cfg.scaling_factor_num[sl] = 1 << sl;
+    rc_cfg.scaling_factor_den[sl] = 4;
+  }
+  for (int tl = 0; tl < 3; ++tl) rc_cfg.ts_rate_decimator[tl] = 4 >> tl;
+  for (int i = 0; i < 9; ++i) {
+    rc_cfg.layer_target_bitrate[i] = kLayerTargetBitrate[i];
+    rc_cfg.max_quantizers[i] = 56;
+    rc_cfg.min_quantizers[i] = 2;
+  }
+  return rc_cfg;
+}
+
+std::vector<int> Simulate(const aom::AV1RateControlRtcConfig &cfg,
+                          int num_superframes) {
+  RcSimulator sim(cfg);
+  for (int i = 0; i < num_superframes; ++i) sim.CodeSuperframe();
+  return sim.qps();
+}
+
+// QPs of the rate control before it was split from the encoder context. The
+// state kept by each instance must reproduce them exactly.
+constexpr int kOneLayerQps[] = {
+  132, 191, 185, 178, 174, 172, 161, 155, 152, 150, 142, 131, 125, 123, 123,
+  124, 126, 125, 126, 128, 171, 134, 133, 133, 135, 138, 135, 132, 133, 135
+};
+
+constexpr int kOneLayerCyclicRefreshQps[] = {
+  132, 191, 185, 178, 174, 172, 161, 155, 152, 150, 142, 131, 126, 124, 124,
+  126, 127, 125, 126, 128, 171, 136, 134, 134, 136, 139, 136, 132, 132, 135
+};
+
+constexpr int kSvcCyclicRefreshQps[] = {
+  212, 158, 158, 154, 151, 156, 150, 150, 150, 150, 150, 154, 150, 150, 146,
+  150, 150, 155, 150, 150, 150, 150, 125, 152, 150, 124, 124, 120, 115, 151,
+  150, 150, 150, 108, 112, 145, 150, 123, 122, 98, 103, 140, 150, 124, 150,
+  86, 101, 137, 150, 110, 110, 74, 92, 133, 120, 114, 145, 61, 90, 130,
+  188, 100, 99, 55, 92, 130, 108, 103, 139, 52, 87, 128, 120, 88, 86,
+  53, 84, 133, 98, 91, 141, 49, 81, 131, 108, 75, 74, 50, 78, 139
+};
+
+void ExpectQps(const std::vector<int> &qps, const int *expected, size_t size) {
+  ASSERT_EQ(qps.size(), size);
+  for (size_t i = 0; i < size; ++i) {
+    EXPECT_EQ(qps[i], expected[i]) << "layer frame " << i;
+  }
+}
+
+TEST(RcInterfaceStateTest, MatchesReference) {
+  ExpectQps(Simulate(OneLayerConfig(0), 30), kOneLayerQps,
+            sizeof(kOneLayerQps) / sizeof(kOneLayerQps[0]));
+  ExpectQps(Simulate(OneLayerConfig(3), 30), kOneLayerCyclicRefreshQps,
+            sizeof(kOneLayerCyclicRefreshQps) /
+                sizeof(kOneLayerCyclicRefreshQps[0]));
+  ExpectQps(Simulate(SvcConfig(3), 30), kSvcCyclicRefreshQps,
+            sizeof(kSvcCyclicRefreshQps) / sizeof(kSvcCyclicRefreshQps[0]));
+}
+
+// Instances share the encoder context of their thread, so interleaving them
+// must not change any of their QPs.
+TEST(RcInterfaceStateTest, InterleavedInstances) {
+  std::vector<aom::AV1RateControlRtcConfig> configs = {
+    OneLayerConfig(0), OneLayerConfig(3), SvcConfig(0), SvcConfig(3)
+  };
+  configs[1].target_bandwidth = 600;
+  configs[1].layer_target_bitrate[0] = 600;
+  configs[3].width = 640;
+  configs[3].height = 360;
+
+  std::vector<std::unique_ptr<RcSimulator>> sims;
+  for (const aom::AV1RateControlRtcConfig &cfg : configs) {
+    sims.emplace_back(new RcSimulator(cfg));
+    ASSERT_TRUE(sims.back()->Initialized());
+  }
+  for (int i = 0; i < 30; ++i) {
+    for (auto &sim : sims) sim->CodeSuperframe();
+  }
+  for (size_t i = 0; i < configs.size(); ++i) {
+    EXPECT_EQ(sims[i]->qps(), Simulate(configs[i], 30)) << "instance " << i;
+  }
+}
+
+TEST(RcInterfaceStateTest, DISABLED_Speed) {
+  constexpr int kNumInstances = 1000;
+  const aom::AV1RateControlRtcConfig cfg = SvcConfig(3);
+  std::vector<std::unique_ptr<aom::AV1RateControlRTC>> instances;
+  instances.reserve(kNumInstances);
+  aom_usec_timer timer;
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < kNumInstances; ++i) {
+    instances.push_back(aom::AV1RateControlRTC::Create(cfg));
+  }
+  aom_usec_timer_mark(&timer);
+  const int64_t create_time = aom_usec_timer_elapsed(&timer);
+  for (const auto &instance : instances) ASSERT_NE(instance, nullptr);
+
+  aom::AV1FrameParamsRTC frame_params;
+  frame_params.frame_type = aom::kInterFrame;
+  frame_params.temporal_layer_id = 0;
+  aom_usec_timer_start(&timer);
+  for (int sl = 0; sl < cfg.ss_number_layers; ++sl) {
+    frame_params.spatial_layer_id = sl;
+    for (const auto &instance : instances) {
+      instance->ComputeQP(frame_params);
+      instance->PostEncodeUpdate(1000);
+    }
+  }
+  aom_usec_timer_mark(&timer);
+  const int64_t frame_time = aom_usec_timer_elapsed(&timer);
+  printf("Create: %.2f us/instance, ComputeQP + PostEncodeUpdate: "
+         "%.2f us/layer frame\n",
+         static_cast<double>(create_time) / kNumInstances,
+         static_cast<double>(frame_time) /
+             (kNumInstances * cfg.ss_number_layers));
+}
+
+// Runs |configs|, which must all have the same number of spatial layers, as
+// one batch and returns the QPs of every stream.
+std::vector<std::vector<int>> SimulateBatch(
+    const std::vector<aom::AV1RateControlRtcConfig> &configs,
+    int num_superframes) {
+  const int num_streams = static_cast<int>(configs.size());
+  std::unique_ptr<aom::AV1RateControlRtcBatch> batch =
+      aom::AV1RateControlRtcBatch::Create(configs.data(), num_streams);
+  EXPECT_NE(batch, nullptr);
+  if (batch == nullptr) return {};
+  EXPECT_EQ(batch->num_streams(), num_streams);
+
+  std::vector<std::vector<int>> qps(num_streams);
+  std::vector<aom::AV1FrameParamsRTC> frame_params(num_streams);
+  std::vector<int> frame_qps(num_streams);
+  std::vector<uint64_t> sizes(num_streams);
+  for (int superframe = 0; superframe < num_superframes; ++superframe) {
+    for (int sl = 0; sl < configs[0].ss_number_layers; ++sl) {
+      for (int i = 0; i < num_streams; ++i) {
+        frame_params[i] = SimFrameParams(configs[i], sl, superframe);
+      }
+      batch->ComputeQP(frame_params.data(), frame_qps.data());
+      for (int i = 0; i < num_streams; ++i) {
+        qps[i].push_back(frame_qps[i]);
+        sizes[i] = ModelFrameSize(
+            configs[i], sl, superframe, frame_qps[i],
+            frame_params[i].frame_type == aom::kKeyFrame);
+      }
+      batch->PostEncodeUpdate(sizes.data());
+    }
+  }
+  return qps;
+}
+
+TEST(RcInterfaceStateTest, BatchMatchesInstances) {
+  std::vector<aom::AV1RateControlRtcConfig> simulcast = { OneLayerConfig(0),
+                                                          OneLayerConfig(3),
+                                                          OneLayerConfig(3) };
+  simulcast[2].width = 640;
+  simulcast[2].height = 360;
+  simulcast[2].target_bandwidth = 400;
+  simulcast[2].layer_target_bitrate[0] = 400;
+  std::vector<aom::AV1RateControlRtcConfig> svc = { SvcConfig(0),
+                                                    SvcConfig(3) };
+  svc[1].width = 640;
+  svc[1].height = 360;
+
+  for (const auto &configs : { simulcast, svc }) {
+    const std::vector<std::vector<int>> qps = SimulateBatch(configs, 30);
+    ASSERT_EQ(qps.size(), configs.size());
+    for (size_t i = 0; i < configs.size(); ++i) {
+      EXPECT_EQ(qps[i], Simulate(configs[i], 30)) << "stream " << i;
+    }
+  }
+}
+
+TEST(RcInterfaceStateTest, DISABLED_BatchSpeed) {
+  constexpr int kNumStreams = 1000;
+  constexpr int kNumFrames = 100;
+  const std::vector<aom::AV1RateControlRtcConfig> configs(kNumStreams,
+                                                          OneLayerConfig(3));
+  std::vector<std::unique_ptr<aom::AV1RateControlRTC>> instances;
+  for (const auto &cfg : configs) {
+    instances.push_back(aom::AV1RateControlRTC::Create(cfg));
+    ASSERT_NE(instances.back(), nullptr);
+  }
+  std::unique_ptr<aom::AV1RateControlRtcBatch> batch =
+      aom::AV1RateControlRtcBatch::Create(configs.data(), kNumStreams);
+  ASSERT_NE(batch, nullptr);
+
+  aom::AV1FrameParamsRTC frame_params;
+  frame_params.frame_type = aom::kInterFrame;
+  frame_params.spatial_layer_id = 0;
+  frame_params.temporal_layer_id = 0;
+  aom_usec_timer timer;
+  aom_usec_timer_start(&timer);
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    for (const auto &instance : instances) {
+      instance->ComputeQP(frame_params);
+      instance->PostEncodeUpdate(3000);
+    }
+  }
+  aom_usec_timer_mark(&timer);
+  const int64_t instance_time = aom_usec_timer_elapsed(&timer);
+
+  const std::vector<aom::AV1FrameParamsRTC> batch_params(kNumStreams,
+                                                         frame_params);
+  const std::vector<uint64_t> sizes(kNumStreams, 3000);
+  std::vector<int> qps(kNumStreams);
+  aom_usec_timer_start(&timer);
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    batch->ComputeQP(batch_params.data(), qps.data());
+    batch->PostEncodeUpdate(sizes.data());
+  }
+  aom_usec_timer_mark(&timer);
+  const int64_t batch_time = aom_usec_timer_elapsed(&timer);
+  printf("ComputeQP + PostEncodeUpdate: %.2f us/frame per instance, "
+         "%.2f us/frame batched\n",
+         static_cast<double>(instance_time) / (kNumStreams * kNumFrames),
+         static_cast<double>(batch_time) / (kNumStreams * kNumFrames));
+}
+
 }  // namespace
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <tuple>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "test/acm_random.h"
+#include "test/function_equivalence_test.h"
+
+using libaom_test::ACMRandom;
+
+namespace {
+const int kNumIterations = 10000;
+const int kMaxStride = 64;
+
+typedef void (*SsimParmsFunc)(const uint8_t *s, int sp, const uint8_t *r,
+                              int rp, uint32_t *sum_s, uint32_t *sum_r,
+                              uint32_t *sum_sq_s, uint32_t *sum_sq_r,
+                              uint32_t *sum_sxr);
+typedef libaom_test::FuncParam<SsimParmsFunc> SsimParmsFuncs;
+
+class SsimParmsTest : public ::testing::TestWithParam<SsimParmsFuncs> {
+ public:
+  virtual void SetUp() {
+    params_ = GetParam();
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+  }
+
+ protected:
+  // Fills s and r with random samples, or with extreme ones when extreme is
+  // set, and checks the sums against the C function.
+  void RunTest(bool extreme) {
+    for (int k = 0; k < kNumIterations; ++k) {
+      const uint8_t s_max = extreme ? 255 : rnd_.Rand8();
+      const uint8_t r_max = extreme ? (rnd_(2) ? 255 : 0) : rnd_.Rand8();
+      for (int i = 0; i < 8 * kMaxStride; ++i) {
+        s_[i] = extreme ? s_max : rnd_(s_max + 1);
+        r_[i] = extreme ? r_max : rnd_(r_max + 1);
+      }
+      const int sp = 8 + rnd_(kMaxStride - 7);
+      const int rp = 8 + rnd_(kMaxStride - 7);
+      // The functions accumulate into the outputs.
+      uint32_t ref[5] = { 1, 2, 3, 4, 5 };
+      uint32_t tst[5] = { 1, 2, 3, 4, 5 };
+      params_.ref_func(s_, sp, r_, rp, &ref[0], &ref[1], &ref[2], &ref[3],
+                       &ref[4]);
+      params_.tst_func(s_, sp, r_, rp, &tst[0], &tst[1], &tst[2], &tst[3],
+                       &tst[4]);
+      for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(ref[i], tst[i]) << "sum " << i << " iteration " << k;
+      }
+    }
+  }
+
+  SsimParmsFuncs params_;
+  ACMRandom rnd_;
+  uint8_t s_[8 * kMaxStride];
+  uint8_t r_[8 * kMaxStride];
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(SsimParmsTest);
+
+TEST_P(SsimParmsTest, RandomValues) { RunTest(false); }
+
+TEST_P(SsimParmsTest, ExtremeValues) { RunTest(true); }
+
+#if HAVE_SSE2 && ARCH_X86_64
+INSTANTIATE_TEST_SUITE_P(
+    SSE2, SsimParmsTest,
+    ::testing::Values(SsimParmsFuncs(&aom_ssim_parms_8x8_c,
+                                     &aom_ssim_parms_8x8_sse2)));
+#endif  // HAVE_SSE2 && ARCH_X86_64
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, SsimParmsTest,
+    ::testing::Values(SsimParmsFuncs(&aom_ssim_parms_8x8_c,
+                                     &aom_ssim_parms_8x8_avx2)));
+#endif  // HAVE_AVX2
+
+#if CONFIG_AV1_HIGHBITDEPTH
+typedef void (*HighbdSsimParmsFunc)(const uint16_t *s, int sp,
+                                    const uint16_t *r, int rp, uint32_t *sum_s,
+                                    uint32_t *sum_r, uint32_t *sum_sq_s,
+                                    uint32_t *sum_sq_r, uint32_t *sum_sxr);
+typedef std::tuple<HighbdSsimParmsFunc, HighbdSsimParmsFunc, int>
+    HighbdSsimParmsParam;
+
+class HighbdSsimParmsTest
+    : public ::testing::TestWithParam<HighbdSsimParmsParam> {
+ public:
+  virtual void SetUp() { rnd_.Reset(ACMRandom::DeterministicSeed()); }
+
+ protected:
+  void RunTest(bool extreme) {
+    const HighbdSsimParmsFunc ref_func = std::get<0>(GetParam());
+    const HighbdSsimParmsFunc tst_func = std::get<1>(GetParam());
+    const int bd = std::get<2>(GetParam());
+    const int mask = (1 << bd) - 1;
+    for (int k = 0; k < kNumIterations; ++k) {
+      const int r_max = rnd_(2) ? mask : 0;
+      for (int i = 0; i < 8 * kMaxStride; ++i) {
+        s_[i] = extreme ? mask : rnd_.Rand16() & mask;
+        r_[i] = extreme ? r_max : rnd_.Rand16() & mask;
+      }
+      const int sp = 8 + rnd_(kMaxStride - 7);
+      const int rp = 8 + rnd_(kMaxStride - 7);
+      uint32_t ref[5] = { 1, 2, 3, 4, 5 };
+      uint32_t tst[5] = { 1, 2, 3, 4, 5 };
+      ref_func(s_, sp, r_, rp, &ref[0], &ref[1], &ref[2], &ref[3], &ref[4]);
+      tst_func(s_, sp, r_, rp, &tst[0], &tst[1], &tst[2], &tst[3], &tst[4]);
+      for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(ref[i], tst[i]) << "sum " << i << " iteration " << k;
+      }
+    }
+  }
+
+  ACMRandom rnd_;
+  uint16_t s_[8 * kMaxStride];
+  uint16_t r_[8 * kMaxStride];
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(HighbdSsimParmsTest);
+
+TEST_P(HighbdSsimParmsTest, RandomValues) { RunTest(false); }
+
+TEST_P(HighbdSsimParmsTest, ExtremeValues) { RunTest(true); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(
+    AVX2, HighbdSsimParmsTest,
+    ::testing::Combine(::testing::Values(&aom_highbd_ssim_parms_8x8_c),
+                       ::testing::Values(&aom_highbd_ssim_parms_8x8_avx2),
+                       ::testing::Values(8, 10, 12)));
+#endif  // HAVE_AVX2
+#endif  // CONFIG_AV1_HIGHBITDEPTH
+
+}  // namespace
@@ -90,6 +90,7 @@ class DatarateTestSVC
     frame_sync_ = 0;
     current_video_frame_ = 0;
     screen_mode_ = 0;
+    reuse_lower_layer_mv_ = 0;
   }
 
   virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
@@ -118,6 +119,8 @@ class DatarateTestSVC
       if (screen_mode_) {
         encoder->Control(AV1E_SET_TUNE_CONTENT, AOM_CONTENT_SCREEN);
       }
+      encoder->Control(AV1E_SET_SVC_REUSE_LOWER_LAYER_MV,
+                       reuse_lower_layer_mv_);
     }
     if (number_spatial_layers_ == 2) {
       spatial_layer_id = (layer_frame_cnt_ % 2 == 0) ? 0 : 1;
@@ -880,6 +883,37 @@ class DatarateTestSVC
     }
   }
 
+  virtual void BasicRateTargetingSVC1TL3SLReuseLowerLayerMVTest() {
+    cfg_.rc_buf_initial_sz = 500;
+    cfg_.rc_buf_optimal_sz = 500;
+    cfg_.rc_buf_sz = 1000;
+    cfg_.rc_dropframe_thresh = 0;
+    cfg_.rc_min_quantizer = 0;
+    cfg_.rc_max_quantizer = 63;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.g_error_resilient = 0;
+
+    ::libaom_test::I420VideoSource video("niklas_640_480_30.yuv", 640, 480, 30,
+                                         1, 0, 300);
+    const int bitrate_array[2] = { 500, 1000 };
+    cfg_.rc_target_bitrate = bitrate_array[GET_PARAM(4)];
+    ResetModel();
+    reuse_lower_layer_mv_ = 1;
+    number_temporal_layers_ = 1;
+    number_spatial_layers_ = 3;
+    target_layer_bitrate_[0] = 1 * cfg_.rc_target_bitrate / 8;
+    target_layer_bitrate_[1] = 3 * cfg_.rc_target_bitrate / 8;
+    target_layer_bitrate_[2] = 4 * cfg_.rc_target_bitrate / 8;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    for (int i = 0; i < number_temporal_layers_ * number_spatial_layers_; i++) {
+      ASSERT_GE(effective_datarate_tl[i], target_layer_bitrate_[i] * 0.80)
+          << " The datarate for the file is lower than target by too much!";
+      ASSERT_LE(effective_datarate_tl[i], target_layer_bitrate_[i] * 1.38)
+          << " The datarate for the file is greater than target by too much!";
+    }
+  }
+
   virtual void BasicRateTargetingSVC1TL3SLMultiRefTest() {
     cfg_.rc_buf_initial_sz = 500;
     cfg_.rc_buf_optimal_sz = 500;
@@ -1721,6 +1755,7 @@ class DatarateTestSVC
   unsigned int frame_sync_;
   unsigned int current_video_frame_;
   int screen_mode_;
+  int reuse_lower_layer_mv_;
 };
 
 // Check basic rate targeting for CBR, for 3 temporal layers, 1 spatial.
@@ -1777,6 +1812,13 @@ TEST_P(DatarateTestSVC, BasicRateTargetingSVC1TL3SL) {
   BasicRateTargetingSVC1TL3SLTest();
 }
 
+// Check basic rate targeting for CBR, for 3 spatial layers, 1 temporal,
+// with the motion vectors of the lower spatial layer seeding the motion
+// search of the upper layers.
+TEST_P(DatarateTestSVC, BasicRateTargetingSVC1TL3SLReuseLowerLayerMV) {
+  BasicRateTargetingSVC1TL3SLReuseLowerLayerMVTest();
+}
+
 // Check basic rate targeting for CBR, for 3 spatial layers, 1 temporal,
 // with additional temporal reference for top spatial layer.
 TEST_P(DatarateTestSVC, BasicRateTargetingSVC1TL3SLMultiRef) {
@@ -239,6 +239,12 @@ webm_io_available() {
   [ "$(aom_config_option_enabled CONFIG_WEBM_IO)" = "yes" ] && echo yes
 }
 
+# Echoes yes to stdout when aom_config_option_enabled() reports yes for
+# CONFIG_MULTITHREAD.
+multithread_available() {
+  [ "$(aom_config_option_enabled CONFIG_MULTITHREAD)" = "yes" ] && echo yes
+}
+
 # Echoes yes to stdout when aom_config_option_enabled() reports yes for
 # CONFIG_REALTIME_ONLY.
 realtime_only_build() {
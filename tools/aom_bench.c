@@ -0,0 +1,582 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Encoder benchmark. Encodes a clip held in memory for every combination of
+// the requested usages, speeds, thread counts and resolutions, and writes a
+// JSON report with the throughput, the time spent in each encoder stage, the
+// CPU time and peak memory of every configuration.
+//
+// The clip is either read from a local Y4M file or synthesized, so no test
+// vectors are needed and the same command line always encodes the same
+// frames. Reports of two builds can be compared to catch speed regressions.
+//
+// Command line: ./aom_bench --usage=good,rt --cpu-used=4,6 --threads=1,4
+//                           --resolutions=640x360,1280x720 -o report.json
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/aom_timer.h"
+#include "common/args.h"
+#include "common/tools_common.h"
+#include "common/y4minput.h"
+
+#define MAX_LIST_SIZE 16
+#define DEFAULT_FRAMES 30
+
+static const arg_def_t input_arg =
+    ARG_DEF("i", "input", 1, "Y4M input file (default: synthesized clip)");
+static const arg_def_t output_arg =
+    ARG_DEF("o", "output", 1, "JSON report file (default: stdout)");
+static const arg_def_t limit_arg =
+    ARG_DEF(NULL, "limit", 1, "Number of frames to encode (default: 30)");
+static const arg_def_t usage_arg =
+    ARG_DEF("u", "usage", 1, "Comma separated usages: good, rt, allintra");
+static const arg_def_t cpu_used_arg =
+    ARG_DEF(NULL, "cpu-used", 1, "Comma separated speeds (default: 6)");
+static const arg_def_t threads_arg =
+    ARG_DEF("t", "threads", 1, "Comma separated thread counts (default: 1)");
+static const arg_def_t resolutions_arg =
+    ARG_DEF("r", "resolutions", 1,
+            "Comma separated WxH sizes of the synthesized clip "
+            "(default: 352x288)");
+static const arg_def_t bitrate_arg =
+    ARG_DEF(NULL, "target-bitrate", 1,
+            "Bitrate in kbps (default: the default of the usage)");
+static const arg_def_t repeat_arg =
+    ARG_DEF(NULL, "repeat", 1,
+            "Runs of each configuration, the fastest is reported (default: 1)");
+
+static const arg_def_t *bench_args[] = { &input_arg,       &output_arg,
+                                         &limit_arg,       &usage_arg,
+                                         &cpu_used_arg,    &threads_arg,
+                                         &resolutions_arg, &bitrate_arg,
+                                         &repeat_arg,      NULL };
+
+static const char *exec_name;
+
+void usage_exit(void) {
+  fprintf(stderr, "Usage: %s <options>\n", exec_name);
+  fprintf(stderr, "Options:\n");
+  arg_show_usage(stderr, bench_args);
+  exit(EXIT_FAILURE);
+}
+
+static const struct {
+  const char *name;
+  unsigned int usage;
+} usage_names[] = {
+  { "good", AOM_USAGE_GOOD_QUALITY },
+  { "rt", AOM_USAGE_REALTIME },
+  { "allintra", AOM_USAGE_ALL_INTRA },
+};
+
+// Names of the stages of aom_enc_stage_t in the report.
+static const char *const stage_names[AOM_ENC_STAGE_COUNT] = {
+  "first_pass",     "temporal_filter", "tpl",
+  "global_motion",  "encode",          "loop_filter",
+  "cdef_search",    "cdef",            "loop_restoration",
+  "pack_bitstream", "metrics",
+};
+
+typedef struct {
+  const char *input_filename;
+  const char *output_filename;
+  int limit;
+  int repeat;
+  unsigned int target_bitrate;
+  int usages[MAX_LIST_SIZE];
+  int num_usages;
+  int cpu_used[MAX_LIST_SIZE];
+  int num_cpu_used;
+  int threads[MAX_LIST_SIZE];
+  int num_threads;
+  int widths[MAX_LIST_SIZE];
+  int heights[MAX_LIST_SIZE];
+  int num_resolutions;
+} BenchConfig;
+
+// A clip held in memory, so that reading the input is not measured.
+typedef struct {
+  aom_image_t *frames;
+  int num_frames;
+  int bit_depth;
+  struct aom_rational timebase;
+} Clip;
+
+typedef struct {
+  size_t bytes;
+  int64_t encode_us;
+  int64_t cpu_us;
+  int64_t peak_rss_kb;
+  aom_enc_stage_times_t stage_times;
+} BenchResult;
+
+static const char *usage_name(unsigned int usage) {
+  for (size_t i = 0; i < sizeof(usage_names) / sizeof(usage_names[0]); ++i) {
+    if (usage_names[i].usage == usage) return usage_names[i].name;
+  }
+  return "unknown";
+}
+
+static int parse_usages(const char *val, int *usages) {
+  int n = 0;
+  while (*val != '\0') {
+    const size_t len = strcspn(val, ",");
+    size_t i;
+    for (i = 0; i < sizeof(usage_names) / sizeof(usage_names[0]); ++i) {
+      if (strlen(usage_names[i].name) == len &&
+          !strncmp(val, usage_names[i].name, len)) {
+        break;
+      }
+    }
+    if (i == sizeof(usage_names) / sizeof(usage_names[0]))
+      die("Unknown usage in '%s'.", val);
+    if (n == MAX_LIST_SIZE) die("Too many usages.");
+    usages[n++] = (int)usage_names[i].usage;
+    val += len;
+    if (*val == ',') ++val;
+  }
+  return n;
+}
+
+static int parse_resolutions(const char *val, int *widths, int *heights) {
+  int n = 0;
+  while (*val != '\0') {
+    char *end;
+    if (n == MAX_LIST_SIZE) die("Too many resolutions.");
+    widths[n] = (int)strtol(val, &end, 10);
+    if (*end != 'x') die("Bad resolution '%s', expected WxH.", val);
+    heights[n] = (int)strtol(end + 1, &end, 10);
+    if (widths[n] <= 0 || heights[n] <= 0 || (*end != ',' && *end != '\0'))
+      die("Bad resolution '%s', expected WxH.", val);
+    ++n;
+    val = *end == ',' ? end + 1 : end;
+  }
+  return n;
+}
+
+static void parse_command_line(int argc, const char **argv_,
+                               BenchConfig *config) {
+  struct arg arg;
+  char **argv = argv_dup(argc - 1, argv_ + 1);
+  char **argi;
+  char **argj;
+  if (!argv) fatal("Error allocating argument list");
+
+  memset(config, 0, sizeof(*config));
+  config->limit = DEFAULT_FRAMES;
+  config->repeat = 1;
+#if CONFIG_REALTIME_ONLY
+  config->num_usages = parse_usages("rt", config->usages);
+#else
+  config->num_usages = parse_usages("good,rt,allintra", config->usages);
+#endif
+  config->cpu_used[0] = 6;
+  config->num_cpu_used = 1;
+  config->threads[0] = 1;
+  config->num_threads = 1;
+  config->widths[0] = 352;
+  config->heights[0] = 288;
+  config->num_resolutions = 1;
+
+  for (argi = argj = argv; (*argj = *argi); argi += arg.argv_step) {
+    arg.argv_step = 1;
+    if (arg_match(&arg, &input_arg, argi)) {
+      config->input_filename = arg.val;
+    } else if (arg_match(&arg, &output_arg, argi)) {
+      config->output_filename = arg.val;
+    } else if (arg_match(&arg, &limit_arg, argi)) {
+      config->limit = arg_parse_int(&arg);
+    } else if (arg_match(&arg, &repeat_arg, argi)) {
+      config->repeat = arg_parse_int(&arg);
+    } else if (arg_match(&arg, &bitrate_arg, argi)) {
+      config->target_bitrate = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &usage_arg, argi)) {
+      config->num_usages = parse_usages(arg.val, config->usages);
+    } else if (arg_match(&arg, &cpu_used_arg, argi)) {
+      config->num_cpu_used =
+          arg_parse_list(&arg, config->cpu_used, MAX_LIST_SIZE);
+    } else if (arg_match(&arg, &threads_arg, argi)) {
+      config->num_threads =
+          arg_parse_list(&arg, config->threads, MAX_LIST_SIZE);
+    } else if (arg_match(&arg, &resolutions_arg, argi)) {
+      config->num_resolutions =
+          parse_resolutions(arg.val, config->widths, config->heights);
+    } else {
+      ++argj;
+    }
+  }
+  if (argv[0] != NULL) die("Unrecognized option: %s", argv[0]);
+  free(argv);
+
+  if (config->limit <= 0) die("--limit must be positive.");
+  if (config->repeat <= 0) die("--repeat must be positive.");
+  if (!config->num_usages || !config->num_cpu_used || !config->num_threads ||
+      !config->num_resolutions) {
+    die("Every swept list needs at least one entry.");
+  }
+  for (int i = 0; i < config->num_threads; ++i) {
+    if (config->threads[i] <= 0) die("Thread counts must be positive.");
+  }
+}
+
+// Fills |img| with frame |index| of a synthetic clip: a textured background
+// panning to the right with two blocks moving across it in opposite
+// directions. The pixels only depend on the size and the index.
+static void synthesize_frame(aom_image_t *img, int index) {
+  const int w = (int)img->d_w;
+  const int h = (int)img->d_h;
+  const int block_size = AOMMAX(h / 4, 8);
+  const int block0_x = (index * 4) % AOMMAX(w - block_size, 1);
+  const int block1_x = AOMMAX(w - block_size - (index * 3) % w, 0);
+
+  for (int y = 0; y < h; ++y) {
+    uint8_t *const row = img->planes[AOM_PLANE_Y] + y * img->stride[0];
+    for (int x = 0; x < w; ++x) {
+      const int bx = x - 2 * index;
+      const unsigned int hash = (unsigned int)(bx * 73856093) ^
+                                (unsigned int)(y * 19349663);
+      int v = 64 + ((bx * 3 + y * 5) & 0x7f) + ((hash >> 7) & 0x1f);
+      if (y >= h / 4 && y < h / 4 + block_size && x >= block0_x &&
+          x < block0_x + block_size) {
+        v = 200 + ((x - block0_x) ^ (y - h / 4)) % 32;
+      } else if (y >= h / 2 && y < h / 2 + block_size && x >= block1_x &&
+                 x < block1_x + block_size) {
+        v = 24 + ((x - block1_x) * (y - h / 2)) % 24;
+      }
+      row[x] = (uint8_t)v;
+    }
+  }
+  for (int plane = AOM_PLANE_U; plane <= AOM_PLANE_V; ++plane) {
+    const int cw = (w + img->x_chroma_shift) >> img->x_chroma_shift;
+    const int ch = (h + img->y_chroma_shift) >> img->y_chroma_shift;
+    for (int y = 0; y < ch; ++y) {
+      uint8_t *const row = img->planes[plane] + y * img->stride[plane];
+      for (int x = 0; x < cw; ++x) {
+        row[x] = (uint8_t)(plane == AOM_PLANE_U ? 96 + (x + index) % 64
+                                                : 160 - (y + index) % 48);
+      }
+    }
+  }
+}
+
+static void synthesize_clip(Clip *clip, int width, int height,
+                            int num_frames) {
+  clip->frames = (aom_image_t *)calloc(num_frames, sizeof(*clip->frames));
+  if (!clip->frames) fatal("Failed to allocate the clip.");
+  for (int i = 0; i < num_frames; ++i) {
+    if (!aom_img_alloc(&clip->frames[i], AOM_IMG_FMT_I420, width, height, 32))
+      fatal("Failed to allocate a frame.");
+    synthesize_frame(&clip->frames[i], i);
+  }
+  clip->num_frames = num_frames;
+  clip->bit_depth = 8;
+  clip->timebase.num = 1;
+  clip->timebase.den = 30;
+}
+
+static void copy_image(const aom_image_t *src, aom_image_t *dst) {
+  const int bytes_per_sample = (src->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? (int)((src->d_w + src->x_chroma_shift) >>
+                                src->x_chroma_shift)
+                        : (int)src->d_w;
+    const int h = plane ? (int)((src->d_h + src->y_chroma_shift) >>
+                                src->y_chroma_shift)
+                        : (int)src->d_h;
+    for (int y = 0; y < h; ++y) {
+      memcpy(dst->planes[plane] + y * dst->stride[plane],
+             src->planes[plane] + y * src->stride[plane],
+             (size_t)w * bytes_per_sample);
+    }
+  }
+}
+
+static void read_y4m_clip(Clip *clip, const char *filename, int limit) {
+  FILE *const file = fopen(filename, "rb");
+  y4m_input y4m;
+  aom_image_t img;
+  if (!file) fatal("Failed to open %s.", filename);
+  if (y4m_input_open(&y4m, file, NULL, 0, AOM_CSP_UNKNOWN, 0) < 0)
+    fatal("%s is not a supported Y4M file.", filename);
+  if (y4m.aom_fmt != AOM_IMG_FMT_I420 && y4m.aom_fmt != AOM_IMG_FMT_I42016)
+    fatal("Only 4:2:0 Y4M input is supported.");
+
+  clip->frames = (aom_image_t *)calloc(limit, sizeof(*clip->frames));
+  if (!clip->frames) fatal("Failed to allocate the clip.");
+  memset(&img, 0, sizeof(img));
+  clip->num_frames = 0;
+  while (clip->num_frames < limit && y4m_input_fetch_frame(&y4m, file, &img)) {
+    aom_image_t *const frame = &clip->frames[clip->num_frames++];
+    if (!aom_img_alloc(frame, img.fmt, img.d_w, img.d_h, 32))
+      fatal("Failed to allocate a frame.");
+    copy_image(&img, frame);
+    frame->bit_depth = y4m.bit_depth;
+  }
+  if (clip->num_frames == 0)
+    fatal("No frames could be read from %s.", filename);
+  clip->bit_depth = (int)y4m.bit_depth;
+  clip->timebase.num = y4m.fps_d;
+  clip->timebase.den = y4m.fps_n;
+  y4m_input_close(&y4m);
+  fclose(file);
+}
+
+static void free_clip(Clip *clip) {
+  for (int i = 0; i < clip->num_frames; ++i) aom_img_free(&clip->frames[i]);
+  free(clip->frames);
+  memset(clip, 0, sizeof(*clip));
+}
+
+// Returns the user and system time used by the process in microseconds, or -1
+// if it is not available.
+static int64_t get_cpu_time_us(void) {
+#if !defined(_WIN32)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+  return ((int64_t)usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#else
+  return -1;
+#endif
+}
+
+// Restarts the tracking of the peak resident set size, so that the next
+// get_peak_rss_kb() only covers what follows. Only Linux can do this; on
+// other systems the peak of the whole run so far is reported.
+static void reset_peak_rss(void) {
+#if defined(__linux__)
+  FILE *const file = fopen("/proc/self/clear_refs", "w");
+  if (file) {
+    fputs("5", file);
+    fclose(file);
+  }
+#endif
+}
+
+// Returns the peak resident set size of the process in KiB, or -1 if it is
+// not available.
+static int64_t get_peak_rss_kb(void) {
+#if defined(__linux__)
+  char line[128];
+  int64_t peak = -1;
+  FILE *const file = fopen("/proc/self/status", "r");
+  if (!file) return -1;
+  while (fgets(line, sizeof(line), file)) {
+    if (!strncmp(line, "VmHWM:", 6)) {
+      peak = strtoll(line + 6, NULL, 10);
+      break;
+    }
+  }
+  fclose(file);
+  return peak;
+#elif !defined(_WIN32)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(__APPLE__)
+  return (int64_t)usage.ru_maxrss / 1024;
+#else
+  return (int64_t)usage.ru_maxrss;
+#endif
+#else
+  return -1;
+#endif
+}
+
+static size_t get_frame_bytes(aom_codec_ctx_t *codec) {
+  aom_codec_iter_t iter = NULL;
+  const aom_codec_cx_pkt_t *pkt;
+  size_t bytes = 0;
+  while ((pkt = aom_codec_get_cx_data(codec, &iter)) != NULL) {
+    if (pkt->kind == AOM_CODEC_CX_FRAME_PKT) bytes += pkt->data.frame.sz;
+  }
+  return bytes;
+}
+
+// Encodes |clip| once with the given settings and fills |result|.
+static void run_encode(const Clip *clip, const BenchConfig *config,
+                       unsigned int usage, int cpu_used, int threads,
+                       BenchResult *result) {
+  aom_codec_iface_t *const iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t codec;
+  struct aom_usec_timer timer;
+  const aom_image_t *const first = &clip->frames[0];
+  aom_codec_flags_t flags = 0;
+
+  if (aom_codec_enc_config_default(iface, &cfg, usage) != AOM_CODEC_OK)
+    fatal("Usage %s is not supported by this build.", usage_name(usage));
+  cfg.g_w = first->d_w;
+  cfg.g_h = first->d_h;
+  cfg.g_timebase = clip->timebase;
+  cfg.g_threads = threads;
+  cfg.g_bit_depth = (aom_bit_depth_t)clip->bit_depth;
+  cfg.g_input_bit_depth = clip->bit_depth;
+  if (config->target_bitrate) cfg.rc_target_bitrate = config->target_bitrate;
+  if (first->fmt & AOM_IMG_FMT_HIGHBITDEPTH)
+    flags |= AOM_CODEC_USE_HIGHBITDEPTH;
+
+  memset(result, 0, sizeof(*result));
+  reset_peak_rss();
+  const int64_t cpu_start = get_cpu_time_us();
+  aom_usec_timer_start(&timer);
+
+  if (aom_codec_enc_init(&codec, iface, &cfg, flags))
+    fatal("Failed to initialize encoder");
+  if (aom_codec_control(&codec, AOME_SET_CPUUSED, cpu_used))
+    die_codec(&codec, "Failed to set cpu-used");
+  for (int i = 0; i < clip->num_frames; ++i) {
+    if (aom_codec_encode(&codec, &clip->frames[i], i, 1, 0))
+      die_codec(&codec, "Failed to encode frame");
+    result->bytes += get_frame_bytes(&codec);
+  }
+  // Flush the frames held back for lookahead.
+  size_t bytes;
+  do {
+    if (aom_codec_encode(&codec, NULL, -1, 0, 0))
+      die_codec(&codec, "Failed to flush encoder");
+    bytes = get_frame_bytes(&codec);
+    result->bytes += bytes;
+  } while (bytes > 0);
+
+  aom_usec_timer_mark(&timer);
+  const int64_t cpu_end = get_cpu_time_us();
+  result->encode_us = aom_usec_timer_elapsed(&timer);
+  result->cpu_us = cpu_start >= 0 && cpu_end >= 0 ? cpu_end - cpu_start : -1;
+  result->peak_rss_kb = get_peak_rss_kb();
+  if (aom_codec_control(&codec, AV1E_GET_STAGE_TIMES, &result->stage_times))
+    die_codec(&codec, "Failed to get the stage times");
+  if (aom_codec_destroy(&codec)) die_codec(&codec, "Failed to destroy codec");
+}
+
+static void print_json_string(FILE *out, const char *str) {
+  fputc('"', out);
+  for (; *str != '\0'; ++str) {
+    if (*str == '"' || *str == '\\') fputc('\\', out);
+    fputc(*str, out);
+  }
+  fputc('"', out);
+}
+
+static void print_result(FILE *out, const Clip *clip, unsigned int usage,
+                         int cpu_used, int threads, const BenchResult *result,
+                         int is_first) {
+  const double encode_s = result->encode_us / 1000000.0;
+  fprintf(out, "%s\n    {\n", is_first ? "" : ",");
+  fprintf(out, "      \"usage\": \"%s\",\n", usage_name(usage));
+  fprintf(out, "      \"cpu_used\": %d,\n", cpu_used);
+  fprintf(out, "      \"threads\": %d,\n", threads);
+  fprintf(out, "      \"width\": %u,\n", clip->frames[0].d_w);
+  fprintf(out, "      \"height\": %u,\n", clip->frames[0].d_h);
+  fprintf(out, "      \"frames\": %d,\n", clip->num_frames);
+  fprintf(out, "      \"bytes\": %zu,\n", result->bytes);
+  fprintf(out, "      \"encode_ms\": %.3f,\n", result->encode_us / 1000.0);
+  fprintf(out, "      \"fps\": %.3f,\n",
+          encode_s > 0 ? clip->num_frames / encode_s : 0.0);
+  if (result->cpu_us >= 0) {
+    fprintf(out, "      \"cpu_ms\": %.3f,\n", result->cpu_us / 1000.0);
+    // Share of the time the encoder threads could have run that they did.
+    fprintf(out, "      \"thread_utilization\": %.3f,\n",
+            result->encode_us > 0
+                ? (double)result->cpu_us / result->encode_us / threads
+                : 0.0);
+  } else {
+    fprintf(out, "      \"cpu_ms\": null,\n");
+    fprintf(out, "      \"thread_utilization\": null,\n");
+  }
+  if (result->peak_rss_kb >= 0) {
+    fprintf(out, "      \"peak_rss_kb\": %" PRId64 ",\n", result->peak_rss_kb);
+  } else {
+    fprintf(out, "      \"peak_rss_kb\": null,\n");
+  }
+  fprintf(out, "      \"stage_ms\": {");
+  for (int i = 0; i < AOM_ENC_STAGE_COUNT; ++i) {
+    fprintf(out, "%s\n        \"%s\": %.3f", i ? "," : "", stage_names[i],
+            result->stage_times.time_us[i] / 1000.0);
+  }
+  fprintf(out, "\n      }\n    }");
+}
+
+int main(int argc, const char **argv) {
+  BenchConfig config;
+  FILE *out = stdout;
+  int num_results = 0;
+
+  exec_name = argv[0];
+  parse_command_line(argc, argv, &config);
+  if (config.output_filename) {
+    out = fopen(config.output_filename, "w");
+    if (!out) fatal("Failed to open %s for writing.", config.output_filename);
+  }
+
+  fprintf(out, "{\n  \"version\": ");
+  print_json_string(out, aom_codec_version_str());
+  fprintf(out, ",\n  \"input\": ");
+  print_json_string(out, config.input_filename ? config.input_filename
+                                               : "synthetic");
+  fprintf(out, ",\n  \"repeat\": %d,\n  \"results\": [", config.repeat);
+
+  // A Y4M input has a single resolution.
+  const int num_resolutions =
+      config.input_filename ? 1 : config.num_resolutions;
+  for (int r = 0; r < num_resolutions; ++r) {
+    Clip clip;
+    if (config.input_filename) {
+      read_y4m_clip(&clip, config.input_filename, config.limit);
+    } else {
+      synthesize_clip(&clip, config.widths[r], config.heights[r],
+                      config.limit);
+    }
+    for (int u = 0; u < config.num_usages; ++u) {
+      const unsigned int usage = (unsigned int)config.usages[u];
+      for (int c = 0; c < config.num_cpu_used; ++c) {
+        for (int t = 0; t < config.num_threads; ++t) {
+          BenchResult best;
+          run_encode(&clip, &config, usage, config.cpu_used[c],
+                     config.threads[t], &best);
+          for (int i = 1; i < config.repeat; ++i) {
+            BenchResult result;
+            run_encode(&clip, &config, usage, config.cpu_used[c],
+                       config.threads[t], &result);
+            if (result.encode_us < best.encode_us) best = result;
+          }
+          fprintf(stderr, "%s cpu-used=%d threads=%d %ux%u: %.2f fps\n",
+                  usage_name(usage), config.cpu_used[c], config.threads[t],
+                  clip.frames[0].d_w, clip.frames[0].d_h,
+                  best.encode_us > 0
+                      ? clip.num_frames * 1000000.0 / best.encode_us
+                      : 0.0);
+          print_result(out, &clip, usage, config.cpu_used[c],
+                       config.threads[t], &best, num_results++ == 0);
+          fflush(out);
+        }
+      }
+    }
+    free_clip(&clip);
+  }
+
+  fprintf(out, "\n  ]\n}\n");
+  if (out != stdout) fclose(out);
+  return EXIT_SUCCESS;
+}
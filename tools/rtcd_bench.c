@@ -0,0 +1,678 @@
+/*
+ * Copyright (c) 2022, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Microbenchmark of the functions with run time CPU detection. Times the C
+// version and every specialized version of the functions declared in
+// aom_dsp_rtcd_defs.pl, av1_rtcd_defs.pl and aom_scale_rtcd.pl, and prints the
+// speedup of each version over C, then the slowest kernels that lack a
+// version for the best instruction set of the CPU.
+//
+// The tables of functions are generated by rtcd.pl --bench, which picks the
+// arguments of each function from their types and names: random buffers for
+// pointers, the benchmarked block size for widths, heights and counts, and
+// fixed settings for strides and structures. Functions whose name includes a
+// block size are timed on that size only, the others on each of --sizes.
+// Functions with arguments it cannot fill are listed at the end.
+//
+// Every version runs in a child process where fork() is available, so one
+// that crashes on the generic data is reported without stopping the run.
+//
+// Command line: ./rtcd_bench --filter=sad,variance --min-time=20
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#if !defined(_WIN32)
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
+#include "aom_scale/yv12config.h"
+#include "av1/common/blockd.h"
+#include "av1/common/common_data.h"
+#include "av1/common/convolve.h"
+#include "av1/common/filter.h"
+#include "av1/common/restoration.h"
+#include "common/args.h"
+#include "common/tools_common.h"
+
+#if ARCH_X86 || ARCH_X86_64
+#include "aom_ports/x86.h"
+#elif ARCH_ARM
+#include "aom_ports/arm.h"
+#elif ARCH_PPC
+#include "aom_ports/ppc.h"
+#endif
+
+#define RTCD_BENCH_MAX_BUFS 16
+#define RTCD_BENCH_MAX_VARIANTS 12
+#define RTCD_BENCH_MAX_SIZES 16
+
+// Buffers are RTCD_BENCH_ROWS rows of RTCD_BENCH_STRIDE elements, and passed
+// with a margin above and to the left for the functions that read the
+// neighbors of a block.
+#define RTCD_BENCH_STRIDE 256
+#define RTCD_BENCH_ROWS 256
+#define RTCD_BENCH_OFFSET (32 * RTCD_BENCH_STRIDE + 64)
+#define RTCD_BENCH_FRAME_WIDTH 352
+#define RTCD_BENCH_FRAME_HEIGHT 288
+
+// Types of the elements of the buffers.
+enum {
+  RTCD_BENCH_U8 = 1,
+  RTCD_BENCH_U16,
+  RTCD_BENCH_U32,
+  RTCD_BENCH_U64,
+  RTCD_BENCH_F32,
+  RTCD_BENCH_F64,
+};
+
+typedef void (*rtcd_bench_fn)(void);
+
+// Arguments of the benchmarked functions.
+typedef struct {
+  void *buf[RTCD_BENCH_MAX_BUFS];
+  // Pointers to 4 blocks of buf[k], for the functions that take an array of
+  // reference blocks, as is and converted with CONVERT_TO_BYTEPTR().
+  uint8_t *blocks[RTCD_BENCH_MAX_BUFS][4];
+  uint8_t *blocks_hbd[RTCD_BENCH_MAX_BUFS][4];
+  int w;
+  int h;
+  int stride;
+  int bd;
+  BLOCK_SIZE bsize;
+  TX_SIZE tx_size;
+  const int16_t *filter;
+  const InterpFilterParams *filter_params;
+  ConvolveParams conv_params;
+  DIST_WTD_COMP_PARAMS jcp_param;
+  TxfmParam txfm_param;
+  const sgr_params_type *sgr_params;
+  YV12_BUFFER_CONFIG frames[2];
+} RtcdBenchArgs;
+
+typedef struct {
+  const char *isa;
+  // HAS_* flag of the instruction set, 0 if it is always available.
+  int flag;
+  rtcd_bench_fn fn;
+} RtcdBenchVariant;
+
+typedef struct {
+  const char *name;
+  void (*bench)(rtcd_bench_fn fn, const RtcdBenchArgs *a);
+  // Block size in the name of the function, 0 if there is none.
+  int w;
+  int h;
+  // Whether the work depends on the benchmarked block size.
+  int sized;
+  int bufs[RTCD_BENCH_MAX_BUFS];
+  RtcdBenchVariant variants[RTCD_BENCH_MAX_VARIANTS];
+} RtcdBenchKernel;
+
+typedef struct {
+  const char *name;
+  const char *arg;
+} RtcdBenchSkipped;
+
+#include "config/aom_dsp_rtcd_bench.h"
+#include "config/aom_scale_rtcd_bench.h"
+#include "config/av1_rtcd_bench.h"
+
+static const struct {
+  const RtcdBenchKernel *kernels;
+  int num_kernels;
+  const RtcdBenchSkipped *skipped;
+  int num_skipped;
+} kernel_tables[] = {
+  { aom_dsp_rtcd_bench_kernels, NELEMENTS(aom_dsp_rtcd_bench_kernels),
+    aom_dsp_rtcd_bench_skipped, NELEMENTS(aom_dsp_rtcd_bench_skipped) },
+  { av1_rtcd_bench_kernels, NELEMENTS(av1_rtcd_bench_kernels),
+    av1_rtcd_bench_skipped, NELEMENTS(av1_rtcd_bench_skipped) },
+  { aom_scale_rtcd_bench_kernels, NELEMENTS(aom_scale_rtcd_bench_kernels),
+    aom_scale_rtcd_bench_skipped, NELEMENTS(aom_scale_rtcd_bench_skipped) },
+};
+
+static const arg_def_t filter_arg =
+    ARG_DEF("f", "filter", 1,
+            "Comma separated substrings of the functions to run "
+            "(default: all)");
+static const arg_def_t sizes_arg =
+    ARG_DEF("s", "sizes", 1,
+            "Comma separated WxH block sizes of the functions without a size "
+            "in their name (default: 8x8,16x16,32x32,64x64)");
+static const arg_def_t min_time_arg =
+    ARG_DEF(NULL, "min-time", 1,
+            "Minimum time of each measurement in ms (default: 10)");
+static const arg_def_t missing_arg =
+    ARG_DEF(NULL, "missing", 1,
+            "Instruction set whose missing versions are listed (default: the "
+            "best one of the CPU)");
+static const arg_def_t csv_arg =
+    ARG_DEF(NULL, "csv", 0, "Print kernel,size,isa,ns,speedup lines");
+static const arg_def_t no_fork_arg =
+    ARG_DEF(NULL, "no-fork", 0, "Run the functions in the main process");
+
+static const arg_def_t *bench_args[] = { &filter_arg,  &sizes_arg,
+                                         &min_time_arg, &missing_arg,
+                                         &csv_arg,     &no_fork_arg,
+                                         NULL };
+
+static const char *exec_name;
+
+void usage_exit(void) {
+  fprintf(stderr, "Usage: %s <options>\n", exec_name);
+  fprintf(stderr, "Options:\n");
+  arg_show_usage(stderr, bench_args);
+  exit(EXIT_FAILURE);
+}
+
+typedef struct {
+  const char *filter;
+  const char *missing_isa;
+  int widths[RTCD_BENCH_MAX_SIZES];
+  int heights[RTCD_BENCH_MAX_SIZES];
+  int num_sizes;
+  int min_time_us;
+  int csv;
+  int use_fork;
+} BenchConfig;
+
+// Results of one version.
+enum {
+  RESULT_OK,
+  RESULT_MISSING,      // The function has no version for the instruction set.
+  RESULT_UNSUPPORTED,  // The CPU lacks the instruction set.
+  RESULT_CRASHED,
+};
+
+typedef struct {
+  int status;
+  double ns;
+} VariantResult;
+
+// A kernel that lacks a version of the instruction set --missing.
+typedef struct {
+  const char *name;
+  int w;
+  int h;
+  double c_ns;
+} MissingKernel;
+
+// Instruction sets of all the tables, in the order of rtcd.pl.
+static const char *isas[RTCD_BENCH_MAX_VARIANTS];
+static int isa_flags[RTCD_BENCH_MAX_VARIANTS];
+static int num_isas;
+
+static int get_cpu_caps(void) {
+#if ARCH_X86 || ARCH_X86_64
+  return x86_simd_caps();
+#elif ARCH_ARM
+  return aom_arm_cpu_caps();
+#elif ARCH_PPC
+  return ppc_simd_caps();
+#else
+  return 0;
+#endif
+}
+
+static int parse_sizes(const char *val, int *widths, int *heights) {
+  int n = 0;
+  while (*val != '\0') {
+    char *end;
+    if (n == RTCD_BENCH_MAX_SIZES) die("Too many sizes.");
+    widths[n] = (int)strtol(val, &end, 10);
+    if (*end != 'x') die("Bad size '%s', expected WxH.", val);
+    heights[n] = (int)strtol(end + 1, &end, 10);
+    if (*end != ',' && *end != '\0') die("Bad size '%s', expected WxH.", val);
+    int bsize;
+    for (bsize = 0; bsize < BLOCK_SIZES_ALL; ++bsize) {
+      if (block_size_wide[bsize] == widths[n] &&
+          block_size_high[bsize] == heights[n]) {
+        break;
+      }
+    }
+    if (bsize == BLOCK_SIZES_ALL) die("%s is not a block size.", val);
+    ++n;
+    val = *end == ',' ? end + 1 : end;
+  }
+  return n;
+}
+
+static void parse_command_line(int argc, const char **argv_,
+                               BenchConfig *config) {
+  struct arg arg;
+  char **argv = argv_dup(argc - 1, argv_ + 1);
+  char **argi;
+  char **argj;
+  if (!argv) fatal("Error allocating argument list");
+
+  memset(config, 0, sizeof(*config));
+  config->num_sizes =
+      parse_sizes("8x8,16x16,32x32,64x64", config->widths, config->heights);
+  config->min_time_us = 10000;
+#if !defined(_WIN32)
+  config->use_fork = 1;
+#endif
+
+  for (argi = argj = argv; (*argj = *argi); argi += arg.argv_step) {
+    arg.argv_step = 1;
+    if (arg_match(&arg, &filter_arg, argi)) {
+      config->filter = arg.val;
+    } else if (arg_match(&arg, &sizes_arg, argi)) {
+      config->num_sizes = parse_sizes(arg.val, config->widths, config->heights);
+    } else if (arg_match(&arg, &min_time_arg, argi)) {
+      config->min_time_us = arg_parse_int(&arg) * 1000;
+    } else if (arg_match(&arg, &missing_arg, argi)) {
+      config->missing_isa = arg.val;
+    } else if (arg_match(&arg, &csv_arg, argi)) {
+      config->csv = 1;
+    } else if (arg_match(&arg, &no_fork_arg, argi)) {
+      config->use_fork = 0;
+    } else {
+      ++argj;
+    }
+  }
+  if (argv[0] != NULL) die("Unrecognized option: %s", argv[0]);
+  free(argv);
+
+  if (config->min_time_us <= 0) die("--min-time must be positive.");
+  if (!config->num_sizes) die("--sizes needs at least one entry.");
+}
+
+static int match_filter(const char *filter, const char *name) {
+  if (filter == NULL) return 1;
+  while (*filter != '\0') {
+    const size_t len = strcspn(filter, ",");
+    const char *s;
+    for (s = name; *s != '\0'; ++s) {
+      if (!strncmp(s, filter, len)) return 1;
+    }
+    filter += len;
+    if (*filter == ',') ++filter;
+  }
+  return 0;
+}
+
+static void collect_isas(void) {
+  for (int t = 0; t < NELEMENTS(kernel_tables); ++t) {
+    for (int i = 0; i < kernel_tables[t].num_kernels; ++i) {
+      const RtcdBenchVariant *v = kernel_tables[t].kernels[i].variants;
+      for (; v->isa != NULL; ++v) {
+        int j;
+        for (j = 0; j < num_isas && strcmp(isas[j], v->isa); ++j) {
+        }
+        if (j == num_isas && num_isas < RTCD_BENCH_MAX_VARIANTS) {
+          isas[num_isas] = v->isa;
+          isa_flags[num_isas++] = v->flag;
+        }
+      }
+    }
+  }
+}
+
+static int find_isa(const char *isa) {
+  for (int i = 0; i < num_isas; ++i) {
+    if (!strcmp(isas[i], isa)) return i;
+  }
+  return -1;
+}
+
+static void alloc_args(RtcdBenchArgs *a) {
+  // 8-bit filter kernels summing to 128, for the functions that index filters
+  // by position.
+  static const int16_t kFilter[8] = { -1, 3, -10, 122, 18, -6, 2, 0 };
+  const size_t buf_size = RTCD_BENCH_ROWS * RTCD_BENCH_STRIDE * sizeof(double);
+  int16_t *filter;
+
+  memset(a, 0, sizeof(*a));
+  for (int k = 0; k < RTCD_BENCH_MAX_BUFS; ++k) {
+    a->buf[k] = aom_memalign(64, buf_size);
+    if (a->buf[k] == NULL) fatal("Failed to allocate the buffers");
+  }
+  filter = (int16_t *)aom_memalign(64, 1024 * sizeof(*filter));
+  if (filter == NULL) fatal("Failed to allocate the filters");
+  for (int i = 0; i < 1024; ++i) filter[i] = kFilter[i % 8];
+  a->filter = filter;
+  a->stride = RTCD_BENCH_STRIDE;
+  a->sgr_params = &av1_sgr_params[0];
+  a->jcp_param.use_dist_wtd_comp_avg = 1;
+  a->jcp_param.fwd_offset = 9;
+  a->jcp_param.bck_offset = 7;
+  for (int i = 0; i < 2; ++i) {
+    if (aom_alloc_frame_buffer(&a->frames[i], RTCD_BENCH_FRAME_WIDTH,
+                               RTCD_BENCH_FRAME_HEIGHT, 1, 1, 0,
+                               AOM_BORDER_IN_PIXELS, 0, 0)) {
+      fatal("Failed to allocate the frames");
+    }
+    memset(a->frames[i].buffer_alloc, 128, a->frames[i].frame_size);
+  }
+}
+
+static void free_args(RtcdBenchArgs *a) {
+  for (int k = 0; k < RTCD_BENCH_MAX_BUFS; ++k) aom_free(a->buf[k]);
+  aom_free((void *)a->filter);
+  aom_free_frame_buffer(&a->frames[0]);
+  aom_free_frame_buffer(&a->frames[1]);
+}
+
+// Fills the buffers with the same pseudo-random data before each version
+// runs, as some functions write to their inputs. The values fit in 10 bits so
+// that 16-bit buffers hold valid high bitdepth pixels.
+static void fill_buffers(const RtcdBenchKernel *kernel, RtcdBenchArgs *a,
+                         void *const *bufs) {
+  const int n = RTCD_BENCH_ROWS * RTCD_BENCH_STRIDE;
+  for (int k = 0; k < RTCD_BENCH_MAX_BUFS && kernel->bufs[k]; ++k) {
+    unsigned int seed = 0x12345 + k;
+    size_t elem_size = 1;
+    for (int i = 0; i < n; ++i) {
+      seed = seed * 1103515245 + 12345;
+      const unsigned int v = seed >> 16;
+      switch (kernel->bufs[k]) {
+        case RTCD_BENCH_U8: ((uint8_t *)bufs[k])[i] = (uint8_t)v; break;
+        case RTCD_BENCH_U16:
+          elem_size = 2;
+          ((uint16_t *)bufs[k])[i] = v & 1023;
+          break;
+        case RTCD_BENCH_U32:
+          elem_size = 4;
+          ((int32_t *)bufs[k])[i] = v & 1023;
+          break;
+        case RTCD_BENCH_U64:
+          elem_size = 8;
+          ((int64_t *)bufs[k])[i] = v & 1023;
+          break;
+        case RTCD_BENCH_F32:
+          elem_size = 4;
+          ((float *)bufs[k])[i] = (v & 1023) / 1024.0f;
+          break;
+        default:
+          elem_size = 8;
+          ((double *)bufs[k])[i] = (v & 1023) / 1024.0;
+          break;
+      }
+    }
+    uint8_t *const base = (uint8_t *)bufs[k] + RTCD_BENCH_OFFSET * elem_size;
+    a->buf[k] = base;
+    for (int i = 0; i < 4; ++i) {
+      a->blocks[k][i] = base + i * elem_size;
+      a->blocks_hbd[k][i] = CONVERT_TO_BYTEPTR(a->blocks[k][i]);
+    }
+  }
+}
+
+// Sets the arguments that depend on the function and the block size.
+static void set_size(const RtcdBenchKernel *kernel, int w, int h,
+                     RtcdBenchArgs *a, CONV_BUF_TYPE *conv_dst) {
+  const int highbd = strstr(kernel->name, "highbd") != NULL ||
+                     strstr(kernel->name, "high_bd") != NULL;
+  a->w = w;
+  a->h = h;
+  a->bd = highbd ? 10 : 8;
+  a->bsize = BLOCK_INVALID;
+  for (int bsize = 0; bsize < BLOCK_SIZES_ALL; ++bsize) {
+    if (block_size_wide[bsize] == w && block_size_high[bsize] == h) {
+      a->bsize = (BLOCK_SIZE)bsize;
+    }
+  }
+  a->tx_size =
+      a->bsize == BLOCK_INVALID ? TX_4X4 : max_txsize_rect_lookup[a->bsize];
+  a->filter_params =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, w);
+  a->conv_params = get_conv_params_no_round(
+      0, 0, conv_dst, RTCD_BENCH_STRIDE,
+      strstr(kernel->name, "dist_wtd_convolve") != NULL, a->bd);
+  a->txfm_param.tx_type = DCT_DCT;
+  a->txfm_param.tx_size = a->tx_size;
+  a->txfm_param.lossless = 0;
+  a->txfm_param.bd = a->bd;
+  a->txfm_param.is_hbd = highbd;
+  a->txfm_param.tx_set_type = EXT_TX_SET_ALL16;
+  a->txfm_param.eob =
+      tx_size_wide[a->tx_size] * AOMMIN(tx_size_high[a->tx_size], 32);
+}
+
+// Returns the average time of one call of |fn| in ns, doubling the number of
+// calls until they take at least |min_time_us|.
+static double time_variant(const RtcdBenchKernel *kernel, rtcd_bench_fn fn,
+                           const RtcdBenchArgs *a, int min_time_us) {
+  struct aom_usec_timer timer;
+  int64_t elapsed;
+  int64_t n = 1;
+  kernel->bench(fn, a);
+  for (;;) {
+    aom_usec_timer_start(&timer);
+    for (int64_t i = 0; i < n; ++i) kernel->bench(fn, a);
+    aom_usec_timer_mark(&timer);
+    elapsed = aom_usec_timer_elapsed(&timer);
+    if (elapsed >= min_time_us) break;
+    n *= 2;
+  }
+  return elapsed * 1000.0 / n;
+}
+
+static void run_variant(const RtcdBenchKernel *kernel,
+                        const RtcdBenchVariant *variant, RtcdBenchArgs *a,
+                        void *const *bufs, const BenchConfig *config,
+                        VariantResult *result) {
+  fill_buffers(kernel, a, bufs);
+#if !defined(_WIN32)
+  if (config->use_fork) {
+    int fds[2];
+    double ns;
+    int status;
+    if (pipe(fds)) fatal("Failed to create a pipe");
+    fflush(stdout);
+    const pid_t pid = fork();
+    if (pid < 0) fatal("Failed to fork");
+    if (pid == 0) {
+      close(fds[0]);
+      // Kernels that loop forever on the generic data are stopped.
+      alarm(30 + 100 * config->min_time_us / 1000000);
+      ns = time_variant(kernel, variant->fn, a, config->min_time_us);
+      _exit(write(fds[1], &ns, sizeof(ns)) == sizeof(ns) ? 0 : 1);
+    }
+    close(fds[1]);
+    const ssize_t bytes = read(fds[0], &ns, sizeof(ns));
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+    if (bytes != sizeof(ns)) {
+      result->status = RESULT_CRASHED;
+      if (WIFSIGNALED(status)) {
+        fprintf(stderr, "%s_%s (%dx%d) crashed with signal %d.\n",
+                kernel->name, variant->isa, a->w, a->h, WTERMSIG(status));
+      }
+      return;
+    }
+    result->status = RESULT_OK;
+    result->ns = ns;
+    return;
+  }
+#endif
+  result->status = RESULT_OK;
+  result->ns = time_variant(kernel, variant->fn, a, config->min_time_us);
+}
+
+static void print_header(void) {
+  printf("%-48s %-8s %10s", "function", "size", "c (ns)");
+  for (int i = 1; i < num_isas; ++i) printf(" %8s", isas[i]);
+  printf("\n");
+}
+
+static void print_results(const RtcdBenchKernel *kernel, int w, int h,
+                          const VariantResult *results,
+                          const BenchConfig *config) {
+  char size[16];
+  if (kernel->w || kernel->sized) {
+    snprintf(size, sizeof(size), "%dx%d", w, h);
+  } else {
+    snprintf(size, sizeof(size), "-");
+  }
+  const double c_ns = results[0].status == RESULT_OK ? results[0].ns : 0;
+  if (config->csv) {
+    for (int i = 0; i < num_isas; ++i) {
+      if (results[i].status != RESULT_OK) continue;
+      printf("%s,%s,%s,%.2f,%.3f\n", kernel->name, size, isas[i],
+             results[i].ns, c_ns > 0 ? c_ns / results[i].ns : 0.0);
+    }
+    return;
+  }
+  printf("%-48s %-8s", kernel->name, size);
+  if (results[0].status == RESULT_OK) {
+    printf(" %10.1f", c_ns);
+  } else {
+    printf(" %10s", "crash");
+  }
+  for (int i = 1; i < num_isas; ++i) {
+    char cell[16];
+    switch (results[i].status) {
+      case RESULT_OK:
+        if (c_ns > 0) {
+          snprintf(cell, sizeof(cell), "%.2fx", c_ns / results[i].ns);
+        } else {
+          snprintf(cell, sizeof(cell), "%.1fns", results[i].ns);
+        }
+        break;
+      case RESULT_MISSING: snprintf(cell, sizeof(cell), "-"); break;
+      case RESULT_UNSUPPORTED: snprintf(cell, sizeof(cell), "n/a"); break;
+      default: snprintf(cell, sizeof(cell), "crash"); break;
+    }
+    printf(" %8s", cell);
+  }
+  printf("\n");
+}
+
+static int compare_missing(const void *a, const void *b) {
+  const double ns_a = ((const MissingKernel *)a)->c_ns;
+  const double ns_b = ((const MissingKernel *)b)->c_ns;
+  return (ns_a < ns_b) - (ns_a > ns_b);
+}
+
+int main(int argc, const char **argv) {
+  BenchConfig config;
+  RtcdBenchArgs args;
+  void *bufs[RTCD_BENCH_MAX_BUFS];
+  VariantResult results[RTCD_BENCH_MAX_VARIANTS];
+  MissingKernel *missing = NULL;
+  int num_missing = 0;
+  int missing_capacity = 0;
+  int num_skipped = 0;
+  const int caps = get_cpu_caps();
+
+  exec_name = argv[0];
+  parse_command_line(argc, argv, &config);
+
+  aom_dsp_rtcd();
+  av1_rtcd();
+  aom_scale_rtcd();
+  collect_isas();
+
+  // By default list the kernels without a version for the best instruction
+  // set of the CPU.
+  int missing_isa = -1;
+  if (config.missing_isa != NULL) {
+    missing_isa = find_isa(config.missing_isa);
+    if (missing_isa < 0) {
+      die("No function has a version for '%s'.", config.missing_isa);
+    }
+  } else {
+    for (int i = 1; i < num_isas; ++i) {
+      if ((caps & isa_flags[i]) == isa_flags[i]) missing_isa = i;
+    }
+  }
+
+  alloc_args(&args);
+  memcpy(bufs, args.buf, sizeof(bufs));
+  CONV_BUF_TYPE *const conv_dst = (CONV_BUF_TYPE *)aom_memalign(
+      64, RTCD_BENCH_ROWS * RTCD_BENCH_STRIDE * sizeof(*conv_dst));
+  if (conv_dst == NULL) fatal("Failed to allocate the convolve buffer");
+
+  if (!config.csv) print_header();
+  for (int t = 0; t < NELEMENTS(kernel_tables); ++t) {
+    for (int k = 0; k < kernel_tables[t].num_kernels; ++k) {
+      const RtcdBenchKernel *const kernel = &kernel_tables[t].kernels[k];
+      if (!match_filter(config.filter, kernel->name)) continue;
+      const int num_sizes = kernel->sized ? config.num_sizes : 1;
+      for (int s = 0; s < num_sizes; ++s) {
+        const int w = kernel->w ? kernel->w
+                                : kernel->sized ? config.widths[s] : 16;
+        const int h = kernel->w ? kernel->h
+                                : kernel->sized ? config.heights[s] : 16;
+        set_size(kernel, w, h, &args, conv_dst);
+        for (int i = 0; i < num_isas; ++i) {
+          const RtcdBenchVariant *v = kernel->variants;
+          while (v->isa != NULL && strcmp(v->isa, isas[i])) ++v;
+          if (v->isa == NULL) {
+            results[i].status = RESULT_MISSING;
+          } else if ((caps & v->flag) != v->flag) {
+            results[i].status = RESULT_UNSUPPORTED;
+          } else {
+            run_variant(kernel, v, &args, bufs, &config, &results[i]);
+          }
+        }
+        print_results(kernel, w, h, results, &config);
+        fflush(stdout);
+
+        if (missing_isa > 0 && results[missing_isa].status == RESULT_MISSING &&
+            results[0].status == RESULT_OK) {
+          if (num_missing == missing_capacity) {
+            missing_capacity = AOMMAX(2 * missing_capacity, 64);
+            missing = (MissingKernel *)realloc(
+                missing, missing_capacity * sizeof(*missing));
+            if (missing == NULL) fatal("Failed to allocate the missing list");
+          }
+          missing[num_missing].name = kernel->name;
+          missing[num_missing].w = w;
+          missing[num_missing].h = h;
+          missing[num_missing++].c_ns = results[0].ns;
+        }
+      }
+    }
+  }
+
+  if (!config.csv) {
+    if (num_missing > 0) {
+      qsort(missing, num_missing, sizeof(*missing), compare_missing);
+      printf("\nSlowest functions without a %s version:\n", isas[missing_isa]);
+      for (int i = 0; i < AOMMIN(num_missing, 20); ++i) {
+        printf("  %-48s %3dx%-3d %10.1f ns\n", missing[i].name, missing[i].w,
+               missing[i].h, missing[i].c_ns);
+      }
+    }
+    for (int t = 0; t < NELEMENTS(kernel_tables); ++t) {
+      for (int i = 0; i < kernel_tables[t].num_skipped; ++i) {
+        const RtcdBenchSkipped *const skipped = &kernel_tables[t].skipped[i];
+        if (skipped->name == NULL ||
+            !match_filter(config.filter, skipped->name)) {
+          continue;
+        }
+        if (num_skipped++ == 0) {
+          printf("\nFunctions without generic arguments, not benchmarked:\n");
+        }
+        printf("  %-48s (%s)\n", skipped->name, skipped->arg);
+      }
+    }
+  }
+
+  free(missing);
+  aom_free(conv_dst);
+  memcpy(args.buf, bufs, sizeof(bufs));
+  free_args(&args);
+  return EXIT_SUCCESS;
+}